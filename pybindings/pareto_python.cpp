@@ -1,8 +1,14 @@
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
 namespace py = pybind11;
 
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 #include <pareto/archive.h>
 #include <pareto/common/demangle.h>
 #include <pareto/front.h>
@@ -24,13 +30,35 @@ namespace pareto {
     }
 } // namespace pareto
 
+/// Largest number of dimensions with compile-time instantiations
+/// Containers with more dimensions use runtime dimensions
+#ifndef PARETO_PYTHON_MAX_DIMENSIONS
+#define PARETO_PYTHON_MAX_DIMENSIONS 10
+#endif
+
 /// Define the standard type we'll use in the bindings
 using dimension_type = double;
 using mapped_type = py::object;
 using point_type = pareto::point<dimension_type, 0>;
 using value_type = std::pair<const pareto::point<dimension_type, 0>, mapped_type>;
 
+/// Create a point from a list of coordinates
+/// Points with compile-time dimensions need exactly that many coordinates
+template <class P, class Iterator> P make_point(Iterator first, Iterator last) {
+    if constexpr (P::compile_dimensions != 0) {
+        if (static_cast<size_t>(std::distance(first, last)) !=
+            P::compile_dimensions) {
+            throw std::invalid_argument(
+                "Expected a point with " +
+                std::to_string(P::compile_dimensions) + " dimensions");
+        }
+    }
+    return P(first, last);
+}
+
 template <class def_t> void bind_point_concept(def_t &p) {
+    using point_type = typename def_t::type;
+
     // Constructors
     p.def(py::init<>());
     p.def(py::init<size_t>());
@@ -40,7 +68,7 @@ template <class def_t> void bind_point_concept(def_t &p) {
     }));
     p.def(py::init<const point_type &>());
     p.def(py::init([](const std::vector<dimension_type> &v) {
-        return new point_type(v.begin(), v.end());
+        return new point_type(make_point<point_type>(v.begin(), v.end()));
     }));
 
     // Assignment
@@ -129,7 +157,9 @@ template <class def_t> void bind_point_concept(def_t &p) {
     });
 
     // Values
-    p.def("values", [](const point_type &a) { return a.values(); });
+    p.def("values", [](const point_type &a) {
+        return std::vector<dimension_type>(a.begin(), a.end());
+    });
 
     // Quadrant
     p.def("quadrant", [](const point_type &a, const point_type &b) {
@@ -195,6 +225,9 @@ template <class def_t> void bind_point_concept(def_t &p) {
 }
 
 template <class C, class def_t> void bind_spatial_container_concept(def_t &p) {
+    using point_type = typename C::key_type;
+    using value_type = typename C::value_type;
+
     // Constructors
     p.def(py::init<>());
     p.def(py::init<const C &>());
@@ -218,14 +251,14 @@ template <class C, class def_t> void bind_spatial_container_concept(def_t &p) {
     p.def("at", py::overload_cast<const point_type &>(&C::at, py::const_));
     p.def("__getitem__", py::overload_cast<const point_type &>(&C::operator[]));
     p.def("__getitem__", [](C &lhs, std::vector<dimension_type> k) {
-        return lhs[point_type(k.begin(), k.end())];
+        return lhs[make_point<point_type>(k.begin(), k.end())];
     });
 
     p.def("__setitem__", [](C &lhs, const point_type &k, const mapped_type &v) {
         lhs[k] = v;
     });
     p.def("__setitem__", [](C &lhs, std::vector<dimension_type> k, mapped_type v) {
-        lhs[point_type(k.begin(), k.end())] = v;
+        lhs[make_point<point_type>(k.begin(), k.end())] = v;
     });
 
     // Iterators
@@ -268,11 +301,11 @@ template <class C, class def_t> void bind_spatial_container_concept(def_t &p) {
     p.def("emplace", [](C &lhs, const value_type &v) { lhs.emplace(v); });
     p.def("erase", [](C &lhs, const point_type &k) { return lhs.erase(k); });
     p.def("erase", [](C &lhs, const std::vector<dimension_type> &k) {
-        return lhs.erase(point_type(k.begin(), k.end()));
+        return lhs.erase(make_point<point_type>(k.begin(), k.end()));
     });
     p.def("__delitem__", [](C &lhs, const point_type &k) { return lhs.erase(k); });
     p.def("__delitem__", [](C &lhs, std::vector<dimension_type> k) {
-      return lhs.erase(point_type(k.begin(), k.end()));
+      return lhs.erase(make_point<point_type>(k.begin(), k.end()));
     });
     p.def("merge", [](C &lhs, C &rhs) { return lhs.merge(rhs); });
 
@@ -296,7 +329,7 @@ template <class C, class def_t> void bind_spatial_container_concept(def_t &p) {
     p.def("__contains__",
           [](const C &lhs, const point_type &k) { return lhs.contains(k); });
     p.def("__contains__",
-          [](const C &lhs, const std::vector<dimension_type> &k) { return lhs.contains(point_type(k.begin(), k.end())); });
+          [](const C &lhs, const std::vector<dimension_type> &k) { return lhs.contains(make_point<point_type>(k.begin(), k.end())); });
 
     // Lookup / Spatial concept
     p.def(
@@ -370,7 +403,45 @@ std::vector<uint8_t> to_directions(const std::vector<std::string> &tags) {
     return v;
 }
 
+/// Contiguous arrays of coordinates with one point per row
+using points_array_type =
+    py::array_t<dimension_type, py::array::c_style | py::array::forcecast>;
+
+/// Create points from the rows of an array
+/// The rows are read directly from the buffer without the GIL
+/// \param a Array with one point per row
+/// \param dimensions Number of columns we expect, or 0 if the
+///        container has no elements to compare the points with
+template <class P>
+std::vector<P> to_points(const points_array_type &a, size_t dimensions) {
+    if (a.ndim() != 2) {
+        throw std::invalid_argument(
+            "Expected a two-dimensional array with one point per row");
+    }
+    if (P::compile_dimensions != 0) {
+        dimensions = P::compile_dimensions;
+    }
+    if (dimensions != 0 && static_cast<size_t>(a.shape(1)) != dimensions) {
+        throw std::invalid_argument("Expected an array with " +
+                                    std::to_string(dimensions) + " columns");
+    }
+    auto rows = a.template unchecked<2>();
+    std::vector<P> v;
+    {
+        py::gil_scoped_release release;
+        v.reserve(static_cast<size_t>(rows.shape(0)));
+        for (py::ssize_t i = 0; i < rows.shape(0); ++i) {
+            const dimension_type *row = rows.data(i, 0);
+            v.emplace_back(row, row + rows.shape(1));
+        }
+    }
+    return v;
+}
+
 template <class C, class def_t> void bind_front_container_concept(def_t &p) {
+    using point_type = typename C::key_type;
+    using value_type = typename C::value_type;
+
     // Constructors
     p.def(py::init([](const std::vector<std::string> &d) {
         std::vector<uint8_t> m = to_directions(d);
@@ -412,30 +483,31 @@ template <class C, class def_t> void bind_front_container_concept(def_t &p) {
     p.def("non_dominates", [](const C &lhs, const C& P2) { return lhs.non_dominates(P2); });
 
     // Non-modifiers / Indicators / Front concept
-    p.def("hypervolume", [](const C &lhs) { return lhs.hypervolume(); });
-    p.def("hypervolume", [](const C &lhs, const point_type& p) { return lhs.hypervolume(p); });
-    p.def("hypervolume", [](const C &lhs, size_t sample_size) { return lhs.hypervolume(sample_size); });
-    p.def("hypervolume", [](const C &lhs, size_t sample_size, const point_type& p) { return lhs.hypervolume(sample_size, p); });
-    p.def("coverage", [](const C &lhs, const C& rhs) { return lhs.coverage(rhs); });
-    p.def("coverage_ratio", [](const C &lhs, const C& rhs) { return lhs.coverage_ratio(rhs); });
-    p.def("gd", [](const C &lhs, const C& rhs) { return lhs.gd(rhs); });
-    p.def("std_gd", [](const C &lhs, const C& rhs) { return lhs.std_gd(rhs); });
-    p.def("igd", [](const C &lhs, const C& rhs) { return lhs.igd(rhs); });
-    p.def("std_igd", [](const C &lhs, const C& rhs) { return lhs.std_igd(rhs); });
-    p.def("hausdorff", [](const C &lhs, const C& rhs) { return lhs.hausdorff(rhs); });
-    p.def("igd_plus", [](const C &lhs, const C& rhs) { return lhs.igd_plus(rhs); });
-    p.def("std_igd_plus", [](const C &lhs, const C& rhs) { return lhs.std_igd_plus(rhs); });
-    p.def("uniformity", [](const C &lhs) { return lhs.uniformity(); });
-    p.def("average_distance", [](const C &lhs) { return lhs.average_distance(); });
-    p.def("average_nearest_distance", [](const C &lhs, size_t k) { return lhs.average_nearest_distance(k); });
-    p.def("crowding_distance", [](const C &lhs, const point_type& k) { return lhs.crowding_distance(k); });
-    p.def("average_crowding_distance", [](const C &lhs) { return lhs.average_crowding_distance(); });
-    p.def("direct_conflict", [](const C &lhs, size_t a, size_t b) { return lhs.direct_conflict(a,b); });
-    p.def("normalized_direct_conflict", [](const C &lhs, size_t a, size_t b) { return lhs.normalized_direct_conflict(a,b); });
-    p.def("maxmin_conflict", [](const C &lhs, size_t a, size_t b) { return lhs.maxmin_conflict(a,b); });
-    p.def("normalized_maxmin_conflict", [](const C &lhs, size_t a, size_t b) { return lhs.normalized_maxmin_conflict(a,b); });
-    p.def("conflict", [](const C &lhs, size_t a, size_t b) { return lhs.conflict(a,b); });
-    p.def("normalized_conflict", [](const C &lhs, size_t a, size_t b) { return lhs.normalized_conflict(a,b); });
+    // These only read the keys, so other python threads can run meanwhile
+    p.def("hypervolume", [](const C &lhs) { return lhs.hypervolume(); }, py::call_guard<py::gil_scoped_release>());
+    p.def("hypervolume", [](const C &lhs, const point_type& p) { return lhs.hypervolume(p); }, py::call_guard<py::gil_scoped_release>());
+    p.def("hypervolume", [](const C &lhs, size_t sample_size) { return lhs.hypervolume(sample_size); }, py::call_guard<py::gil_scoped_release>());
+    p.def("hypervolume", [](const C &lhs, size_t sample_size, const point_type& p) { return lhs.hypervolume(sample_size, p); }, py::call_guard<py::gil_scoped_release>());
+    p.def("coverage", [](const C &lhs, const C& rhs) { return lhs.coverage(rhs); }, py::call_guard<py::gil_scoped_release>());
+    p.def("coverage_ratio", [](const C &lhs, const C& rhs) { return lhs.coverage_ratio(rhs); }, py::call_guard<py::gil_scoped_release>());
+    p.def("gd", [](const C &lhs, const C& rhs) { return lhs.gd(rhs); }, py::call_guard<py::gil_scoped_release>());
+    p.def("std_gd", [](const C &lhs, const C& rhs) { return lhs.std_gd(rhs); }, py::call_guard<py::gil_scoped_release>());
+    p.def("igd", [](const C &lhs, const C& rhs) { return lhs.igd(rhs); }, py::call_guard<py::gil_scoped_release>());
+    p.def("std_igd", [](const C &lhs, const C& rhs) { return lhs.std_igd(rhs); }, py::call_guard<py::gil_scoped_release>());
+    p.def("hausdorff", [](const C &lhs, const C& rhs) { return lhs.hausdorff(rhs); }, py::call_guard<py::gil_scoped_release>());
+    p.def("igd_plus", [](const C &lhs, const C& rhs) { return lhs.igd_plus(rhs); }, py::call_guard<py::gil_scoped_release>());
+    p.def("std_igd_plus", [](const C &lhs, const C& rhs) { return lhs.std_igd_plus(rhs); }, py::call_guard<py::gil_scoped_release>());
+    p.def("uniformity", [](const C &lhs) { return lhs.uniformity(); }, py::call_guard<py::gil_scoped_release>());
+    p.def("average_distance", [](const C &lhs) { return lhs.average_distance(); }, py::call_guard<py::gil_scoped_release>());
+    p.def("average_nearest_distance", [](const C &lhs, size_t k) { return lhs.average_nearest_distance(k); }, py::call_guard<py::gil_scoped_release>());
+    p.def("crowding_distance", [](const C &lhs, const point_type& k) { return lhs.crowding_distance(k); }, py::call_guard<py::gil_scoped_release>());
+    p.def("average_crowding_distance", [](const C &lhs) { return lhs.average_crowding_distance(); }, py::call_guard<py::gil_scoped_release>());
+    p.def("direct_conflict", [](const C &lhs, size_t a, size_t b) { return lhs.direct_conflict(a,b); }, py::call_guard<py::gil_scoped_release>());
+    p.def("normalized_direct_conflict", [](const C &lhs, size_t a, size_t b) { return lhs.normalized_direct_conflict(a,b); }, py::call_guard<py::gil_scoped_release>());
+    p.def("maxmin_conflict", [](const C &lhs, size_t a, size_t b) { return lhs.maxmin_conflict(a,b); }, py::call_guard<py::gil_scoped_release>());
+    p.def("normalized_maxmin_conflict", [](const C &lhs, size_t a, size_t b) { return lhs.normalized_maxmin_conflict(a,b); }, py::call_guard<py::gil_scoped_release>());
+    p.def("conflict", [](const C &lhs, size_t a, size_t b) { return lhs.conflict(a,b); }, py::call_guard<py::gil_scoped_release>());
+    p.def("normalized_conflict", [](const C &lhs, size_t a, size_t b) { return lhs.normalized_conflict(a,b); }, py::call_guard<py::gil_scoped_release>());
 
     // Lookup / Pareto concept
     p.def(
@@ -460,6 +532,59 @@ template <class C, class def_t> void bind_front_container_concept(def_t &p) {
         return *lhs.worst_element(dimension);
     });
 
+    // Bulk operations / NumPy arrays
+    // The GIL is only held while the mapped python objects are touched
+    p.def(
+        "insert_array",
+        [](C &lhs, const points_array_type &a, const py::object &payloads) {
+            std::vector<point_type> keys = to_points<point_type>(
+                a, lhs.empty() ? 0 : lhs.dimensions());
+            const bool has_payloads = !payloads.is_none();
+            if (has_payloads && py::len(payloads) != keys.size()) {
+                throw std::invalid_argument(
+                    "The number of payloads and points should be the same");
+            }
+            std::vector<value_type> v;
+            v.reserve(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i) {
+                v.emplace_back(std::move(keys[i]),
+                               has_payloads ? mapped_type(payloads[py::int_(i)])
+                                            : mapped_type(py::none()));
+            }
+            return lhs.insert(v.begin(), v.end());
+        },
+        py::arg("array"), py::arg("payloads") = py::none());
+    p.def("dominates_many", [](const C &lhs, const points_array_type &a) {
+        std::vector<point_type> keys =
+            to_points<point_type>(a, lhs.empty() ? 0 : lhs.dimensions());
+        py::array_t<bool> r(static_cast<py::ssize_t>(keys.size()));
+        auto out = r.template mutable_unchecked<1>();
+        {
+            py::gil_scoped_release release;
+            for (size_t i = 0; i < keys.size(); ++i) {
+                out(static_cast<py::ssize_t>(i)) = lhs.dominates(keys[i]);
+            }
+        }
+        return r;
+    });
+    p.def("to_numpy", [](const C &lhs) {
+        py::array_t<dimension_type> r(std::vector<py::ssize_t>{
+            static_cast<py::ssize_t>(lhs.size()),
+            static_cast<py::ssize_t>(lhs.dimensions())});
+        auto out = r.template mutable_unchecked<2>();
+        {
+            py::gil_scoped_release release;
+            py::ssize_t i = 0;
+            for (const auto &[k, v] : lhs) {
+                for (size_t j = 0; j < k.dimensions(); ++j) {
+                    out(i, static_cast<py::ssize_t>(j)) = k[j];
+                }
+                ++i;
+            }
+        }
+        return r;
+    });
+
     // Operators
     // https://docs.python.org/3/reference/datamodel.html#special-method-names
     p.def("__lt__", [](const C &a, const C &b) { return a < b; });
@@ -469,6 +594,9 @@ template <class C, class def_t> void bind_front_container_concept(def_t &p) {
 }
 
 template <class C, class def_t> void bind_archive_container_concept(def_t &p) {
+    using point_type = typename C::key_type;
+    using value_type = typename C::value_type;
+
     // Constructors (one extra constructor for each with the capacity)
     p.def(py::init<size_t>());
     p.def(py::init([](size_t max_capacity, const std::vector<std::string> &d) {
@@ -537,116 +665,258 @@ template <class C, class def_t> void bind_archive_container_concept(def_t &p) {
     });
 }
 
-/// Create modules
-PYBIND11_MODULE(pareto, m) {
-    using namespace py::literals;
+/// Evaluate fn(i) for each i in [0, n) with all hardware threads
+/// The GIL is released, so fn cannot touch python objects
+template <class FN> std::vector<double> parallel_evaluate(size_t n, FN fn) {
+    std::vector<double> r(n);
+    py::gil_scoped_release release;
+    const size_t n_threads = std::min(
+        n, static_cast<size_t>(
+               std::max(std::thread::hardware_concurrency(), 1u)));
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto work = [&]() {
+        for (size_t i = next++; i < n; i = next++) {
+            try {
+                r[i] = fn(i);
+            } catch (...) {
+                std::lock_guard lock(error_mutex);
+                error = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < n_threads; ++i) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto &t : threads) {
+        t.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return r;
+}
+
+/// Bind indicators that evaluate a list of fronts in parallel
+/// For instance, pareto.igd_plus(fronts, reference) returns the list
+/// [f.igd_plus(reference) for f in fronts].
+template <class C> void bind_batch_indicators(py::module &m) {
+    using point_type = typename C::key_type;
+    using fronts_type = std::vector<const C *>;
+    m.def("hypervolume", [](const fronts_type &fronts) {
+        return parallel_evaluate(fronts.size(), [&](size_t i) {
+            return static_cast<double>(fronts[i]->hypervolume());
+        });
+    });
+    m.def("hypervolume",
+          [](const fronts_type &fronts, const point_type &reference_point) {
+              return parallel_evaluate(fronts.size(), [&](size_t i) {
+                  return static_cast<double>(
+                      fronts[i]->hypervolume(reference_point));
+              });
+          });
+    m.def("gd", [](const fronts_type &fronts, const C &reference) {
+        return parallel_evaluate(fronts.size(), [&](size_t i) {
+            return fronts[i]->gd(reference);
+        });
+    });
+    m.def("igd", [](const fronts_type &fronts, const C &reference) {
+        return parallel_evaluate(fronts.size(), [&](size_t i) {
+            return fronts[i]->igd(reference);
+        });
+    });
+    m.def("igd_plus", [](const fronts_type &fronts, const C &reference) {
+        return parallel_evaluate(fronts.size(), [&](size_t i) {
+            return fronts[i]->igd_plus(reference);
+        });
+    });
+    m.def("hausdorff", [](const fronts_type &fronts, const C &reference) {
+        return parallel_evaluate(fronts.size(), [&](size_t i) {
+            return fronts[i]->hausdorff(reference);
+        });
+    });
+    m.def("average_crowding_distance", [](const fronts_type &fronts) {
+        return parallel_evaluate(fronts.size(), [&](size_t i) {
+            return fronts[i]->average_crowding_distance();
+        });
+    });
+}
+
+/// Bind the trees, fronts, and archives with M dimensions
+/// The names of the types with compile-time dimensions end with the
+/// number of dimensions, as in r_front_3d.
+template <size_t M> void bind_containers(py::module &m) {
     using namespace pareto;
-    m.doc() =
-        "A library for spatial containers, Pareto fronts, and Pareto archives";
+    const std::string suffix = M == 0 ? "" : "_" + std::to_string(M) + "d";
+    auto name = [&suffix](const char *type_name) {
+        return std::string(type_name) + suffix;
+    };
 
     /*
      * Bind point type
      */
-    py::class_<point_type> p(m, "point");
+    using point_m = point<dimension_type, M>;
+    py::class_<point_m> p(m, name("point").c_str());
     bind_point_concept(p);
+    if constexpr (M != 0) {
+        // Runtime-dimension points and lists convert implicitly
+        p.def(py::init([](const point_type &v) {
+            return new point_m(make_point<point_m>(v.begin(), v.end()));
+        }));
+        py::implicitly_convertible<point_type, point_m>();
+        py::implicitly_convertible<std::vector<dimension_type>, point_m>();
+    }
 
     /*
      * Bind spatial types
      */
-    using type2 = implicit_tree<dimension_type, 0, mapped_type>;
-    py::class_<type2> sm2(m, "implicit_tree");
+    using type2 = implicit_tree<dimension_type, M, mapped_type>;
+    py::class_<type2> sm2(m, name("implicit_tree").c_str());
     bind_spatial_container_concept<type2>(sm2);
 
-    using type3 = kd_tree<dimension_type, 0, mapped_type>;
-    py::class_<type3> sm3(m, "kd_tree");
+    using type3 = kd_tree<dimension_type, M, mapped_type>;
+    py::class_<type3> sm3(m, name("kd_tree").c_str());
     bind_spatial_container_concept<type3>(sm3);
 
-    using type4 = quad_tree<dimension_type, 0, mapped_type>;
-    py::class_<type4> sm4(m, "quad_tree");
+    using type4 = quad_tree<dimension_type, M, mapped_type>;
+    py::class_<type4> sm4(m, name("quad_tree").c_str());
     bind_spatial_container_concept<type4>(sm4);
 
-    using type5 = r_tree<dimension_type, 0, mapped_type>;
-    py::class_<type5> sm5(m, "r_tree");
+    using type5 = r_tree<dimension_type, M, mapped_type>;
+    py::class_<type5> sm5(m, name("r_tree").c_str());
     bind_spatial_container_concept<type5>(sm5);
 
-    using type6 = r_star_tree<dimension_type, 0, mapped_type>;
-    py::class_<type6> sm6(m, "r_star_tree");
+    using type6 = r_star_tree<dimension_type, M, mapped_type>;
+    py::class_<type6> sm6(m, name("r_star_tree").c_str());
     bind_spatial_container_concept<type6>(sm6);
 
-    m.attr("spatial_map") = m.attr("r_tree");
-
     /*
      * Bind front types
      */
-    using ftype2 = front<dimension_type, 0, mapped_type,
-                         implicit_tree<dimension_type, 0, mapped_type>>;
-    py::class_<ftype2> fsm2(m, "implicit_front");
+    using ftype2 = front<dimension_type, M, mapped_type,
+                         implicit_tree<dimension_type, M, mapped_type>>;
+    py::class_<ftype2> fsm2(m, name("implicit_front").c_str());
     bind_spatial_container_concept<ftype2>(fsm2);
     bind_front_container_concept<ftype2>(fsm2);
+    bind_batch_indicators<ftype2>(m);
 
-    using ftype3 = front<dimension_type, 0, mapped_type,
-                         kd_tree<dimension_type, 0, mapped_type>>;
-    py::class_<ftype3> fsm3(m, "kd_front");
+    using ftype3 = front<dimension_type, M, mapped_type,
+                         kd_tree<dimension_type, M, mapped_type>>;
+    py::class_<ftype3> fsm3(m, name("kd_front").c_str());
     bind_spatial_container_concept<ftype3>(fsm3);
     bind_front_container_concept<ftype3>(fsm3);
+    bind_batch_indicators<ftype3>(m);
 
-    using ftype4 = front<dimension_type, 0, mapped_type,
-                         quad_tree<dimension_type, 0, mapped_type>>;
-    py::class_<ftype4> fsm4(m, "quad_front");
+    using ftype4 = front<dimension_type, M, mapped_type,
+                         quad_tree<dimension_type, M, mapped_type>>;
+    py::class_<ftype4> fsm4(m, name("quad_front").c_str());
     bind_spatial_container_concept<ftype4>(fsm4);
     bind_front_container_concept<ftype4>(fsm4);
+    bind_batch_indicators<ftype4>(m);
 
     using ftype5 =
-        front<dimension_type, 0, mapped_type, r_tree<dimension_type, 0, mapped_type>>;
-    py::class_<ftype5> fsm5(m, "r_front");
+        front<dimension_type, M, mapped_type, r_tree<dimension_type, M, mapped_type>>;
+    py::class_<ftype5> fsm5(m, name("r_front").c_str());
     bind_spatial_container_concept<ftype5>(fsm5);
     bind_front_container_concept<ftype5>(fsm5);
+    bind_batch_indicators<ftype5>(m);
 
-    using ftype6 = front<dimension_type, 0, mapped_type,
-                         r_star_tree<dimension_type, 0, mapped_type>>;
-    py::class_<ftype6> fsm6(m, "r_star_front");
+    using ftype6 = front<dimension_type, M, mapped_type,
+                         r_star_tree<dimension_type, M, mapped_type>>;
+    py::class_<ftype6> fsm6(m, name("r_star_front").c_str());
     bind_spatial_container_concept<ftype6>(fsm6);
     bind_front_container_concept<ftype6>(fsm6);
-
-    m.attr("front") = m.attr("r_front");
+    bind_batch_indicators<ftype6>(m);
 
     /*
      * Bind archive types
      */
-    using atype2 = archive<dimension_type, 0, mapped_type,
-                         implicit_tree<dimension_type, 0, mapped_type>>;
-    py::class_<atype2> asm2(m, "implicit_archive");
+    using atype2 = archive<dimension_type, M, mapped_type,
+                         implicit_tree<dimension_type, M, mapped_type>>;
+    py::class_<atype2> asm2(m, name("implicit_archive").c_str());
     bind_spatial_container_concept<atype2>(asm2);
     bind_front_container_concept<atype2>(asm2);
     bind_archive_container_concept<atype2>(asm2);
 
-    using atype3 = archive<dimension_type, 0, mapped_type,
-                         kd_tree<dimension_type, 0, mapped_type>>;
-    py::class_<atype3> asm3(m, "kd_archive");
+    using atype3 = archive<dimension_type, M, mapped_type,
+                         kd_tree<dimension_type, M, mapped_type>>;
+    py::class_<atype3> asm3(m, name("kd_archive").c_str());
     bind_spatial_container_concept<atype3>(asm3);
     bind_front_container_concept<atype3>(asm3);
     bind_archive_container_concept<atype3>(asm3);
 
-    using atype4 = archive<dimension_type, 0, mapped_type,
-                         quad_tree<dimension_type, 0, mapped_type>>;
-    py::class_<atype4> asm4(m, "quad_archive");
+    using atype4 = archive<dimension_type, M, mapped_type,
+                         quad_tree<dimension_type, M, mapped_type>>;
+    py::class_<atype4> asm4(m, name("quad_archive").c_str());
     bind_spatial_container_concept<atype4>(asm4);
     bind_front_container_concept<atype4>(asm4);
     bind_archive_container_concept<atype4>(asm4);
 
     using atype5 =
-        archive<dimension_type, 0, mapped_type, r_tree<dimension_type, 0, mapped_type>>;
-    py::class_<atype5> asm5(m, "r_archive");
+        archive<dimension_type, M, mapped_type, r_tree<dimension_type, M, mapped_type>>;
+    py::class_<atype5> asm5(m, name("r_archive").c_str());
     bind_spatial_container_concept<atype5>(asm5);
     bind_front_container_concept<atype5>(asm5);
     bind_archive_container_concept<atype5>(asm5);
 
-    using atype6 = archive<dimension_type, 0, mapped_type,
-                         r_star_tree<dimension_type, 0, mapped_type>>;
-    py::class_<atype6> asm6(m, "r_star_archive");
+    using atype6 = archive<dimension_type, M, mapped_type,
+                         r_star_tree<dimension_type, M, mapped_type>>;
+    py::class_<atype6> asm6(m, name("r_star_archive").c_str());
     bind_spatial_container_concept<atype6>(asm6);
     bind_front_container_concept<atype6>(asm6);
     bind_archive_container_concept<atype6>(asm6);
 
-    m.attr("archive") = m.attr("r_archive");
+    /*
+     * Default types
+     */
+    m.attr(name("spatial_map").c_str()) = m.attr(name("r_tree").c_str());
+    m.attr(name("front").c_str()) = m.attr(name("r_front").c_str());
+    m.attr(name("archive").c_str()) = m.attr(name("r_archive").c_str());
+}
+
+/// Bind the containers with 1 to PARETO_PYTHON_MAX_DIMENSIONS dimensions
+template <size_t... Ms>
+void bind_fixed_dimension_containers(py::module &m, std::index_sequence<Ms...>) {
+    (bind_containers<Ms + 1>(m), ...);
+}
+
+/// Bind a factory that creates the type with the given dimensions
+/// The factory creates the fixed-dimension type, such as r_front_3d,
+/// only when the "dimensions" keyword argument is passed. Without it,
+/// or with more than PARETO_PYTHON_MAX_DIMENSIONS dimensions, it creates
+/// the runtime-dimension type, such as pareto.front. Binary operators
+/// only accept containers of the same type.
+void bind_factory(py::module &m, const char *factory_name,
+                  const std::string &type_name) {
+    py::object module = m;
+    m.def(factory_name, [module, type_name](py::args args, py::kwargs kwargs) {
+        py::object dimensions = kwargs.attr("pop")("dimensions", py::none());
+        const size_t d = dimensions.is_none() ? 0 : dimensions.cast<size_t>();
+        if (d != 0 && d <= PARETO_PYTHON_MAX_DIMENSIONS) {
+            const std::string name = type_name + "_" + std::to_string(d) + "d";
+            return module.attr(name.c_str())(*args, **kwargs);
+        }
+        return module.attr(type_name.c_str())(*args, **kwargs);
+    });
+}
+
+/// Create modules
+PYBIND11_MODULE(pareto, m) {
+    m.doc() =
+        "A library for spatial containers, Pareto fronts, and Pareto archives";
+
+    // Runtime dimensions
+    bind_containers<0>(m);
+
+    // Compile-time dimensions
+    bind_fixed_dimension_containers(
+        m, std::make_index_sequence<PARETO_PYTHON_MAX_DIMENSIONS>());
+
+    // Factories for the default types
+    bind_factory(m, "make_spatial_map", "r_tree");
+    bind_factory(m, "make_front", "r_front");
+    bind_factory(m, "make_archive", "r_archive");
 }
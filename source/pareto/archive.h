@@ -5,16 +5,28 @@
 #ifndef PARETO_FRONT_ARCHIVE_H
 #define PARETO_FRONT_ARCHIVE_H
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <pareto/common/promote_to_floating_point.h>
 #include <pareto/front.h>
 #include <set>
+#include <thread>
 #include <vector>
 
 namespace pareto {
 
+    /// \brief How the archive removes elements over its capacity
+    /// The elements are always removed from the last front.
+    /// crowding removes the elements closest to their neighbours,
+    /// hypervolume removes the elements with the least hypervolume
+    /// contribution, and grid removes elements from the most crowded
+    /// cells of a grid over the last front.
+    enum class archive_pruning { crowding, hypervolume, grid };
+
     template <typename K, size_t M, typename T,
-              class Container = spatial_map<K, M, T>>
+              class Container = front_map<K, M, T>>
     class archive : container_with_pool {
       public /* SpatialAdapter Concept */:
         using container_type = Container;
@@ -541,7 +553,9 @@ namespace pareto {
         /// \param rhs
         archive(const archive &rhs)
             : fronts_(rhs.fronts_), is_minimization_(rhs.is_minimization_),
-              size_(rhs.size_), capacity_(rhs.capacity_), alloc_(rhs.alloc_){};
+              size_(rhs.size_), capacity_(rhs.capacity_), alloc_(rhs.alloc_),
+              pruning_(rhs.pruning_),
+              pruning_reference_(rhs.pruning_reference_){};
 
         /// \brief Copy constructor data but use another allocator
         archive(const archive &rhs, const allocator_type &alloc)
@@ -550,7 +564,9 @@ namespace pareto {
                   front_set_allocator_type(
                       construct_allocator<front_set_allocator_type>(alloc))),
               is_minimization_(rhs.is_minimization_), size_(rhs.size_),
-              capacity_(rhs.capacity_), alloc_(rhs.alloc_){};
+              capacity_(rhs.capacity_), alloc_(rhs.alloc_),
+              pruning_(rhs.pruning_),
+              pruning_reference_(rhs.pruning_reference_){};
 
         /// \brief Move constructor
         /// Move constructors obtain their instances of allocators
@@ -560,7 +576,8 @@ namespace pareto {
             : fronts_(std::move(rhs.fronts_)),
               is_minimization_(std::move(rhs.is_minimization_)),
               size_(std::move(rhs.size_)), capacity_(std::move(rhs.capacity_)),
-              alloc_(std::move(rhs.alloc_)) {}
+              alloc_(std::move(rhs.alloc_)), pruning_(rhs.pruning_),
+              pruning_reference_(std::move(rhs.pruning_reference_)) {}
 
         /// \brief Move constructor data but use new allocator
         archive(archive &&rhs, const allocator_type &alloc) noexcept
@@ -570,7 +587,8 @@ namespace pareto {
                       construct_allocator<front_set_allocator_type>(alloc))),
               is_minimization_(std::move(rhs.is_minimization_)),
               size_(std::move(rhs.size_)), capacity_(std::move(rhs.capacity_)),
-              alloc_(rhs.alloc_) {}
+              alloc_(rhs.alloc_), pruning_(rhs.pruning_),
+              pruning_reference_(std::move(rhs.pruning_reference_)) {}
 
         /// \brief Destructor
         ~archive() = default;
@@ -898,6 +916,8 @@ namespace pareto {
             is_minimization_ = rhs.is_minimization_;
             size_ = rhs.size_;
             capacity_ = rhs.capacity_;
+            pruning_ = rhs.pruning_;
+            pruning_reference_ = rhs.pruning_reference_;
             constexpr bool should_copy = std::allocator_traits<
                 allocator_type>::propagate_on_container_copy_assignment::value;
             if constexpr (should_copy) {
@@ -926,6 +946,8 @@ namespace pareto {
             is_minimization_ = std::move(rhs.is_minimization_);
             size_ = rhs.size_;
             capacity_ = rhs.capacity_;
+            pruning_ = rhs.pruning_;
+            pruning_reference_ = std::move(rhs.pruning_reference_);
             const bool should_move = std::allocator_traits<
                 allocator_type>::propagate_on_container_move_assignment::value;
             if constexpr (should_move) {
@@ -1453,6 +1475,35 @@ namespace pareto {
             return fronts_.begin()->hypervolume(reference_point);
         }
 
+        /// \brief Get exact hypervolume with a given algorithm
+        /// \param reference_point Reference point
+        /// \param algorithm Algorithm for the exact hypervolume
+        /// \return Hypervolume of this front
+        dimension_type hypervolume(point_type reference_point,
+                                   hypervolume_algorithm algorithm) const {
+            if (fronts_.empty()) {
+                return dimension_type{0};
+            }
+            return fronts_.begin()->hypervolume(reference_point, algorithm);
+        }
+
+        /// \brief Get exact hypervolume reusing the memory in a workspace
+        /// \param reference_point Reference point
+        /// \param workspace Memory for the hypervolume algorithm
+        /// \param algorithm Algorithm for the exact hypervolume
+        /// \return Hypervolume of this front
+        dimension_type
+        hypervolume(point_type reference_point,
+                    hypervolume_workspace &workspace,
+                    hypervolume_algorithm algorithm =
+                        hypervolume_algorithm::automatic) const {
+            if (fronts_.empty()) {
+                return dimension_type{0};
+            }
+            return fronts_.begin()->hypervolume(reference_point, workspace,
+                                                algorithm);
+        }
+
         /// \brief Get hypervolume with monte-carlo simulation
         dimension_type hypervolume(size_t sample_size) const {
             if (fronts_.empty()) {
@@ -1907,6 +1958,8 @@ namespace pareto {
             std::swap(is_minimization_, rhs.is_minimization_);
             std::swap(size_, rhs.size_);
             std::swap(capacity_, rhs.capacity_);
+            std::swap(pruning_, rhs.pruning_);
+            std::swap(pruning_reference_, rhs.pruning_reference_);
             const bool should_swap = std::allocator_traits<
                 allocator_type>::propagate_on_container_swap::value;
             if constexpr (should_swap) {
@@ -1976,12 +2029,29 @@ namespace pareto {
         ///     at once.
         /// Insertion removes any point dominated by the point
         ///     before inserting the element in the rtree
+        /// If the archive is empty and the elements fit in it, they are
+        ///     sorted into fronts at once. Otherwise, pruning depends on
+        ///     the order of insertion, so they are inserted one at a time.
+        ///     The result is the same in both cases.
         /// \param first Iterator to first element
         /// \param last Iterator to last element
-        /// \return Iterator to the new element
-        /// \return True if insertion happened successfully
+        /// \return Number of elements inserted
         template <class InputIterator>
         size_t insert(InputIterator first, InputIterator last) {
+            if (empty()) {
+                std::vector<value_type> batch(first, last);
+                if (batch.size() <= capacity()) {
+                    // Sort all elements into fronts at once rather than
+                    // cascading dominated elements through the fronts
+                    return insert_sorted(std::move(batch));
+                }
+                size_t c = 0;
+                for (value_type &v : batch) {
+                    auto res = insert(std::move(v));
+                    c += res.second;
+                }
+                return c;
+            }
             size_t c = 0;
             for (auto it = first; it != last; ++it) {
                 auto res = insert(*it);
@@ -2003,6 +2073,53 @@ namespace pareto {
             return insert(il.begin(), il.end());
         }
 
+        /// \brief Insert list of elements in the archive with many threads
+        /// The elements already in the archive and the new elements are
+        ///     sorted into fronts at once. The threads sort shards of the
+        ///     elements, which we then merge, and build the containers
+        ///     of the fronts.
+        /// Sorting again also moves the elements already in the archive,
+        ///     so we only do it for batches at least as large as the
+        ///     archive. Smaller batches are inserted one at a time.
+        /// If all elements fit in the archive, the result is the same as
+        ///     inserting them one at a time. Otherwise, the sort stops
+        ///     once the fronts reach the capacity and the last front is
+        ///     pruned once with the pruning policy. With hypervolume or
+        ///     grid pruning, the result does not depend on the number of
+        ///     threads. Crowding pruning removes random elements when
+        ///     the excess is large. In any case, the last front might
+        ///     differ from sequential insertion, where pruning depends
+        ///     on the order of insertion.
+        /// Fronts using a polymorphic allocator share the archive memory
+        ///     pool, so their containers are built by a single thread.
+        /// \param first Iterator to first element
+        /// \param last Iterator to last element
+        /// \param number_of_threads Number of threads
+        /// \return Number of elements in the archive
+        template <class InputIterator>
+        size_t parallel_insert(
+            InputIterator first, InputIterator last,
+            size_t number_of_threads = std::thread::hardware_concurrency()) {
+            std::vector<value_type> batch(first, last);
+            if (batch.empty()) {
+                return size();
+            }
+            const bool sort_again = batch.size() >= size();
+            if (!sort_again) {
+                for (value_type &v : batch) {
+                    insert(std::move(v));
+                }
+                return size();
+            }
+            batch.reserve(batch.size() + size());
+            for (const value_type &v : *this) {
+                batch.emplace_back(v);
+            }
+            clear();
+            return insert_sorted(std::move(batch),
+                                 std::max(number_of_threads, size_t(1)));
+        }
+
         /// \brief Create element and emplace it in the front
         /// Emplace becomes insert because the rtree does not have
         /// an emplace function
@@ -2100,8 +2217,8 @@ namespace pareto {
         /// If new size is more than the number of elements
         /// we currently have, adjust the capacity.
         /// If we need to remove elements, to make them fit
-        /// in the new capacity by removing the most crowded
-        /// elements in the last front.
+        /// in the new capacity by removing elements from the
+        /// last front with the pruning policy.
         /// \param new_size
         void resize(size_t new_size) {
             size_t current_size = size();
@@ -2111,6 +2228,28 @@ namespace pareto {
             }
         }
 
+        /// \brief Set how the archive removes elements over its capacity
+        void set_pruning(archive_pruning policy) {
+            if (pruning_ == archive_pruning::hypervolume &&
+                policy != archive_pruning::hypervolume) {
+                for (const front_type &pf : fronts_) {
+                    unconst_reference(pf).untrack_hypervolume_contributions();
+                }
+            }
+            if (pruning_ == archive_pruning::grid &&
+                policy != archive_pruning::grid) {
+                for (const front_type &pf : fronts_) {
+                    unconst_reference(pf).untrack_grid_crowding();
+                }
+            }
+            pruning_ = policy;
+        }
+
+        /// \brief How the archive removes elements over its capacity
+        [[nodiscard]] archive_pruning pruning() const noexcept {
+            return pruning_;
+        }
+
       public /* Lookup / Multimap Concept */:
         /// \brief Returns the number of elements with key that compares
         /// equivalent to the specified argument.
@@ -2876,9 +3015,16 @@ namespace pareto {
                     excess -= fronts_.rbegin()->size();
                     size_ -= fronts_.rbegin()->size();
                     fronts_.erase(std::prev(fronts_.end()));
+                } else if (pruning_ == archive_pruning::hypervolume) {
+                    prune_least_contribution(excess);
+                    excess = 0;
+                } else if (pruning_ == archive_pruning::grid) {
+                    prune_grid(excess);
+                    excess = 0;
                 } else {
-                    double max_linecurrent_archive_time_pruning =
-                        2 * log2(static_cast<double>(capacity_));
+                    const auto max_linecurrent_archive_time_pruning =
+                        static_cast<size_t>(
+                            2 * log2(static_cast<double>(capacity_)));
                     if (excess > max_linecurrent_archive_time_pruning) {
                         prune_random(excess -
                                      max_linecurrent_archive_time_pruning);
@@ -2930,8 +3076,95 @@ namespace pareto {
                 candidates.end(), [](const auto &a, const auto &b) {
                     return a.second < b.second;
                 });
+            // copies of an element are candidates of their own, so we
+            // erase a single copy for each candidate
+            for (size_t i = 0; i < n_to_remove; ++i) {
+                last_front.erase(last_front.find(candidates[i].first));
+                --size_;
+            }
+        }
+
+        /// \brief Remove the elements with the least hypervolume
+        /// contribution from the last front
+        /// Only the last front keeps its contributions up to date, so
+        /// each removal only updates the contributions of the neighbours
+        /// of the element. The reference point is a little worse than
+        /// the nadir point of the last front, and we only replace it
+        /// when an element of the last front is not better than it.
+        void prune_least_contribution(size_t n_to_remove) {
+            for (auto it = fronts_.begin(); it != std::prev(fronts_.end());
+                 ++it) {
+                if (it->is_tracking_hypervolume_contributions()) {
+                    unconst_reference(*it).untrack_hypervolume_contributions();
+                }
+            }
+            front_type &last_front = unconst_reference(*fronts_.rbegin());
+            const point_type ideal_point = last_front.ideal();
+            const point_type nadir_point = last_front.nadir();
+            bool reference_is_valid =
+                last_front.is_tracking_hypervolume_contributions() &&
+                pruning_reference_.dimensions() == nadir_point.dimensions();
+            for (size_t i = 0; reference_is_valid && i < dimensions(); ++i) {
+                reference_is_valid = is_minimization(i)
+                                         ? nadir_point[i] < pruning_reference_[i]
+                                         : pruning_reference_[i] < nadir_point[i];
+            }
+            if (!reference_is_valid) {
+                pruning_reference_ = nadir_point;
+                // |nadir - ideal| / 10 without wrapping around for
+                // unsigned dimension types
+                using limits = std::numeric_limits<dimension_type>;
+                for (size_t i = 0; i < dimensions(); ++i) {
+                    dimension_type offset =
+                        nadir_point[i] < ideal_point[i]
+                            ? (ideal_point[i] - nadir_point[i]) / 10
+                            : (nadir_point[i] - ideal_point[i]) / 10;
+                    if (offset == dimension_type{0}) {
+                        offset = dimension_type{1};
+                    }
+                    if (is_minimization(i)) {
+                        pruning_reference_[i] =
+                            pruning_reference_[i] <= limits::max() - offset
+                                ? pruning_reference_[i] + offset
+                                : limits::max();
+                    } else {
+                        pruning_reference_[i] =
+                            limits::lowest() + offset <= pruning_reference_[i]
+                                ? pruning_reference_[i] - offset
+                                : limits::lowest();
+                    }
+                }
+                last_front.track_hypervolume_contributions(pruning_reference_);
+            }
             for (size_t i = 0; i < n_to_remove; ++i) {
-                size_ -= last_front.erase(candidates[i].first);
+                last_front.erase(last_front.least_contributor(pruning_reference_));
+                --size_;
+            }
+        }
+
+        /// \brief Remove elements from the most crowded cells of a grid
+        /// The grid divides the box around the last front in about
+        /// as many cells as the capacity of the archive. Only the last
+        /// front keeps its grid cells up to date, so we only place all
+        /// elements in cells again when the box around it changes.
+        void prune_grid(size_t n_to_remove) {
+            for (auto it = fronts_.begin(); it != std::prev(fronts_.end());
+                 ++it) {
+                if (it->is_tracking_grid_crowding()) {
+                    unconst_reference(*it).untrack_grid_crowding();
+                }
+            }
+            front_type &last_front = unconst_reference(*fronts_.rbegin());
+            const size_t m = dimensions();
+            const auto divisions = static_cast<size_t>(std::max(
+                2., std::ceil(std::pow(static_cast<double>(capacity_),
+                                       1. / std::max(m - 1, size_t{1})))));
+            if (last_front.grid_divisions() != divisions) {
+                last_front.track_grid_crowding(divisions);
+            }
+            for (size_t i = 0; i < n_to_remove && !last_front.empty(); ++i) {
+                last_front.erase(last_front.most_crowded_element());
+                --size_;
             }
         }
 
@@ -2941,6 +3174,249 @@ namespace pareto {
 
         void maybe_resize(std::vector<uint8_t> &v, size_t n) { v.resize(n); }
 
+        /// \brief Sort elements into fronts with the Efficient
+        /// Non-dominated Sort (ENS-BS)
+        /// We visit elements in lexicographic order, so no element can
+        /// be dominated by an element visited later. Each element goes to
+        /// the first front with no element dominating it, which we find
+        /// with a binary search because dominance is transitive. In two
+        /// dimensions, the last element of a front is the only one we
+        /// need to check. In three dimensions, each front keeps the
+        /// staircase of the last two coordinates of its elements in a map.
+        /// \param v Elements to sort
+        /// \param max_size Stop once the fronts have this many elements
+        /// \param number_of_threads Threads sorting the elements
+        /// \return Indexes of the elements in each front
+        std::vector<std::vector<size_t>>
+        non_dominated_sort(const std::vector<value_type> &v, size_t max_size,
+                           size_t number_of_threads = 1) const {
+            const std::vector<size_t> idx =
+                lexicographic_order(v, number_of_threads);
+            const size_t m = dimensions();
+
+            // Compare chunks of coordinates with the direction mask when
+            // the dimensions are known at compile time
+            const typename front_type::direction_mask_type directions(
+                is_minimization_);
+            auto dominates = [&](const point_type &a, const point_type &b) {
+                if constexpr (number_of_compile_dimensions != 0) {
+                    return a.dominates(b, directions);
+                } else {
+                    return a.dominates(b, is_minimization_);
+                }
+            };
+
+            auto better_1 = [&](const dimension_type &a,
+                                const dimension_type &b) {
+                return is_minimization_[1] ? a < b : a > b;
+            };
+            auto better_2 = [&](const dimension_type &a,
+                                const dimension_type &b) {
+                return is_minimization_[2] ? a < b : a > b;
+            };
+            // Steps get worse in dimension 1 and better in dimension 2
+            using staircase_type =
+                std::map<dimension_type, dimension_type, decltype(better_1)>;
+            std::vector<staircase_type> staircases;
+
+            std::vector<std::vector<size_t>> r;
+            auto front_dominates = [&](size_t k, const point_type &p) {
+                if (m == 2) {
+                    return dominates(v[r[k].back()].first, p);
+                }
+                if (m == 3) {
+                    // the best step in dimension 2 that is not worse than
+                    // p in dimension 1
+                    auto it = staircases[k].upper_bound(p[1]);
+                    return it != staircases[k].begin() &&
+                           !better_2(p[2], std::prev(it)->second);
+                }
+                // Elements visited last are the most likely to dominate p
+                return std::any_of(r[k].rbegin(), r[k].rend(), [&](size_t j) {
+                    return dominates(v[j].first, p);
+                });
+            };
+
+            constexpr size_t no_front = std::numeric_limits<size_t>::max();
+            const point_type *previous = nullptr;
+            size_t previous_front = no_front;
+            size_t n = 0;
+            for (size_t i : idx) {
+                const point_type &p = v[i].first;
+                // copies of an element are next to each other and go
+                // to the same front
+                if (previous != nullptr && p == *previous) {
+                    if (previous_front != no_front) {
+                        r[previous_front].emplace_back(i);
+                        ++n;
+                    }
+                    continue;
+                }
+                previous = &p;
+                size_t lo = 0;
+                size_t hi = r.size();
+                while (lo < hi) {
+                    const size_t mid = lo + (hi - lo) / 2;
+                    if (front_dominates(mid, p)) {
+                        lo = mid + 1;
+                    } else {
+                        hi = mid;
+                    }
+                }
+                if (lo == r.size()) {
+                    // Fronts after the capacity would only be pruned
+                    if (n >= max_size) {
+                        previous_front = no_front;
+                        continue;
+                    }
+                    r.emplace_back();
+                    if (m == 3) {
+                        staircases.emplace_back(better_1);
+                    }
+                }
+                r[lo].emplace_back(i);
+                previous_front = lo;
+                ++n;
+                if (m == 3) {
+                    staircase_type &staircase = staircases[lo];
+                    auto first = staircase.lower_bound(p[1]);
+                    auto last = first;
+                    while (last != staircase.end() &&
+                           !better_2(last->second, p[2])) {
+                        ++last;
+                    }
+                    staircase.erase(first, last);
+                    staircase.emplace(p[1], p[2]);
+                }
+            }
+            return r;
+        }
+
+        /// \brief Indexes of the elements in lexicographic order
+        /// The order follows the direction of each dimension, so no
+        /// element can be dominated by an element after it. Each thread
+        /// sorts one shard of the indexes and we merge the shards in
+        /// pairs.
+        std::vector<size_t>
+        lexicographic_order(const std::vector<value_type> &v,
+                            size_t number_of_threads) const {
+            std::vector<size_t> idx(v.size());
+            for (size_t i = 0; i < idx.size(); ++i) {
+                idx[i] = i;
+            }
+            const size_t m = dimensions();
+            auto less = [&](size_t a, size_t b) {
+                const point_type &pa = v[a].first;
+                const point_type &pb = v[b].first;
+                for (size_t i = 0; i < m; ++i) {
+                    if (pa[i] != pb[i]) {
+                        return is_minimization_[i] ? pa[i] < pb[i]
+                                                   : pa[i] > pb[i];
+                    }
+                }
+                // copies keep their order in v, so the fronts and
+                // their pruning do not depend on the number of threads
+                return a < b;
+            };
+            // Small shards are not worth a thread
+            constexpr size_t min_shard_size = 1024;
+            const size_t shards =
+                std::min(number_of_threads,
+                         std::max(idx.size() / min_shard_size, size_t(1)));
+            if (shards == 1) {
+                std::sort(idx.begin(), idx.end(), less);
+                return idx;
+            }
+            std::vector<size_t> bounds(shards + 1);
+            for (size_t i = 0; i <= shards; ++i) {
+                bounds[i] = idx.size() * i / shards;
+            }
+            auto at = [&](size_t i) {
+                return idx.begin() + static_cast<std::ptrdiff_t>(bounds[i]);
+            };
+            std::vector<std::thread> threads;
+            for (size_t i = 0; i < shards; ++i) {
+                threads.emplace_back(
+                    [&, i]() { std::sort(at(i), at(i + 1), less); });
+            }
+            for (auto &thread : threads) {
+                thread.join();
+            }
+            for (size_t width = 1; width < shards; width *= 2) {
+                threads.clear();
+                for (size_t i = 0; i + width < shards; i += 2 * width) {
+                    const size_t j = std::min(i + 2 * width, shards);
+                    threads.emplace_back([&, i, j, width]() {
+                        std::inplace_merge(at(i), at(i + width), at(j), less);
+                    });
+                }
+                for (auto &thread : threads) {
+                    thread.join();
+                }
+            }
+            return idx;
+        }
+
+        /// \brief Insert a batch of elements in an empty archive
+        /// We assign each element to its front up front and build
+        /// each front in one shot.
+        /// \return Number of elements from the batch in the archive
+        size_t insert_sorted(std::vector<value_type> &&batch,
+                             size_t number_of_threads = 1) {
+            if (batch.empty()) {
+                return 0;
+            }
+            maybe_adjust_dimensions(batch.front());
+            const auto ranks =
+                non_dominated_sort(batch, capacity(), number_of_threads);
+            std::vector<front_type> fronts;
+            fronts.reserve(ranks.size());
+            for (size_t k = 0; k < ranks.size(); ++k) {
+                fronts.emplace_back(front_type({}, is_minimization_.begin(),
+                                               is_minimization_.end(), comp_,
+                                               alloc_));
+            }
+            auto build_front = [&](size_t k) {
+                std::vector<value_type> elements;
+                elements.reserve(ranks[k].size());
+                for (size_t i : ranks[k]) {
+                    elements.emplace_back(std::move(batch[i]));
+                }
+                // Elements in the same rank do not dominate each other
+                fronts[k].data_.insert(elements.begin(), elements.end());
+                fronts[k].update_all_extremes();
+            };
+            // Fronts with a polymorphic allocator share our memory pool
+            if (number_of_threads > 1 && fronts.size() > 1 &&
+                !is_polymorphic_allocator<allocator_type>::value) {
+                std::vector<std::thread> threads;
+                const size_t n = std::min(number_of_threads, fronts.size());
+                for (size_t t = 0; t < n; ++t) {
+                    threads.emplace_back([&, t]() {
+                        for (size_t k = t; k < fronts.size(); k += n) {
+                            build_front(k);
+                        }
+                    });
+                }
+                for (auto &thread : threads) {
+                    thread.join();
+                }
+            } else {
+                for (size_t k = 0; k < fronts.size(); ++k) {
+                    build_front(k);
+                }
+            }
+            const size_t size_before = size();
+            for (front_type &pf : fronts) {
+                size_ += pf.size();
+                fronts_.emplace_hint(fronts_.end(), std::move(pf));
+            }
+            if (size() > capacity()) {
+                resize(capacity());
+            }
+            return size() - size_before;
+        }
+
         /// \brief If the dimension is being set at runtime, this sets the
         /// dimension in case we don't already know it.
         inline void maybe_adjust_dimensions(const value_type &v) {
@@ -3070,6 +3546,12 @@ namespace pareto {
 
         /// \brief Key comparison (single dimension)
         dimension_compare comp_{std::less<dimension_type>()};
+
+        /// \brief How we remove elements over the capacity
+        archive_pruning pruning_{archive_pruning::crowding};
+
+        /// \brief Reference point for the hypervolume contributions
+        point_type pruning_reference_;
     };
 
     /// \brief Relational operator < for archives and archives
@@ -0,0 +1,1267 @@
+#ifndef PARETO_COLUMNAR_TREE_H
+#define PARETO_COLUMNAR_TREE_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include <pareto/common/column_scan.h>
+#include <pareto/common/default_allocator.h>
+#include <pareto/point.h>
+#include <pareto/query/predicates.h>
+#include <pareto/query/query_box.h>
+
+namespace pareto {
+
+    /// \brief Columnar variant of the implicit tree
+    /// Like implicit_tree, this container keeps the elements in a vector in
+    /// insertion order and answers every query with a linear scan. The
+    /// difference is that the keys are also stored in columns: the values
+    /// of each dimension are contiguous in memory.
+    ///
+    /// Queries scan the columns in blocks of 64 elements. A block is
+    /// summarized by a 64-bit mask of the elements that pass the box
+    /// predicates, which we compute one column at a time with SSE2/AVX
+    /// comparisons. The iterators walk the set bits of these masks, so
+    /// each block is tested once and no function is called per element.
+    /// Nearest queries compute the distances to a block of elements at a
+    /// time in the same way.
+    ///
+    /// Linear scans are the fastest option for small fronts, and the
+    /// columns keep them competitive with the trees for larger fronts.
+    /// Insertions are appends and never reorganize the container.
+    ///
+    /// This container type implements the following concepts
+    /// Container: https://en.cppreference.com/w/cpp/named_req/Container
+    /// ReversibleContainer:
+    /// https://en.cppreference.com/w/cpp/named_req/Container
+    /// AssociativeContainer:
+    /// https://en.cppreference.com/w/cpp/named_req/AssociativeContainer
+    ///
+    /// \tparam K Number/key type
+    /// \tparam M Number of dimensions
+    /// \tparam E Element/mapped type
+    /// \tparam C Comparison function type in one dimension
+    /// \tparam A Allocator type
+    template <class K, size_t M, class T, typename C = std::less<K>,
+              class A = default_allocator_type<std::pair<const point<K, M>, T>>>
+    class columnar_tree {
+      private /* Internal types */:
+        using unprotected_point_type = point<K, M>;
+        using protected_point_type = const point<K, M>;
+        using unprotected_mapped_type = T;
+        using unprotected_key_type = unprotected_point_type;
+        using protected_key_type = protected_point_type;
+        using unprotected_value_type =
+            std::pair<unprotected_key_type, unprotected_mapped_type>;
+        using protected_value_type =
+            std::pair<protected_key_type, unprotected_mapped_type>;
+        using unprotected_allocator_type = typename std::allocator_traits<
+            A>::template rebind_alloc<unprotected_value_type>;
+        using unprotected_vector_type =
+            std::vector<unprotected_value_type, unprotected_allocator_type>;
+        using column_allocator_type =
+            typename std::allocator_traits<A>::template rebind_alloc<K>;
+        using column_vector_type = std::vector<K, column_allocator_type>;
+        using point_type = unprotected_point_type;
+
+      public /* Forward declarations */:
+        template <bool is_const> class iterator_impl;
+
+      public /* Container Concept */:
+        using value_type = protected_value_type;
+        using reference = value_type &;
+        using const_reference = value_type const &;
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+        using pointer = value_type *;
+        using const_pointer = const value_type *;
+        using difference_type =
+            typename unprotected_vector_type::difference_type;
+        using size_type = typename unprotected_vector_type::size_type;
+
+      public /* ReversibleContainer Concept */:
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      public /* AssociativeContainer Concept */:
+        using key_type = unprotected_point_type;
+        using mapped_type = T;
+        using key_compare =
+            std::function<bool(const key_type &, const key_type &)>;
+        using value_compare =
+            std::function<bool(const value_type &, const value_type &)>;
+
+      public /* AllocatorAwareContainer Concept */:
+        using allocator_type = A;
+
+      public /* SpatialContainer Concept */:
+        static constexpr size_t number_of_compile_dimensions = M;
+        using dimension_type = K;
+        using dimension_compare = C;
+        using box_type =
+            query_box<dimension_type, number_of_compile_dimensions>;
+        using predicate_list_type =
+            predicate_list<dimension_type, number_of_compile_dimensions, T>;
+
+      private /* Internal types */:
+        using nearest_type =
+            nearest<dimension_type, number_of_compile_dimensions>;
+        using distance_type = typename point_type::distance_type;
+
+        /// \brief Index that represents no element
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        /// \brief Number of elements in a block of the scan
+        static constexpr size_t block_size = detail::scan_block_size;
+
+      public /* Iterators */:
+        /// \brief Columnar tree iterator
+        /// The iterator is an index in the vector. Iterators with predicates
+        /// also keep the mask of the elements after the index in the current
+        /// block that pass the predicates, so that moving forward only scans
+        /// the columns again when the block is over.
+        ///
+        /// Nearest queries find the k nearest elements when the iterator is
+        /// created and iterate them from the closest to the farthest.
+        template <bool is_const> class iterator_impl {
+          private /* Internal Types */:
+            template <class TYPE, class CONST_TYPE>
+            using const_toggle =
+                std::conditional_t<!is_const, TYPE, CONST_TYPE>;
+
+            using tree_pointer =
+                const_toggle<columnar_tree *, const columnar_tree *>;
+
+          public /* LegacyIterator Types */:
+            using value_type = const_toggle<columnar_tree::value_type,
+                                            const columnar_tree::value_type>;
+            using reference = const_toggle<columnar_tree::reference,
+                                           columnar_tree::const_reference>;
+            using difference_type = columnar_tree::difference_type;
+            using pointer = const_toggle<columnar_tree::pointer,
+                                         columnar_tree::const_pointer>;
+            using iterator_category = std::bidirectional_iterator_tag;
+
+          public /* LegacyForwardIterator Constructors */:
+            /// \brief Default constructor
+            iterator_impl() = default;
+
+          public /* ContainerConcept Constructors */:
+            /// \brief Copy constructor
+            /// const_iterator can be constructed from const_iterator and
+            /// iterator, but iterator cannot be constructed from
+            /// const_iterator.
+            template <bool rhs_is_const,
+                      class = std::enable_if_t<is_const && !rhs_is_const>>
+            // NOLINTNEXTLINE(google-explicit-constructor)
+            iterator_impl(const iterator_impl<rhs_is_const> &rhs)
+                : tree_(rhs.tree_), index_(rhs.index_),
+                  predicates_(rhs.predicates_), block_mask_(rhs.block_mask_),
+                  is_nearest_(rhs.is_nearest_), nearest_set_(rhs.nearest_set_),
+                  nearest_position_(rhs.nearest_position_) {}
+
+          public /* Internal Constructors / Used by Container */:
+            /// \brief Iterator to an element of the vector
+            iterator_impl(tree_pointer tree, size_t index)
+                : tree_(tree), index_(index) {}
+
+            /// \brief Iterator to the first element that passes the
+            /// predicates
+            iterator_impl(tree_pointer tree,
+                          const predicate_list_type &predicates)
+                : tree_(tree), index_(tree->size()), predicates_(predicates) {
+                if (predicates_.contains_nearest()) {
+                    is_nearest_ = true;
+                    nearest_set_ =
+                        tree_->nearest_indices(*predicates_.get_nearest());
+                    nearest_position_ = 0;
+                    advance_nearest();
+                } else {
+                    index_ = tree_->next_match(0, predicates_, block_mask_);
+                }
+            }
+
+          public /* LegacyIterator */:
+            /// \brief Dereference iterator
+            reference operator*() const { return tree_->value_at(index_); }
+
+            /// \brief Advance iterator
+            iterator_impl &operator++() {
+                if (is_nearest_) {
+                    ++nearest_position_;
+                    advance_nearest();
+                } else if (predicates_.size() == 0) {
+                    ++index_;
+                } else if (block_mask_ != 0) {
+                    index_ = block_begin(index_) +
+                             detail::lowest_bit(block_mask_);
+                    block_mask_ &= block_mask_ - 1;
+                } else {
+                    index_ = tree_->next_match(block_begin(index_) + block_size,
+                                               predicates_, block_mask_);
+                }
+                return *this;
+            }
+
+          public /* LegacyInputIterator */:
+            pointer operator->() const { return &tree_->value_at(index_); }
+
+          public /* LegacyForwardIterator */:
+            /// \brief Equality operator
+            template <bool rhs_is_const>
+            bool operator==(const iterator_impl<rhs_is_const> &rhs) const {
+                return index_ == rhs.index_;
+            }
+
+            /// \brief Inequality operator
+            template <bool rhs_is_const>
+            bool operator!=(const iterator_impl<rhs_is_const> &rhs) const {
+                return !(this->operator==(rhs));
+            }
+
+            /// \brief Advance iterator
+            iterator_impl operator++(int) { // NOLINT(cert-dcl21-cpp):
+                auto tmp = *this;
+                operator++();
+                return tmp;
+            }
+
+          public /* LegacyBidirectionalIterator */:
+            /// \brief Decrement iterator
+            iterator_impl &operator--() {
+                if (is_nearest_) {
+                    rewind_nearest();
+                } else if (predicates_.size() == 0) {
+                    --index_;
+                } else {
+                    const size_t previous =
+                        tree_->previous_match(index_, predicates_, block_mask_);
+                    assert(previous != npos);
+                    index_ = previous;
+                }
+                return *this;
+            }
+
+            /// \brief Decrement iterator
+            iterator_impl operator--(int) { // NOLINT(cert-dcl21-cpp)
+                auto tmp = *this;
+                operator--();
+                return tmp;
+            }
+
+          private /* Internal Functions */:
+            /// \brief First position of the block of an element
+            static size_t block_begin(size_t index) {
+                return index - index % block_size;
+            }
+
+            /// \brief Move to the next nearest element that passes the
+            /// other predicates
+            void advance_nearest() {
+                while (nearest_position_ < nearest_set_.size() &&
+                       !tree_->passes(nearest_set_[nearest_position_],
+                                      predicates_)) {
+                    ++nearest_position_;
+                }
+                index_ = nearest_position_ < nearest_set_.size()
+                             ? nearest_set_[nearest_position_]
+                             : tree_->size();
+            }
+
+            /// \brief Move to the previous nearest element that passes the
+            /// other predicates
+            void rewind_nearest() {
+                do {
+                    assert(nearest_position_ > 0);
+                    --nearest_position_;
+                } while (nearest_position_ > 0 &&
+                         !tree_->passes(nearest_set_[nearest_position_],
+                                        predicates_));
+                index_ = nearest_set_[nearest_position_];
+            }
+
+          private:
+            /// \brief Tree we are iterating
+            tree_pointer tree_{nullptr};
+
+            /// \brief Index of the current element in the vector
+            size_t index_{0};
+
+            /// \brief Predicates the elements need to pass
+            predicate_list_type predicates_;
+
+            /// \brief Elements after the current element in its block that
+            /// pass the predicates
+            uint64_t block_mask_{0};
+
+            /// \brief Whether we are iterating the k nearest elements
+            bool is_nearest_{false};
+
+            /// \brief Indexes of the nearest elements by distance
+            std::vector<size_t> nearest_set_;
+
+            /// \brief Position of the current element in nearest_set_
+            size_t nearest_position_{0};
+
+          public:
+            /// Let the tree access the spatial private constructors
+            friend columnar_tree;
+
+            /// Let iterators and const iterators access each other
+            template <bool> friend class iterator_impl;
+        };
+
+      public /* Constructors: Container + AllocatorAwareContainer */:
+        /// \brief Create an empty container
+        explicit columnar_tree(const allocator_type &alloc = allocator_type())
+            : data_(unprotected_allocator_type(alloc)),
+              columns_(column_allocator_type(alloc)),
+              comp_(dimension_compare()) {}
+
+        /// \brief Copy constructor
+        columnar_tree(const columnar_tree &rhs)
+            : data_(rhs.data_), columns_(rhs.columns_), stride_(rhs.stride_),
+              comp_(rhs.comp_) {}
+
+        /// \brief Copy constructor data but use another allocator
+        columnar_tree(const columnar_tree &rhs, const allocator_type &alloc)
+            : data_(rhs.data_, unprotected_allocator_type(alloc)),
+              columns_(rhs.columns_, column_allocator_type(alloc)),
+              stride_(rhs.stride_), comp_(rhs.comp_) {}
+
+        /// \brief Move constructor
+        columnar_tree(columnar_tree &&rhs) noexcept
+            : data_(std::move(rhs.data_)), columns_(std::move(rhs.columns_)),
+              stride_(rhs.stride_), comp_(std::move(rhs.comp_)) {
+            rhs.stride_ = 0;
+        }
+
+        /// \brief Move constructor data but use new allocator
+        columnar_tree(columnar_tree &&rhs, const allocator_type &alloc) noexcept
+            : data_(std::move(rhs.data_), unprotected_allocator_type(alloc)),
+              columns_(std::move(rhs.columns_), column_allocator_type(alloc)),
+              stride_(rhs.stride_), comp_(std::move(rhs.comp_)) {
+            rhs.stride_ = 0;
+        }
+
+        /// \brief Destructor
+        ~columnar_tree() = default;
+
+      public /* Constructors: AssociativeContainer + AllocatorAwareContainer */:
+        /// \brief Create container with custom comparison function
+        explicit columnar_tree(const C &comp,
+                               const allocator_type &alloc = allocator_type())
+            : data_(unprotected_allocator_type(alloc)),
+              columns_(column_allocator_type(alloc)), comp_(comp) {}
+
+        /// \brief Construct with iterators + comparison
+        template <class InputIt>
+        columnar_tree(InputIt first, InputIt last, const C &comp = C(),
+                      const allocator_type &alloc = allocator_type())
+            : columnar_tree(comp, alloc) {
+            insert(first, last);
+        }
+
+        /// \brief Construct with list + comparison
+        columnar_tree(std::initializer_list<value_type> il, const C &comp = C(),
+                      const allocator_type &alloc = allocator_type())
+            : columnar_tree(il.begin(), il.end(), comp, alloc) {}
+
+        /// \brief Construct with iterators
+        template <class InputIt>
+        columnar_tree(InputIt first, InputIt last, const allocator_type &alloc)
+            : columnar_tree(first, last, C(), alloc) {}
+
+        /// \brief Construct with list
+        columnar_tree(std::initializer_list<value_type> il,
+                      const allocator_type &alloc)
+            : columnar_tree(il.begin(), il.end(), C(), alloc) {}
+
+      public /* Assignment: Container + AllocatorAwareContainer */:
+        /// \brief Copy assignment
+        columnar_tree &operator=(const columnar_tree &rhs) {
+            if (&rhs == this) {
+                return *this;
+            }
+            data_.clear();
+            data_.insert(data_.end(), rhs.data_.begin(), rhs.data_.end());
+            columns_.clear();
+            columns_.insert(columns_.end(), rhs.columns_.begin(),
+                            rhs.columns_.end());
+            stride_ = rhs.stride_;
+            comp_ = rhs.comp_;
+            return *this;
+        }
+
+        /// \brief Move assignment
+        columnar_tree &operator=(columnar_tree &&rhs) noexcept {
+            if (&rhs == this) {
+                return *this;
+            }
+            data_ = std::move(rhs.data_);
+            columns_ = std::move(rhs.columns_);
+            stride_ = rhs.stride_;
+            rhs.stride_ = 0;
+            comp_ = std::move(rhs.comp_);
+            return *this;
+        }
+
+      public /* Assignment: AssociativeContainer */:
+        /// \brief Initializer list assignment
+        columnar_tree &operator=(std::initializer_list<value_type> il) {
+            clear();
+            insert(il.begin(), il.end());
+            return *this;
+        }
+
+      public /* Non-Modifying Functions: AllocatorAwareContainer */:
+        /// \brief Obtains a copy of the allocator
+        allocator_type get_allocator() const noexcept {
+            return allocator_type(data_.get_allocator());
+        }
+
+      public /* Element Access / Map Concept */:
+        /// \brief Get reference to element at a given position, and throw error
+        /// if it does not exist
+        mapped_type &at(const key_type &k) {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                throw std::out_of_range("columnar_tree::at: key not found");
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and throw error
+        /// if it does not exist
+        const mapped_type &at(const key_type &k) const {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                throw std::out_of_range("columnar_tree::at: key not found");
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and create one
+        /// if it does not exits
+        mapped_type &operator[](const key_type &k) {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                auto it_new = insert(std::make_pair(k, mapped_type()));
+                return it_new->second;
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and create one
+        /// if it does not exits
+        mapped_type &operator[](key_type &&k) {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                auto it_new = insert(std::make_pair(std::move(k), mapped_type()));
+                return it_new->second;
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and create one
+        /// if it does not exits
+        template <typename... Targs>
+        mapped_type &operator()(const dimension_type &x1, const Targs &...xs) {
+            constexpr size_t m = sizeof...(Targs) + 1;
+            assert(number_of_compile_dimensions == 0 ||
+                   number_of_compile_dimensions == m);
+            point_type p(m);
+            copy_pack(p.begin(), x1, xs...);
+            return operator[](p);
+        }
+
+      public /* Non-Modifying Functions: Container Concept */:
+        /// \brief Get iterator to first element
+        const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+        /// \brief Get iterator to past-the-end element
+        const_iterator end() const noexcept {
+            return const_iterator(this, data_.size());
+        }
+
+        /// \brief Get iterator to first element
+        iterator begin() noexcept { return iterator(this, 0); }
+
+        /// \brief Get iterator to past-the-end element
+        iterator end() noexcept { return iterator(this, data_.size()); }
+
+        /// \brief Get iterator to first element
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        /// \brief Get iterator to past-the-end element
+        const_iterator cend() const noexcept { return end(); }
+
+      public /* Non-Modifying Functions: ReversibleContainer Concept */:
+        /// \brief Get iterator to first element in reverse
+        const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        }
+
+        /// \brief Get iterator to last element in reverse
+        const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        /// \brief Get iterator to first element in reverse
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        /// \brief Get iterator to last element in reverse
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        /// \brief Get iterator to first element in reverse
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        /// \brief Get iterator to past-the-end element in reverse
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+      public /* Non-Modifying Functions / Capacity / Container Concept */:
+        /// \brief True if container is empty
+        [[nodiscard]] bool empty() const noexcept { return data_.empty(); }
+
+        /// \brief Get container size
+        [[nodiscard]] size_t size() const noexcept { return data_.size(); }
+
+        /// \brief Get container max size
+        [[nodiscard]] size_t max_size() const noexcept {
+            return data_.max_size();
+        }
+
+      public /* Non-Modifying Functions / Capacity / Spatial Concept */:
+        /// \brief Get container dimensions
+        [[nodiscard]] size_t dimensions() const noexcept {
+            if constexpr (M != 0) {
+                return M;
+            } else {
+                return data_.empty() ? 0 : data_.front().first.dimensions();
+            }
+        }
+
+        /// \brief Get maximum value in a given dimension
+        dimension_type max_value(size_t dimension) const {
+            auto it = max_element(dimension);
+            return it != end() ? it->first[dimension]
+                               : std::numeric_limits<dimension_type>::max();
+        }
+
+        /// \brief Get minimum value in a given dimension
+        dimension_type min_value(size_t dimension) const {
+            auto it = min_element(dimension);
+            return it != end() ? it->first[dimension]
+                               : std::numeric_limits<dimension_type>::min();
+        }
+
+      public /* Modifying Functions: Container + AllocatorAwareContainer */:
+        /// \brief Swap the content of two objects
+        void swap(columnar_tree &other) noexcept {
+            data_.swap(other.data_);
+            columns_.swap(other.columns_);
+            std::swap(stride_, other.stride_);
+            std::swap(comp_, other.comp_);
+        }
+
+      public /* Modifiers: Multimap Concept */:
+        /// \brief Clear the container
+        void clear() noexcept {
+            data_.clear();
+            columns_.clear();
+            stride_ = 0;
+        }
+
+        /// \brief Insert element pair
+        iterator insert(const value_type &v) { return insert(value_type(v)); }
+
+        /// \brief Insert element pair
+        /// The element is appended to the vector and to the columns
+        iterator insert(value_type &&v) {
+            append_to_columns(v.first);
+            data_.emplace_back(std::move(v));
+            return iterator(this, data_.size() - 1);
+        }
+
+        /// \brief Insert element pair
+        template <class P> iterator insert(P &&v) {
+            static_assert(std::is_constructible_v<value_type, P &&>);
+            return emplace(std::forward<P>(v));
+        }
+
+        /// \brief Insert element with a hint
+        iterator insert(const_iterator, const value_type &v) {
+            return insert(v);
+        }
+
+        /// \brief Insert element with a hint
+        iterator insert(const_iterator, value_type &&v) {
+            return insert(std::move(v));
+        }
+
+        /// \brief Insert element with a hint
+        template <class P> iterator insert(const_iterator hint, P &&v) {
+            static_assert(std::is_constructible_v<value_type, P &&>);
+            return emplace_hint(hint, std::forward<P>(v));
+        }
+
+        /// \brief Insert list of elements
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            for (; first != last; ++first) {
+                append_to_columns(first->first);
+                data_.emplace_back(first->first, first->second);
+            }
+        }
+
+        /// \brief Insert list of elements
+        void insert(std::initializer_list<value_type> init) {
+            insert(init.begin(), init.end());
+        }
+
+        /// \brief Emplace element
+        template <class... Args> iterator emplace(Args &&...args) {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+
+        /// \brief Emplace element with a hint
+        template <class... Args>
+        iterator emplace_hint(const_iterator, Args &&...args) {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+
+        /// \brief Erase element
+        /// \return Iterator to the element that was after the erased element
+        iterator erase(const_iterator position) {
+            const size_t index = position.index_;
+            if (index >= data_.size()) {
+                return end();
+            }
+            const size_t n = data_.size();
+            for (size_t d = 0; d < column_dimensions(); ++d) {
+                K *column = columns_.data() + d * stride_;
+                std::copy(column + index + 1, column + n, column + index);
+            }
+            data_.erase(data_.begin() + index);
+            return iterator(this, index);
+        }
+
+        /// \brief Erase element
+        iterator erase(iterator position) {
+            return erase(const_iterator(position));
+        }
+
+        /// \brief Remove range of iterators from the container
+        /// Iterators are positions in the vector, so we can mark the
+        /// positions in the range and remove them all in one pass.
+        iterator erase(const_iterator first, const_iterator last) {
+            std::vector<bool> erased(data_.size(), false);
+            size_t last_erased = npos;
+            for (; first != last; ++first) {
+                erased[first.index_] = true;
+                last_erased = last_erased == npos
+                                  ? first.index_
+                                  : std::max(last_erased, first.index_);
+            }
+            if (last_erased == npos) {
+                return iterator(this, last.index_);
+            }
+            return iterator(this, compact(erased, last_erased));
+        }
+
+        /// \brief Erase elements with given key
+        size_type erase(const key_type &k) {
+            // k might be a reference to the element we are about to delete
+            const key_type k_copy(k);
+            std::vector<bool> erased(data_.size(), false);
+            size_type s = 0;
+            size_t last_erased = npos;
+            for_each_equal(k_copy, [&](size_t i) {
+                erased[i] = true;
+                last_erased = i;
+                ++s;
+                return true;
+            });
+            if (s != 0) {
+                compact(erased, last_erased);
+            }
+            return s;
+        }
+
+        /// \brief Splices nodes from another container
+        void merge(columnar_tree &source) noexcept {
+            insert(source.begin(), source.end());
+        }
+
+        /// \brief Splices nodes from another container
+        void merge(columnar_tree &&source) noexcept {
+            insert(source.begin(), source.end());
+        }
+
+      public /* Lookup / Multimap Concept */:
+        /// \brief Returns the number of elements with key that compares
+        /// equivalent to the specified argument.
+        size_type count(const key_type &k) const {
+            size_type s = 0;
+            for_each_equal(k, [&s](size_t) {
+                ++s;
+                return true;
+            });
+            return s;
+        }
+
+        /// \brief Returns the number of elements with key that compares
+        /// equivalent to the specified argument.
+        template <class L> size_type count(const L &k) const {
+            return count(key_type(k));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        iterator find(const key_type &k) { return iterator(this, find_index(k)); }
+
+        /// \brief Finds an element with key equivalent to key
+        const_iterator find(const key_type &k) const {
+            return const_iterator(this, find_index(k));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> iterator find(const L &x) {
+            return find(key_type(x));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> const_iterator find(const L &x) const {
+            return find(key_type(x));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        bool contains(const key_type &k) const { return find(k) != end(); }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> bool contains(const L &x) const {
+            return find(x) != end();
+        }
+
+      public /* Modifiers: Lookup / Spatial Concept */:
+        /// \brief Get iterator to first element that passes the list of
+        /// predicates
+        const_iterator find(const predicate_list_type &ps) const noexcept {
+            return const_iterator(this, ps);
+        }
+
+        /// \brief Get iterator to first element that passes the list of
+        /// predicates
+        iterator find(const predicate_list_type &ps) noexcept {
+            return iterator(this, ps);
+        }
+
+        /// \brief Find intersection between points and query box
+        iterator find_intersection(const point_type &k) {
+            return find_intersection(k, k);
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator find_intersection(const point_type &k) const {
+            return find_intersection(k, k);
+        }
+
+        /// \brief Find intersection between points and query box
+        iterator find_intersection(const point_type &lb, const point_type &ub) {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return iterator(this, {intersects(lb_, ub_)});
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator find_intersection(const point_type &lb,
+                                         const point_type &ub) const {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return const_iterator(this, {intersects(lb_, ub_)});
+        }
+
+        /// \brief Find intersection between points and query box
+        iterator find_intersection(const point_type &lb, const point_type &ub,
+                                   std::function<bool(const value_type &)> fn) {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return iterator(
+                this, {intersects(lb_, ub_),
+                       satisfies<dimension_type, number_of_compile_dimensions,
+                                 mapped_type>(fn)});
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator
+        find_intersection(const point_type &lb, const point_type &ub,
+                          std::function<bool(const value_type &)> fn) const {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return const_iterator(
+                this, {intersects(lb_, ub_),
+                       satisfies<dimension_type, number_of_compile_dimensions,
+                                 mapped_type>(fn)});
+        }
+
+        /// \brief Find points within a query box
+        iterator find_within(const point_type &lb, const point_type &ub) {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return iterator(this, {within(lb_, ub_)});
+        }
+
+        /// \brief Find points within a query box
+        const_iterator find_within(const point_type &lb,
+                                   const point_type &ub) const {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return const_iterator(this, {within(lb_, ub_)});
+        }
+
+        /// \brief Find points outside a query box
+        iterator find_disjoint(const point_type &lb, const point_type &ub) {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return iterator(this, {disjoint(lb_, ub_)});
+        }
+
+        /// \brief Find points outside a query box
+        const_iterator find_disjoint(const point_type &lb,
+                                     const point_type &ub) const {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return const_iterator(this, {disjoint(lb_, ub_)});
+        }
+
+        /// \brief Find points closest to a reference point
+        iterator find_nearest(const point_type &p) {
+            return iterator(this, {nearest(p)});
+        }
+
+        /// \brief Find points closest to a reference point
+        const_iterator find_nearest(const point_type &p) const {
+            return const_iterator(this, {nearest(p)});
+        }
+
+        /// \brief Find points closest to a reference point
+        iterator find_nearest(const point_type &p, size_t k) {
+            return iterator(this, {nearest(p, k)});
+        }
+
+        /// \brief Find points closest to a reference point
+        const_iterator find_nearest(const point_type &p, size_t k) const {
+            return const_iterator(this, {nearest(p, k)});
+        }
+
+        /// \brief Find points closest to a reference box
+        iterator find_nearest(const box_type &b, size_t k) {
+            return iterator(this, {nearest(b, k)});
+        }
+
+        /// \brief Find points closest to a reference box
+        const_iterator find_nearest(const box_type &b, size_t k) const {
+            return const_iterator(this, {nearest(b, k)});
+        }
+
+        /// \brief Find points closest to a reference point
+        iterator find_nearest(const point_type &p, size_t k,
+                              std::function<bool(const value_type &)> fn) {
+            return iterator(
+                this, {nearest(p, k),
+                       satisfies<dimension_type, number_of_compile_dimensions,
+                                 mapped_type>(fn)});
+        }
+
+        /// \brief Find points closest to a reference point
+        const_iterator
+        find_nearest(const point_type &p, size_t k,
+                     std::function<bool(const value_type &)> fn) const {
+            return const_iterator(
+                this, {nearest(p, k),
+                       satisfies<dimension_type, number_of_compile_dimensions,
+                                 mapped_type>(fn)});
+        }
+
+        /// \brief Get iterator to element with maximum value in a given
+        /// dimension
+        iterator max_element(size_t dimension) {
+            return iterator(this, extreme_index(dimension, true));
+        }
+
+        /// \brief Get iterator to element with maximum value in a given
+        /// dimension
+        const_iterator max_element(size_t dimension) const {
+            return const_iterator(this, extreme_index(dimension, true));
+        }
+
+        /// \brief Get iterator to element with minimum value in a given
+        /// dimension
+        iterator min_element(size_t dimension) {
+            return iterator(this, extreme_index(dimension, false));
+        }
+
+        /// \brief Get iterator to element with minimum value in a given
+        /// dimension
+        const_iterator min_element(size_t dimension) const {
+            return const_iterator(this, extreme_index(dimension, false));
+        }
+
+      public /* Observers: AssociativeContainer */:
+        /// \brief Returns the function object that compares keys
+        key_compare key_comp() const noexcept {
+            return [this](const key_type &a, const key_type &b) {
+                return std::lexicographical_compare(a.begin(), a.end(),
+                                                    b.begin(), b.end(), comp_);
+            };
+        }
+
+        /// \brief Returns the function object that compares values
+        value_compare value_comp() const noexcept {
+            return [this](const value_type &a, const value_type &b) {
+                return std::lexicographical_compare(
+                    a.first.begin(), a.first.end(), b.first.begin(),
+                    b.first.end(), comp_);
+            };
+        }
+
+        /// \brief Returns the function object that compares numbers
+        /// This is the comparison operator for a single dimension
+        dimension_compare dimension_comp() const noexcept { return comp_; }
+
+      private /* Internal functions: Elements */:
+        /// \brief Element at a position as a protected reference
+        value_type &value_at(size_t i) const {
+            const std::pair<key_type, mapped_type> &p = data_[i];
+            return *(value_type *)&p;
+        }
+
+        /// \brief Check if the element at a position passes the predicates
+        bool passes(size_t i, const predicate_list_type &ps) const {
+            return ps.pass_predicate(data_[i]);
+        }
+
+        /// \brief Position of an element with key k or size() if there is
+        /// none
+        size_t find_index(const key_type &k) const {
+            size_t r = data_.size();
+            for_each_equal(k, [&r](size_t i) {
+                r = i;
+                return false;
+            });
+            return r;
+        }
+
+        /// \brief Call fn with the positions of the elements with key k
+        /// The key is a box with a single point, so the columns filter the
+        /// candidates before we compare the keys.
+        /// \param fn Returns false to stop the search
+        template <class F> void for_each_equal(const key_type &k, F fn) const {
+            if (data_.empty() || k.dimensions() != column_dimensions()) {
+                return;
+            }
+            const K *x = k.values().data();
+            for (size_t block = 0; block < data_.size(); block += block_size) {
+                uint64_t mask = detail::box_mask<false>(
+                    columns_.data(), stride_, column_dimensions(), block,
+                    elements_in_block(block), x, x);
+                while (mask != 0) {
+                    const size_t i = block + detail::lowest_bit(mask);
+                    mask &= mask - 1;
+                    if (data_[i].first == k && !fn(i)) {
+                        return;
+                    }
+                }
+            }
+        }
+
+      private /* Internal functions: Columns */:
+        /// \brief Number of columns
+        size_t column_dimensions() const {
+            return stride_ == 0 ? 0 : columns_.size() / stride_;
+        }
+
+        /// \brief Append a key to the columns
+        /// Each column has room for stride_ elements. When the columns are
+        /// full, we double their capacity and move them to a new vector.
+        void append_to_columns(const key_type &k) {
+            const size_t n = data_.size();
+            if (n == stride_) {
+                const size_t m = n == 0 ? k.dimensions() : column_dimensions();
+                const size_t new_stride = std::max(block_size, 2 * stride_);
+                column_vector_type new_columns(m * new_stride, K(),
+                                               columns_.get_allocator());
+                for (size_t d = 0; d < m; ++d) {
+                    std::copy(columns_.begin() + d * stride_,
+                              columns_.begin() + d * stride_ + n,
+                              new_columns.begin() + d * new_stride);
+                }
+                columns_.swap(new_columns);
+                stride_ = new_stride;
+            }
+            for (size_t d = 0; d < column_dimensions(); ++d) {
+                columns_[d * stride_ + n] = k[d];
+            }
+        }
+
+        /// \brief Remove the marked elements from the vector and the columns
+        /// \return Position of the element after the last erased element
+        size_t compact(const std::vector<bool> &erased, size_t last_erased) {
+            const size_t m = column_dimensions();
+            size_t next = 0;
+            size_t j = 0;
+            for (size_t i = 0; i < data_.size(); ++i) {
+                if (i == last_erased + 1) {
+                    next = j;
+                }
+                if (!erased[i]) {
+                    if (i != j) {
+                        data_[j] = std::move(data_[i]);
+                        for (size_t d = 0; d < m; ++d) {
+                            columns_[d * stride_ + j] =
+                                columns_[d * stride_ + i];
+                        }
+                    }
+                    ++j;
+                }
+            }
+            if (last_erased + 1 == data_.size()) {
+                next = j;
+            }
+            data_.erase(data_.begin() + j, data_.end());
+            return next;
+        }
+
+        /// \brief Number of elements in the block that starts at a position
+        size_t elements_in_block(size_t block) const {
+            return std::min(block_size, data_.size() - block);
+        }
+
+      private /* Internal functions: Queries */:
+        /// \brief Mask of the elements in a block that pass the predicates
+        /// Box predicates are tested on the columns. Other predicates are
+        /// only tested on the elements that passed the box predicates.
+        uint64_t block_mask(size_t block, const predicate_list_type &ps) const {
+            const size_t n = elements_in_block(block);
+            const size_t m = column_dimensions();
+            const K *columns = columns_.data();
+            uint64_t r = detail::low_bits(n);
+            for (const auto &p : ps) {
+                if (r == 0) {
+                    return 0;
+                }
+                if (p.is_intersects()) {
+                    const box_type &b = p.as_intersects().data();
+                    r &= detail::box_mask<false>(
+                        columns, stride_, m, block, n,
+                        b.first().values().data(), b.second().values().data());
+                } else if (p.is_within()) {
+                    const box_type &b = p.as_within().data();
+                    r &= detail::box_mask<true>(
+                        columns, stride_, m, block, n,
+                        b.first().values().data(), b.second().values().data());
+                } else if (p.is_disjoint()) {
+                    const box_type &b = p.as_disjoint().data();
+                    r &= ~detail::box_mask<false>(
+                        columns, stride_, m, block, n,
+                        b.first().values().data(), b.second().values().data());
+                }
+            }
+            for (const auto &p : ps) {
+                if (p.is_satisfies()) {
+                    for (uint64_t bits = r; bits != 0; bits &= bits - 1) {
+                        const size_t j = detail::lowest_bit(bits);
+                        const auto &v = data_[block + j];
+                        if (!p.as_satisfies().pass_predicate(v)) {
+                            r &= ~(uint64_t(1) << j);
+                        }
+                    }
+                }
+            }
+            return r;
+        }
+
+        /// \brief First element at or after the position that passes the
+        /// predicates
+        /// \param mask Elements after the result in its block that also
+        /// pass the predicates
+        /// \return The position of the element or size() if there is none
+        size_t next_match(size_t from, const predicate_list_type &ps,
+                          uint64_t &mask) const {
+            size_t block = from - from % block_size;
+            uint64_t bits = 0;
+            if (from < data_.size()) {
+                bits = block_mask(block, ps) & ~detail::low_bits(from - block);
+            }
+            while (bits == 0) {
+                block += block_size;
+                if (block >= data_.size()) {
+                    mask = 0;
+                    return data_.size();
+                }
+                bits = block_mask(block, ps);
+            }
+            mask = bits & (bits - 1);
+            return block + detail::lowest_bit(bits);
+        }
+
+        /// \brief Last element before the position that passes the predicates
+        /// \param mask Elements after the result in its block that also
+        /// pass the predicates
+        /// \return The position of the element or npos if there is none
+        size_t previous_match(size_t to, const predicate_list_type &ps,
+                              uint64_t &mask) const {
+            if (to == 0) {
+                return npos;
+            }
+            size_t block = (to - 1) - (to - 1) % block_size;
+            uint64_t all = block_mask(block, ps);
+            uint64_t bits = all & detail::low_bits(to - block);
+            while (bits == 0) {
+                if (block == 0) {
+                    return npos;
+                }
+                block -= block_size;
+                all = block_mask(block, ps);
+                bits = all;
+            }
+            const size_t j = detail::highest_bit(bits);
+            mask = all & ~detail::low_bits(j + 1);
+            return block + j;
+        }
+
+        /// \brief Indexes of the k nearest elements sorted by distance
+        /// We compute the squared distances to a block of elements at a time
+        /// and keep the k nearest in a heap.
+        std::vector<size_t>
+        nearest_indices(const nearest_type &reference) const {
+            const size_t k = std::min(reference.k(), data_.size());
+            std::priority_queue<std::pair<distance_type, size_t>>
+                nearest_so_far;
+            if (k != 0) {
+                const size_t m = column_dimensions();
+                std::array<distance_type, block_size> distances{};
+                for (size_t block = 0; block < data_.size();
+                     block += block_size) {
+                    const size_t n = elements_in_block(block);
+                    if (reference.has_reference_point()) {
+                        detail::squared_distances(
+                            columns_.data(), stride_, m, block, n,
+                            reference.reference_point().values().data(),
+                            distances.data());
+                    } else {
+                        const box_type &b = reference.reference_box();
+                        detail::squared_distances(
+                            columns_.data(), stride_, m, block, n,
+                            b.first().values().data(),
+                            b.second().values().data(), distances.data());
+                    }
+                    for (size_t j = 0; j < n; ++j) {
+                        if (nearest_so_far.size() < k) {
+                            nearest_so_far.emplace(distances[j], block + j);
+                        } else if (distances[j] < nearest_so_far.top().first) {
+                            nearest_so_far.pop();
+                            nearest_so_far.emplace(distances[j], block + j);
+                        }
+                    }
+                }
+            }
+            std::vector<size_t> r(nearest_so_far.size());
+            for (auto it = r.rbegin(); it != r.rend(); ++it) {
+                *it = nearest_so_far.top().second;
+                nearest_so_far.pop();
+            }
+            return r;
+        }
+
+        /// \brief Position of the max or min element in a dimension
+        /// This is a scan of a single column
+        size_t extreme_index(size_t dimension, bool is_max) const {
+            if (data_.empty()) {
+                return data_.size();
+            }
+            const K *column = columns_.data() + dimension * stride_;
+            size_t best = 0;
+            if (is_max) {
+                for (size_t i = 1; i < data_.size(); ++i) {
+                    if (column[best] < column[i]) {
+                        best = i;
+                    }
+                }
+            } else {
+                for (size_t i = 1; i < data_.size(); ++i) {
+                    if (column[i] < column[best]) {
+                        best = i;
+                    }
+                }
+            }
+            return best;
+        }
+
+      private:
+        /// \brief Elements in insertion order
+        /// Note that the key_type is not constant, unlike the value_type
+        /// exposed to the user. The iterators are responsible for
+        /// converting these references to protected types where the
+        /// key is const.
+        unprotected_vector_type data_{};
+
+        /// \brief Keys of the elements by dimension
+        /// Column d holds the values of dimension d for all elements and
+        /// starts at position d * stride_.
+        column_vector_type columns_{};
+
+        /// \brief Capacity of each column
+        size_t stride_{0};
+
+        /// \brief Key comparison (single dimension)
+        dimension_compare comp_{dimension_compare()};
+    };
+
+    /* Non-Modifying Functions / Comparison / Container Concept */
+    /// \brief Equality operator
+    /// Elements are in insertion order, so this tells us if the trees are
+    /// equal and not if they contain the same elements.
+    template <class K, size_t M, class T, class C, class A>
+    bool operator==(const columnar_tree<K, M, T, C, A> &lhs,
+                    const columnar_tree<K, M, T, C, A> &rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        using value_type = typename columnar_tree<K, M, T, C, A>::value_type;
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                          [](const value_type &a, const value_type &b) {
+                              return a.first == b.first &&
+                                     mapped_type_custom_equality_operator(
+                                         a.second, b.second);
+                          });
+    }
+
+    /// \brief Inequality operator
+    template <class K, size_t M, class T, class C, class A>
+    bool operator!=(const columnar_tree<K, M, T, C, A> &lhs,
+                    const columnar_tree<K, M, T, C, A> &rhs) {
+        return !(lhs == rhs);
+    }
+
+} // namespace pareto
+
+#endif // PARETO_COLUMNAR_TREE_H
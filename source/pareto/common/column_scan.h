@@ -0,0 +1,271 @@
+#ifndef PARETO_COLUMN_SCAN_H
+#define PARETO_COLUMN_SCAN_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <pareto/common/dominance.h>
+
+namespace pareto {
+    namespace detail {
+        /// \brief Number of elements in a block of a column scan
+        /// Each block is summarized by a 64-bit mask
+        constexpr size_t scan_block_size = 64;
+
+        /// \brief Position of the lowest set bit of a non-zero mask
+        inline size_t lowest_bit(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<size_t>(__builtin_ctzll(mask));
+#else
+            size_t i = 0;
+            while (!(mask & 1)) {
+                mask >>= 1;
+                ++i;
+            }
+            return i;
+#endif
+        }
+
+        /// \brief Position of the highest set bit of a non-zero mask
+        inline size_t highest_bit(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+            return 63 - static_cast<size_t>(__builtin_clzll(mask));
+#else
+            size_t i = 0;
+            while (mask >>= 1) {
+                ++i;
+            }
+            return i;
+#endif
+        }
+
+        /// \brief Mask of the elements of a column inside an interval
+        /// Bit j is set if lo <= x[j] <= hi (or lo < x[j] < hi when
+        /// is_open). We test the negation of the conditions that exclude an
+        /// element, like query_box does, so NaNs give the same results.
+        ///
+        /// We compare a few elements at a time with SSE2 or AVX when they
+        /// are available and use movemask to get the bits.
+        /// \param n Number of elements (at most 64)
+        template <bool is_open, class T>
+        uint64_t interval_mask(const T *x, size_t n, T lo, T hi) {
+            uint64_t r = 0;
+            size_t j = 0;
+            if constexpr (std::is_same_v<T, double>) {
+#ifdef PARETO_DOMINANCE_AVX
+                const __m256d l4 = _mm256_set1_pd(lo);
+                const __m256d h4 = _mm256_set1_pd(hi);
+                for (; j + 4 <= n; j += 4) {
+                    const __m256d v = _mm256_loadu_pd(x + j);
+                    const __m256d a =
+                        is_open ? _mm256_cmp_pd(v, l4, _CMP_NLE_UQ)
+                                : _mm256_cmp_pd(v, l4, _CMP_NLT_UQ);
+                    const __m256d b =
+                        is_open ? _mm256_cmp_pd(v, h4, _CMP_NGE_UQ)
+                                : _mm256_cmp_pd(v, h4, _CMP_NGT_UQ);
+                    r |= uint64_t(_mm256_movemask_pd(_mm256_and_pd(a, b)))
+                         << j;
+                }
+#endif
+#ifdef PARETO_DOMINANCE_SSE2
+                const __m128d l2 = _mm_set1_pd(lo);
+                const __m128d h2 = _mm_set1_pd(hi);
+                for (; j + 2 <= n; j += 2) {
+                    const __m128d v = _mm_loadu_pd(x + j);
+                    const __m128d a =
+                        is_open ? _mm_cmpnle_pd(v, l2) : _mm_cmpnlt_pd(v, l2);
+                    const __m128d b =
+                        is_open ? _mm_cmpnge_pd(v, h2) : _mm_cmpngt_pd(v, h2);
+                    r |= uint64_t(_mm_movemask_pd(_mm_and_pd(a, b))) << j;
+                }
+#endif
+            } else if constexpr (std::is_same_v<T, float>) {
+#ifdef PARETO_DOMINANCE_AVX
+                const __m256 l8 = _mm256_set1_ps(lo);
+                const __m256 h8 = _mm256_set1_ps(hi);
+                for (; j + 8 <= n; j += 8) {
+                    const __m256 v = _mm256_loadu_ps(x + j);
+                    const __m256 a = is_open
+                                         ? _mm256_cmp_ps(v, l8, _CMP_NLE_UQ)
+                                         : _mm256_cmp_ps(v, l8, _CMP_NLT_UQ);
+                    const __m256 b = is_open
+                                         ? _mm256_cmp_ps(v, h8, _CMP_NGE_UQ)
+                                         : _mm256_cmp_ps(v, h8, _CMP_NGT_UQ);
+                    r |= uint64_t(_mm256_movemask_ps(_mm256_and_ps(a, b)))
+                         << j;
+                }
+#endif
+#ifdef PARETO_DOMINANCE_SSE2
+                const __m128 l4 = _mm_set1_ps(lo);
+                const __m128 h4 = _mm_set1_ps(hi);
+                for (; j + 4 <= n; j += 4) {
+                    const __m128 v = _mm_loadu_ps(x + j);
+                    const __m128 a =
+                        is_open ? _mm_cmpnle_ps(v, l4) : _mm_cmpnlt_ps(v, l4);
+                    const __m128 b =
+                        is_open ? _mm_cmpnge_ps(v, h4) : _mm_cmpngt_ps(v, h4);
+                    r |= uint64_t(_mm_movemask_ps(_mm_and_ps(a, b))) << j;
+                }
+#endif
+            } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> &&
+                                 sizeof(T) == 4) {
+#ifdef PARETO_DOMINANCE_AVX2
+                const __m256i l8 = _mm256_set1_epi32(lo);
+                const __m256i h8 = _mm256_set1_epi32(hi);
+                for (; j + 8 <= n; j += 8) {
+                    const __m256i v = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i *>(x + j));
+                    // closed: not (lo > x or x > hi)
+                    // open: x > lo and hi > x
+                    const __m256i c =
+                        is_open
+                            ? _mm256_and_si256(_mm256_cmpgt_epi32(v, l8),
+                                               _mm256_cmpgt_epi32(h8, v))
+                            : _mm256_or_si256(_mm256_cmpgt_epi32(l8, v),
+                                              _mm256_cmpgt_epi32(v, h8));
+                    const auto bits = uint64_t(
+                        _mm256_movemask_ps(_mm256_castsi256_ps(c)));
+                    r |= (is_open ? bits : ~bits & 0xFF) << j;
+                }
+#endif
+#ifdef PARETO_DOMINANCE_SSE2
+                const __m128i l4 = _mm_set1_epi32(lo);
+                const __m128i h4 = _mm_set1_epi32(hi);
+                for (; j + 4 <= n; j += 4) {
+                    const __m128i v = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i *>(x + j));
+                    const __m128i c =
+                        is_open ? _mm_and_si128(_mm_cmpgt_epi32(v, l4),
+                                                _mm_cmplt_epi32(v, h4))
+                                : _mm_or_si128(_mm_cmplt_epi32(v, l4),
+                                               _mm_cmpgt_epi32(v, h4));
+                    const auto bits =
+                        uint64_t(_mm_movemask_ps(_mm_castsi128_ps(c)));
+                    r |= (is_open ? bits : ~bits & 0xF) << j;
+                }
+#endif
+            }
+            for (; j < n; ++j) {
+                const bool pass = is_open ? !(x[j] <= lo) && !(x[j] >= hi)
+                                          : !(x[j] < lo) && !(x[j] > hi);
+                r |= uint64_t(pass) << j;
+            }
+            return r;
+        }
+
+        /// \brief Mask of the elements of a block inside a box
+        /// We test one column at a time and stop as soon as no element of
+        /// the block is left.
+        /// \param columns Columns of the container, where column d starts
+        /// at columns + d * stride
+        /// \param first Position of the first element of the block
+        /// \param n Number of elements in the block (at most 64)
+        template <bool is_open, class T>
+        uint64_t box_mask(const T *columns, size_t stride, size_t m,
+                          size_t first, size_t n, const T *lo, const T *hi) {
+            uint64_t r = low_bits(n);
+            for (size_t d = 0; d < m && r != 0; ++d) {
+                r &= interval_mask<is_open>(columns + d * stride + first, n,
+                                            lo[d], hi[d]);
+            }
+            return r;
+        }
+
+        /// \brief Squared distances between the elements of a block and a
+        /// reference point
+        /// The squared distances are accumulated one column at a time.
+        /// \param out Squared distances of the n elements of the block
+        template <class T, class D>
+        void squared_distances(const T *columns, size_t stride, size_t m,
+                               size_t first, size_t n, const T *p, D *out) {
+            std::fill(out, out + n, D(0));
+            for (size_t d = 0; d < m; ++d) {
+                const T *x = columns + d * stride + first;
+                size_t j = 0;
+                if constexpr (std::is_same_v<T, double> &&
+                              std::is_same_v<D, double>) {
+#ifdef PARETO_DOMINANCE_AVX
+                    const __m256d p4 = _mm256_set1_pd(p[d]);
+                    for (; j + 4 <= n; j += 4) {
+                        const __m256d t =
+                            _mm256_sub_pd(_mm256_loadu_pd(x + j), p4);
+                        _mm256_storeu_pd(
+                            out + j, _mm256_add_pd(_mm256_loadu_pd(out + j),
+                                                   _mm256_mul_pd(t, t)));
+                    }
+#endif
+#ifdef PARETO_DOMINANCE_SSE2
+                    const __m128d p2 = _mm_set1_pd(p[d]);
+                    for (; j + 2 <= n; j += 2) {
+                        const __m128d t = _mm_sub_pd(_mm_loadu_pd(x + j), p2);
+                        _mm_storeu_pd(out + j,
+                                      _mm_add_pd(_mm_loadu_pd(out + j),
+                                                 _mm_mul_pd(t, t)));
+                    }
+#endif
+                }
+                for (; j < n; ++j) {
+                    const D t = static_cast<D>(x[j]) - static_cast<D>(p[d]);
+                    out[j] += t * t;
+                }
+            }
+        }
+
+        /// \brief Squared distances between the elements of a block and a
+        /// reference box
+        /// Elements inside the box have distance zero.
+        template <class T, class D>
+        void squared_distances(const T *columns, size_t stride, size_t m,
+                               size_t first, size_t n, const T *lo,
+                               const T *hi, D *out) {
+            std::fill(out, out + n, D(0));
+            for (size_t d = 0; d < m; ++d) {
+                const T *x = columns + d * stride + first;
+                size_t j = 0;
+                if constexpr (std::is_same_v<T, double> &&
+                              std::is_same_v<D, double>) {
+#ifdef PARETO_DOMINANCE_AVX
+                    const __m256d l4 = _mm256_set1_pd(lo[d]);
+                    const __m256d h4 = _mm256_set1_pd(hi[d]);
+                    const __m256d z4 = _mm256_setzero_pd();
+                    for (; j + 4 <= n; j += 4) {
+                        const __m256d v = _mm256_loadu_pd(x + j);
+                        const __m256d t = _mm256_max_pd(
+                            _mm256_max_pd(_mm256_sub_pd(l4, v),
+                                          _mm256_sub_pd(v, h4)),
+                            z4);
+                        _mm256_storeu_pd(
+                            out + j, _mm256_add_pd(_mm256_loadu_pd(out + j),
+                                                   _mm256_mul_pd(t, t)));
+                    }
+#endif
+#ifdef PARETO_DOMINANCE_SSE2
+                    const __m128d l2 = _mm_set1_pd(lo[d]);
+                    const __m128d h2 = _mm_set1_pd(hi[d]);
+                    const __m128d z2 = _mm_setzero_pd();
+                    for (; j + 2 <= n; j += 2) {
+                        const __m128d v = _mm_loadu_pd(x + j);
+                        const __m128d t = _mm_max_pd(
+                            _mm_max_pd(_mm_sub_pd(l2, v), _mm_sub_pd(v, h2)),
+                            z2);
+                        _mm_storeu_pd(out + j,
+                                      _mm_add_pd(_mm_loadu_pd(out + j),
+                                                 _mm_mul_pd(t, t)));
+                    }
+#endif
+                }
+                for (; j < n; ++j) {
+                    const D t = std::max(
+                        std::max(static_cast<D>(lo[d]) - static_cast<D>(x[j]),
+                                 static_cast<D>(x[j]) - static_cast<D>(hi[d])),
+                        D(0));
+                    out[j] += t * t;
+                }
+            }
+        }
+    } // namespace detail
+} // namespace pareto
+
+#endif // PARETO_COLUMN_SCAN_H
@@ -0,0 +1,240 @@
+#ifndef PARETO_DOMINANCE_H
+#define PARETO_DOMINANCE_H
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARETO_DOMINANCE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX__)
+#define PARETO_DOMINANCE_AVX
+#include <immintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define PARETO_DOMINANCE_AVX2
+#endif
+
+namespace pareto {
+    namespace detail {
+        /// \brief Coordinates where a point is less or greater than another
+        /// Bit i of each mask refers to dimension i
+        struct comparison_masks {
+            uint64_t less;
+            uint64_t greater;
+        };
+
+        /// \brief Whether we can check the dominance of these points with
+        /// bit masks
+        template <class T, size_t M>
+        constexpr bool has_dominance_masks_v =
+            M > 0 && std::is_arithmetic_v<T>;
+
+        /// \brief Mask with the lowest n bits set
+        constexpr uint64_t low_bits(size_t n) {
+            return n >= 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1;
+        }
+
+        /// \brief Compare a chunk of coordinates of two points
+        /// We compare a few coordinates at a time with SSE2 or AVX when
+        /// they are available and use movemask to get the bits. Otherwise,
+        /// we compare one coordinate.
+        /// \param i First coordinate in the chunk
+        /// \param r Bit k refers to coordinate i + k
+        /// \return Number of coordinates compared
+        template <class T, size_t M>
+        size_t compare_chunk(const std::array<T, M> &a,
+                             const std::array<T, M> &b, size_t i,
+                             comparison_masks &r) {
+            if constexpr (std::is_same_v<T, double>) {
+#ifdef PARETO_DOMINANCE_AVX
+                if (i + 4 <= M) {
+                    const __m256d x = _mm256_loadu_pd(a.data() + i);
+                    const __m256d y = _mm256_loadu_pd(b.data() + i);
+                    r.less = uint64_t(
+                        _mm256_movemask_pd(_mm256_cmp_pd(x, y, _CMP_LT_OQ)));
+                    r.greater = uint64_t(
+                        _mm256_movemask_pd(_mm256_cmp_pd(x, y, _CMP_GT_OQ)));
+                    return 4;
+                }
+#endif
+#ifdef PARETO_DOMINANCE_SSE2
+                if (i + 2 <= M) {
+                    const __m128d x = _mm_loadu_pd(a.data() + i);
+                    const __m128d y = _mm_loadu_pd(b.data() + i);
+                    r.less = uint64_t(_mm_movemask_pd(_mm_cmplt_pd(x, y)));
+                    r.greater = uint64_t(_mm_movemask_pd(_mm_cmpgt_pd(x, y)));
+                    return 2;
+                }
+#endif
+            } else if constexpr (std::is_same_v<T, float>) {
+#ifdef PARETO_DOMINANCE_AVX
+                if (i + 8 <= M) {
+                    const __m256 x = _mm256_loadu_ps(a.data() + i);
+                    const __m256 y = _mm256_loadu_ps(b.data() + i);
+                    r.less = uint64_t(
+                        _mm256_movemask_ps(_mm256_cmp_ps(x, y, _CMP_LT_OQ)));
+                    r.greater = uint64_t(
+                        _mm256_movemask_ps(_mm256_cmp_ps(x, y, _CMP_GT_OQ)));
+                    return 8;
+                }
+#endif
+#ifdef PARETO_DOMINANCE_SSE2
+                if (i + 4 <= M) {
+                    const __m128 x = _mm_loadu_ps(a.data() + i);
+                    const __m128 y = _mm_loadu_ps(b.data() + i);
+                    r.less = uint64_t(_mm_movemask_ps(_mm_cmplt_ps(x, y)));
+                    r.greater = uint64_t(_mm_movemask_ps(_mm_cmpgt_ps(x, y)));
+                    return 4;
+                }
+#endif
+            } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> &&
+                                 sizeof(T) == 4) {
+#ifdef PARETO_DOMINANCE_AVX2
+                if (i + 8 <= M) {
+                    const __m256i x = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i *>(a.data() + i));
+                    const __m256i y = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i *>(b.data() + i));
+                    r.less = uint64_t(_mm256_movemask_ps(
+                        _mm256_castsi256_ps(_mm256_cmpgt_epi32(y, x))));
+                    r.greater = uint64_t(_mm256_movemask_ps(
+                        _mm256_castsi256_ps(_mm256_cmpgt_epi32(x, y))));
+                    return 8;
+                }
+#endif
+#ifdef PARETO_DOMINANCE_SSE2
+                if (i + 4 <= M) {
+                    const __m128i x = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i *>(a.data() + i));
+                    const __m128i y = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i *>(b.data() + i));
+                    r.less = uint64_t(_mm_movemask_ps(
+                        _mm_castsi128_ps(_mm_cmplt_epi32(x, y))));
+                    r.greater = uint64_t(_mm_movemask_ps(
+                        _mm_castsi128_ps(_mm_cmpgt_epi32(x, y))));
+                    return 4;
+                }
+#endif
+            }
+            r.less = uint64_t(a[i] < b[i]);
+            r.greater = uint64_t(a[i] > b[i]);
+            return 1;
+        }
+
+        /// \brief Check weak dominance one chunk of coordinates at a time
+        /// A point is worse in a minimization dimension if it's greater
+        /// and worse in a maximization dimension if it's less. We return
+        /// as soon as a chunk is worse in any dimension.
+        template <class T, size_t M>
+        bool dominates(const std::array<T, M> &a, const std::array<T, M> &b,
+                       bool is_minimization) {
+            bool better_at_any = false;
+            for (size_t i = 0; i < M;) {
+                comparison_masks c{};
+                const size_t n = compare_chunk(a, b, i, c);
+                if (is_minimization) {
+                    std::swap(c.less, c.greater);
+                }
+                if (c.less) {
+                    return false;
+                }
+                better_at_any |= c.greater != 0;
+                i += n;
+            }
+            return better_at_any;
+        }
+
+        /// \brief Optimization direction of each dimension as bits
+        /// Bit i is set when dimension i is a minimization dimension.
+        /// Containers compute the mask once from their directions so that
+        /// dominance checks with mixed directions also compare a chunk of
+        /// coordinates at a time.
+        template <size_t M> class direction_mask {
+          public:
+            direction_mask() = default;
+
+            /// \brief Mask from a range of directions
+            /// A range with a single direction applies to all dimensions
+            template <class Rng> explicit direction_mask(const Rng &directions) {
+                const size_t n = static_cast<size_t>(
+                    std::distance(directions.begin(), directions.end()));
+                auto it = directions.begin();
+                for (size_t i = 0; i < M; ++i) {
+                    if (*it) {
+                        words_[i / 64] |= uint64_t(1) << (i % 64);
+                    }
+                    if (n != 1) {
+                        ++it;
+                    }
+                }
+            }
+
+            /// \brief Minimization bits of n dimensions starting at i
+            [[nodiscard]] uint64_t bits(size_t i, size_t n) const {
+                uint64_t r = words_[i / 64] >> (i % 64);
+                if (i % 64 != 0 && i / 64 + 1 < words_.size()) {
+                    r |= words_[i / 64 + 1] << (64 - i % 64);
+                }
+                return r & low_bits(n);
+            }
+
+            bool operator==(const direction_mask &rhs) const {
+                return words_ == rhs.words_;
+            }
+
+          private:
+            std::array<uint64_t, (M + 63) / 64> words_{};
+        };
+
+        /// \brief Check weak dominance with a direction for each dimension
+        /// The bits of the minimization dimensions swap the less and
+        /// greater masks with an XOR, so that "less" always means worse.
+        template <class T, size_t M>
+        bool dominates(const std::array<T, M> &a, const std::array<T, M> &b,
+                       const direction_mask<M> &directions) {
+            bool better_at_any = false;
+            for (size_t i = 0; i < M;) {
+                comparison_masks c{};
+                const size_t n = compare_chunk(a, b, i, c);
+                // swap in the minimization dimensions
+                const uint64_t swap =
+                    (c.less ^ c.greater) & directions.bits(i, n);
+                c.less ^= swap;
+                c.greater ^= swap;
+                if (c.less) {
+                    return false;
+                }
+                better_at_any |= c.greater != 0;
+                i += n;
+            }
+            return better_at_any;
+        }
+
+        /// \brief Check strong dominance one chunk of coordinates at a time
+        template <class T, size_t M>
+        bool strongly_dominates(const std::array<T, M> &a,
+                                const std::array<T, M> &b,
+                                bool is_minimization) {
+            for (size_t i = 0; i < M;) {
+                comparison_masks c{};
+                const size_t n = compare_chunk(a, b, i, c);
+                const uint64_t better = is_minimization ? c.less : c.greater;
+                if (better != low_bits(n)) {
+                    return false;
+                }
+                i += n;
+            }
+            return true;
+        }
+    } // namespace detail
+} // namespace pareto
+
+#endif // PARETO_DOMINANCE_H
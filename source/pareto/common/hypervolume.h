@@ -21,10 +21,17 @@
 /// containers to work to calculate hypervolumes
 /// directly in other data types (to be implemented).
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstdlib>
+#include <deque>
+#include <iterator>
 #include <limits>
+#include <map>
+#include <tuple>
 #include <variant>
+#include <vector>
 
 namespace pareto {
     namespace detail {
@@ -121,11 +128,6 @@ namespace pareto {
             return rc;
         }
 
-        inline avl_tree_t *avl_alloc_tree(avl_compare_t cmp,
-                                          avl_freeitem_t freeitem) {
-            return avl_init_tree(new avl_tree_t, cmp, freeitem);
-        }
-
         inline void avl_clear_tree(avl_tree_t *avltree) {
             avltree->top = avltree->head = nullptr;
         }
@@ -376,29 +378,55 @@ namespace pareto {
                                       : 1;
         }
 
+        /// \brief Memory used by one hypervolume computation
+        /// All the state of the algorithm lives here, so calls with
+        /// different workspaces never share memory. The buffers only
+        /// grow, so a workspace reused for fronts of similar sizes
+        /// stops allocating after the first call.
+        struct fpli_workspace {
+            std::vector<dlnode_t> nodes;
+            std::vector<dlnode_t *> next;
+            std::vector<dlnode_t *> prev;
+            std::vector<avl_node_t> tnodes;
+            std::vector<double> area;
+            std::vector<double> vol;
+            std::vector<dlnode_t *> scratch;
+            std::vector<double> bound;
+            // points for hv_2d and hv_3d
+            std::vector<std::array<double, 2>> points_2d;
+            std::vector<std::array<double, 3>> points_3d;
+            // points and their order in each level of wfg_hv
+            std::vector<std::vector<double>> wfg_points;
+            std::vector<std::vector<size_t>> wfg_order;
+        };
+
         /*
          * Setup circular double-linked list in each dimension
          */
-        inline dlnode_t *setup_cdllist(double *data, int d, int n) {
+        inline dlnode_t *setup_cdllist(double *data, int d, int n,
+                                       fpli_workspace &w) {
             dlnode_t *head;
             dlnode_t **scratch;
             int i, j;
 
-            head = reinterpret_cast<dlnode_t *>(
-                malloc((n + 1) * sizeof(dlnode_t)));
-
+            const auto n_nodes = static_cast<size_t>(n + 1);
+            const auto n_links = static_cast<size_t>(d) * n_nodes;
+            w.nodes.resize(n_nodes);
+            w.next.resize(n_links);
+            w.prev.resize(n_links);
+            w.tnodes.resize(n_nodes);
+            w.area.resize(n_links);
+            w.vol.resize(n_links);
+            w.scratch.resize(static_cast<size_t>(n));
+
+            head = w.nodes.data();
             head->x = data;
             head->ignore = 0; /* should never get used */
-            head->next = reinterpret_cast<dlnode_t **>(
-                malloc(d * (n + 1) * sizeof(dlnode_t *)));
-            head->prev = reinterpret_cast<dlnode_t **>(
-                malloc(d * (n + 1) * sizeof(dlnode_t *)));
-            head->tnode = reinterpret_cast<avl_node_t *>(
-                malloc((n + 1) * sizeof(avl_node_t)));
-            head->area = reinterpret_cast<double *>(
-                malloc(d * (n + 1) * sizeof(double)));
-            head->vol = reinterpret_cast<double *>(
-                malloc(d * (n + 1) * sizeof(double)));
+            head->next = w.next.data();
+            head->prev = w.prev.data();
+            head->tnode = w.tnodes.data();
+            head->area = w.area.data();
+            head->vol = w.vol.data();
 
             for (i = 1; i <= n; i++) {
                 head[i].x = head[i - 1].x +
@@ -412,8 +440,7 @@ namespace pareto {
             }
             head->x = nullptr; /* head contains no data */
 
-            scratch =
-                reinterpret_cast<dlnode_t **>(malloc(n * sizeof(dlnode_t *)));
+            scratch = w.scratch.data();
             for (i = 0; i < n; i++)
                 scratch[i] = head + i + 1;
 
@@ -431,8 +458,6 @@ namespace pareto {
                 head->prev[j] = scratch[n - 1];
             }
 
-            free(scratch);
-
             for (i = 1; i <= n; i++) {
                 (head[i].tnode)->item = head[i].x;
             }
@@ -440,15 +465,6 @@ namespace pareto {
             return head;
         }
 
-        inline void free_cdllist(dlnode_t *head) {
-            free(head->tnode); /* Frees _all_ nodes. */
-            free(head->next);
-            free(head->prev);
-            free(head->area);
-            free(head->vol);
-            free(head);
-        }
-
         inline void delete_dlnode(dlnode_t *nodep, int dim,
                                   std::vector<double> &bound) {
             int i;
@@ -785,23 +801,606 @@ namespace pareto {
         }
     } // namespace detail
 
-    inline double fpli_hv(double *data, int d, int n, const double *ref) {
+    /// \brief Exact hypervolume of points in two dimensions
+    /// We sort the points by the first coordinate and sweep them. Each
+    /// point that improves the second coordinate adds a slab between
+    /// its value and the best second coordinate so far. This is
+    /// O(n log n).
+    /// \param points Points (minimization). They are sorted in place.
+    /// \param ref Reference point with 2 coordinates
+    inline double hv_2d(std::vector<std::array<double, 2>> &points,
+                        const double *ref) {
+        std::sort(points.begin(), points.end(),
+                  [](const std::array<double, 2> &a,
+                     const std::array<double, 2> &b) { return a[0] < b[0]; });
+        double hyperv = 0.0;
+        double best_y = ref[1];
+        for (const auto &p : points) {
+            if (p[0] >= ref[0]) {
+                break;
+            }
+            if (p[1] < best_y) {
+                hyperv += (ref[0] - p[0]) * (best_y - p[1]);
+                best_y = p[1];
+            }
+        }
+        return hyperv;
+    }
+
+    /// \brief Exact hypervolume of points in three dimensions
+    /// This is the sweep from Beume et al. (2009). We sort the points
+    /// by the third coordinate and keep the two-dimensional staircase
+    /// of the points we have seen so far in a balanced tree. The area
+    /// of the staircase is updated as points enter it, and each point
+    /// adds the area times the distance to the next point. This is
+    /// O(n log n).
+    /// \see https://doi.org/10.1109/TEVC.2008.2009026
+    /// \param points Points (minimization). They are sorted in place.
+    /// \param ref Reference point with 3 coordinates
+    inline double hv_3d(std::vector<std::array<double, 3>> &points,
+                        const double *ref) {
+        points.erase(std::remove_if(points.begin(), points.end(),
+                                    [&](const std::array<double, 3> &p) {
+                                        return p[0] >= ref[0] ||
+                                               p[1] >= ref[1] ||
+                                               p[2] >= ref[2];
+                                    }),
+                     points.end());
+        if (points.empty()) {
+            return 0.0;
+        }
+        std::sort(points.begin(), points.end(),
+                  [](const std::array<double, 3> &a,
+                     const std::array<double, 3> &b) { return a[2] < b[2]; });
+
+        // Staircase: x -> y, with x increasing and y decreasing
+        std::map<double, double> staircase;
+        // Width of the step that starts at x
+        auto width = [&](std::map<double, double>::const_iterator it) {
+            auto next = std::next(it);
+            return (next == staircase.end() ? ref[0] : next->first) -
+                   it->first;
+        };
+        double area = 0.0;
+        double hyperv = 0.0;
+        double last_z = points.front()[2];
+        for (const auto &p : points) {
+            hyperv += area * (p[2] - last_z);
+            last_z = p[2];
+
+            // p is dominated by a step at its left
+            auto right = staircase.upper_bound(p[0]);
+            if (right != staircase.begin() && std::prev(right)->second <= p[1]) {
+                continue;
+            }
+
+            // remove the steps p dominates
+            auto first = staircase.lower_bound(p[0]);
+            auto last = first;
+            while (last != staircase.end() && last->second >= p[1]) {
+                area -= width(last) * (ref[1] - last->second);
+                ++last;
+            }
+            // the step at the left of p becomes narrower
+            if (first != staircase.begin()) {
+                auto left = std::prev(first);
+                area -= width(left) * (ref[1] - left->second);
+            }
+            staircase.erase(first, last);
+            auto it = staircase.emplace_hint(last, p[0], p[1]);
+            area += width(it) * (ref[1] - it->second);
+            if (it != staircase.begin()) {
+                auto left = std::prev(it);
+                area += width(left) * (ref[1] - left->second);
+            }
+        }
+        hyperv += area * (ref[2] - last_z);
+        return hyperv;
+    }
+
+    namespace detail {
+        /// \brief Volume between a point and the reference
+        inline double inclusive_hv(const double *p, size_t d,
+                                   const double *ref) {
+            double v = 1.0;
+            for (size_t i = 0; i < d; ++i) {
+                v *= ref[i] - p[i];
+            }
+            return v;
+        }
+
+        /// \brief Non-dominated points limited by p
+        /// Each of the n points is replaced by its coordinates that
+        /// are worse than p. The limited points that don't dominate
+        /// the reference or are dominated by other limited points are
+        /// removed.
+        /// \param point_at Function that returns the j-th point
+        /// \param d Number of coordinates we limit
+        /// \param limited Output with m * d coordinates
+        /// \param m Output number of limited points
+        /// \return False if a point covers p, so the limit set is p itself
+        template <class PointAt>
+        bool limit_set(const double *p, size_t n, size_t d, PointAt point_at,
+                       const double *ref, std::vector<double> &limited,
+                       size_t &m) {
+            limited.clear();
+            m = 0;
+            for (size_t j = 0; j < n; ++j) {
+                const double *q = point_at(j);
+                const size_t first = limited.size();
+                bool equals_p = true;
+                bool dominates_ref = true;
+                for (size_t i = 0; i < d; ++i) {
+                    limited.emplace_back(std::max(q[i], p[i]));
+                    equals_p = equals_p && q[i] <= p[i];
+                    dominates_ref = dominates_ref && q[i] < ref[i];
+                }
+                if (equals_p) {
+                    return false;
+                }
+                if (!dominates_ref) {
+                    limited.resize(first);
+                    continue;
+                }
+                const double *l = limited.data() + first;
+                bool is_dominated = false;
+                for (size_t r = 0; r < m;) {
+                    double *kept = limited.data() + r * d;
+                    bool kept_is_better = true;
+                    bool l_is_better = true;
+                    for (size_t i = 0; i < d; ++i) {
+                        kept_is_better = kept_is_better && kept[i] <= l[i];
+                        l_is_better = l_is_better && l[i] <= kept[i];
+                    }
+                    if (kept_is_better) {
+                        is_dominated = true;
+                        break;
+                    }
+                    if (l_is_better) {
+                        // replace the kept point with the last one
+                        --m;
+                        std::copy(limited.data() + m * d,
+                                  limited.data() + (m + 1) * d, kept);
+                    } else {
+                        ++r;
+                    }
+                }
+                if (is_dominated) {
+                    limited.resize(first);
+                } else {
+                    std::copy(limited.begin() + first,
+                              limited.begin() + first + d,
+                              limited.begin() + m * d);
+                    ++m;
+                    limited.resize(m * d);
+                }
+            }
+            return true;
+        }
+
+        /// \brief Hypervolume of the n points in w.wfg_points[level]
+        /// We slice the points by the last objective. The slice of each
+        /// point is its exclusive hypervolume in d - 1 dimensions, which
+        /// is its inclusive hypervolume minus the hypervolume of the
+        /// previous points limited by it. The limited points that
+        /// are dominated are removed before the recursion.
+        inline double wfg_hv(size_t level, size_t n, size_t d,
+                             const double *ref, fpli_workspace &w) {
+            const double *points = w.wfg_points[level].data();
+            if (n == 0) {
+                return 0.0;
+            }
+            if (n == 1) {
+                return inclusive_hv(points, d, ref);
+            }
+            if (d == 2) {
+                w.points_2d.resize(n);
+                for (size_t i = 0; i < n; ++i) {
+                    w.points_2d[i] = {points[2 * i], points[2 * i + 1]};
+                }
+                return hv_2d(w.points_2d, ref);
+            }
+            if (d == 3) {
+                w.points_3d.resize(n);
+                for (size_t i = 0; i < n; ++i) {
+                    w.points_3d[i] = {points[3 * i], points[3 * i + 1],
+                                      points[3 * i + 2]};
+                }
+                return hv_3d(w.points_3d, ref);
+            }
+
+            std::vector<size_t> &order = w.wfg_order[level];
+            order.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                order[i] = i;
+            }
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return points[a * d + d - 1] < points[b * d + d - 1];
+            });
+
+            const size_t dl = d - 1;
+            auto previous = [&](size_t j) { return points + order[j] * d; };
+            double hyperv = 0.0;
+            for (size_t k = 0; k < n; ++k) {
+                const double *p = points + order[k] * d;
+                size_t m = 0;
+                if (!limit_set(p, k, dl, previous, ref,
+                               w.wfg_points[level + 1], m)) {
+                    // the slice of p is covered by a previous point
+                    continue;
+                }
+                const double exclusive =
+                    inclusive_hv(p, dl, ref) - wfg_hv(level + 1, m, dl, ref, w);
+                hyperv += (ref[d - 1] - p[d - 1]) * exclusive;
+            }
+            return hyperv;
+        }
+
+        /// \brief Hypervolume only p dominates among p and n other points
+        /// This is the inclusive hypervolume of p minus the hypervolume
+        /// of the other points limited by p.
+        /// \param point_at Function that returns the j-th other point
+        template <class PointAt>
+        double exclusive_hv(const double *p, size_t n, size_t d,
+                            PointAt point_at, const double *ref,
+                            fpli_workspace &w) {
+            for (size_t i = 0; i < d; ++i) {
+                if (p[i] >= ref[i]) {
+                    return 0.0;
+                }
+            }
+            if (w.wfg_points.size() < d + 1) {
+                w.wfg_points.resize(d + 1);
+                w.wfg_order.resize(d + 1);
+            }
+            size_t m = 0;
+            if (!limit_set(p, n, d, point_at, ref, w.wfg_points[1], m)) {
+                return 0.0;
+            }
+            return inclusive_hv(p, d, ref) - wfg_hv(1, m, d, ref, w);
+        }
+
+        /// \brief Contributions of n points in two dimensions
+        /// The points on the staircase contribute the rectangle between
+        /// them and their neighbours. Duplicates contribute nothing.
+        /// \pre w.wfg_order has at least 3 buffers
+        /// \return False if a point is dominated by another point
+        inline bool hv_contributions_2d(const double *data, size_t n,
+                                        const double *ref,
+                                        double *contributions,
+                                        fpli_workspace &w) {
+            std::vector<size_t> &order = w.wfg_order[0];
+            order.clear();
+            for (size_t i = 0; i < n; ++i) {
+                contributions[i] = 0.0;
+                if (data[2 * i] < ref[0] && data[2 * i + 1] < ref[1]) {
+                    order.emplace_back(i);
+                }
+            }
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return std::make_pair(data[2 * a], data[2 * a + 1]) <
+                       std::make_pair(data[2 * b], data[2 * b + 1]);
+            });
+            // steps of the staircase and whether they have duplicates
+            std::vector<size_t> &steps = w.wfg_order[1];
+            std::vector<size_t> &is_duplicate = w.wfg_order[2];
+            steps.clear();
+            is_duplicate.clear();
+            for (size_t i : order) {
+                const double *p = data + 2 * i;
+                if (steps.empty() || p[1] < data[2 * steps.back() + 1]) {
+                    steps.emplace_back(i);
+                    is_duplicate.emplace_back(0);
+                } else if (p[0] == data[2 * steps.back()] &&
+                           p[1] == data[2 * steps.back() + 1]) {
+                    is_duplicate.back() = 1;
+                } else {
+                    return false;
+                }
+            }
+            for (size_t k = 0; k < steps.size(); ++k) {
+                if (is_duplicate[k]) {
+                    continue;
+                }
+                const double *p = data + 2 * steps[k];
+                const double right =
+                    k + 1 < steps.size() ? data[2 * steps[k + 1]] : ref[0];
+                const double up =
+                    k > 0 ? data[2 * steps[k - 1] + 1] : ref[1];
+                contributions[steps[k]] = (right - p[0]) * (up - p[1]);
+            }
+            return true;
+        }
+
+        /// \brief Contributions of n points in three dimensions
+        /// This is the sweep from Emmerich and Fonseca (2011). We sweep
+        /// the points by the third coordinate and keep the two-dimensional
+        /// staircase of the points we have seen so far, as in hv_3d. In
+        /// each slice of the sweep, the area only a step dominates is the
+        /// rectangle between the step and its neighbours minus the points
+        /// the step dominates. We keep this area as strips along the first
+        /// coordinate. When a new point cuts the area of a step, the strips
+        /// it cuts add their volume up to this slice and restart with their
+        /// new size. Each point creates and merges O(1) strips on average,
+        /// so this is O(n log n).
+        /// \see https://doi.org/10.1007/978-3-642-19893-9_9
+        /// \pre w.wfg_order has at least 1 buffer
+        /// \return False if a point is weakly dominated by another point
+        inline bool hv_contributions_3d(const double *data, size_t n,
+                                        const double *ref,
+                                        double *contributions,
+                                        fpli_workspace &w) {
+            std::vector<size_t> &order = w.wfg_order[0];
+            order.clear();
+            for (size_t i = 0; i < n; ++i) {
+                contributions[i] = 0.0;
+                const double *p = data + 3 * i;
+                if (p[0] < ref[0] && p[1] < ref[1] && p[2] < ref[2]) {
+                    order.emplace_back(i);
+                }
+            }
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                const double *pa = data + 3 * a;
+                const double *pb = data + 3 * b;
+                return std::make_tuple(pa[2], pa[0], pa[1]) <
+                       std::make_tuple(pb[2], pb[0], pb[1]);
+            });
+
+            auto x = [&](size_t i) { return data[3 * i]; };
+            auto y = [&](size_t i) { return data[3 * i + 1]; };
+            auto z = [&](size_t i) { return data[3 * i + 2]; };
+
+            // Strip [x_lo, x_hi) x [y of the step, y_hi) since z_start
+            struct strip {
+                double x_lo;
+                double x_hi;
+                double y_hi;
+                double z_start;
+            };
+            // Strips of each step, from left to right. Their y_hi
+            // decrease from left to right.
+            std::vector<std::deque<strip>> strips(n);
+            auto close = [&](size_t i, const strip &s, double at_z) {
+                contributions[i] +=
+                    (s.x_hi - s.x_lo) * (s.y_hi - y(i)) * (at_z - s.z_start);
+            };
+            // The step i loses its area at the right of x_cut
+            auto cut_right = [&](size_t i, double x_cut, double at_z) {
+                std::deque<strip> &d = strips[i];
+                while (!d.empty() && d.back().x_hi > x_cut) {
+                    strip s = d.back();
+                    d.pop_back();
+                    close(i, s, at_z);
+                    if (s.x_lo < x_cut) {
+                        d.push_back({s.x_lo, x_cut, s.y_hi, at_z});
+                        break;
+                    }
+                }
+            };
+            // The step i loses its area above y_cut
+            auto cut_top = [&](size_t i, double y_cut, double at_z) {
+                std::deque<strip> &d = strips[i];
+                if (d.empty() || d.front().y_hi <= y_cut) {
+                    return;
+                }
+                const double x_lo = d.front().x_lo;
+                double x_hi = x_lo;
+                while (!d.empty() && d.front().y_hi > y_cut) {
+                    x_hi = d.front().x_hi;
+                    close(i, d.front(), at_z);
+                    d.pop_front();
+                }
+                if (y_cut > y(i)) {
+                    d.push_front({x_lo, x_hi, y_cut, at_z});
+                }
+            };
+
+            // Staircase: x -> point, with x increasing and y decreasing
+            std::map<double, size_t> staircase;
+            std::vector<size_t> &dominated = w.wfg_order[1];
+            for (size_t i : order) {
+                // i is weakly dominated by a step at its left
+                auto right = staircase.upper_bound(x(i));
+                if (right != staircase.begin() &&
+                    y(std::prev(right)->second) <= y(i)) {
+                    return false;
+                }
+                // remove the steps i dominates
+                auto first = staircase.lower_bound(x(i));
+                auto last = first;
+                dominated.clear();
+                while (last != staircase.end() && y(last->second) >= y(i)) {
+                    dominated.emplace_back(last->second);
+                    for (const strip &s : strips[last->second]) {
+                        close(last->second, s, z(i));
+                    }
+                    strips[last->second].clear();
+                    ++last;
+                }
+                staircase.erase(first, last);
+                auto it = staircase.emplace_hint(last, x(i), i);
+                const bool has_left = it != staircase.begin();
+                const bool has_right = std::next(it) != staircase.end();
+                const double x_right =
+                    has_right ? x(std::next(it)->second) : ref[0];
+                const double y_up = has_left ? y(std::prev(it)->second) : ref[1];
+                // the neighbours of i lose the area i dominates
+                if (has_left) {
+                    cut_right(std::prev(it)->second, x(i), z(i));
+                }
+                if (has_right) {
+                    cut_top(std::next(it)->second, y(i), z(i));
+                }
+                // i dominates the area below the points it dominates
+                double x_lo = x(i);
+                double y_hi = y_up;
+                for (size_t j : dominated) {
+                    if (x(j) > x_lo && y_hi > y(i)) {
+                        strips[i].push_back({x_lo, x(j), y_hi, z(i)});
+                    }
+                    x_lo = std::max(x_lo, x(j));
+                    y_hi = y(j);
+                }
+                if (x_right > x_lo && y_hi > y(i)) {
+                    strips[i].push_back({x_lo, x_right, y_hi, z(i)});
+                }
+            }
+            for (const auto &step : staircase) {
+                for (const strip &s : strips[step.second]) {
+                    close(step.second, s, ref[2]);
+                }
+            }
+            return true;
+        }
+    } // namespace detail
+
+    /// \brief Exact hypervolume of n points with WFG
+    /// This is the WFG algorithm from While, Bradstreet and Barone
+    /// (2012), which is much faster than fpli_hv with many objectives.
+    /// \see https://doi.org/10.1109/TEVC.2010.2077298
+    /// \param data Row-major array with n * d coordinates (minimization)
+    /// \param ref Reference point with d coordinates
+    /// \param workspace Memory for the algorithm
+    inline double wfg_hv(const double *data, int d, int n, const double *ref,
+                         detail::fpli_workspace &workspace) {
+        const auto dimensions = static_cast<size_t>(d);
+        if (n <= 0 || dimensions == 0) {
+            return 0.0;
+        }
+        // one point or one dimension: the best point is the hypervolume
+        if (n == 1 || dimensions == 1) {
+            const double *best = data;
+            for (int i = 1; i < n; ++i) {
+                const double *p = data + static_cast<size_t>(i) * dimensions;
+                if (p[0] < best[0]) {
+                    best = p;
+                }
+            }
+            for (size_t j = 0; j < dimensions; ++j) {
+                if (best[j] >= ref[j]) {
+                    return 0.0;
+                }
+            }
+            return detail::inclusive_hv(best, dimensions, ref);
+        }
+        // the recursion uses one buffer per level
+        if (workspace.wfg_points.size() < dimensions) {
+            workspace.wfg_points.resize(dimensions);
+            workspace.wfg_order.resize(dimensions);
+        }
+        // points that don't dominate the reference add nothing
+        std::vector<double> &points = workspace.wfg_points[0];
+        points.clear();
+        size_t m = 0;
+        for (int i = 0; i < n; ++i) {
+            const double *p = data + static_cast<size_t>(i) * dimensions;
+            bool dominates_ref = true;
+            for (size_t j = 0; j < dimensions; ++j) {
+                dominates_ref = dominates_ref && p[j] < ref[j];
+            }
+            if (dominates_ref) {
+                points.insert(points.end(), p, p + dimensions);
+                ++m;
+            }
+        }
+        return detail::wfg_hv(0, m, dimensions, ref, workspace);
+    }
+
+    /// \brief Hypervolume contribution of a point
+    /// The contribution of p is the hypervolume we lose if we remove
+    /// it, i.e., the hypervolume only p dominates.
+    /// \param p Point with d coordinates (minimization)
+    /// \param data Row-major array with the n * d coordinates of the
+    /// other points (minimization)
+    /// \param ref Reference point with d coordinates
+    /// \param workspace Memory for the algorithm
+    inline double hv_contribution(const double *p, const double *data, int d,
+                                  int n, const double *ref,
+                                  detail::fpli_workspace &workspace) {
+        const auto dimensions = static_cast<size_t>(d);
+        return detail::exclusive_hv(
+            p, static_cast<size_t>(n), dimensions,
+            [&](size_t j) { return data + j * dimensions; }, ref, workspace);
+    }
+
+    /// \brief Hypervolume contributions of n points
+    /// Two and three dimensions use a sweep over the staircase, which is
+    /// O(n log n). Otherwise, or if a point is weakly dominated by
+    /// another point, the contribution of each point is its inclusive
+    /// hypervolume minus the hypervolume of the other points limited by
+    /// it, which usually has very few points after the dominated ones
+    /// are removed.
+    /// \param data Row-major array with n * d coordinates (minimization)
+    /// \param ref Reference point with d coordinates
+    /// \param contributions Output with n contributions
+    /// \param workspace Memory for the algorithm
+    inline void hv_contributions(const double *data, int d, int n,
+                                 const double *ref, double *contributions,
+                                 detail::fpli_workspace &workspace) {
+        const auto dimensions = static_cast<size_t>(d);
+        const auto m = static_cast<size_t>(n);
+        if (workspace.wfg_points.size() < dimensions + 1) {
+            workspace.wfg_points.resize(dimensions + 1);
+            workspace.wfg_order.resize(dimensions + 1);
+        }
+        if (dimensions == 2 &&
+            detail::hv_contributions_2d(data, m, ref, contributions,
+                                        workspace)) {
+            return;
+        }
+        if (dimensions == 3 &&
+            detail::hv_contributions_3d(data, m, ref, contributions,
+                                        workspace)) {
+            return;
+        }
+        for (size_t i = 0; i < m; ++i) {
+            contributions[i] = detail::exclusive_hv(
+                data + i * dimensions, m - 1, dimensions,
+                [&](size_t j) {
+                    return data + (j < i ? j : j + 1) * dimensions;
+                },
+                ref, workspace);
+        }
+    }
+
+    /// \brief Algorithm for the exact hypervolume
+    /// automatic uses hv_2d and hv_3d for 2 and 3 dimensions, fpli_hv
+    /// up to 5 dimensions, and wfg_hv for more dimensions, where
+    /// fpli_hv becomes much slower.
+    enum class hypervolume_algorithm { automatic, fpli, wfg };
+
+    /// \brief Workspace for fpli_hv
+    /// fpli_hv keeps no global state. Concurrent calls are safe as long
+    /// as each thread uses its own workspace. Reusing a workspace for
+    /// many fronts avoids allocating new buffers on every call.
+    using hypervolume_workspace = detail::fpli_workspace;
+
+    /// \brief Exact hypervolume of n points with d dimensions
+    /// \param data Row-major array with n * d coordinates (minimization)
+    /// \param ref Reference point with d coordinates
+    /// \param workspace Memory for the algorithm
+    inline double fpli_hv(double *data, int d, int n, const double *ref,
+                          hypervolume_workspace &workspace) {
+        if (n == 0) {
+            return 0.0;
+        }
+
         // replace with list<struct>
         detail::dlnode_t *list;
 
         double hyperv;
 
-        std::vector<double> bound(d, -std::numeric_limits<double>::max());
+        workspace.bound.assign(static_cast<size_t>(d),
+                               -std::numeric_limits<double>::max());
         int i;
 
         // replace with set
-        detail::avl_tree_t *tree;
+        detail::avl_tree_t tree;
+        detail::avl_init_tree(&tree,
+                              (detail::avl_compare_t)detail::compare_tree_asc,
+                              (detail::avl_freeitem_t) nullptr);
 
-        tree = detail::avl_alloc_tree(
-            (detail::avl_compare_t)detail::compare_tree_asc,
-            (detail::avl_freeitem_t) nullptr);
-
-        list = detail::setup_cdllist(data, d, n);
+        list = detail::setup_cdllist(data, d, n, workspace);
 
         n = filter(list, d, n, ref);
         if (n == 0) {
@@ -812,16 +1411,20 @@ namespace pareto {
             for (i = 0; i < d; i++)
                 hyperv *= ref[i] - p->x[i];
         } else {
-            hyperv = hv_recursive(tree, list, d - 1, n, ref, bound);
+            hyperv = hv_recursive(&tree, list, d - 1, n, ref, workspace.bound);
         }
 
-        /* Clean up. */
-        free_cdllist(list);
-        delete tree; /* The nodes are freed by free_cdllist ().  */
-
+        /* The tree nodes live in the workspace, so there is nothing to free */
         return hyperv;
     }
 
+    /// \brief Exact hypervolume of n points with d dimensions
+    /// This overload uses a temporary workspace
+    inline double fpli_hv(double *data, int d, int n, const double *ref) {
+        hypervolume_workspace workspace;
+        return fpli_hv(data, d, n, ref, workspace);
+    }
+
 } // namespace pareto
 
 #endif // PARETO_HYPERVOLUME_H
@@ -0,0 +1,299 @@
+#ifndef PARETO_SMALL_VECTOR_H
+#define PARETO_SMALL_VECTOR_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pareto {
+    /// \class Vector with inline storage for small sizes
+    /// Up to N elements are stored inside the object, so small vectors
+    /// need no heap allocation. Larger vectors move their elements to
+    /// the heap like a std::vector.
+    ///
+    /// This is the storage of points with runtime dimensions, where
+    /// almost all points have only a few coordinates.
+    ///
+    /// \tparam T Element type (default constructible)
+    /// \tparam N Number of elements stored inline
+    template <class T, size_t N> class small_vector {
+      public /* Types */:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T &;
+        using const_reference = const T &;
+        using pointer = T *;
+        using const_pointer = const T *;
+        using iterator = T *;
+        using const_iterator = const T *;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      public /* Constructors */:
+        /// \brief Create an empty vector
+        small_vector() noexcept = default;
+
+        /// \brief Create a vector with n value-initialized elements
+        explicit small_vector(size_type n) : small_vector() { resize(n); }
+
+        /// \brief Create a vector with n copies of value
+        small_vector(size_type n, const T &value) : small_vector() {
+            resize(n, value);
+        }
+
+        /// \brief Create a vector with the elements of a range
+        template <class Iterator,
+                  std::enable_if_t<!std::is_integral_v<Iterator>, int> = 0>
+        small_vector(Iterator first, Iterator last) : small_vector() {
+            assign(first, last);
+        }
+
+        /// \brief Create a vector with the elements of a list
+        small_vector(std::initializer_list<T> il) : small_vector() {
+            assign(il.begin(), il.end());
+        }
+
+        /// \brief Copy constructor
+        small_vector(const small_vector &rhs) : small_vector() {
+            assign(rhs.begin(), rhs.end());
+        }
+
+        /// \brief Move constructor
+        /// Heap elements are stolen and inline elements are moved
+        small_vector(small_vector &&rhs) noexcept(
+            std::is_nothrow_move_assignable_v<T>)
+            : small_vector() {
+            steal(rhs);
+        }
+
+        /// \brief Destructor
+        ~small_vector() { release(); }
+
+        /// \brief Copy assignment
+        small_vector &operator=(const small_vector &rhs) {
+            if (this != &rhs) {
+                assign(rhs.begin(), rhs.end());
+            }
+            return *this;
+        }
+
+        /// \brief Move assignment
+        small_vector &operator=(small_vector &&rhs) noexcept(
+            std::is_nothrow_move_assignable_v<T>) {
+            if (this != &rhs) {
+                release();
+                steal(rhs);
+            }
+            return *this;
+        }
+
+        /// \brief Replace the elements with the elements of a range
+        template <class Iterator> void assign(Iterator first, Iterator last) {
+            const auto n = static_cast<size_type>(std::distance(first, last));
+            if (n > capacity_) {
+                reallocate(n, 0);
+            }
+            std::copy(first, last, data_);
+            size_ = n;
+        }
+
+      public /* Iterators */:
+        iterator begin() noexcept { return data_; }
+        const_iterator begin() const noexcept { return data_; }
+        const_iterator cbegin() const noexcept { return data_; }
+        iterator end() noexcept { return data_ + size_; }
+        const_iterator end() const noexcept { return data_ + size_; }
+        const_iterator cend() const noexcept { return data_ + size_; }
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+      public /* Capacity */:
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+        [[nodiscard]] size_type size() const noexcept { return size_; }
+        [[nodiscard]] size_type capacity() const noexcept { return capacity_; }
+
+        /// \brief Maximum number of elements stored without the heap
+        static constexpr size_type inline_capacity() noexcept { return N; }
+
+        /// \brief True if the elements are stored inside the object
+        [[nodiscard]] bool is_inline() const noexcept {
+            return data_ == inline_.data();
+        }
+
+        /// \brief Make sure the vector holds n elements without reallocating
+        void reserve(size_type n) {
+            if (n > capacity_) {
+                reallocate(n, size_);
+            }
+        }
+
+      public /* Element access */:
+        reference operator[](size_type n) { return data_[n]; }
+        const_reference operator[](size_type n) const { return data_[n]; }
+        reference front() { return data_[0]; }
+        const_reference front() const { return data_[0]; }
+        reference back() { return data_[size_ - 1]; }
+        const_reference back() const { return data_[size_ - 1]; }
+        pointer data() noexcept { return data_; }
+        const_pointer data() const noexcept { return data_; }
+
+      public /* Modifiers */:
+        void clear() noexcept { size_ = 0; }
+
+        void resize(size_type n) { resize(n, T()); }
+
+        void resize(size_type n, const T &value) {
+            reserve(n);
+            if (n > size_) {
+                std::fill(data_ + size_, data_ + n, value);
+            }
+            size_ = n;
+        }
+
+        void push_back(const T &value) { emplace_back(value); }
+
+        void push_back(T &&value) { emplace_back(std::move(value)); }
+
+        template <class... Args> reference emplace_back(Args &&...args) {
+            if (size_ == capacity_) {
+                // construct first in case args refer to our elements
+                T value(std::forward<Args>(args)...);
+                reallocate(std::max(capacity_ * 2, size_type(1)), size_);
+                data_[size_] = std::move(value);
+            } else {
+                data_[size_] = T(std::forward<Args>(args)...);
+            }
+            return data_[size_++];
+        }
+
+        void pop_back() { --size_; }
+
+        void swap(small_vector &rhs) noexcept(
+            std::is_nothrow_move_assignable_v<T>) {
+            small_vector tmp(std::move(rhs));
+            rhs = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+      public /* Conversions */:
+        /// \brief Copy the elements to a std::vector
+        /// Points with runtime dimensions used to store a std::vector, so
+        /// code that copies point::values() into one still works
+        operator std::vector<T>() const {
+            return std::vector<T>(begin(), end());
+        }
+
+      public /* Relational operators */:
+        friend bool operator==(const small_vector &a, const small_vector &b) {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end());
+        }
+
+        friend bool operator!=(const small_vector &a, const small_vector &b) {
+            return !(a == b);
+        }
+
+        friend bool operator<(const small_vector &a, const small_vector &b) {
+            return std::lexicographical_compare(a.begin(), a.end(), b.begin(),
+                                                b.end());
+        }
+
+        friend bool operator>(const small_vector &a, const small_vector &b) {
+            return b < a;
+        }
+
+        friend bool operator<=(const small_vector &a, const small_vector &b) {
+            return !(b < a);
+        }
+
+        friend bool operator>=(const small_vector &a, const small_vector &b) {
+            return !(a < b);
+        }
+
+      private /* Internal functions */:
+        /// \brief Move the first n elements to a new heap buffer
+        void reallocate(size_type new_capacity, size_type n) {
+            T *new_data = new T[new_capacity];
+            std::move(data_, data_ + n, new_data);
+            release();
+            data_ = new_data;
+            capacity_ = new_capacity;
+        }
+
+        /// \brief Free the heap buffer, if any, and go back to inline storage
+        void release() noexcept {
+            if (!is_inline()) {
+                delete[] data_;
+                data_ = inline_.data();
+                capacity_ = N;
+            }
+        }
+
+        /// \brief Take the elements of rhs and leave rhs empty
+        /// This vector should be empty and inline
+        void steal(small_vector &rhs) noexcept(
+            std::is_nothrow_move_assignable_v<T>) {
+            if (rhs.is_inline()) {
+                std::move(rhs.begin(), rhs.end(), inline_.begin());
+                size_ = rhs.size_;
+            } else {
+                data_ = rhs.data_;
+                size_ = rhs.size_;
+                capacity_ = rhs.capacity_;
+                rhs.data_ = rhs.inline_.data();
+                rhs.capacity_ = N;
+            }
+            rhs.size_ = 0;
+        }
+
+      private:
+        /// \brief Inline storage for up to N elements
+        std::array<T, N> inline_;
+
+        /// \brief Where the elements are: inline_ or a heap buffer
+        T *data_{inline_.data()};
+
+        /// \brief Number of elements
+        size_type size_{0};
+
+        /// \brief Number of elements data_ can hold
+        size_type capacity_{N};
+    };
+
+    /// \brief Resize if vector, not resize if array
+    template <typename number_t, size_t N>
+    void maybe_resize(small_vector<number_t, N> &v, size_t n) {
+        v.resize(n);
+    }
+
+    /// \brief Push back if vector, not push back if array
+    template <typename number_t, size_t N>
+    void maybe_push_back(small_vector<number_t, N> &v, const number_t &n) {
+        v.push_back(n);
+    }
+
+    /// \brief Push back (move back) if vector, not push back if array
+    template <typename number_t, size_t N>
+    void maybe_push_back(small_vector<number_t, N> &v, number_t &&n) {
+        v.push_back(std::move(n));
+    }
+
+    /// \brief Clear if vector, not clear if array
+    template <typename number_t, size_t N>
+    void maybe_clear(small_vector<number_t, N> &v) {
+        v.clear();
+    }
+} // namespace pareto
+
+#endif // PARETO_SMALL_VECTOR_H
@@ -0,0 +1,141 @@
+#ifndef PARETO_SPACE_FILLING_CURVE_H
+#define PARETO_SPACE_FILLING_CURVE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pareto {
+    /// \brief Z-order (Morton) curve
+    /// The code interleaves the bits of the grid coordinates, from the most
+    /// significant bit of the first coordinate to the least significant bit
+    /// of the last coordinate.
+    ///
+    /// Curves encode m coordinates with b bits each into an (m * b)-bit code
+    /// and have the property that the first l * m bits of a code identify
+    /// the cell of level l that contains the point, i.e. the cell of side
+    /// 2^(b - l). These l * m bits are also the code of that cell in a grid
+    /// with l bits per coordinate. Containers use this property to turn a
+    /// range of codes into a box.
+    struct morton_curve {
+        /// \brief Encode grid coordinates
+        /// \param x Grid coordinates in [0, 2^bits)
+        /// \param m Number of coordinates
+        /// \param bits Bits per coordinate (m * bits <= 64)
+        static uint64_t encode(const uint64_t *x, size_t m, size_t bits) {
+            uint64_t code = 0;
+            for (size_t b = bits; b > 0; --b) {
+                for (size_t i = 0; i < m; ++i) {
+                    code = (code << 1) | ((x[i] >> (b - 1)) & 1);
+                }
+            }
+            return code;
+        }
+
+        /// \brief Decode grid coordinates
+        static void decode(uint64_t code, uint64_t *x, size_t m,
+                           size_t bits) {
+            for (size_t i = 0; i < m; ++i) {
+                x[i] = 0;
+            }
+            size_t shift = m * bits;
+            for (size_t b = bits; b > 0; --b) {
+                for (size_t i = 0; i < m; ++i) {
+                    --shift;
+                    x[i] = (x[i] << 1) | ((code >> shift) & 1);
+                }
+            }
+        }
+    };
+
+    /// \brief Hilbert curve
+    /// Consecutive cells along the Hilbert curve are always neighbours,
+    /// which gives better locality than the Z-order curve at the cost of a
+    /// more expensive encoding.
+    ///
+    /// \see Skilling, John. "Programming the Hilbert curve." AIP Conference
+    /// Proceedings 707 (2004): 381-387.
+    struct hilbert_curve {
+        /// \brief Encode grid coordinates
+        /// \param x Grid coordinates in [0, 2^bits)
+        /// \param m Number of coordinates (at most 64)
+        /// \param bits Bits per coordinate (m * bits <= 64)
+        static uint64_t encode(const uint64_t *x, size_t m, size_t bits) {
+            if (m == 0 || bits == 0) {
+                return 0;
+            }
+            uint64_t t[64];
+            for (size_t i = 0; i < m; ++i) {
+                t[i] = x[i];
+            }
+            axes_to_transpose(t, m, bits);
+            return morton_curve::encode(t, m, bits);
+        }
+
+        /// \brief Decode grid coordinates
+        static void decode(uint64_t code, uint64_t *x, size_t m,
+                           size_t bits) {
+            morton_curve::decode(code, x, m, bits);
+            if (m != 0 && bits != 0) {
+                transpose_to_axes(x, m, bits);
+            }
+        }
+
+      private:
+        /// \brief Replace the coordinates with the transposed Hilbert index
+        static void axes_to_transpose(uint64_t *x, size_t m, size_t bits) {
+            const uint64_t top = uint64_t(1) << (bits - 1);
+            // inverse undo
+            for (uint64_t q = top; q > 1; q >>= 1) {
+                const uint64_t p = q - 1;
+                for (size_t i = 0; i < m; ++i) {
+                    if (x[i] & q) {
+                        x[0] ^= p;
+                    } else {
+                        const uint64_t t = (x[0] ^ x[i]) & p;
+                        x[0] ^= t;
+                        x[i] ^= t;
+                    }
+                }
+            }
+            // gray encode
+            for (size_t i = 1; i < m; ++i) {
+                x[i] ^= x[i - 1];
+            }
+            uint64_t t = 0;
+            for (uint64_t q = top; q > 1; q >>= 1) {
+                if (x[m - 1] & q) {
+                    t ^= q - 1;
+                }
+            }
+            for (size_t i = 0; i < m; ++i) {
+                x[i] ^= t;
+            }
+        }
+
+        /// \brief Replace the transposed Hilbert index with the coordinates
+        static void transpose_to_axes(uint64_t *x, size_t m, size_t bits) {
+            // gray decode
+            uint64_t t = x[m - 1] >> 1;
+            for (size_t i = m - 1; i > 0; --i) {
+                x[i] ^= x[i - 1];
+            }
+            x[0] ^= t;
+            // undo excess work
+            for (uint64_t q = 2; q != (uint64_t(1) << bits) && q != 0;
+                 q <<= 1) {
+                const uint64_t p = q - 1;
+                for (size_t i = m; i > 0; --i) {
+                    if (x[i - 1] & q) {
+                        x[0] ^= p;
+                    } else {
+                        t = (x[0] ^ x[i - 1]) & p;
+                        x[0] ^= t;
+                        x[i - 1] ^= t;
+                    }
+                }
+            }
+        }
+    };
+} // namespace pareto
+
+#endif // PARETO_SPACE_FILLING_CURVE_H
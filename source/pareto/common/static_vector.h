@@ -0,0 +1,145 @@
+#ifndef PARETO_STATIC_VECTOR_H
+#define PARETO_STATIC_VECTOR_H
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace pareto {
+    /// \class Vector with a fixed capacity and inline storage
+    /// Up to N elements are stored inside the object. Unlike a
+    /// std::array, only the first size() elements are constructed, so
+    /// the element type does not need a default constructor.
+    ///
+    /// This is the bucket of values in the nodes of kd-trees and
+    /// quadtrees.
+    ///
+    /// \tparam T Element type
+    /// \tparam N Maximum number of elements
+    template <class T, size_t N> class static_vector {
+      public /* Types */:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T &;
+        using const_reference = const T &;
+        using pointer = T *;
+        using const_pointer = const T *;
+        using iterator = T *;
+        using const_iterator = const T *;
+
+      public /* Constructors */:
+        /// \brief Create an empty vector
+        static_vector() noexcept = default;
+
+        /// \brief Copy constructor
+        static_vector(const static_vector &rhs) {
+            for (const T &v : rhs) {
+                emplace_back(v);
+            }
+        }
+
+        /// \brief Move constructor
+        static_vector(static_vector &&rhs) noexcept(
+            std::is_nothrow_move_constructible_v<T>) {
+            for (T &v : rhs) {
+                emplace_back(std::move(v));
+            }
+            rhs.clear();
+        }
+
+        /// \brief Destructor
+        ~static_vector() { clear(); }
+
+        /// \brief Copy assignment
+        static_vector &operator=(const static_vector &rhs) {
+            if (this != &rhs) {
+                clear();
+                for (const T &v : rhs) {
+                    emplace_back(v);
+                }
+            }
+            return *this;
+        }
+
+        /// \brief Move assignment
+        static_vector &operator=(static_vector &&rhs) noexcept(
+            std::is_nothrow_move_constructible_v<T>) {
+            if (this != &rhs) {
+                clear();
+                for (T &v : rhs) {
+                    emplace_back(std::move(v));
+                }
+                rhs.clear();
+            }
+            return *this;
+        }
+
+      public /* Iterators */:
+        iterator begin() noexcept { return data(); }
+        const_iterator begin() const noexcept { return data(); }
+        iterator end() noexcept { return data() + size_; }
+        const_iterator end() const noexcept { return data() + size_; }
+
+      public /* Capacity */:
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+        [[nodiscard]] size_type size() const noexcept { return size_; }
+        static constexpr size_type capacity() noexcept { return N; }
+        [[nodiscard]] bool full() const noexcept { return size_ == N; }
+
+      public /* Element access */:
+        reference operator[](size_type n) { return data()[n]; }
+        const_reference operator[](size_type n) const { return data()[n]; }
+        reference back() { return data()[size_ - 1]; }
+        const_reference back() const { return data()[size_ - 1]; }
+        pointer data() noexcept { return reinterpret_cast<T *>(storage_); }
+        const_pointer data() const noexcept {
+            return reinterpret_cast<const T *>(storage_);
+        }
+
+      public /* Modifiers */:
+        template <class... Args> reference emplace_back(Args &&...args) {
+            assert(size_ < N);
+            T *p = ::new (static_cast<void *>(storage_ + size_ * sizeof(T)))
+                T(std::forward<Args>(args)...);
+            ++size_;
+            return *p;
+        }
+
+        void pop_back() {
+            assert(size_ > 0);
+            --size_;
+            std::destroy_at(data() + size_);
+        }
+
+        void clear() noexcept {
+            std::destroy(begin(), end());
+            size_ = 0;
+        }
+
+        /// \brief Remove the element at position n
+        /// The last element takes its place, so the order of the other
+        /// elements is not kept.
+        void swap_and_pop(size_type n) {
+            if (n != size_ - 1) {
+                T *p = data() + n;
+                std::destroy_at(p);
+                ::new (static_cast<void *>(p)) T(std::move(back()));
+            }
+            pop_back();
+        }
+
+      private:
+        /// \brief Storage for up to N elements
+        alignas(T) unsigned char storage_[N * sizeof(T)];
+
+        /// \brief Number of constructed elements
+        size_type size_{0};
+    };
+} // namespace pareto
+
+#endif // PARETO_STATIC_VECTOR_H
@@ -0,0 +1,182 @@
+#ifndef PARETO_CONCURRENT_FRONT_H
+#define PARETO_CONCURRENT_FRONT_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <pareto/front.h>
+
+namespace pareto {
+    /// \class Concurrent Pareto Front
+    /// A copy-on-write front for read-mostly use: many threads can read
+    /// it while another thread occasionally updates it.
+    ///
+    /// The current front is an immutable version behind a shared pointer.
+    /// Readers get a snapshot of the current version, which remains valid
+    /// and unchanged for as long as they hold it. Writers copy the current
+    /// version, modify the copy, and publish the copy as the new version.
+    /// Readers never wait for a writer to finish modifying the front, and
+    /// old versions are released by the last reader holding them.
+    ///
+    /// Each publication copies the front, which costs O(n). Writers should
+    /// group their changes with insert(first, last) or modify(fn) so that
+    /// many changes are published at once. Writers that produce one change
+    /// at a time can defer(fn) their changes and flush() them in a single
+    /// publication. Writers are serialized by a mutex readers never lock.
+    ///
+    /// Snapshots are loaded and published with the atomic shared_ptr
+    /// functions. Standard libraries such as libstdc++ implement them
+    /// with a small pool of mutexes, so taking a snapshot is not
+    /// lock-free, but it only holds a lock while the pointer is copied.
+    ///
+    /// \note Iterators from a snapshot are only valid while the snapshot
+    /// is alive.
+    template <typename K, size_t M, typename T,
+              class Container = front_map<K, M, T>>
+    class concurrent_front {
+      public /* Types */:
+        using front_type = front<K, M, T, Container>;
+        using snapshot_type = std::shared_ptr<const front_type>;
+        using value_type = typename front_type::value_type;
+        using key_type = typename front_type::key_type;
+        using size_type = typename front_type::size_type;
+
+      public /* Constructors */:
+        /// \brief Create an empty front
+        concurrent_front() : current_(std::make_shared<const front_type>()) {}
+
+        /// \brief Create from the elements and directions of a front
+        explicit concurrent_front(front_type pf)
+            : current_(std::make_shared<const front_type>(std::move(pf))) {}
+
+        /// \brief Concurrent fronts are not copyable
+        /// Copy the snapshot instead
+        concurrent_front(const concurrent_front &) = delete;
+
+        /// \brief Concurrent fronts are not copyable
+        concurrent_front &operator=(const concurrent_front &) = delete;
+
+        /// \brief Destructor
+        ~concurrent_front() = default;
+
+      public /* Readers */:
+        /// \brief Get the current version of the front
+        /// The snapshot does not change when writers publish new versions
+        snapshot_type snapshot() const noexcept {
+            return std::atomic_load_explicit(&current_,
+                                             std::memory_order_acquire);
+        }
+
+        /// \brief Number of versions published since construction
+        [[nodiscard]] size_type version() const noexcept {
+            return version_.load(std::memory_order_acquire);
+        }
+
+      public /* Writers */:
+        /// \brief Apply a function to a copy of the front and publish it
+        /// The function receives a front_type& and all its changes are
+        /// published at once.
+        /// \return The value returned by fn
+        template <class FN> auto modify(FN &&fn) {
+            std::lock_guard lock(writer_mutex_);
+            auto next = std::make_shared<front_type>(*current_);
+            if constexpr (std::is_void_v<
+                              std::invoke_result_t<FN &&, front_type &>>) {
+                std::forward<FN>(fn)(*next);
+                publish(std::move(next));
+            } else {
+                auto r = std::forward<FN>(fn)(*next);
+                publish(std::move(next));
+                return r;
+            }
+        }
+
+        /// \brief Queue a change for the next flush
+        /// The function receives a front_type& when flush() is called.
+        /// Readers do not see the change until then.
+        /// \return Number of changes waiting for the next flush
+        template <class FN> size_type defer(FN &&fn) {
+            std::lock_guard lock(writer_mutex_);
+            deferred_.emplace_back(std::forward<FN>(fn));
+            return deferred_.size();
+        }
+
+        /// \brief Queue an insertion for the next flush
+        /// \return Number of changes waiting for the next flush
+        size_type defer_insert(value_type v) {
+            return defer(
+                [v = std::move(v)](front_type &pf) { pf.insert(v); });
+        }
+
+        /// \brief Apply the deferred changes to one copy and publish it
+        /// \return Number of changes applied
+        size_type flush() {
+            std::lock_guard lock(writer_mutex_);
+            if (deferred_.empty()) {
+                return 0;
+            }
+            auto next = std::make_shared<front_type>(*current_);
+            for (auto &fn : deferred_) {
+                fn(*next);
+            }
+            const size_type n = deferred_.size();
+            deferred_.clear();
+            publish(std::move(next));
+            return n;
+        }
+
+        /// \brief Insert an element and publish the new front
+        /// \return True if the element is in the new front
+        bool insert(const value_type &v) {
+            return modify([&v](front_type &pf) { return pf.insert(v).second; });
+        }
+
+        /// \brief Insert a list of elements and publish the new front once
+        /// \return Number of elements from the list in the new front
+        template <class InputIterator>
+        size_type insert(InputIterator first, InputIterator last) {
+            return modify(
+                [&](front_type &pf) { return pf.insert(first, last); });
+        }
+
+        /// \brief Erase an element and publish the new front
+        /// \return Number of elements erased
+        size_type erase(const key_type &k) {
+            return modify([&k](front_type &pf) { return pf.erase(k); });
+        }
+
+        /// \brief Publish an empty front with the same directions
+        void clear() {
+            modify([](front_type &pf) { pf.clear(); });
+        }
+
+      private /* Internal functions */:
+        void publish(std::shared_ptr<front_type> &&next) {
+            std::atomic_store_explicit(
+                &current_, snapshot_type(std::move(next)),
+                std::memory_order_release);
+            version_.fetch_add(1, std::memory_order_release);
+        }
+
+      private:
+        /// \brief Current version of the front
+        /// Always accessed with the atomic shared_ptr functions
+        snapshot_type current_;
+
+        /// \brief Number of versions published
+        std::atomic<size_type> version_{0};
+
+        /// \brief Serializes writers
+        std::mutex writer_mutex_;
+
+        /// \brief Changes waiting for the next flush
+        std::vector<std::function<void(front_type &)>> deferred_;
+    };
+} // namespace pareto
+
+#endif // PARETO_CONCURRENT_FRONT_H
@@ -0,0 +1,218 @@
+#ifndef PARETO_CONCURRENT_SPATIAL_MAP_H
+#define PARETO_CONCURRENT_SPATIAL_MAP_H
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include <pareto/spatial_map.h>
+
+namespace pareto {
+    /// \brief Spatial map that many threads can update and query
+    /// The elements are distributed over shards by the hash of their keys.
+    /// Each shard is a spatial_map with its own reader/writer lock, so
+    /// threads inserting elements in different shards never wait for each
+    /// other, and queries only wait for writers of the shard they are
+    /// visiting. There is no global lock.
+    ///
+    /// Iterators into the shards would be invalidated by other threads,
+    /// so queries return copies of the elements they find.
+    ///
+    /// \tparam K Number/key type
+    /// \tparam M Number of dimensions
+    /// \tparam T Element/mapped type
+    /// \tparam C Comparison function type in one dimension
+    /// \tparam A Allocator type
+    template <class K, size_t M, class T, typename C = std::less<K>,
+              class A = default_allocator_type<std::pair<const point<K, M>, T>>>
+    class concurrent_spatial_map {
+      public /* Types */:
+        using map_type = spatial_map<K, M, T, C, A>;
+        using key_type = typename map_type::key_type;
+        using mapped_type = typename map_type::mapped_type;
+        using value_type = typename map_type::value_type;
+        using size_type = typename map_type::size_type;
+        using box_type = typename map_type::box_type;
+        using result_type =
+            std::vector<std::pair<key_type, mapped_type>>;
+
+      public /* Constructors */:
+        /// \brief Create a map with one shard per hardware thread
+        concurrent_spatial_map()
+            : concurrent_spatial_map(std::thread::hardware_concurrency()) {}
+
+        /// \brief Create a map with a number of shards
+        /// More shards mean less contention between writers, but every
+        /// query visits all shards.
+        explicit concurrent_spatial_map(size_t number_of_shards)
+            : shards_(std::max(number_of_shards, size_t(1))) {}
+
+        /// \brief Concurrent maps are not copyable
+        concurrent_spatial_map(const concurrent_spatial_map &) = delete;
+
+        /// \brief Concurrent maps are not copyable
+        concurrent_spatial_map &
+        operator=(const concurrent_spatial_map &) = delete;
+
+        /// \brief Destructor
+        ~concurrent_spatial_map() = default;
+
+      public /* Capacity */:
+        /// \brief Number of elements in all shards
+        /// Other threads might be changing the shards while we count
+        [[nodiscard]] size_type size() const {
+            size_type n = 0;
+            for (const shard &s : shards_) {
+                std::shared_lock lock(s.mutex);
+                n += s.map.size();
+            }
+            return n;
+        }
+
+        /// \brief True if all shards are empty
+        [[nodiscard]] bool empty() const { return size() == 0; }
+
+        /// \brief Number of shards
+        [[nodiscard]] size_t number_of_shards() const noexcept {
+            return shards_.size();
+        }
+
+      public /* Modifiers */:
+        /// \brief Insert an element
+        /// Only the shard of the element is locked
+        void insert(const value_type &v) {
+            shard &s = shard_of(v.first);
+            std::unique_lock lock(s.mutex);
+            s.map.insert(v);
+        }
+
+        /// \brief Insert a list of elements
+        /// Each shard is locked once for all its elements
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            std::vector<std::vector<value_type>> batches(shards_.size());
+            for (; first != last; ++first) {
+                batches[shard_index(first->first)].emplace_back(*first);
+            }
+            for (size_t i = 0; i < batches.size(); ++i) {
+                if (!batches[i].empty()) {
+                    std::unique_lock lock(shards_[i].mutex);
+                    shards_[i].map.insert(batches[i].begin(),
+                                          batches[i].end());
+                }
+            }
+        }
+
+        /// \brief Erase all elements with key k
+        /// \return Number of elements erased
+        size_type erase(const key_type &k) {
+            shard &s = shard_of(k);
+            std::unique_lock lock(s.mutex);
+            return s.map.erase(k);
+        }
+
+        /// \brief Erase all elements
+        void clear() {
+            for (shard &s : shards_) {
+                std::unique_lock lock(s.mutex);
+                s.map.clear();
+            }
+        }
+
+      public /* Lookup */:
+        /// \brief True if there is an element with key k
+        bool contains(const key_type &k) const {
+            const shard &s = shard_of(k);
+            std::shared_lock lock(s.mutex);
+            return s.map.find(k) != s.map.end();
+        }
+
+        /// \brief Copies of the elements intersecting a query box
+        result_type find_intersection(const key_type &lb,
+                                      const key_type &ub) const {
+            return collect([&](const map_type &m) {
+                return m.find_intersection(lb, ub);
+            });
+        }
+
+        /// \brief Copies of the elements within a query box
+        result_type find_within(const key_type &lb, const key_type &ub) const {
+            return collect(
+                [&](const map_type &m) { return m.find_within(lb, ub); });
+        }
+
+        /// \brief Copies of the elements disjoint from a query box
+        result_type find_disjoint(const key_type &lb,
+                                  const key_type &ub) const {
+            return collect(
+                [&](const map_type &m) { return m.find_disjoint(lb, ub); });
+        }
+
+        /// \brief Copies of the k elements closest to a point
+        /// Each shard finds its k nearest elements and we keep the k
+        /// nearest among them, from the closest to the farthest.
+        result_type find_nearest(const key_type &p, size_t k = 1) const {
+            result_type r = collect(
+                [&](const map_type &m) { return m.find_nearest(p, k); });
+            auto closer = [&p](const auto &a, const auto &b) {
+                return a.first.distance(p) < b.first.distance(p);
+            };
+            if (r.size() > k) {
+                std::partial_sort(r.begin(),
+                                  r.begin() + static_cast<std::ptrdiff_t>(k),
+                                  r.end(), closer);
+                r.resize(k);
+            } else {
+                std::sort(r.begin(), r.end(), closer);
+            }
+            return r;
+        }
+
+      private /* Internal types */:
+        /// \brief A spatial map and the lock protecting it
+        struct shard {
+            mutable std::shared_mutex mutex;
+            map_type map;
+        };
+
+      private /* Internal functions */:
+        /// \brief Shard where the elements with key k are
+        size_t shard_index(const key_type &k) const {
+            size_t h = 0;
+            for (const auto &x : k) {
+                // keys equal to zero and negative zero have to match
+                const K y = x == K() ? K() : x;
+                h ^= std::hash<K>()(y) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            }
+            return h % shards_.size();
+        }
+
+        shard &shard_of(const key_type &k) { return shards_[shard_index(k)]; }
+
+        const shard &shard_of(const key_type &k) const {
+            return shards_[shard_index(k)];
+        }
+
+        /// \brief Run a query in each shard and copy the results
+        template <class QUERY_FUNCTION>
+        result_type collect(QUERY_FUNCTION query) const {
+            result_type r;
+            for (const shard &s : shards_) {
+                std::shared_lock lock(s.mutex);
+                for (auto it = query(s.map); it != s.map.end(); ++it) {
+                    r.emplace_back(it->first, it->second);
+                }
+            }
+            return r;
+        }
+
+      private:
+        /// \brief Shards with the elements
+        std::vector<shard> shards_;
+    };
+} // namespace pareto
+
+#endif // PARETO_CONCURRENT_SPATIAL_MAP_H
@@ -1,13 +1,14 @@
 #ifndef PARETO_FRONTS_PARETO_FRONT_RTREE_H
 #define PARETO_FRONTS_PARETO_FRONT_RTREE_H
 
+#include <algorithm>
 #include <initializer_list>
 #include <map>
 #include <memory>
-#include <mutex>
 #include <optional>
 #include <ostream>
 #include <random>
+#include <set>
 #include <thread>
 
 #include <pareto/common/common.h>
@@ -16,6 +17,7 @@
 #include <pareto/common/metaprogramming.h>
 #include <pareto/common/promote_to_floating_point.h>
 
+#include <pareto/frozen_kd_tree.h>
 #include <pareto/spatial_map.h>
 
 #ifdef BUILD_BOOST_TREE
@@ -38,7 +40,7 @@ namespace pareto {
     /// \note See other container adaptors such as stack
     /// \see https://en.cppreference.com/w/cpp/container/stack
     template <typename K, size_t M, typename T,
-              class Container = spatial_map<K, M, T>>
+              class Container = front_map<K, M, T>>
     class front {
       public /* SpatialAdapter Concept */:
         using container_type = Container;
@@ -83,6 +85,8 @@ namespace pareto {
             typename container_type::predicate_list_type;
 
       public /* ParetoConcept */:
+        using direction_mask_type =
+            detail::direction_mask<number_of_compile_dimensions>;
         using directions_type = std::conditional_t<
             number_of_compile_dimensions == 0, std::vector<uint8_t>,
             std::array<uint8_t, number_of_compile_dimensions>>;
@@ -116,11 +120,17 @@ namespace pareto {
         /// on the allocator of the container being copied.
         /// \param rhs
         front(const front &rhs)
-            : data_(rhs.data_), is_minimization_(rhs.is_minimization_){};
+            : data_(rhs.data_), is_minimization_(rhs.is_minimization_),
+              direction_mask_(rhs.direction_mask_),
+              extremes_(rhs.extremes_), contributions_(rhs.contributions_),
+              grid_(rhs.grid_){};
 
         /// \brief Copy constructor data but use another allocator
         front(const front &rhs, const allocator_type &alloc)
-            : data_(rhs.data_, alloc), is_minimization_(rhs.is_minimization_){};
+            : data_(rhs.data_, alloc), is_minimization_(rhs.is_minimization_),
+              direction_mask_(rhs.direction_mask_),
+              extremes_(rhs.extremes_), contributions_(rhs.contributions_),
+              grid_(rhs.grid_){};
 
         /// \brief Move constructor
         /// Move constructors obtain their instances of allocators
@@ -128,12 +138,20 @@ namespace pareto {
         /// the old container
         front(front &&rhs) noexcept
             : data_(std::move(rhs.data_)),
-              is_minimization_(std::move(rhs.is_minimization_)) {}
+              is_minimization_(std::move(rhs.is_minimization_)),
+              direction_mask_(rhs.direction_mask_),
+              extremes_(std::move(rhs.extremes_)),
+              contributions_(std::move(rhs.contributions_)),
+              grid_(std::move(rhs.grid_)) {}
 
         /// \brief Move constructor data but use new allocator
         front(front &&rhs, const allocator_type &alloc) noexcept
             : data_(std::move(rhs.data_), alloc),
-              is_minimization_(std::move(rhs.is_minimization_)) {}
+              is_minimization_(std::move(rhs.is_minimization_)),
+              direction_mask_(rhs.direction_mask_),
+              extremes_(std::move(rhs.extremes_)),
+              contributions_(std::move(rhs.contributions_)),
+              grid_(std::move(rhs.grid_)) {}
 
         /// \brief Destructor
         ~front() = default;
@@ -353,6 +371,16 @@ namespace pareto {
         front(std::initializer_list<bool> il_dir, const allocator_type &alloc)
             : front({}, il_dir, alloc) {}
 
+      private /* Constructors: Freezing */:
+        /// \brief Construct from a container whose elements are a front
+        /// freeze() uses this to copy the elements to another container
+        /// type without checking dominance again.
+        front(container_type &&data, const directions_type &is_minimization)
+            : data_(std::move(data)), is_minimization_(is_minimization) {
+            update_direction_mask();
+            update_all_extremes();
+        }
+
       public /* Non-Modifying Functions: AllocatorAwareContainer */:
         /// \brief Obtains a copy of the allocator
         /// The accessor get_allocator() obtains a copy of
@@ -378,6 +406,10 @@ namespace pareto {
             }
             data_ = rhs.data_;
             is_minimization_ = rhs.is_minimization_;
+            direction_mask_ = rhs.direction_mask_;
+            extremes_ = rhs.extremes_;
+            contributions_ = rhs.contributions_;
+            grid_ = rhs.grid_;
             return *this;
         };
 
@@ -398,13 +430,17 @@ namespace pareto {
             }
             data_ = std::move(rhs.data_);
             is_minimization_ = std::move(rhs.is_minimization_);
+            direction_mask_ = rhs.direction_mask_;
+            extremes_ = std::move(rhs.extremes_);
+            contributions_ = std::move(rhs.contributions_);
+            grid_ = std::move(rhs.grid_);
             return *this;
         }
 
       public /* Assignment: AssociativeContainer */:
         /// \brief Initializer list assignment
         front &operator=(std::initializer_list<value_type> il) noexcept {
-            data_.clear();
+            clear();
             insert(il.begin(), il.end());
             return *this;
         }
@@ -580,13 +616,21 @@ namespace pareto {
         }
 
         /// \brief Get maximum value in a given dimension
+        /// The extreme values are cached, so this is O(1)
         dimension_type max_value(size_t dimension) const {
-            return data_.max_value(dimension);
+            if (empty()) {
+                return data_.max_value(dimension);
+            }
+            return extremes_.upper[dimension];
         }
 
         /// \brief Get minimum value in a given dimension
+        /// The extreme values are cached, so this is O(1)
         dimension_type min_value(size_t dimension) const {
-            return data_.min_value(dimension);
+            if (empty()) {
+                return data_.min_value(dimension);
+            }
+            return extremes_.lower[dimension];
         }
 
       public /* Reference points / Pareto Concept */:
@@ -601,7 +645,7 @@ namespace pareto {
 
         /// \brief Ideal value in a front dimension
         dimension_type ideal(size_t d) const {
-            return is_minimization(d) ? data_.min_value(d) : data_.max_value(d);
+            return is_minimization(d) ? min_value(d) : max_value(d);
         }
 
         /// \brief The nadir point is the worst point among the
@@ -618,7 +662,7 @@ namespace pareto {
 
         /// \brief Nadir value in dimension d
         dimension_type nadir(size_t d) const {
-            return is_minimization(d) ? data_.max_value(d) : data_.min_value(d);
+            return is_minimization(d) ? max_value(d) : min_value(d);
         }
 
         /// \brief Worst point in the front
@@ -668,6 +712,80 @@ namespace pareto {
             }
         }
 
+      private /* Reference points */:
+        /// \brief Minimum and maximum values in each dimension
+        /// The ideal and nadir points are taken from these values.
+        /// They are only meaningful while the front is not empty.
+        struct extremes_cache {
+            point_type lower;
+            point_type upper;
+        };
+
+        /// \brief Include a new element in the extreme values
+        /// This costs O(m)
+        void update_extremes_after_insert(const point_type &p) {
+            if (size() == 1) {
+                extremes_.lower = p;
+                extremes_.upper = p;
+                return;
+            }
+            for (size_t i = 0; i < p.dimensions(); ++i) {
+                if (p[i] < extremes_.lower[i]) {
+                    extremes_.lower[i] = p[i];
+                }
+                if (extremes_.upper[i] < p[i]) {
+                    extremes_.upper[i] = p[i];
+                }
+            }
+        }
+
+        /// \brief Update the extreme values after erasing some elements
+        /// We only ask the container for the new extremes in the
+        /// dimensions where an erased element was an extreme.
+        template <class PointIterator>
+        void update_extremes_after_erase(PointIterator first,
+                                         PointIterator last) {
+            if (empty() || first == last) {
+                return;
+            }
+            const size_t m = extremes_.lower.dimensions();
+            std::vector<uint8_t> lower_changed(m, 0);
+            std::vector<uint8_t> upper_changed(m, 0);
+            for (; first != last; ++first) {
+                const point_type &p = *first;
+                for (size_t i = 0; i < m; ++i) {
+                    lower_changed[i] |= !(extremes_.lower[i] < p[i]);
+                    upper_changed[i] |= !(p[i] < extremes_.upper[i]);
+                }
+            }
+            for (size_t i = 0; i < m; ++i) {
+                if (lower_changed[i]) {
+                    extremes_.lower[i] = data_.min_value(i);
+                }
+                if (upper_changed[i]) {
+                    extremes_.upper[i] = data_.max_value(i);
+                }
+            }
+        }
+
+        /// \brief Update the extreme values after erasing one element
+        void update_extremes_after_erase(const point_type &p) {
+            update_extremes_after_erase(&p, &p + 1);
+        }
+
+        /// \brief Recalculate all extreme values from the container
+        void update_all_extremes() {
+            if (empty()) {
+                return;
+            }
+            extremes_.lower = data_.begin()->first;
+            extremes_.upper = data_.begin()->first;
+            for (size_t i = 0; i < extremes_.lower.dimensions(); ++i) {
+                extremes_.lower[i] = data_.min_value(i);
+                extremes_.upper[i] = data_.max_value(i);
+            }
+        }
+
       public /* Non-Modifying Functions / Dominance / Pareto Concept */:
         /// \brief Check if this front weakly dominates a point
         /// A front a weakly dominates a solution p if it has at least
@@ -682,25 +800,7 @@ namespace pareto {
             if (empty()) {
                 return false;
             }
-
-            // trivial case: p is not behind ideal
-            point_type ideal_point = ideal();
-            const bool p_is_not_behind_ideal =
-                !ideal_point.dominates(p, is_minimization_);
-            if (p_is_not_behind_ideal) {
-                return false;
-            }
-
-            // trivial case: p is in the front
-            if (find(p) != end()) {
-                return false;
-            }
-
-            // general case (removing trivial case 1)
-            // points intersecting(ideal,p)
-            const_iterator first_element_that_dominates =
-                data_.find_intersection(ideal_point, p);
-            return first_element_that_dominates != end();
+            return dominates(p, ideal());
         }
 
         /// \brief Check if this front strongly dominates a point
@@ -774,7 +874,7 @@ namespace pareto {
             }
 
             auto ideal_point = ideal();
-            return p.dominates(ideal_point, is_minimization_);
+            return p.dominates(ideal_point, dominance_directions());
         }
 
         /// \brief Check if this front non-dominates the point
@@ -858,7 +958,7 @@ namespace pareto {
             }
 
             // trivial case: p's ideal point doesn't dominate this ideal point
-            if (!p.ideal().dominates(this->ideal(), is_minimization_)) {
+            if (!p.ideal().dominates(this->ideal(), dominance_directions())) {
                 return false;
             }
 
@@ -899,38 +999,574 @@ namespace pareto {
         /// \param reference_point Reference point
         /// \return Hypervolume of this front
         dimension_type hypervolume(point_type reference_point) const {
+            hypervolume_workspace workspace;
+            return hypervolume(reference_point, workspace);
+        }
+
+        /// \brief Get exact hypervolume with a given algorithm
+        /// \param reference_point Reference point
+        /// \param algorithm Algorithm for the exact hypervolume
+        /// \return Hypervolume of this front
+        dimension_type hypervolume(point_type reference_point,
+                                   hypervolume_algorithm algorithm) const {
+            hypervolume_workspace workspace;
+            return hypervolume(reference_point, workspace, algorithm);
+        }
+
+        /// \brief Get exact hypervolume reusing the memory in a workspace
+        /// Each thread should have its own workspace. Reusing the
+        /// workspace avoids allocations when we calculate the
+        /// hypervolume of many fronts.
+        /// \param reference_point Reference point
+        /// \param workspace Memory for the hypervolume algorithm
+        /// \param algorithm Algorithm for the exact hypervolume
+        /// \return Hypervolume of this front
+        dimension_type
+        hypervolume(point_type reference_point,
+                    hypervolume_workspace &workspace,
+                    hypervolume_algorithm algorithm =
+                        hypervolume_algorithm::automatic) const {
+            // two and three dimensions have their own sweeps, which
+            // only need the points in the workspace
+            if (algorithm == hypervolume_algorithm::automatic) {
+                if (dimensions() == 2) {
+                    return hypervolume_sweep(reference_point,
+                                             workspace.points_2d);
+                }
+                if (dimensions() == 3) {
+                    return hypervolume_sweep(reference_point,
+                                             workspace.points_3d);
+                }
+            }
+
             // reshape points
             std::vector<double> data;
             data.reserve(size() * dimensions());
             for (const auto &[k, v] : *this) {
-                point<double, point_type::compile_dimensions,
-                      typename point_type::coordinate_system_t>
-                    inv(k.size());
                 for (size_t i = 0; i < dimensions(); ++i) {
                     if (is_minimization(i)) {
-                        inv[i] = k[i];
+                        data.emplace_back(k[i]);
                     } else {
-                        inv[i] = -k[i];
+                        data.emplace_back(-k[i]);
                     }
                 }
-                data.insert(data.end(), inv.begin(), inv.end());
             }
-            point_type inv_ref = reference_point;
+            std::vector<double> v_ref(reference_point.begin(),
+                                      reference_point.end());
             for (size_t i = 0; i < dimensions(); ++i) {
                 if (!is_minimization(i)) {
-                    inv_ref[i] = -inv_ref[i];
+                    v_ref[i] = -v_ref[i];
                 }
             }
-            std::vector<double> v_ref(inv_ref.begin(), inv_ref.end());
             int n = static_cast<int>(size());
             int d = static_cast<int>(dimensions());
-            static std::mutex hv_mutex;
-            hv_mutex.lock();
-            double hv = fpli_hv(data.data(), d, n, v_ref.data());
-            hv_mutex.unlock();
-            return hv;
+            const bool use_wfg =
+                algorithm == hypervolume_algorithm::wfg ||
+                (algorithm == hypervolume_algorithm::automatic && d > 5);
+            if (use_wfg) {
+                return wfg_hv(data.data(), d, n, v_ref.data(), workspace);
+            }
+            return fpli_hv(data.data(), d, n, v_ref.data(), workspace);
         }
 
+        /// \brief Hypervolume contribution of each element from the nadir
+        /// \see hypervolume_contributions(const point_type &)
+        std::vector<dimension_type> hypervolume_contributions() const {
+            return hypervolume_contributions(nadir());
+        }
+
+        /// \brief Hypervolume contribution of each element
+        /// The contribution of an element is the hypervolume the front
+        /// loses if we remove the element. In two and three dimensions,
+        /// all contributions are calculated in a single O(n log n) sweep.
+        /// In more dimensions, the contribution of each element only
+        /// needs the hypervolume of the other elements limited by it.
+        /// Both are much faster than calculating the hypervolume of the
+        /// front without each element.
+        /// \param reference_point Reference point
+        /// \return Contributions in the same order as the elements
+        std::vector<dimension_type>
+        hypervolume_contributions(const point_type &reference_point) const {
+            if (!is_tracking_contributions(reference_point)) {
+                return calculate_contributions(reference_point);
+            }
+            std::vector<dimension_type> r;
+            r.reserve(size());
+            for (const auto &[k, v] : *this) {
+                r.emplace_back(contributions_.values.find(k)->second);
+            }
+            return r;
+        }
+
+        /// \brief Hypervolume contribution of an element from the nadir
+        dimension_type hypervolume_contribution(const_iterator element) const {
+            return hypervolume_contribution(element, nadir());
+        }
+
+        /// \brief Hypervolume contribution of an element
+        /// This only calculates the hypervolume of the other elements
+        /// limited by this element, so it's also much faster than
+        /// calculating the hypervolume of the front twice.
+        /// \param element Element in the front
+        /// \param reference_point Reference point
+        dimension_type
+        hypervolume_contribution(const_iterator element,
+                                 const point_type &reference_point) const {
+            if (is_tracking_contributions(reference_point)) {
+                return contributions_.values.find(element->first)->second;
+            }
+            return exclusive_contribution(element->first, reference_point);
+        }
+
+        /// \brief Keep the hypervolume contributions up to date
+        /// The contributions for this reference point are cached and
+        /// the other functions return them without any calculation.
+        /// Inserting or erasing an element only updates the elements
+        /// whose exclusive hypervolume overlaps the hypervolume of
+        /// the element, which are usually just its neighbours.
+        /// Inserting or erasing ranges of elements updates all
+        /// contributions.
+        /// \param reference_point Reference point
+        void
+        track_hypervolume_contributions(const point_type &reference_point) {
+            contributions_.is_tracking = true;
+            contributions_.reference_point = reference_point;
+            update_all_contributions();
+        }
+
+        /// \brief Stop keeping the hypervolume contributions
+        void untrack_hypervolume_contributions() {
+            contributions_.is_tracking = false;
+            contributions_.values.clear();
+        }
+
+        /// \brief Check if we are keeping the hypervolume contributions
+        [[nodiscard]] bool is_tracking_hypervolume_contributions() const {
+            return contributions_.is_tracking;
+        }
+
+        /// \brief Element with the least hypervolume contribution
+        /// This is the element SMS-EMOA removes when the population is
+        /// too large. If we are tracking the contributions for this
+        /// reference point, we only look for the least cached value.
+        /// \param reference_point Reference point
+        const_iterator
+        least_contributor(const point_type &reference_point) const {
+            if (empty()) {
+                return end();
+            }
+            if (is_tracking_contributions(reference_point)) {
+                auto it = std::min_element(
+                    contributions_.values.begin(), contributions_.values.end(),
+                    [](const auto &a, const auto &b) {
+                        return a.second < b.second;
+                    });
+                return find(it->first);
+            }
+            auto c = calculate_contributions(reference_point);
+            auto it = std::min_element(c.begin(), c.end());
+            return std::next(begin(), std::distance(c.begin(), it));
+        }
+
+        /// \brief Keep the elements in the cells of a grid
+        /// The grid divides the box between the minimum and maximum
+        /// values of the front into hypercube cells with the given number
+        /// of divisions per dimension. We keep the elements of each cell
+        /// and the cells sorted by how many elements they have.
+        /// Inserting or erasing an element only moves it in or out of
+        /// its cell, which costs O(log n). If this changes the minimum
+        /// or maximum values, all elements move to the new grid.
+        /// \param divisions Number of divisions per dimension
+        void track_grid_crowding(size_t divisions) {
+            grid_.is_tracking = true;
+            grid_.divisions = std::max(divisions, size_t{1});
+            update_all_grid_cells();
+        }
+
+        /// \brief Stop keeping the grid cells
+        void untrack_grid_crowding() {
+            grid_.is_tracking = false;
+            grid_.cells.clear();
+            grid_.crowding.clear();
+        }
+
+        /// \brief Check if we are keeping the grid cells
+        [[nodiscard]] bool is_tracking_grid_crowding() const {
+            return grid_.is_tracking;
+        }
+
+        /// \brief Number of divisions per dimension of the grid we keep
+        [[nodiscard]] size_t grid_divisions() const {
+            return grid_.is_tracking ? grid_.divisions : 0;
+        }
+
+        /// \brief Element in the grid cell with most elements
+        /// This is the element grid-based archives remove when they are
+        /// too large. It requires track_grid_crowding.
+        const_iterator most_crowded_element() const {
+            if (!grid_.is_tracking || grid_.crowding.empty()) {
+                return end();
+            }
+            const auto &cell = std::prev(grid_.crowding.end())->second;
+            return find(grid_.cells.find(cell)->second.back());
+        }
+
+      private /* Indicators */:
+        /// \brief Exact hypervolume with the sweep for D dimensions
+        /// \param points Buffer for the points as minimization
+        template <size_t D>
+        dimension_type
+        hypervolume_sweep(const point_type &reference_point,
+                          std::vector<std::array<double, D>> &points) const {
+            points.clear();
+            points.reserve(size());
+            for (const auto &[k, v] : *this) {
+                std::array<double, D> &p = points.emplace_back();
+                for (size_t i = 0; i < D; ++i) {
+                    p[i] = is_minimization(i) ? k[i] : -k[i];
+                }
+            }
+            std::array<double, D> ref;
+            for (size_t i = 0; i < D; ++i) {
+                ref[i] = is_minimization(i) ? reference_point[i]
+                                            : -reference_point[i];
+            }
+            if constexpr (D == 2) {
+                return hv_2d(points, ref.data());
+            } else {
+                return hv_3d(points, ref.data());
+            }
+        }
+
+      private /* Hypervolume contributions */:
+        /// \brief Lexicographic order of points
+        struct lexicographic_less {
+            bool operator()(const point_type &a, const point_type &b) const {
+                return std::lexicographical_compare(a.begin(), a.end(),
+                                                    b.begin(), b.end());
+            }
+        };
+
+        /// \brief Contribution of each point for a reference point
+        struct contribution_cache {
+            bool is_tracking{false};
+            point_type reference_point;
+            std::multimap<point_type, dimension_type, lexicographic_less>
+                values;
+        };
+
+        using cache_iterator =
+            typename std::multimap<point_type, dimension_type,
+                                   lexicographic_less>::iterator;
+
+        /// \brief Check if we cache the contributions for this reference
+        bool
+        is_tracking_contributions(const point_type &reference_point) const {
+            return contributions_.is_tracking &&
+                   contributions_.reference_point == reference_point;
+        }
+
+        /// \brief Append the coordinates of p as minimization
+        void append_minimization(const point_type &p,
+                                 std::vector<double> &data) const {
+            for (size_t i = 0; i < p.dimensions(); ++i) {
+                const auto x = static_cast<double>(p[i]);
+                data.emplace_back(is_minimization(i) ? x : -x);
+            }
+        }
+
+        /// \brief Calculate the contribution of each element at once
+        std::vector<dimension_type>
+        calculate_contributions(const point_type &reference_point) const {
+            std::vector<dimension_type> r;
+            r.reserve(size());
+            std::vector<double> data;
+            data.reserve(size() * dimensions());
+            for (const auto &[k, v] : *this) {
+                append_minimization(k, data);
+            }
+            std::vector<double> ref;
+            append_minimization(reference_point, ref);
+            std::vector<double> contributions(size());
+            hypervolume_workspace workspace;
+            hv_contributions(data.data(), static_cast<int>(dimensions()),
+                             static_cast<int>(size()), ref.data(),
+                             contributions.data(), workspace);
+            for (double c : contributions) {
+                r.emplace_back(static_cast<dimension_type>(c));
+            }
+            return r;
+        }
+
+        /// \brief Hypervolume only p dominates in this front
+        /// If the front has copies of p, we only exclude one of them
+        dimension_type
+        exclusive_contribution(const point_type &p,
+                               const point_type &reference_point) const {
+            std::vector<double> others;
+            others.reserve(size() * dimensions());
+            bool is_excluded = false;
+            for (const auto &[k, v] : *this) {
+                if (!is_excluded && k == p) {
+                    is_excluded = true;
+                } else {
+                    append_minimization(k, others);
+                }
+            }
+            std::vector<double> x;
+            append_minimization(p, x);
+            std::vector<double> ref;
+            append_minimization(reference_point, ref);
+            const int d = static_cast<int>(x.size());
+            const int n = static_cast<int>(others.size() / x.size());
+            hypervolume_workspace workspace;
+            return static_cast<dimension_type>(hv_contribution(
+                x.data(), others.data(), d, n, ref.data(), workspace));
+        }
+
+        /// \brief Hypervolume only an element in the cache dominates
+        /// The cache has all elements, and it's faster to iterate
+        dimension_type cached_exclusive_contribution(cache_iterator q) const {
+            std::vector<double> others;
+            others.reserve(size() * dimensions());
+            for (auto it = contributions_.values.begin();
+                 it != contributions_.values.end(); ++it) {
+                if (it != q) {
+                    append_minimization(it->first, others);
+                }
+            }
+            std::vector<double> x;
+            append_minimization(q->first, x);
+            std::vector<double> ref;
+            append_minimization(contributions_.reference_point, ref);
+            const int d = static_cast<int>(x.size());
+            const int n = static_cast<int>(others.size() / x.size());
+            hypervolume_workspace workspace;
+            return static_cast<dimension_type>(hv_contribution(
+                x.data(), others.data(), d, n, ref.data(), workspace));
+        }
+
+        /// \brief Recalculate all cached contributions
+        void update_all_contributions() {
+            contributions_.values.clear();
+            if (empty()) {
+                return;
+            }
+            std::vector<dimension_type> c =
+                calculate_contributions(contributions_.reference_point);
+            auto c_it = c.begin();
+            for (const auto &[k, v] : *this) {
+                contributions_.values.emplace(k, *c_it);
+                ++c_it;
+            }
+        }
+
+        /// \brief Remove the cached contribution of one copy of p
+        void forget_contribution(const point_type &p) {
+            auto it = contributions_.values.find(p);
+            if (it != contributions_.values.end()) {
+                contributions_.values.erase(it);
+            }
+        }
+
+        /// \brief Update the contributions that overlap the hypervolume of p
+        /// The hypervolume p and q dominate together is the box between
+        /// their worst coordinates and the reference point. The exclusive
+        /// hypervolume of q overlaps this box unless another element s
+        /// weakly dominates its corner, which happens iff the corner of
+        /// s and p weakly dominates the corner of q and p. So we only
+        /// update the elements whose corners with p are non-dominated.
+        /// \note The cache should not have the points p dominates
+        /// \param self Entry of p in the cache, if any
+        void update_overlapping_contributions(const point_type &p,
+                                              cache_iterator self) {
+            struct corner_type {
+                point_type corner;
+                cache_iterator element;
+                bool is_covered;
+            };
+            const point_type &ref = contributions_.reference_point;
+            std::vector<corner_type> corners;
+            for (auto it = contributions_.values.begin();
+                 it != contributions_.values.end(); ++it) {
+                if (it == self) {
+                    continue;
+                }
+                point_type corner = it->first;
+                bool dominates_ref = true;
+                for (size_t i = 0; i < corner.dimensions(); ++i) {
+                    if (is_minimization(i)) {
+                        corner[i] = std::max(p[i], corner[i]);
+                        dominates_ref = dominates_ref && corner[i] < ref[i];
+                    } else {
+                        corner[i] = std::min(p[i], corner[i]);
+                        dominates_ref = dominates_ref && corner[i] > ref[i];
+                    }
+                }
+                if (!dominates_ref) {
+                    continue;
+                }
+                bool is_dominated = false;
+                for (size_t k = 0; k < corners.size();) {
+                    if (corners[k].corner == corner) {
+                        corners[k].is_covered = true;
+                        is_dominated = true;
+                        break;
+                    }
+                    if (corners[k].corner.dominates(corner,
+                                                    dominance_directions())) {
+                        is_dominated = true;
+                        break;
+                    }
+                    if (corner.dominates(corners[k].corner,
+                                         dominance_directions())) {
+                        corners[k] = std::move(corners.back());
+                        corners.pop_back();
+                    } else {
+                        ++k;
+                    }
+                }
+                if (!is_dominated) {
+                    corners.push_back({std::move(corner), it, false});
+                }
+            }
+            for (const corner_type &c : corners) {
+                if (!c.is_covered) {
+                    c.element->second =
+                        cached_exclusive_contribution(c.element);
+                }
+            }
+        }
+
+        /// \brief Update the cached contributions after p is inserted
+        /// The points p dominates were already removed from the cache
+        void update_contributions_after_insert(const point_type &p) {
+            if (!contributions_.is_tracking) {
+                return;
+            }
+            auto self = contributions_.values.emplace(p, dimension_type{0});
+            update_overlapping_contributions(p, self);
+            self->second = cached_exclusive_contribution(self);
+        }
+
+        /// \brief Update the cached contributions after p is erased
+        void update_contributions_after_erase(const point_type &p) {
+            update_overlapping_contributions(p, contributions_.values.end());
+        }
+
+      private /* Grid crowding */:
+        /// \brief Elements in each cell of a grid over the front
+        /// The grid is the box between lower and upper, which are
+        /// the extreme values of the front when we placed the elements.
+        struct grid_cache {
+            bool is_tracking{false};
+            size_t divisions{0};
+            point_type lower;
+            point_type upper;
+            std::map<std::vector<size_t>, std::vector<point_type>> cells;
+            /// Number of elements and cell, from least to most crowded
+            std::set<std::pair<size_t, std::vector<size_t>>> crowding;
+        };
+
+        /// \brief Cell of a point in the grid
+        std::vector<size_t> grid_cell(const point_type &p) const {
+            std::vector<size_t> cell(p.dimensions());
+            for (size_t j = 0; j < p.dimensions(); ++j) {
+                const auto width =
+                    static_cast<double>(grid_.upper[j] - grid_.lower[j]);
+                const double x =
+                    width > 0.
+                        ? static_cast<double>(p[j] - grid_.lower[j]) / width
+                        : 0.;
+                const auto d = static_cast<double>(grid_.divisions);
+                cell[j] = std::min(static_cast<size_t>(x * d),
+                                   grid_.divisions - 1);
+            }
+            return cell;
+        }
+
+        /// \brief Place a point in its grid cell
+        void add_to_grid(const point_type &p) {
+            std::vector<size_t> cell = grid_cell(p);
+            std::vector<point_type> &elements = grid_.cells[cell];
+            if (!elements.empty()) {
+                grid_.crowding.erase({elements.size(), cell});
+            }
+            elements.emplace_back(p);
+            grid_.crowding.emplace(elements.size(), std::move(cell));
+        }
+
+        /// \brief Remove one copy of a point from its grid cell
+        void remove_from_grid(const point_type &p) {
+            std::vector<size_t> cell = grid_cell(p);
+            auto cell_it = grid_.cells.find(cell);
+            if (cell_it == grid_.cells.end()) {
+                return;
+            }
+            std::vector<point_type> &elements = cell_it->second;
+            auto it = std::find(elements.begin(), elements.end(), p);
+            if (it == elements.end()) {
+                return;
+            }
+            grid_.crowding.erase({elements.size(), cell});
+            *it = std::move(elements.back());
+            elements.pop_back();
+            if (elements.empty()) {
+                grid_.cells.erase(cell_it);
+            } else {
+                grid_.crowding.emplace(elements.size(), std::move(cell));
+            }
+        }
+
+        /// \brief Check if the extreme values moved since we placed the
+        /// elements in the grid
+        bool grid_is_outdated() const {
+            return grid_.lower != extremes_.lower ||
+                   grid_.upper != extremes_.upper;
+        }
+
+        /// \brief Place all elements in a grid over the current extremes
+        void update_all_grid_cells() {
+            grid_.cells.clear();
+            grid_.crowding.clear();
+            grid_.lower = extremes_.lower;
+            grid_.upper = extremes_.upper;
+            if (empty()) {
+                return;
+            }
+            for (const auto &[k, v] : *this) {
+                add_to_grid(k);
+            }
+        }
+
+        /// \brief Update the grid cells after p is inserted
+        void update_grid_after_insert(const point_type &p) {
+            if (!grid_.is_tracking) {
+                return;
+            }
+            if (grid_is_outdated()) {
+                update_all_grid_cells();
+            } else {
+                add_to_grid(p);
+            }
+        }
+
+        /// \brief Update the grid cells after some points are erased
+        template <class PointIterator>
+        void update_grid_after_erase(PointIterator first, PointIterator last) {
+            if (!grid_.is_tracking || first == last) {
+                return;
+            }
+            if (empty() || grid_is_outdated()) {
+                update_all_grid_cells();
+            } else {
+                for (; first != last; ++first) {
+                    remove_from_grid(*first);
+                }
+            }
+        }
+
+      public /* Indicators / Pareto Concept */:
         /// \brief Get hypervolume with monte-carlo simulation
         dimension_type hypervolume(size_t sample_size) const {
             return hypervolume(sample_size, nadir());
@@ -1348,11 +1984,20 @@ namespace pareto {
         void swap(front &other) noexcept {
             other.data_.swap(data_);
             std::swap(is_minimization_, other.is_minimization_);
+            std::swap(direction_mask_, other.direction_mask_);
+            std::swap(extremes_, other.extremes_);
+            std::swap(contributions_, other.contributions_);
+            std::swap(grid_, other.grid_);
         }
 
       public /* Modifiers: Multimap Concept */:
         /// \brief Clear the front
-        void clear() noexcept { data_.clear(); }
+        void clear() noexcept {
+            data_.clear();
+            contributions_.values.clear();
+            grid_.cells.clear();
+            grid_.crowding.clear();
+        }
 
         /// \brief Insert element pair
         /// Insertion removes any point dominated by the point
@@ -1364,7 +2009,11 @@ namespace pareto {
             maybe_adjust_dimensions(v);
             if (!dominates(v.first)) {
                 clear_dominated(v.first);
-                return {data_.insert(v), true};
+                auto it = data_.insert(v);
+                update_extremes_after_insert(it->first);
+                update_contributions_after_insert(it->first);
+                update_grid_after_insert(it->first);
+                return {it, true};
             }
             return {end(), false};
         }
@@ -1378,7 +2027,11 @@ namespace pareto {
             if (!dominates(v.first)) {
                 clear_dominated(v.first);
                 auto p = std::move(v);
-                return {data_.insert(p), true};
+                auto it = data_.insert(p);
+                update_extremes_after_insert(it->first);
+                update_contributions_after_insert(it->first);
+                update_grid_after_insert(it->first);
+                return {it, true};
             }
             return {end(), false};
         }
@@ -1413,38 +2066,79 @@ namespace pareto {
         /// \brief Insert list of elements in the front
         /// It's always more efficient to insert lots of elements
         ///     at once.
-        /// Insertion removes any point dominated by the point
-        ///     before inserting the element in the rtree
+        /// We first discard the elements dominated by other elements
+        ///     in the same list. The remaining elements are compared with
+        ///     the front, which removes the points they dominate, and
+        ///     are then inserted in the container at once.
+        /// The final front is the same we would get by inserting the
+        ///     elements one at a time.
         /// \param first Iterator to first element
         /// \param last Iterator to last element
-        /// \return Iterator to the new element
-        /// \return True if insertion happened successfully
+        /// \return Number of elements from the list in the front
         template <class InputIterator>
         size_type insert(InputIterator first, InputIterator last) {
-            size_t s = 0;
-            for (auto it = first; it != last; ++it) {
-                std::pair<iterator, bool> r = insert(*it);
-                s += r.second;
+            std::vector<value_type> batch(first, last);
+            if (batch.empty()) {
+                return 0;
             }
-            return s;
+            maybe_adjust_dimensions(batch.front());
+            std::vector<size_t> candidates = non_dominated_indices(batch);
+
+            std::vector<value_type> survivors;
+            survivors.reserve(candidates.size());
+            bool erased_any = false;
+            if (empty()) {
+                for (size_t i : candidates) {
+                    survivors.emplace_back(std::move(batch[i]));
+                }
+            } else {
+                // Compare all candidates with the front before erasing
+                // anything, so that ideal and worst are computed only once.
+                // The old worst point is still a valid corner for the
+                // points left in the front after each erase.
+                const point_type ideal_point = ideal();
+                const point_type worst_point = worst();
+                for (size_t i : candidates) {
+                    if (!dominates(batch[i].first, ideal_point)) {
+                        survivors.emplace_back(std::move(batch[i]));
+                    }
+                }
+                for (const value_type &v : survivors) {
+                    if (v.first.dominates(worst_point,
+                                          dominance_directions()) &&
+                        find(v.first) == end()) {
+                        data_.erase(
+                            data_.find_intersection(worst_point, v.first),
+                            end());
+                        erased_any = true;
+                    }
+                }
+            }
+            data_.insert(survivors.begin(), survivors.end());
+            if (erased_any) {
+                update_all_extremes();
+            } else if (!survivors.empty()) {
+                if (size() == survivors.size()) {
+                    extremes_.lower = survivors.front().first;
+                    extremes_.upper = survivors.front().first;
+                }
+                for (const value_type &v : survivors) {
+                    update_extremes_after_insert(v.first);
+                }
+            }
+            if (contributions_.is_tracking && !survivors.empty()) {
+                update_all_contributions();
+            }
+            if (grid_.is_tracking && !survivors.empty()) {
+                update_all_grid_cells();
+            }
+            return survivors.size();
         }
 
         /// \brief Insert list of elements in the front
-        /// It's always more efficient to insert lots of elements
-        ///     at once.
-        /// Insertion removes any point dominated by the point
-        ///     before inserting the element in the rtree
-        /// \param first Iterator to first element
-        /// \param last Iterator to last element
-        /// \return Iterator to the new element
-        /// \return True if insertion happened successfully
+        /// \see insert(InputIterator first, InputIterator last)
         size_t insert(std::initializer_list<value_type> il) {
-            size_t s = 0;
-            for (auto it = il.begin(); it != il.end(); ++it) {
-                std::pair<iterator, bool> r = insert(*it);
-                s += r.second;
-            }
-            return s;
+            return insert(il.begin(), il.end());
         }
 
         /// \brief Create element and emplace it in the front
@@ -1464,24 +2158,61 @@ namespace pareto {
         /// \warning The modification of the rtree may invalidate the iterators.
         iterator erase(const_iterator position) {
             auto it = find(position->first);
-            return data_.erase(it);
+            const point_type p = position->first;
+            auto next = data_.erase(it);
+            update_extremes_after_erase(p);
+            update_grid_after_erase(&p, &p + 1);
+            if (contributions_.is_tracking) {
+                forget_contribution(p);
+                update_contributions_after_erase(p);
+            }
+            return next;
         }
 
         /// \brief Erase element pointed by iterator from the front
         /// \warning The modification of the rtree may invalidate the iterators.
         iterator erase(iterator position) {
-            auto it = find(position->first);
-            return data_.erase(it);
+            return erase(const_iterator(position));
         }
 
         /// \brief Remove range of iterators from the front
         iterator erase(const_iterator first, const_iterator last) {
-            return data_.erase(first, last);
+            std::vector<point_type> erased;
+            for (auto it = first; it != last; ++it) {
+                erased.emplace_back(it->first);
+            }
+            auto next = data_.erase(first, last);
+            update_extremes_after_erase(erased.begin(), erased.end());
+            update_grid_after_erase(erased.begin(), erased.end());
+            if (!contributions_.is_tracking) {
+                return next;
+            }
+            if (erased.size() == 1) {
+                forget_contribution(erased.front());
+                update_contributions_after_erase(erased.front());
+            } else if (!erased.empty()) {
+                update_all_contributions();
+            }
+            return next;
         }
 
         /// \brief Erase element from the front
         /// \param v Point
-        size_type erase(const key_type &point) { return data_.erase(point); }
+        size_type erase(const key_type &point) {
+            // point might refer to an element we are about to erase
+            const point_type p = point;
+            const size_type n = data_.erase(p);
+            if (n != 0) {
+                update_extremes_after_erase(p);
+                const std::vector<point_type> erased(n, p);
+                update_grid_after_erase(erased.begin(), erased.end());
+            }
+            if (contributions_.is_tracking && n != 0) {
+                contributions_.values.erase(p);
+                update_contributions_after_erase(p);
+            }
+            return n;
+        }
 
         /// \brief Splices nodes from another container
         void merge(front &source) noexcept {
@@ -1648,6 +2379,24 @@ namespace pareto {
             return data_.min_element(dimension);
         }
 
+      public /* Freezing */:
+        /// \brief Type of the front returned by freeze()
+        using frozen_type = front<K, M, T,
+                                  frozen_kd_tree<K, M, T, dimension_compare,
+                                                 allocator_type>>;
+
+        /// \brief Copy the front to a front of an immutable kd-tree
+        /// The frozen front keeps the directions of this front and all
+        /// of its const functions. The kd-tree is a single array, which
+        /// makes many queries on a front we do not change anymore faster.
+        frozen_type freeze() const {
+            return frozen_type(
+                typename frozen_type::container_type(
+                    data_.begin(), data_.end(), data_.dimension_comp(),
+                    data_.get_allocator()),
+                is_minimization_);
+        }
+
       public /* Modifiers: Lookup / Pareto Concept */:
         /// \brief Find points dominated by p
         /// If p is in the front, it dominates no other point
@@ -1660,7 +2409,7 @@ namespace pareto {
 
             point_type worst_point = worst();
             const bool p_dominates_worst =
-                p.dominates(worst_point, is_minimization_);
+                p.dominates(worst_point, dominance_directions());
             if (!p_dominates_worst) {
                 return end();
             }
@@ -1679,7 +2428,7 @@ namespace pareto {
 
             point_type worst_point = worst();
             const bool p_dominates_worst =
-                p.dominates(worst_point, is_minimization_);
+                p.dominates(worst_point, dominance_directions());
             if (!p_dominates_worst) {
                 return end();
             }
@@ -1816,9 +2565,13 @@ namespace pareto {
         /// \brief Check if front passes the variants that define a front
         /// This is only for tests and it's not officially part of the concept
         [[nodiscard]] bool check_invariants() const {
+            if (!(direction_mask_ == direction_mask_type(is_minimization_))) {
+                return false;
+            }
             for (const value_type &item : data_) {
                 for (const value_type &item2 : data_) {
-                    if (item.first.dominates(item2.first, is_minimization_)) {
+                    if (item.first.dominates(item2.first,
+                                             dominance_directions())) {
                         return false;
                     }
                 }
@@ -1826,6 +2579,131 @@ namespace pareto {
             return true;
         }
       private /* functions */:
+        /// \brief Check if this front weakly dominates a point
+        /// \param ideal_point Ideal point of this front
+        bool dominates(const point_type &p,
+                       const point_type &ideal_point) const {
+            // trivial case: p is not behind ideal
+            const bool p_is_not_behind_ideal =
+                !ideal_point.dominates(p, dominance_directions());
+            if (p_is_not_behind_ideal) {
+                return false;
+            }
+
+            // trivial case: p is in the front
+            if (find(p) != end()) {
+                return false;
+            }
+
+            // general case (removing trivial case 1)
+            // points intersecting(ideal,p)
+            const_iterator first_element_that_dominates =
+                data_.find_intersection(ideal_point, p);
+            return first_element_that_dominates != end();
+        }
+
+        /// \brief Indexes of the values not dominated by other values
+        /// We sort the values lexicographically, from best to worst, so that
+        /// a value can only be dominated by the values before it. In two
+        /// dimensions, each value only needs to be compared with the last
+        /// non-dominated value. In three dimensions, we keep the staircase
+        /// of the last two coordinates of the non-dominated values in a map.
+        /// In more dimensions, each value is compared with the non-dominated
+        /// values we have found so far.
+        /// \return Indexes of the non-dominated values in sorted order
+        std::vector<size_t>
+        non_dominated_indices(const std::vector<value_type> &v) const {
+            std::vector<size_t> idx(v.size());
+            for (size_t i = 0; i < idx.size(); ++i) {
+                idx[i] = i;
+            }
+            const size_t m = v.empty() ? 0 : v.front().first.dimensions();
+            std::sort(idx.begin(), idx.end(), [&](size_t a, size_t b) {
+                const point_type &pa = v[a].first;
+                const point_type &pb = v[b].first;
+                for (size_t i = 0; i < m; ++i) {
+                    if (pa[i] != pb[i]) {
+                        return is_minimization_[i] ? pa[i] < pb[i]
+                                                   : pa[i] > pb[i];
+                    }
+                }
+                return false;
+            });
+
+            std::vector<size_t> r;
+            if (m == 2) {
+                for (size_t i : idx) {
+                    const point_type &p = v[i].first;
+                    if (r.empty()) {
+                        r.emplace_back(i);
+                        continue;
+                    }
+                    const point_type &last = v[r.back()].first;
+                    const bool better_in_second_dimension =
+                        is_minimization_[1] ? p[1] < last[1] : p[1] > last[1];
+                    if (better_in_second_dimension || p == last) {
+                        r.emplace_back(i);
+                    }
+                }
+            } else if (m == 3) {
+                auto better_1 = [&](const dimension_type &a,
+                                    const dimension_type &b) {
+                    return is_minimization_[1] ? a < b : a > b;
+                };
+                auto better_2 = [&](const dimension_type &a,
+                                    const dimension_type &b) {
+                    return is_minimization_[2] ? a < b : a > b;
+                };
+                // Steps get worse in dimension 1 and better in dimension 2
+                std::map<dimension_type, dimension_type, decltype(better_1)>
+                    staircase(better_1);
+                const point_type *previous = nullptr;
+                bool previous_is_non_dominated = false;
+                for (size_t i : idx) {
+                    const point_type &p = v[i].first;
+                    // copies of a point are next to each other
+                    if (previous != nullptr && p == *previous) {
+                        if (previous_is_non_dominated) {
+                            r.emplace_back(i);
+                        }
+                        continue;
+                    }
+                    previous = &p;
+                    // the best step in dimension 2 that is not worse than p
+                    // in dimension 1
+                    auto it = staircase.upper_bound(p[1]);
+                    previous_is_non_dominated =
+                        it == staircase.begin() ||
+                        better_2(p[2], std::prev(it)->second);
+                    if (!previous_is_non_dominated) {
+                        continue;
+                    }
+                    r.emplace_back(i);
+                    auto first = staircase.lower_bound(p[1]);
+                    auto last = first;
+                    while (last != staircase.end() &&
+                           !better_2(last->second, p[2])) {
+                        ++last;
+                    }
+                    staircase.erase(first, last);
+                    staircase.emplace(p[1], p[2]);
+                }
+            } else {
+                for (size_t i : idx) {
+                    const point_type &p = v[i].first;
+                    const bool is_dominated =
+                        std::any_of(r.begin(), r.end(), [&](size_t j) {
+                            return v[j].first.dominates(
+                                p, dominance_directions());
+                        });
+                    if (!is_dominated) {
+                        r.emplace_back(i);
+                    }
+                }
+            }
+            return r;
+        }
+
         /// \brief Clear solutions are dominated by p
         /// Pareto-optimal front is the set F consisting of
         /// all non-dominated solutions x in the whole
@@ -1835,7 +2713,17 @@ namespace pareto {
         void clear_dominated(const point_type &p) {
             if (!empty()) {
                 iterator it = find_dominated(p);
-                erase(it, end());
+                std::vector<point_type> dominated;
+                for (auto dominated_it = it; dominated_it != end();
+                     ++dominated_it) {
+                    dominated.emplace_back(dominated_it->first);
+                    if (contributions_.is_tracking) {
+                        forget_contribution(dominated_it->first);
+                    }
+                }
+                data_.erase(it, end());
+                update_extremes_after_erase(dominated.begin(), dominated.end());
+                update_grid_after_erase(dominated.begin(), dominated.end());
             }
         }
 
@@ -1876,8 +2764,11 @@ namespace pareto {
 #endif
         }
 
+        /// \brief Generator for the Monte Carlo indicators
+        /// Each thread has its own generator, so many threads can
+        /// estimate indicators of the same front
         static std::mt19937 &generator() {
-            static std::mt19937 g(static_cast<unsigned int>(
+            static thread_local std::mt19937 g(static_cast<unsigned int>(
                 static_cast<unsigned int>(std::random_device()()) |
                 static_cast<unsigned int>(
                     std::chrono::high_resolution_clock::now()
@@ -1947,6 +2838,7 @@ namespace pareto {
                 std::fill(is_minimization_.begin(), is_minimization_.end(),
                           0x01);
             }
+            update_direction_mask();
         }
 
         template <class DirectionIt>
@@ -1971,6 +2863,26 @@ namespace pareto {
                     }
                 }
             }
+            update_direction_mask();
+        }
+
+        /// \brief Compute the direction mask from the directions
+        void update_direction_mask() {
+            if constexpr (number_of_compile_dimensions != 0) {
+                direction_mask_ = direction_mask_type(is_minimization_);
+            }
+        }
+
+        /// \brief Directions in the form point::dominates checks fastest
+        /// Points with compile-time dimensions compare chunks of
+        /// coordinates with the direction mask. Runtime dimensions use the
+        /// directions directly.
+        const auto &dominance_directions() const {
+            if constexpr (number_of_compile_dimensions != 0) {
+                return direction_mask_;
+            } else {
+                return is_minimization_;
+            }
         }
 
       private:
@@ -1981,9 +2893,24 @@ namespace pareto {
         /// We use uint8_t instead of bool to avoid the array specialization
         directions_type is_minimization_;
 
+        /// \brief Whether each dimension is minimization as bits
+        direction_mask_type direction_mask_;
+
+        /// \brief Minimum and maximum values we keep updated
+        extremes_cache extremes_;
+
+        /// \brief Hypervolume contributions we keep updated
+        contribution_cache contributions_;
+
+        /// \brief Grid cells we keep updated
+        grid_cache grid_;
+
       public:
         /// We won't need this when we finally deprecate boost tree
         template <class, size_t, class, class> friend class archive;
+
+        /// Let fronts with other containers use the private constructors
+        template <typename, size_t, typename, class> friend class front;
     };
 
     /// \brief Relational operator < for fronts and fronts
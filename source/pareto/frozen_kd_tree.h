@@ -0,0 +1,863 @@
+#ifndef PARETO_FROZEN_KD_TREE_H
+#define PARETO_FROZEN_KD_TREE_H
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include <pareto/common/default_allocator.h>
+#include <pareto/point.h>
+#include <pareto/query/predicates.h>
+#include <pareto/query/query_box.h>
+
+namespace pareto {
+
+    /// \brief Immutable kd-tree stored as a single array
+    /// This is the layout of a kd_tree after we stop changing it. All
+    /// elements live in one vector in median order: the root of the range
+    /// [lo, hi) is the element in the middle of the range, the left subtree
+    /// is in [lo, mid) and the right subtree is in [mid + 1, hi). Each level
+    /// splits the elements in the dimension depth % m.
+    ///
+    /// There are no nodes, pointers or per-node bounds. Queries find the
+    /// bounds of each subtree by cutting the bounds of the whole tree at the
+    /// medians on the way down. Because the layout is an in-order traversal
+    /// of the tree, iterating the array in order is iterating the tree in
+    /// order, so iterators are only an index and a list of predicates.
+    ///
+    /// The container is built from a range of elements or with kd_tree::freeze
+    /// and front::freeze. It only has const functions.
+    ///
+    /// This container type implements the following concepts
+    /// Container: https://en.cppreference.com/w/cpp/named_req/Container
+    /// ReversibleContainer:
+    /// https://en.cppreference.com/w/cpp/named_req/Container
+    ///
+    /// \tparam K Number/key type
+    /// \tparam M Number of dimensions
+    /// \tparam E Element/mapped type
+    /// \tparam C Comparison function type in one dimension
+    /// \tparam A Allocator type
+    template <class K, size_t M, class T, typename C = std::less<K>,
+              class A = default_allocator_type<std::pair<const point<K, M>, T>>>
+    class frozen_kd_tree {
+      private /* Internal types */:
+        using unprotected_point_type = point<K, M>;
+        using protected_point_type = const point<K, M>;
+        using unprotected_mapped_type = T;
+        using unprotected_key_type = unprotected_point_type;
+        using protected_key_type = protected_point_type;
+        using unprotected_value_type =
+            std::pair<unprotected_key_type, unprotected_mapped_type>;
+        using protected_value_type =
+            std::pair<protected_key_type, unprotected_mapped_type>;
+        using unprotected_allocator_type = typename std::allocator_traits<
+            A>::template rebind_alloc<unprotected_value_type>;
+        using unprotected_vector_type =
+            std::vector<unprotected_value_type, unprotected_allocator_type>;
+        using point_type = unprotected_point_type;
+
+      public /* Forward declarations */:
+        template <bool is_const> class iterator_impl;
+
+      public /* Container Concept */:
+        using value_type = protected_value_type;
+        using reference = value_type const &;
+        using const_reference = value_type const &;
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+        using pointer = const value_type *;
+        using const_pointer = const value_type *;
+        using difference_type =
+            typename unprotected_vector_type::difference_type;
+        using size_type = typename unprotected_vector_type::size_type;
+
+      public /* ReversibleContainer Concept */:
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      public /* AssociativeContainer Concept */:
+        using key_type = unprotected_point_type;
+        using mapped_type = T;
+        using key_compare =
+            std::function<bool(const key_type &, const key_type &)>;
+        using value_compare =
+            std::function<bool(const value_type &, const value_type &)>;
+
+      public /* AllocatorAwareContainer Concept */:
+        using allocator_type = A;
+
+      public /* SpatialContainer Concept */:
+        static constexpr size_t number_of_compile_dimensions = M;
+        using dimension_type = K;
+        using dimension_compare = C;
+        using box_type =
+            query_box<dimension_type, number_of_compile_dimensions>;
+        using predicate_list_type =
+            predicate_list<dimension_type, number_of_compile_dimensions, T>;
+
+      private /* Internal types */:
+        using nearest_type =
+            nearest<dimension_type, number_of_compile_dimensions>;
+
+        /// \brief Index that represents no element
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+      public /* Iterators */:
+        /// \brief Frozen kd-tree iterator
+        /// The iterator is an index in the array. Iterators with predicates
+        /// find the next index that passes the predicates by walking the
+        /// implicit tree from the root and skipping the subtrees whose
+        /// bounds cannot pass the predicates.
+        ///
+        /// Nearest queries find the k nearest elements that pass the other
+        /// predicates when the iterator is created and iterate them from
+        /// the closest to the farthest.
+        ///
+        /// The elements are immutable, so iterator and const_iterator both
+        /// point to constant elements and convert into each other.
+        template <bool is_const> class iterator_impl {
+          public /* LegacyIterator Types */:
+            using value_type = const frozen_kd_tree::value_type;
+            using reference = frozen_kd_tree::const_reference;
+            using difference_type = frozen_kd_tree::difference_type;
+            using pointer = frozen_kd_tree::const_pointer;
+            using iterator_category = std::bidirectional_iterator_tag;
+
+          public /* LegacyForwardIterator Constructors */:
+            /// \brief Default constructor
+            iterator_impl() = default;
+
+          public /* ContainerConcept Constructors */:
+            /// \brief Convert between iterator and const_iterator
+            template <bool rhs_is_const,
+                      class = std::enable_if_t<is_const != rhs_is_const>>
+            // NOLINTNEXTLINE(google-explicit-constructor)
+            iterator_impl(const iterator_impl<rhs_is_const> &rhs)
+                : tree_(rhs.tree_), index_(rhs.index_),
+                  predicates_(rhs.predicates_), is_nearest_(rhs.is_nearest_),
+                  nearest_set_(rhs.nearest_set_),
+                  nearest_position_(rhs.nearest_position_) {}
+
+          public /* Internal Constructors / Used by Container */:
+            /// \brief Iterator to an element of the array
+            iterator_impl(const frozen_kd_tree *tree, size_t index)
+                : tree_(tree), index_(index) {}
+
+            /// \brief Iterator to the first element that passes the
+            /// predicates
+            iterator_impl(const frozen_kd_tree *tree,
+                          const predicate_list_type &predicates)
+                : tree_(tree), index_(tree->size()), predicates_(predicates) {
+                if (predicates_.contains_nearest()) {
+                    is_nearest_ = true;
+                    nearest_set_ = tree_->nearest_indices(predicates_);
+                    nearest_position_ = 0;
+                    advance_nearest();
+                } else {
+                    index_ = tree_->next_match(0, predicates_);
+                }
+            }
+
+          public /* LegacyIterator */:
+            /// \brief Dereference iterator
+            reference operator*() const { return tree_->value_at(index_); }
+
+            /// \brief Advance iterator
+            iterator_impl &operator++() {
+                if (is_nearest_) {
+                    ++nearest_position_;
+                    advance_nearest();
+                } else if (predicates_.size() == 0) {
+                    ++index_;
+                } else {
+                    index_ = tree_->next_match(index_ + 1, predicates_);
+                }
+                return *this;
+            }
+
+          public /* LegacyInputIterator */:
+            pointer operator->() const { return &tree_->value_at(index_); }
+
+          public /* LegacyForwardIterator */:
+            /// \brief Equality operator
+            template <bool rhs_is_const>
+            bool operator==(const iterator_impl<rhs_is_const> &rhs) const {
+                return index_ == rhs.index_;
+            }
+
+            /// \brief Inequality operator
+            template <bool rhs_is_const>
+            bool operator!=(const iterator_impl<rhs_is_const> &rhs) const {
+                return !(this->operator==(rhs));
+            }
+
+            /// \brief Advance iterator
+            iterator_impl operator++(int) { // NOLINT(cert-dcl21-cpp):
+                auto tmp = *this;
+                operator++();
+                return tmp;
+            }
+
+          public /* LegacyBidirectionalIterator */:
+            /// \brief Decrement iterator
+            iterator_impl &operator--() {
+                if (is_nearest_) {
+                    rewind_nearest();
+                } else if (predicates_.size() == 0) {
+                    --index_;
+                } else {
+                    const size_t previous =
+                        tree_->previous_match(index_, predicates_);
+                    assert(previous != npos);
+                    index_ = previous;
+                }
+                return *this;
+            }
+
+            /// \brief Decrement iterator
+            iterator_impl operator--(int) { // NOLINT(cert-dcl21-cpp)
+                auto tmp = *this;
+                operator--();
+                return tmp;
+            }
+
+          private /* Internal Functions */:
+            /// \brief Point to the nearest element at the current position
+            void advance_nearest() {
+                index_ = nearest_position_ < nearest_set_.size()
+                             ? nearest_set_[nearest_position_]
+                             : tree_->size();
+            }
+
+            /// \brief Move to the previous nearest element
+            void rewind_nearest() {
+                assert(nearest_position_ > 0);
+                --nearest_position_;
+                index_ = nearest_set_[nearest_position_];
+            }
+
+          private:
+            /// \brief Tree we are iterating
+            const frozen_kd_tree *tree_{nullptr};
+
+            /// \brief Index of the current element in the array
+            size_t index_{0};
+
+            /// \brief Predicates the elements need to pass
+            predicate_list_type predicates_;
+
+            /// \brief Whether we are iterating the k nearest elements
+            bool is_nearest_{false};
+
+            /// \brief Indexes of the nearest elements by distance
+            std::vector<size_t> nearest_set_;
+
+            /// \brief Position of the current element in nearest_set_
+            size_t nearest_position_{0};
+
+          public:
+            /// Let the tree access the spatial private constructors
+            friend frozen_kd_tree;
+
+            /// Let iterators and const iterators access each other
+            template <bool> friend class iterator_impl;
+        };
+
+      public /* Constructors: Container + AllocatorAwareContainer */:
+        /// \brief Create an empty container
+        explicit frozen_kd_tree(const allocator_type &alloc = allocator_type())
+            : data_(unprotected_allocator_type(alloc)),
+              comp_(dimension_compare()) {}
+
+        /// \brief Copy constructor
+        frozen_kd_tree(const frozen_kd_tree &rhs)
+            : data_(rhs.data_), comp_(rhs.comp_), bounds_(rhs.bounds_) {}
+
+        /// \brief Copy constructor data but use another allocator
+        frozen_kd_tree(const frozen_kd_tree &rhs, const allocator_type &alloc)
+            : data_(rhs.data_, unprotected_allocator_type(alloc)),
+              comp_(rhs.comp_), bounds_(rhs.bounds_) {}
+
+        /// \brief Move constructor
+        frozen_kd_tree(frozen_kd_tree &&rhs) noexcept
+            : data_(std::move(rhs.data_)), comp_(std::move(rhs.comp_)),
+              bounds_(std::move(rhs.bounds_)) {}
+
+        /// \brief Move constructor data but use new allocator
+        frozen_kd_tree(frozen_kd_tree &&rhs,
+                       const allocator_type &alloc) noexcept
+            : data_(std::move(rhs.data_), unprotected_allocator_type(alloc)),
+              comp_(std::move(rhs.comp_)), bounds_(std::move(rhs.bounds_)) {}
+
+        /// \brief Destructor
+        ~frozen_kd_tree() = default;
+
+      public /* Constructors: AssociativeContainer + AllocatorAwareContainer */:
+        /// \brief Create container with custom comparison function
+        explicit frozen_kd_tree(const C &comp,
+                                const allocator_type &alloc = allocator_type())
+            : data_(unprotected_allocator_type(alloc)), comp_(comp) {}
+
+        /// \brief Construct with iterators + comparison
+        /// This is the only way to put elements in the container. The
+        /// elements are copied to the array and sorted in median order.
+        template <class InputIt>
+        frozen_kd_tree(InputIt first, InputIt last, const C &comp = C(),
+                       const allocator_type &alloc = allocator_type())
+            : data_(unprotected_allocator_type(alloc)), comp_(comp) {
+            for (; first != last; ++first) {
+                data_.emplace_back(first->first, first->second);
+            }
+            build();
+        }
+
+        /// \brief Construct with list + comparison
+        frozen_kd_tree(std::initializer_list<value_type> il,
+                       const C &comp = C(),
+                       const allocator_type &alloc = allocator_type())
+            : frozen_kd_tree(il.begin(), il.end(), comp, alloc) {}
+
+        /// \brief Construct with iterators
+        template <class InputIt>
+        frozen_kd_tree(InputIt first, InputIt last,
+                       const allocator_type &alloc)
+            : frozen_kd_tree(first, last, C(), alloc) {}
+
+        /// \brief Construct with list
+        frozen_kd_tree(std::initializer_list<value_type> il,
+                       const allocator_type &alloc)
+            : frozen_kd_tree(il.begin(), il.end(), C(), alloc) {}
+
+      public /* Assignment: Container + AllocatorAwareContainer */:
+        /// \brief Copy assignment
+        frozen_kd_tree &operator=(const frozen_kd_tree &rhs) {
+            if (&rhs == this) {
+                return *this;
+            }
+            data_.clear();
+            data_.insert(data_.end(), rhs.data_.begin(), rhs.data_.end());
+            comp_ = rhs.comp_;
+            bounds_ = rhs.bounds_;
+            return *this;
+        }
+
+        /// \brief Move assignment
+        frozen_kd_tree &operator=(frozen_kd_tree &&rhs) noexcept {
+            if (&rhs == this) {
+                return *this;
+            }
+            data_ = std::move(rhs.data_);
+            comp_ = std::move(rhs.comp_);
+            bounds_ = std::move(rhs.bounds_);
+            return *this;
+        }
+
+      public /* Non-Modifying Functions: AllocatorAwareContainer */:
+        /// \brief Obtains a copy of the allocator
+        allocator_type get_allocator() const noexcept {
+            return allocator_type(data_.get_allocator());
+        }
+
+      public /* Element Access / Map Concept */:
+        /// \brief Get reference to element at a given position, and throw error
+        /// if it does not exist
+        const mapped_type &at(const key_type &k) const {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                throw std::out_of_range("frozen_kd_tree::at: key not found");
+            }
+        }
+
+      public /* Non-Modifying Functions: Container Concept */:
+        /// \brief Get iterator to first element
+        const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+        /// \brief Get iterator to past-the-end element
+        const_iterator end() const noexcept {
+            return const_iterator(this, data_.size());
+        }
+
+        /// \brief Get iterator to first element
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        /// \brief Get iterator to past-the-end element
+        const_iterator cend() const noexcept { return end(); }
+
+      public /* Non-Modifying Functions: ReversibleContainer Concept */:
+        /// \brief Get iterator to first element in reverse
+        const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        }
+
+        /// \brief Get iterator to last element in reverse
+        const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        /// \brief Get iterator to first element in reverse
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        /// \brief Get iterator to past-the-end element in reverse
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+      public /* Non-Modifying Functions / Capacity / Container Concept */:
+        /// \brief True if container is empty
+        [[nodiscard]] bool empty() const noexcept { return data_.empty(); }
+
+        /// \brief Get container size
+        [[nodiscard]] size_t size() const noexcept { return data_.size(); }
+
+        /// \brief Get container max size
+        [[nodiscard]] size_t max_size() const noexcept {
+            return data_.max_size();
+        }
+
+      public /* Non-Modifying Functions / Capacity / Spatial Concept */:
+        /// \brief Get container dimensions
+        [[nodiscard]] size_t dimensions() const noexcept {
+            if constexpr (M != 0) {
+                return M;
+            } else {
+                return data_.empty() ? 0 : data_.front().first.dimensions();
+            }
+        }
+
+        /// \brief Get maximum value in a given dimension
+        dimension_type max_value(size_t dimension) const {
+            return !data_.empty() ? bounds_.second()[dimension]
+                                  : std::numeric_limits<dimension_type>::max();
+        }
+
+        /// \brief Get minimum value in a given dimension
+        dimension_type min_value(size_t dimension) const {
+            return !data_.empty() ? bounds_.first()[dimension]
+                                  : std::numeric_limits<dimension_type>::min();
+        }
+
+      public /* Modifying Functions: Container + AllocatorAwareContainer */:
+        /// \brief Swap the content of two objects
+        void swap(frozen_kd_tree &other) noexcept {
+            other.data_.swap(data_);
+            std::swap(comp_, other.comp_);
+            std::swap(bounds_, other.bounds_);
+        }
+
+      public /* Lookup / Multimap Concept */:
+        /// \brief Returns the number of elements with key that compares
+        /// equivalent to the specified argument.
+        size_type count(const key_type &k) const {
+            return static_cast<size_type>(
+                std::distance(find_intersection(k), end()));
+        }
+
+        /// \brief Returns the number of elements with key that compares
+        /// equivalent to the specified argument.
+        template <class L> size_type count(const L &k) const {
+            return count(key_type(k));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        const_iterator find(const key_type &k) const {
+            const_iterator it = find_intersection(k, k);
+            it.predicates_.clear();
+            return it;
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> const_iterator find(const L &x) const {
+            return find(key_type(x));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        bool contains(const key_type &k) const { return find(k) != end(); }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> bool contains(const L &x) const {
+            return find(x) != end();
+        }
+
+      public /* Lookup / Spatial Concept */:
+        /// \brief Get iterator to first element that passes the list of
+        /// predicates
+        const_iterator find(const predicate_list_type &ps) const noexcept {
+            return const_iterator(this, ps);
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator find_intersection(const point_type &k) const {
+            return find_intersection(k, k);
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator find_intersection(const point_type &lb,
+                                         const point_type &ub) const {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return const_iterator(this, {intersects(lb_, ub_)});
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator
+        find_intersection(const point_type &lb, const point_type &ub,
+                          std::function<bool(const value_type &)> fn) const {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return const_iterator(
+                this, {intersects(lb_, ub_),
+                       satisfies<dimension_type, number_of_compile_dimensions,
+                                 mapped_type>(fn)});
+        }
+
+        /// \brief Find points within a query box
+        const_iterator find_within(const point_type &lb,
+                                   const point_type &ub) const {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return const_iterator(this, {within(lb_, ub_)});
+        }
+
+        /// \brief Find points outside a query box
+        const_iterator find_disjoint(const point_type &lb,
+                                     const point_type &ub) const {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return const_iterator(this, {disjoint(lb_, ub_)});
+        }
+
+        /// \brief Find points closest to a reference point
+        const_iterator find_nearest(const point_type &p) const {
+            return const_iterator(this, {nearest(p)});
+        }
+
+        /// \brief Find points closest to a reference point
+        const_iterator find_nearest(const point_type &p, size_t k) const {
+            return const_iterator(this, {nearest(p, k)});
+        }
+
+        /// \brief Find points closest to a reference box
+        const_iterator find_nearest(const box_type &b, size_t k) const {
+            return const_iterator(this, {nearest(b, k)});
+        }
+
+        /// \brief Find points closest to a reference point
+        const_iterator
+        find_nearest(const point_type &p, size_t k,
+                     std::function<bool(const value_type &)> fn) const {
+            return const_iterator(
+                this, {nearest(p, k),
+                       satisfies<dimension_type, number_of_compile_dimensions,
+                                 mapped_type>(fn)});
+        }
+
+        /// \brief Get iterator to element with maximum value in a given
+        /// dimension
+        const_iterator max_element(size_t dimension) const {
+            size_t best = npos;
+            extreme_search(0, data_.size(), 0, bounds_, dimension, true, best);
+            return best == npos ? end() : const_iterator(this, best);
+        }
+
+        /// \brief Get iterator to element with minimum value in a given
+        /// dimension
+        const_iterator min_element(size_t dimension) const {
+            size_t best = npos;
+            extreme_search(0, data_.size(), 0, bounds_, dimension, false,
+                           best);
+            return best == npos ? end() : const_iterator(this, best);
+        }
+
+      public /* Observers: AssociativeContainer */:
+        /// \brief Returns the function object that compares keys
+        key_compare key_comp() const noexcept {
+            return [this](const key_type &a, const key_type &b) {
+                return std::lexicographical_compare(a.begin(), a.end(),
+                                                    b.begin(), b.end(), comp_);
+            };
+        }
+
+        /// \brief Returns the function object that compares values
+        value_compare value_comp() const noexcept {
+            return [this](const value_type &a, const value_type &b) {
+                return std::lexicographical_compare(
+                    a.first.begin(), a.first.end(), b.first.begin(),
+                    b.first.end(), comp_);
+            };
+        }
+
+        /// \brief Returns the function object that compares numbers
+        /// This is the comparison operator for a single dimension
+        dimension_compare dimension_comp() const noexcept { return comp_; }
+
+      private /* Internal functions */:
+        /// \brief Element at a position as a protected reference
+        const value_type &value_at(size_t i) const {
+            const std::pair<key_type, mapped_type> &p = data_[i];
+            return *(const value_type *)&p;
+        }
+
+        /// \brief Check if the element at a position passes the predicates
+        bool passes(size_t i, const predicate_list_type &ps) const {
+            return ps.pass_predicate(data_[i]);
+        }
+
+        /// \brief Sort the array in median order and find its bounds
+        /// The splits use the same order as query_box, so we can cut the
+        /// bounds of a subtree at its median.
+        void build() {
+            if (data_.empty()) {
+                return;
+            }
+            bounds_ = box_type(data_.front().first);
+            for (const auto &v : data_) {
+                bounds_.stretch(v.first);
+            }
+            build(0, data_.size(), 0);
+        }
+
+        void build(size_t lo, size_t hi, size_t depth) {
+            while (hi - lo > 1) {
+                const size_t mid = lo + (hi - lo) / 2;
+                const size_t d = depth % dimensions();
+                std::nth_element(data_.begin() + lo, data_.begin() + mid,
+                                 data_.begin() + hi,
+                                 [d](const auto &a, const auto &b) {
+                                     return a.first[d] < b.first[d];
+                                 });
+                build(lo, mid, depth + 1);
+                lo = mid + 1;
+                ++depth;
+            }
+        }
+
+        /// \brief Bounds of the left subtree given the bounds of the range
+        box_type left_bounds(const box_type &box, size_t mid, size_t d) const {
+            box_type left = box;
+            left.second()[d] = data_[mid].first[d];
+            return left;
+        }
+
+        /// \brief Bounds of the right subtree given the bounds of the range
+        box_type right_bounds(const box_type &box, size_t mid,
+                              size_t d) const {
+            box_type right = box;
+            right.first()[d] = data_[mid].first[d];
+            return right;
+        }
+
+        /// \brief First element at or after the position that passes the
+        /// predicates
+        /// \return The position of the element or size() if there is none
+        size_t next_match(size_t from, const predicate_list_type &ps) const {
+            const size_t i = first_match(0, data_.size(), 0, bounds_, from, ps);
+            return i == npos ? data_.size() : i;
+        }
+
+        /// \brief Last element before the position that passes the predicates
+        size_t previous_match(size_t to, const predicate_list_type &ps) const {
+            return last_match(0, data_.size(), 0, bounds_, to, ps);
+        }
+
+        /// \brief First element in [max(lo, from), hi) that passes the
+        /// predicates
+        size_t first_match(size_t lo, size_t hi, size_t depth,
+                           const box_type &box, size_t from,
+                           const predicate_list_type &ps) const {
+            if (lo >= hi || hi <= from || !ps.might_pass_predicate(box)) {
+                return npos;
+            }
+            // every element in a box inside the query passes
+            if (ps.is_all_intersects() && ps.pass_predicate(box)) {
+                return std::max(lo, from);
+            }
+            const size_t mid = lo + (hi - lo) / 2;
+            const size_t d = depth % dimensions();
+            if (from < mid) {
+                const size_t i = first_match(lo, mid, depth + 1,
+                                             left_bounds(box, mid, d), from, ps);
+                if (i != npos) {
+                    return i;
+                }
+            }
+            if (from <= mid && passes(mid, ps)) {
+                return mid;
+            }
+            return first_match(mid + 1, hi, depth + 1,
+                               right_bounds(box, mid, d), from, ps);
+        }
+
+        /// \brief Last element in [lo, min(hi, to)) that passes the
+        /// predicates
+        size_t last_match(size_t lo, size_t hi, size_t depth,
+                          const box_type &box, size_t to,
+                          const predicate_list_type &ps) const {
+            if (lo >= hi || to <= lo || !ps.might_pass_predicate(box)) {
+                return npos;
+            }
+            if (ps.is_all_intersects() && ps.pass_predicate(box)) {
+                return std::min(hi, to) - 1;
+            }
+            const size_t mid = lo + (hi - lo) / 2;
+            const size_t d = depth % dimensions();
+            if (mid + 1 < to) {
+                const size_t i = last_match(mid + 1, hi, depth + 1,
+                                            right_bounds(box, mid, d), to, ps);
+                if (i != npos) {
+                    return i;
+                }
+            }
+            if (mid < to && passes(mid, ps)) {
+                return mid;
+            }
+            return last_match(lo, mid, depth + 1, left_bounds(box, mid, d), to,
+                              ps);
+        }
+
+        /// \brief Positions of the k nearest elements by distance that
+        /// pass the other predicates
+        /// This is a depth-first branch and bound search. We visit the
+        /// closest subtree first and skip the subtrees that are farther
+        /// than the k-th nearest element so far or cannot pass the
+        /// predicates.
+        std::vector<size_t>
+        nearest_indices(const predicate_list_type &ps) const {
+            nearest_type reference = *ps.get_nearest();
+            const size_t k = std::min(reference.k(), data_.size());
+            std::priority_queue<std::pair<double, size_t>> nearest_so_far;
+            if (k != 0) {
+                nearest_search(0, data_.size(), 0, bounds_, reference, ps, k,
+                               nearest_so_far);
+            }
+            std::vector<size_t> r(nearest_so_far.size());
+            for (auto it = r.rbegin(); it != r.rend(); ++it) {
+                *it = nearest_so_far.top().second;
+                nearest_so_far.pop();
+            }
+            return r;
+        }
+
+        void nearest_search(
+            size_t lo, size_t hi, size_t depth, const box_type &box,
+            nearest_type &reference, const predicate_list_type &ps, size_t k,
+            std::priority_queue<std::pair<double, size_t>> &nearest_so_far)
+            const {
+            if (lo >= hi || !ps.might_pass_predicate(box)) {
+                return;
+            }
+            if (nearest_so_far.size() == k &&
+                reference.distance(box) > nearest_so_far.top().first) {
+                return;
+            }
+            const size_t mid = lo + (hi - lo) / 2;
+            if (passes(mid, ps)) {
+                const double distance = reference.distance(data_[mid].first);
+                if (nearest_so_far.size() < k) {
+                    nearest_so_far.emplace(distance, mid);
+                } else if (distance < nearest_so_far.top().first) {
+                    nearest_so_far.pop();
+                    nearest_so_far.emplace(distance, mid);
+                }
+            }
+            const size_t d = depth % dimensions();
+            const box_type left = left_bounds(box, mid, d);
+            const box_type right = right_bounds(box, mid, d);
+            if (reference.distance(left) <= reference.distance(right)) {
+                nearest_search(lo, mid, depth + 1, left, reference, ps, k,
+                               nearest_so_far);
+                nearest_search(mid + 1, hi, depth + 1, right, reference, ps, k,
+                               nearest_so_far);
+            } else {
+                nearest_search(mid + 1, hi, depth + 1, right, reference, ps, k,
+                               nearest_so_far);
+                nearest_search(lo, mid, depth + 1, left, reference, ps, k,
+                               nearest_so_far);
+            }
+        }
+
+        /// \brief Find the max or min element in a dimension
+        /// We skip the subtrees whose bounds cannot beat the best element
+        /// so far.
+        void extreme_search(size_t lo, size_t hi, size_t depth,
+                            const box_type &box, size_t dimension, bool is_max,
+                            size_t &best) const {
+            if (lo >= hi) {
+                return;
+            }
+            auto better = [is_max](const dimension_type &a,
+                                   const dimension_type &b) {
+                return is_max ? b < a : a < b;
+            };
+            if (best != npos) {
+                const dimension_type &bound = is_max ? box.second()[dimension]
+                                                     : box.first()[dimension];
+                if (!better(bound, data_[best].first[dimension])) {
+                    return;
+                }
+            }
+            const size_t mid = lo + (hi - lo) / 2;
+            if (best == npos ||
+                better(data_[mid].first[dimension],
+                       data_[best].first[dimension])) {
+                best = mid;
+            }
+            const size_t d = depth % dimensions();
+            extreme_search(lo, mid, depth + 1, left_bounds(box, mid, d),
+                           dimension, is_max, best);
+            extreme_search(mid + 1, hi, depth + 1, right_bounds(box, mid, d),
+                           dimension, is_max, best);
+        }
+
+      private:
+        /// \brief Elements in median order
+        /// Note that the key_type is not constant, unlike the value_type
+        /// exposed to the user. The iterators are responsible for
+        /// converting these references to protected types where the
+        /// key is const.
+        unprotected_vector_type data_{};
+
+        /// \brief Key comparison (single dimension)
+        dimension_compare comp_{dimension_compare()};
+
+        /// \brief Minimum bounding rectangle of all elements
+        box_type bounds_{};
+    };
+
+    /* Non-Modifying Functions / Comparison / Container Concept */
+    /// \brief Equality operator
+    /// The median order depends on the order of the elements we used
+    /// to build the tree, so this tells us if the trees are equal and
+    /// not if they contain the same elements.
+    template <class K, size_t M, class T, class C, class A>
+    bool operator==(const frozen_kd_tree<K, M, T, C, A> &lhs,
+                    const frozen_kd_tree<K, M, T, C, A> &rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        return std::equal(
+            lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+            [](const typename frozen_kd_tree<K, M, T, C, A>::value_type &a,
+               const typename frozen_kd_tree<K, M, T, C, A>::value_type &b) {
+                return a.first == b.first &&
+                       mapped_type_custom_equality_operator(a.second, b.second);
+            });
+    }
+
+    /// \brief Inequality operator
+    template <class K, size_t M, class T, class C, class A>
+    bool operator!=(const frozen_kd_tree<K, M, T, C, A> &lhs,
+                    const frozen_kd_tree<K, M, T, C, A> &rhs) {
+        return !(lhs == rhs);
+    }
+
+} // namespace pareto
+
+#endif // PARETO_FROZEN_KD_TREE_H
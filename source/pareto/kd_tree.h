@@ -6,12 +6,14 @@
 #define PARETO_FRONT_KD_TREE_H
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <forward_list>
 #include <functional>
+#include <limits>
 #include <map>
 #include <memory>
 #include <queue>
@@ -20,6 +22,8 @@
 #include <vector>
 
 #include <pareto/common/default_allocator.h>
+#include <pareto/common/static_vector.h>
+#include <pareto/frozen_kd_tree.h>
 #include <pareto/point.h>
 #include <pareto/query/predicates.h>
 #include <pareto/query/query_box.h>
@@ -39,8 +43,15 @@ namespace pareto {
     /// \see https://www.cs.cmu.edu/~ckingsf/bioinfo-lectures/kdtrees.pdf
     /// \see LOTS of kd-trees on github:
     /// https://github.com/search?l=C%2B%2B&q=kd-containers&type=Repositories
+    ///
+    /// BucketSize is the number of points each node holds in a contiguous
+    /// array. A node only gets children when its bucket is full, so larger
+    /// buckets mean fewer nodes and less pointer chasing in queries, while
+    /// each visited node is scanned linearly. containers_benchmark compares
+    /// a few bucket sizes.
     template <class K, size_t M, class T, typename C = std::less<K>,
-              class A = default_allocator_type<std::pair<const point<K, M>, T>>>
+              class A = default_allocator_type<std::pair<const point<K, M>, T>>,
+              size_t BucketSize = 1>
     class kd_tree : container_with_pool {
       private /* Internal types */:
         using unprotected_point_type = point<K, M>;
@@ -110,6 +121,10 @@ namespace pareto {
         static_assert(maxnodes_ > minnodes_);
         static_assert(minnodes_ > 0);
 
+        /// \brief Maximum number of points in a node
+        static constexpr size_t bucket_size = BucketSize;
+        static_assert(bucket_size > 0);
+
       private /* Internal node types */:
         /// Node
         /// Each branch might have a kdtree_node for each branch level
@@ -130,8 +145,10 @@ namespace pareto {
             /// \brief Construct child node with value and split dimension
             kdtree_node(kdtree_node *parent, const value_type &value,
                         size_t split_dimension)
-                : value_(value), split_dimension_(split_dimension),
-                  parent_(parent), bounds_(box_type(value.first)) {}
+                : split_dimension_(split_dimension), parent_(parent),
+                  bounds_(box_type(value.first)) {
+                values_.emplace_back(value);
+            }
 
             /// \brief An internal node, contains other nodes
             [[nodiscard]] bool is_internal_node() const {
@@ -143,8 +160,10 @@ namespace pareto {
                 return l_child == nullptr && r_child == nullptr;
             }
 
-            /// \brief Value: a quad-tree node holds a value
-            unprotected_value_type value_;
+            /// \brief Values: a kd-tree node holds a bucket of values
+            /// The first value is the one that splits the children.
+            /// Only the values in the bucket are constructed.
+            static_vector<unprotected_value_type, bucket_size> values_;
 
             /// \brief Dimension we use to split the children
             size_t split_dimension_{0};
@@ -174,6 +193,11 @@ namespace pareto {
             /// The bounds of a point quad-containers are implicitly defined
             /// by the points in the node and its children.
             box_type bounds_;
+
+            /// \brief Number of values in the subtree rooted at this node
+            /// We need the subtree sizes to find unbalanced subtrees
+            /// when rebalancing the tree.
+            size_t subtree_size_{1};
         };
 
         using node_allocator_type = typename std::allocator_traits<
@@ -229,6 +253,7 @@ namespace pareto {
             iterator_impl(const iterator_impl<rhs_is_const> &rhs)
                 : current_tree_(rhs.current_tree_),
                   current_node_(rhs.current_node_),
+                  current_index_(rhs.current_index_),
                   predicates_(rhs.predicates_),
                   nearest_points_iterated_(rhs.nearest_points_iterated_) {
                 nearest_queue_.reserve(rhs.nearest_queue_.size());
@@ -244,6 +269,7 @@ namespace pareto {
             iterator_impl &operator=(const iterator_impl<rhs_is_const> &rhs) {
                 current_tree_ = rhs.current_tree_;
                 current_node_ = rhs.current_node_;
+                current_index_ = rhs.current_index_;
                 predicates_ = rhs.predicates_;
                 nearest_points_iterated_ = rhs.nearest_points_iterated_;
                 nearest_queue_.clear();
@@ -282,6 +308,7 @@ namespace pareto {
             iterator_impl(iterator_impl<rhs_is_const> &&rhs)
                 : current_tree_(rhs.current_tree_),
                   current_node_(rhs.current_node_),
+                  current_index_(rhs.current_index_),
                   predicates_(std::move(rhs.predicates_)),
                   nearest_points_iterated_(rhs.nearest_points_iterated_) {
                 nearest_queue_.reserve(rhs.nearest_queue_.size());
@@ -297,6 +324,7 @@ namespace pareto {
             iterator_impl &operator=(iterator_impl<rhs_is_const> &&rhs) {
                 current_tree_ = rhs.current_tree_;
                 current_node_ = rhs.current_node_;
+                current_index_ = rhs.current_index_;
                 predicates_ = std::move(rhs.predicates_);
                 nearest_points_iterated_ = rhs.nearest_points_iterated_;
                 nearest_queue_ = rhs.nearest_queue_;
@@ -308,7 +336,13 @@ namespace pareto {
             /// When the current pointer == nullptr, we are at end().
             /// We need the tree_ so that a.end() != b.end().
             iterator_impl(tree_pointer tree_, node_pointer root_)
-                : current_tree_(tree_), current_node_(root_), nearest_queue_{},
+                : iterator_impl(tree_, root_, 0) {}
+
+            /// \brief Iterator to a value in the bucket of a node
+            iterator_impl(tree_pointer tree_, node_pointer node_,
+                          size_t index)
+                : current_tree_(tree_), current_node_(node_),
+                  current_index_(index), nearest_queue_{},
                   nearest_points_iterated_(0) {
                 advance_if_invalid();
             }
@@ -355,11 +389,12 @@ namespace pareto {
             reference operator*() const {
                 assert(is_not_null());
                 constexpr bool is_protected = std::is_const_v<
-                    typename decltype(current_node_->value_)::first_type>;
+                    typename unprotected_value_type::first_type>;
                 if constexpr (is_protected) {
-                    return current_node_->value_;
+                    return current_node_->values_[current_index_];
                 } else {
-                    return protect_pair_key(current_node_->value_);
+                    return protect_pair_key(
+                        current_node_->values_[current_index_]);
                 }
             }
 
@@ -384,7 +419,9 @@ namespace pareto {
                     return false;
                 } else {
                     return (current_node_ == rhs.current_node_) &&
-                           (current_tree_ == rhs.current_tree_);
+                           (current_tree_ == rhs.current_tree_) &&
+                           (current_node_ == nullptr ||
+                            current_index_ == rhs.current_index_);
                 }
             }
 
@@ -427,7 +464,7 @@ namespace pareto {
                     predicates_.get_nearest() != nullptr &&
                     nearest_points_iterated_ == 0;
                 if (need_to_iterate_to_nearest ||
-                    !predicates_.pass_predicate(current_node_->value_)) {
+                    !predicates_.pass_predicate(current_value())) {
                     // advance if current is not valid
                     advance_to_next_valid(false);
                 }
@@ -443,12 +480,47 @@ namespace pareto {
                 if (current_tree_ == nullptr) {
                     return false;
                 }
-                return current_node_ == current_tree_->root_;
+                return current_node_ == current_tree_->root_ &&
+                       current_index_ == 0;
             }
 
             /// \brief Is iterator_impl pointing to valid data
             [[nodiscard]] bool is_not_null() const { return !is_end(); }
 
+            /// \brief Value the iterator points to
+            const unprotected_value_type &current_value() const {
+                return current_node_->values_[current_index_];
+            }
+
+            /// \brief Enqueue the values and children of a node by their
+            /// distance to the reference point
+            void enqueue_nearest(node_pointer node) {
+                auto nearest_predicate = predicates_.get_nearest();
+                for (size_t i = 0; i < node->values_.size(); ++i) {
+                    nearest_queue_.emplace_back(
+                        node, i,
+                        nearest_predicate->distance(node->values_[i].first));
+                    std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
+                                   queue_comp);
+                }
+                // left child
+                if (node->l_child) {
+                    nearest_queue_.emplace_back(
+                        node->l_child, node_index,
+                        nearest_predicate->distance(node->l_child->bounds_));
+                    std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
+                                   queue_comp);
+                }
+                // right child
+                if (node->r_child) {
+                    nearest_queue_.emplace_back(
+                        node->r_child, node_index,
+                        nearest_predicate->distance(node->r_child->bounds_));
+                    std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
+                                   queue_comp);
+                }
+            }
+
             /// \brief Initialize queue for the nearest element algorithm
             void initialize_nearest_algorithm() {
                 auto nearest_predicate = predicates_.get_nearest();
@@ -456,6 +528,11 @@ namespace pareto {
                     return;
                 }
 
+                // An empty tree has no root and no nearest points
+                if (current_node_ == nullptr) {
+                    return;
+                }
+
                 // If this is the end iterator
                 if (is_end()) {
                     // We already pre-process all the results
@@ -494,28 +571,8 @@ namespace pareto {
                 // the distance doesn't matter. It's just easier to Enqueue all
                 // branches of quad-containers.RootNode already, as would always
                 // happen at the first iteration anyway. Because this is a
-                // quad-containers, we also enqueue the node value. node itself
-                nearest_queue_.emplace_back(
-                    current_node_, true,
-                    nearest_predicate->distance(current_node_->value_.first));
-                std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
-                               queue_comp);
-                // left child
-                if (current_node_->l_child) {
-                    nearest_queue_.emplace_back(
-                        current_node_->l_child, false,
-                        nearest_predicate->distance(current_node_->bounds_));
-                    std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
-                                   queue_comp);
-                }
-                // right child
-                if (current_node_->r_child) {
-                    nearest_queue_.emplace_back(
-                        current_node_->r_child, false,
-                        nearest_predicate->distance(current_node_->bounds_));
-                    std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
-                                   queue_comp);
-                }
+                // quad-containers, we also enqueue the node values.
+                enqueue_nearest(current_node_);
 
                 // 3. while not IsEmpty(Queue) do
                 // From this point the algorithm is implemented inside the
@@ -537,11 +594,10 @@ namespace pareto {
                 // If we already iterated this nearest point in the past
                 // we should have the pre-processed results
                 while (nearest_points_iterated_ < nearest_set_.size()) {
-                    bool is_value;
                     bool passed_predicate;
-                    std::tie(current_node_, is_value, passed_predicate) =
+                    std::tie(current_node_, current_index_, passed_predicate) =
                         nearest_set_[nearest_points_iterated_];
-                    assert(is_value);
+                    assert(current_index_ != node_index);
                     ++nearest_points_iterated_;
                     if (passed_predicate) {
                         return;
@@ -555,9 +611,8 @@ namespace pareto {
                 // 3. while not IsEmpty(Queue) do
                 while (!nearest_queue_.empty()) {
                     // 4. Element <- Dequeue(Queue)
-                    auto [element_node, is_value, distance] =
+                    auto [element_node, element_index, distance] =
                         nearest_queue_.front();
-                    auto &element = element_node->value_;
                     std::pop_heap(nearest_queue_.begin(), nearest_queue_.end(),
                                   queue_comp);
                     nearest_queue_.pop_back();
@@ -566,27 +621,29 @@ namespace pareto {
                     // bounding rectangle because we only represent points in
                     // our containers. So we only test if it's an object (a
                     // value).
-                    if (is_value) {
+                    if (element_index != node_index) {
                         // 6. if Element is the bounding rectangle
                         //     7. That never happens in our containers
                         // 8. else
                         // 9.     Report Element
                         // in our version, we only report it if it also passes
                         // the other predicates
-                        if (predicates_.pass_predicate(element)) {
+                        if (predicates_.pass_predicate(
+                                element_node->values_[element_index])) {
                             ++nearest_points_iterated_;
                             current_node_ = element_node;
+                            current_index_ = element_index;
                             // put it in the pre-processed set of results
-                            nearest_set_.emplace_back(current_node_, true,
-                                                      true);
+                            nearest_set_.emplace_back(current_node_,
+                                                      current_index_, true);
                             return;
                         } else {
                             // if it doesn't pass the predicates, we just count
                             // it as one more nearest point we would have
                             // reported
                             ++nearest_points_iterated_;
-                            nearest_set_.emplace_back(current_node_, true,
-                                                      false);
+                            nearest_set_.emplace_back(element_node,
+                                                      element_index, false);
                             if (nearest_points_iterated_ >=
                                 nearest_predicate->k()) {
                                 advance_to_end();
@@ -603,32 +660,9 @@ namespace pareto {
                         // Element do
                         // 16. for each entry (Node,   Rect) in      node
                         // Element do node value
-                        nearest_queue_.emplace_back(
-                            element_node, true,
-                            nearest_predicate->distance(
-                                element_node->value_.first));
-                        std::push_heap(nearest_queue_.begin(),
-                                       nearest_queue_.end(), queue_comp);
                         // 13. Enqueue(Queue, [Object], Dist(QueryObject, Rect))
                         // 17. Enqueue(Queue, Node,     Dist(QueryObject, Rect))
-                        // left child
-                        if (element_node->l_child) {
-                            nearest_queue_.emplace_back(
-                                element_node->l_child, false,
-                                nearest_predicate->distance(
-                                    element_node->l_child->bounds_));
-                            std::push_heap(nearest_queue_.begin(),
-                                           nearest_queue_.end(), queue_comp);
-                        }
-                        // right child
-                        if (element_node->r_child) {
-                            nearest_queue_.emplace_back(
-                                element_node->r_child, false,
-                                nearest_predicate->distance(
-                                    element_node->r_child->bounds_));
-                            std::push_heap(nearest_queue_.begin(),
-                                           nearest_queue_.end(), queue_comp);
-                        }
+                        enqueue_nearest(element_node);
                     }
                 }
                 // Nothing else to report
@@ -651,11 +685,11 @@ namespace pareto {
                     } else {
                         // if nearest_points_iterated_ - 1 is already
                         // pre-processed
-                        bool is_value;
                         bool passed_predicate;
-                        std::tie(current_node_, is_value, passed_predicate) =
+                        std::tie(current_node_, current_index_,
+                                 passed_predicate) =
                             nearest_set_[nearest_points_iterated_ - 1];
-                        assert(is_value);
+                        assert(current_index_ != node_index);
                         --nearest_points_iterated_;
                         if (passed_predicate) {
                             return;
@@ -675,6 +709,7 @@ namespace pareto {
             void return_to_begin() {
                 if (current_tree_ != nullptr) {
                     current_node_ = current_tree_->root_;
+                    current_index_ = 0;
                 }
             }
 
@@ -687,12 +722,19 @@ namespace pareto {
                     // return if first time
                     // if we haven't checked the current node yet
                     if (first_time_in_this_branch) {
-                        if (predicates_.pass_predicate(current_node_->value_)) {
+                        if (predicates_.pass_predicate(current_value())) {
                             // found a valid value in current node
                             // point to it (already does) and return
                             return;
                         }
                         first_time_in_this_branch = false;
+                    } else if (current_index_ + 1 <
+                               current_node_->values_.size()) {
+                        // try the next value in the bucket
+                        ++current_index_;
+                        if (predicates_.pass_predicate(current_value())) {
+                            return;
+                        }
                     } else {
                         // if we already checked this node,
                         // go to first valid child if there are children, stop
@@ -732,6 +774,7 @@ namespace pareto {
                             go_to_sibling(true);
                             first_time_in_this_branch = true;
                         }
+                        current_index_ = 0;
                     }
                 }
             }
@@ -744,12 +787,19 @@ namespace pareto {
                 while (!is_begin()) {
                     // return if first time
                     if (first_time_in_this_branch) {
-                        if (predicates_.pass_predicate(current_node_->value_)) {
+                        if (predicates_.pass_predicate(current_value())) {
                             // found a valid value in current node
                             // point to it (already does) and return
                             return;
                         }
                         first_time_in_this_branch = false;
+                    } else if (current_node_ != nullptr &&
+                               current_index_ > 0) {
+                        // try the previous value in the bucket
+                        --current_index_;
+                        if (predicates_.pass_predicate(current_value())) {
+                            return;
+                        }
                     } else {
                         // go to left sibling and then to rightmost valid
                         // element, stop iterating if this is end(), left
@@ -784,6 +834,8 @@ namespace pareto {
                                 }
                             }
                         }
+                        // start from the last value in the bucket
+                        current_index_ = current_node_->values_.size() - 1;
                         first_time_in_this_branch = true;
                     }
                 }
@@ -911,15 +963,23 @@ namespace pareto {
             /// \brief Stack as we are doing iteration instead of recursion
             node_pointer current_node_{nullptr};
 
+            /// \brief Position of the current value in the node bucket
+            size_t current_index_{0};
+
             /// \brief Predicate constraining the search area
             predicate_list_type predicates_{};
 
+            /// \brief Index of queue elements that represent a whole node
+            static constexpr size_t node_index =
+                std::numeric_limits<size_t>::max();
+
             /// \brief Pair with branch (node or object) and distance to the
-            /// reference point The branch is represented by the node and a
-            /// boolean marking if the pointer represents itself or its value
-            /// tuple<node, represents value, distance>
+            /// reference point The branch is represented by the node and
+            /// the index of a value in its bucket, or node_index if the
+            /// pointer represents the node itself
+            /// tuple<node, value index, distance>
             using queue_element =
-                std::tuple<node_pointer, bool,
+                std::tuple<node_pointer, size_t,
                            typename point_type::distance_type>;
 
             /// \brief Function to compare queue_elements by their distance to
@@ -937,8 +997,8 @@ namespace pareto {
             /// \brief Set of nearest values we have already found
             /// Some pointers represent the value of a node
             /// Some pointers represent the node itself with its bounding box
-            /// tuple<node, represents value, passed predicate>
-            std::vector<std::tuple<node_pointer, bool, bool>> nearest_set_;
+            /// tuple<node, value index, passed predicate>
+            std::vector<std::tuple<node_pointer, size_t, bool>> nearest_set_;
 
           public:
             /// \brief Let implicit tree access the spatial private constructors
@@ -976,7 +1036,8 @@ namespace pareto {
             : size_(rhs.size_), dimensions_(rhs.dimensions_),
               alloc_(std::allocator_traits<node_allocator_type>::
                          select_on_container_copy_construction(rhs.alloc_)),
-              comp_(rhs.comp_) {
+              comp_(rhs.comp_), balance_factor_(rhs.balance_factor_),
+              max_size_(rhs.max_size_) {
             if (rhs.root_ != nullptr) {
                 root_ = allocate_kdtree_node();
                 copy_recursive(root_, rhs.root_);
@@ -990,7 +1051,8 @@ namespace pareto {
             : size_(rhs.size_), dimensions_(rhs.dimensions_),
               alloc_(std::allocator_traits<node_allocator_type>::
                          select_on_container_copy_construction(alloc)),
-              comp_(rhs.comp_) {
+              comp_(rhs.comp_), balance_factor_(rhs.balance_factor_),
+              max_size_(rhs.max_size_) {
             if (rhs.root_ != nullptr) {
                 root_ = allocate_kdtree_node();
                 copy_recursive(root_, rhs.root_);
@@ -1006,7 +1068,8 @@ namespace pareto {
         kd_tree(kd_tree &&rhs) noexcept
             : root_(std::move(rhs.root_)), size_(rhs.size_),
               dimensions_(rhs.dimensions_), alloc_(std::move(rhs.alloc_)),
-              comp_(rhs.comp_) {
+              comp_(rhs.comp_), balance_factor_(rhs.balance_factor_),
+              max_size_(rhs.max_size_) {
             rhs.root_ = nullptr;
         }
 
@@ -1016,7 +1079,8 @@ namespace pareto {
               dimensions_(rhs.dimensions_),
               alloc_(std::allocator_traits<node_allocator_type>::
                          select_on_container_copy_construction(alloc)),
-              comp_(rhs.comp_) {
+              comp_(rhs.comp_), balance_factor_(rhs.balance_factor_),
+              max_size_(rhs.max_size_) {
             rhs.root_ = nullptr;
         }
 
@@ -1101,6 +1165,8 @@ namespace pareto {
             size_ = rhs.size_;
             dimensions_ = rhs.dimensions_;
             comp_ = rhs.comp_;
+            balance_factor_ = rhs.balance_factor_;
+            max_size_ = rhs.max_size_;
             constexpr bool should_copy = std::allocator_traits<
                 allocator_type>::propagate_on_container_copy_assignment::value;
             if constexpr (should_copy) {
@@ -1136,6 +1202,8 @@ namespace pareto {
             size_ = rhs.size_;
             dimensions_ = rhs.dimensions_;
             comp_ = rhs.comp_;
+            balance_factor_ = rhs.balance_factor_;
+            max_size_ = rhs.max_size_;
             const bool should_move = std::allocator_traits<
                 allocator_type>::propagate_on_container_move_assignment::value;
             if constexpr (should_move) {
@@ -1322,6 +1390,143 @@ namespace pareto {
                          : std::numeric_limits<dimension_type>::min();
         }
 
+      public /* Freezing */:
+        /// \brief Copy the elements to an immutable array-based kd-tree
+        /// The frozen tree has the same const query interface and no
+        /// nodes to allocate or follow.
+        frozen_kd_tree<K, M, T, C, A> freeze() const {
+            return frozen_kd_tree<K, M, T, C, A>(begin(), end(), comp_,
+                                                 get_allocator());
+        }
+
+      public /* Balancing */:
+        /// \brief Get the balance factor
+        /// A subtree is unbalanced when one of its children has more than
+        /// balance_factor() * subtree size elements. Unbalanced subtrees
+        /// are rebuilt when an insertion makes the tree too deep. The tree
+        /// is fully rebuilt when erasures make it smaller than
+        /// balance_factor() * its largest size since the last rebuild.
+        [[nodiscard]] double balance_factor() const noexcept {
+            return balance_factor_;
+        }
+
+        /// \brief Set the balance factor
+        /// Values range from 0.5 (always rebuild to a perfect tree) to 1.0
+        /// (never rebuild). Smaller values give shallower trees and more
+        /// frequent rebuilds.
+        void balance_factor(double alpha) {
+            assert(alpha >= 0.5 && alpha <= 1.0);
+            balance_factor_ = alpha;
+        }
+
+        /// \brief Rebuild the whole tree with median splits
+        void rebalance() {
+            if (root_ != nullptr) {
+                rebuild_subtree(root_);
+            }
+            max_size_ = size_;
+        }
+
+        /// \brief Number of levels in the tree
+        /// This takes linear time because we do not keep node depths.
+        [[nodiscard]] size_t height() const {
+            size_t h = 0;
+            std::vector<std::pair<const kdtree_node *, size_t>> stack;
+            if (root_ != nullptr) {
+                stack.emplace_back(root_, 1);
+            }
+            while (!stack.empty()) {
+                auto [node, depth] = stack.back();
+                stack.pop_back();
+                h = std::max(h, depth);
+                if (node->l_child != nullptr) {
+                    stack.emplace_back(node->l_child, depth + 1);
+                }
+                if (node->r_child != nullptr) {
+                    stack.emplace_back(node->r_child, depth + 1);
+                }
+            }
+            return h;
+        }
+
+        /// \brief Ratio between the height and the height of a perfect tree
+        /// This is 1.0 for a perfectly balanced tree and size() for a
+        /// tree that degenerated into a list.
+        [[nodiscard]] double imbalance() const {
+            if (empty()) {
+                return 1.0;
+            }
+            const double perfect_height =
+                std::ceil(std::log2(static_cast<double>(size_) + 1.0));
+            return static_cast<double>(height()) / perfect_height;
+        }
+
+        /// \brief Check the structure of the tree (for tests)
+        /// Each node has a non-empty bucket, a link to its parent, the
+        /// size of its subtree, and bounds with its values and children.
+        /// The first value of a node splits its subtrees: no value on the
+        /// left is greater and no value on the right is smaller in the
+        /// split dimension.
+        [[nodiscard]] bool check_invariants() const {
+            if (root_ == nullptr) {
+                return size_ == 0;
+            }
+            if (root_->parent_ != nullptr) {
+                return false;
+            }
+            size_t n = 0;
+            std::vector<const kdtree_node *> stack = {root_};
+            while (!stack.empty()) {
+                const kdtree_node *node = stack.back();
+                stack.pop_back();
+                if (node->values_.empty()) {
+                    return false;
+                }
+                size_t subtree_size = node->values_.size();
+                for (const auto &[k, v] : node->values_) {
+                    if (!node->bounds_.contains(k)) {
+                        return false;
+                    }
+                }
+                const size_t d = node->split_dimension_;
+                const dimension_type &splitter = node->values_[0].first[d];
+                for (const kdtree_node *child :
+                     {node->l_child, node->r_child}) {
+                    if (child == nullptr) {
+                        continue;
+                    }
+                    if (child->parent_ != node ||
+                        !node->bounds_.contains(child->bounds_)) {
+                        return false;
+                    }
+                    const bool is_left = child == node->l_child;
+                    std::vector<const kdtree_node *> subtree = {child};
+                    while (!subtree.empty()) {
+                        const kdtree_node *s = subtree.back();
+                        subtree.pop_back();
+                        for (const auto &[k, v] : s->values_) {
+                            if (is_left ? comp_(splitter, k[d])
+                                        : comp_(k[d], splitter)) {
+                                return false;
+                            }
+                        }
+                        for (const kdtree_node *c : {s->l_child, s->r_child}) {
+                            if (c != nullptr) {
+                                subtree.emplace_back(c);
+                            }
+                        }
+                    }
+                    subtree_size += child->subtree_size_;
+                    stack.emplace_back(child);
+                }
+                if (subtree_size != node->subtree_size_) {
+                    return false;
+                }
+                n += node->values_.size();
+            }
+            return n == size_;
+        }
+
       public /* Modifying Functions: Container + AllocatorAwareContainer */:
         /// \brief Swap the content of two objects
         /// Swap will replace the allocator only if
@@ -1341,6 +1546,8 @@ namespace pareto {
             std::swap(size_, rhs.size_);
             std::swap(dimensions_, rhs.dimensions_);
             std::swap(comp_, rhs.comp_);
+            std::swap(balance_factor_, rhs.balance_factor_);
+            std::swap(max_size_, rhs.max_size_);
             const bool should_swap = std::allocator_traits<
                 allocator_type>::propagate_on_container_swap::value;
             if constexpr (should_swap) {
@@ -1355,6 +1562,7 @@ namespace pareto {
             remove_all_records();
             root_ = nullptr;
             size_ = 0;
+            max_size_ = 0;
         }
 
         /// \brief Insert entry
@@ -1364,13 +1572,14 @@ namespace pareto {
         /// \return Iterator to the new element
         /// \return True if insertion happened successfully
         iterator insert(const value_type &v) {
-            kdtree_node *destination_node = insert_branch(v, root_);
-            return iterator(this, destination_node);
+            auto [destination_node, index] = insert_branch(v, root_);
+            return iterator(this, destination_node, index);
         }
 
         iterator insert(value_type &&v) {
-            kdtree_node *destination_node = insert_branch(std::move(v), root_);
-            return iterator(this, destination_node);
+            auto [destination_node, index] =
+                insert_branch(std::move(v), root_);
+            return iterator(this, destination_node, index);
         }
 
         template <class P> iterator insert(P &&v) {
@@ -1431,12 +1640,13 @@ namespace pareto {
             // might still invalidate the iterators
             iterator next_position = std::next(position);
             kdtree_node *node_to_remove = position.current_node_;
+            size_t index_to_remove = position.current_index_;
             if (next_position != end()) {
                 key_type next_key = next_position->first;
-                erase_impl(node_to_remove);
+                erase_impl(node_to_remove, index_to_remove);
                 return find(next_key);
             } else {
-                erase_impl(node_to_remove);
+                erase_impl(node_to_remove, index_to_remove);
                 return end();
             }
         }
@@ -1696,7 +1906,8 @@ namespace pareto {
             if (empty()) {
                 return end();
             }
-            return iterator(this, recursive_max_element(root_, dimension));
+            auto [node, index] = recursive_max_element(root_, dimension);
+            return iterator(this, node, index);
         }
 
         /// \brief Get iterator to element with maximum value in a given
@@ -1705,8 +1916,8 @@ namespace pareto {
             if (empty()) {
                 return end();
             }
-            return const_iterator(this,
-                                  recursive_max_element(root_, dimension));
+            auto [node, index] = recursive_max_element(root_, dimension);
+            return const_iterator(this, node, index);
         }
 
         /// \brief Get iterator to element with minimum value in a given
@@ -1715,7 +1926,8 @@ namespace pareto {
             if (empty()) {
                 return end();
             }
-            return iterator(this, recursive_min_element(root_, dimension));
+            auto [node, index] = recursive_min_element(root_, dimension);
+            return iterator(this, node, index);
         }
 
         /// \brief Get iterator to element with minimum value in a given
@@ -1724,8 +1936,8 @@ namespace pareto {
             if (empty()) {
                 return end();
             }
-            return const_iterator(this,
-                                  recursive_min_element(root_, dimension));
+            auto [node, index] = recursive_min_element(root_, dimension);
+            return const_iterator(this, node, index);
         }
 
       public /* Non-Modifying Functions: AssociativeContainer */:
@@ -1754,37 +1966,39 @@ namespace pareto {
         dimension_compare dimension_comp() const noexcept { return comp_; }
 
       private:
-        /// \brief Erase node from kd-containers
+        /// \brief Erase a value from kd-containers
         /// \see https://www.cs.cmu.edu/~ckingsf/bioinfo-lectures/kdtrees.pdf
-        size_t erase_impl(kdtree_node *node_to_remove) {
+        size_t erase_impl(kdtree_node *node_to_remove, size_t index) {
             // if this is empty
             if (node_to_remove == nullptr) {
                 // we can't remove anything
                 return 0;
             }
 
-            if (node_to_remove->is_internal_node()) {
-                kdtree_node *min_cd = nullptr;
+            kdtree_node *current = node_to_remove;
+            if (node_to_remove->values_.size() > 1 &&
+                (index != 0 || node_to_remove->is_leaf_node())) {
+                // other values remain in the bucket: the last value takes
+                // the place of the one we remove. The value splitting the
+                // children of an internal node stays in the first slot.
+                node_to_remove->values_.swap_and_pop(index);
+            } else if (node_to_remove->is_internal_node()) {
+                std::pair<kdtree_node *, size_t> min_cd;
                 // use min(cd) from right subtree:
-                if (node_to_remove->r_child != nullptr) {
-                    min_cd =
-                        recursive_min_element(node_to_remove->r_child,
-                                              node_to_remove->split_dimension_);
-                    node_to_remove->value_ = min_cd->value_;
-                } else if (node_to_remove->l_child != nullptr) {
+                if (node_to_remove->r_child == nullptr) {
                     // swap subtrees and use min(cd) from new right:
                     std::swap(node_to_remove->l_child, node_to_remove->r_child);
-                    min_cd =
-                        recursive_min_element(node_to_remove->r_child,
-                                              node_to_remove->split_dimension_);
-                    node_to_remove->value_ = min_cd->value_;
                 }
+                min_cd = recursive_min_element(node_to_remove->r_child,
+                                               node_to_remove->split_dimension_);
+                node_to_remove->values_[0] =
+                    min_cd.first->values_[min_cd.second];
                 // erase_impl min_cd recursively
-                return erase_impl(min_cd);
+                return erase_impl(min_cd.first, min_cd.second);
             } else {
                 // we’re a leaf: just update bounds and remove
                 // remove link from parent node
-                auto current = node_to_remove->parent_;
+                current = node_to_remove->parent_;
                 if (current != nullptr) {
                     if (current->l_child == node_to_remove) {
                         current->l_child = nullptr;
@@ -1794,18 +2008,26 @@ namespace pareto {
                 } else {
                     root_ = nullptr;
                 }
-                // update parent node bounds up to the root
-                while (current != nullptr) {
-                    current->bounds_ = minimum_bounding_rectangle(current);
-                    current = current->parent_;
-                }
                 // deallocate node
                 deallocate_kdtree_node(node_to_remove);
+            }
 
-                assert(size_ > 0);
-                --size_;
-                return 1;
+            // update node bounds up to the root
+            while (current != nullptr) {
+                current->bounds_ = minimum_bounding_rectangle(current);
+                --current->subtree_size_;
+                current = current->parent_;
+            }
+
+            assert(size_ > 0);
+            --size_;
+            // rebuild everything once erasures shrank the tree enough
+            if (balance_factor_ < 1.0 &&
+                static_cast<double>(size_) <
+                    balance_factor_ * static_cast<double>(max_size_)) {
+                rebalance();
             }
+            return 1;
         }
 
         /// \brief Bulk insertion inserts the median before other elements
@@ -1876,17 +2098,16 @@ namespace pareto {
         }
 
         /// \brief Insert a value into a containers node
-        /// insert_branch provides for splitting the root;
-        /// insert_branch_recursive does the recursion.
-        /// \param value Value to be inserted
-        /// \param a_root Node where we should insert the value (usually root
-        /// node) \param a_level Number of steps up from the leaf level to
-        /// insert e.g. a data rectangle goes in at level = 0. \return return 1
-        /// if root was split, 0 if it was not. \return Pointer to the node
-        /// containing the value we inserted \return Index of the element we
-        /// inserted in the node that contains it
-        kdtree_node *insert_branch(const value_type &v,
-                                   kdtree_node *&root_node) {
+        /// The value goes to the first node with room in its bucket on the
+        /// path to the region that contains the point. If all buckets on
+        /// the path are full, we create a new leaf.
+        /// \param v Value to be inserted
+        /// \param root_node Node where we should insert the value (usually
+        /// root node)
+        /// \return Pointer to the node containing the value we inserted
+        /// \return Index of the value in the bucket of that node
+        std::pair<kdtree_node *, size_t>
+        insert_branch(const value_type &v, kdtree_node *&root_node) {
             if constexpr (number_of_compile_dimensions == 0) {
                 if (dimensions_ == 0) {
                     dimensions_ = v.first.dimensions();
@@ -1896,51 +2117,294 @@ namespace pareto {
             if (root_node == nullptr) {
                 root_node = allocate_kdtree_node(nullptr, v, 0);
                 ++size_;
-                return root_node;
+                max_size_ = std::max(max_size_, size_);
+                return {root_node, 0};
             }
 
             // Find the region that would contain the point P.
             kdtree_node *current = root_node;
-            bool on_the_right_side =
-                !comp_(v.first[current->split_dimension_],
-                       current->value_.first[current->split_dimension_]);
-            auto side_ptr =
-                !on_the_right_side ? current->l_child : current->r_child;
-            while (side_ptr != nullptr) {
-                current = side_ptr;
-                on_the_right_side =
+            kdtree_node *new_node = nullptr;
+            size_t index = 0;
+            size_t depth = 1;
+            while (true) {
+                if (!current->values_.full()) {
+                    // There is room in this bucket
+                    index = current->values_.size();
+                    current->values_.emplace_back(v);
+                    break;
+                }
+                const bool on_the_right_side =
                     !comp_(v.first[current->split_dimension_],
-                           current->value_.first[current->split_dimension_]);
-                side_ptr =
+                           current->values_[0].first[current->split_dimension_]);
+                kdtree_node *&side_ptr =
                     !on_the_right_side ? current->l_child : current->r_child;
-            }
-
-            // Add point where you fall off the tree.
-            // The element would be in current->children_[quadrant]
-            kdtree_node *new_node = allocate_kdtree_node(
-                current, v, (current->split_dimension_ + 1) % dimensions());
-            if (!on_the_right_side) {
-                current->l_child = new_node;
-            } else {
-                current->r_child = new_node;
+                if (side_ptr == nullptr) {
+                    // Add point where you fall off the tree.
+                    new_node = allocate_kdtree_node(
+                        current, v,
+                        (current->split_dimension_ + 1) % dimensions());
+                    side_ptr = new_node;
+                    break;
+                }
+                current = side_ptr;
+                ++depth;
             }
 
             /// \brief Adjust the minimum bounds up to the root
+            kdtree_node *destination_node =
+                new_node != nullptr ? new_node : current;
             current->bounds_.stretch(v.first);
+            ++current->subtree_size_;
             while (current->parent_ != nullptr) {
                 current = current->parent_;
                 current->bounds_.stretch(v.first);
+                ++current->subtree_size_;
             }
 
             ++size_;
-            return new_node;
+            max_size_ = std::max(max_size_, size_);
+            if (new_node == nullptr) {
+                return {destination_node, index};
+            }
+            if (depth > max_balanced_depth()) {
+                return rebuild_scapegoat(new_node);
+            }
+            return {new_node, 0};
+        }
+
+        /// \brief Maximum depth of a new leaf before we look for a scapegoat
+        /// A tree where no subtree is unbalanced has depth at most
+        /// log_{1/alpha}(n), where n is the number of nodes. We estimate
+        /// the number of nodes from the bucket size.
+        [[nodiscard]] size_t max_balanced_depth() const {
+            if (balance_factor_ >= 1.0) {
+                return std::numeric_limits<size_t>::max();
+            }
+            const double nodes = std::max(
+                1.0, static_cast<double>(size_) / static_cast<double>(bucket_size));
+            return static_cast<size_t>(std::log(nodes) /
+                                       -std::log(balance_factor_));
+        }
+
+        /// \brief Rebuild the highest unbalanced ancestor of a new leaf
+        /// Looking for the highest ancestor instead of the first one
+        /// costs the same O(depth) and fixes the depth of the whole path.
+        /// \return Node and position of the value in the new leaf
+        std::pair<kdtree_node *, size_t>
+        rebuild_scapegoat(kdtree_node *new_node) {
+            kdtree_node *scapegoat = nullptr;
+            kdtree_node *child = new_node;
+            while (child->parent_ != nullptr) {
+                kdtree_node *parent = child->parent_;
+                if (static_cast<double>(child->subtree_size_) >
+                    balance_factor_ *
+                        static_cast<double>(parent->subtree_size_)) {
+                    scapegoat = parent;
+                }
+                child = parent;
+            }
+            if (scapegoat != nullptr) {
+                return rebuild_subtree(scapegoat, {new_node, 0});
+            }
+            return {new_node, 0};
+        }
+
+        /// \brief Rebuild a subtree so that each node splits its elements at
+        /// the median
+        /// Without buckets, the nodes are relinked rather than reallocated,
+        /// so pointers to nodes and the values they hold remain valid.
+        /// Splitting the nodes by their first values would leave the other
+        /// values in their buckets on the wrong side of the new splits, so
+        /// buckets are split by value and refilled.
+        /// \param tracked Node and position of a value we want to find
+        /// \return Node and position of the tracked value after the rebuild
+        std::pair<kdtree_node *, size_t>
+        rebuild_subtree(kdtree_node *subtree_root,
+                        std::pair<kdtree_node *, size_t> tracked = {nullptr,
+                                                                    0}) {
+            kdtree_node *parent = subtree_root->parent_;
+            kdtree_node **link = &root_;
+            if (parent != nullptr) {
+                link = parent->l_child == subtree_root ? &parent->l_child
+                                                        : &parent->r_child;
+            }
+            // Collect nodes without recursion: unbalanced subtrees
+            // might be too deep for the stack
+            std::vector<kdtree_node *> nodes;
+            nodes.reserve(subtree_root->subtree_size_);
+            nodes.emplace_back(subtree_root);
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                if (nodes[i]->l_child != nullptr) {
+                    nodes.emplace_back(nodes[i]->l_child);
+                }
+                if (nodes[i]->r_child != nullptr) {
+                    nodes.emplace_back(nodes[i]->r_child);
+                }
+            }
+            const size_t split_dimension = subtree_root->split_dimension_;
+            if constexpr (bucket_size == 1) {
+                *link = build_balanced(nodes.begin(), nodes.end(), parent,
+                                       split_dimension);
+                return tracked;
+            } else {
+                std::vector<unprotected_value_type> values;
+                values.reserve(subtree_root->subtree_size_);
+                constexpr size_t not_tracked =
+                    std::numeric_limits<size_t>::max();
+                size_t tracked_index = not_tracked;
+                for (kdtree_node *node : nodes) {
+                    for (size_t i = 0; i < node->values_.size(); ++i) {
+                        if (node == tracked.first && i == tracked.second) {
+                            tracked_index = values.size();
+                        }
+                        values.emplace_back(std::move(node->values_[i]));
+                    }
+                    node->values_.clear();
+                }
+                std::vector<size_t> idx(values.size());
+                for (size_t i = 0; i < idx.size(); ++i) {
+                    idx[i] = i;
+                }
+                std::pair<kdtree_node *, size_t> location = {nullptr, 0};
+                *link = build_balanced_buckets(
+                    idx.begin(), idx.end(), values, nodes, parent,
+                    split_dimension, tracked_index, location);
+                // buckets are full now, so some nodes might be left
+                for (kdtree_node *node : nodes) {
+                    deallocate_kdtree_node(node);
+                }
+                return location;
+            }
+        }
+
+        /// \brief Link nodes holding a range of values into a tree split at
+        /// the medians
+        /// The median splits the values and the bucket of the node takes
+        /// values from the larger side. Values equal to the median go to
+        /// the right, as in insertion.
+        /// \param first First index of a value in the range
+        /// \param values Values of the subtree
+        /// \param pool Nodes we can reuse before allocating new ones
+        /// \param tracked Index of a value whose location we want to know
+        /// \param location Output location of the tracked value
+        /// \return The root of the new subtree
+        kdtree_node *build_balanced_buckets(
+            typename std::vector<size_t>::iterator first,
+            typename std::vector<size_t>::iterator last,
+            std::vector<unprotected_value_type> &values,
+            std::vector<kdtree_node *> &pool, kdtree_node *parent,
+            size_t split_dimension, size_t tracked,
+            std::pair<kdtree_node *, size_t> &location) {
+            if (first == last) {
+                return nullptr;
+            }
+            auto coordinate = [&](size_t i) -> const dimension_type & {
+                return values[i].first[split_dimension];
+            };
+            auto median = first + (last - first) / 2;
+            std::nth_element(first, median, last, [&](size_t a, size_t b) {
+                return comp_(coordinate(a), coordinate(b));
+            });
+            const size_t m = *median;
+            auto split = std::partition(first, last, [&](size_t i) {
+                return comp_(coordinate(i), coordinate(m));
+            });
+            std::iter_swap(split, std::find(split, last, m));
+
+            kdtree_node *node = nullptr;
+            if (pool.empty()) {
+                node = allocate_kdtree_node(parent);
+            } else {
+                node = pool.back();
+                pool.pop_back();
+                node->parent_ = parent;
+            }
+            node->split_dimension_ = split_dimension;
+            auto take = [&](size_t i) {
+                if (i == tracked) {
+                    location = {node, node->values_.size()};
+                }
+                node->values_.emplace_back(std::move(values[i]));
+            };
+            take(m);
+            auto l_last = split;
+            auto r_first = std::next(split);
+            while (!node->values_.full() &&
+                   (first != l_last || r_first != last)) {
+                if (l_last - first > last - r_first) {
+                    --l_last;
+                    take(*l_last);
+                } else {
+                    take(*r_first);
+                    ++r_first;
+                }
+            }
+
+            const size_t next_dimension = (split_dimension + 1) % dimensions();
+            node->l_child = build_balanced_buckets(
+                first, l_last, values, pool, node, next_dimension, tracked,
+                location);
+            node->r_child = build_balanced_buckets(
+                r_first, last, values, pool, node, next_dimension, tracked,
+                location);
+            node->subtree_size_ = node->values_.size();
+            if (node->l_child != nullptr) {
+                node->subtree_size_ += node->l_child->subtree_size_;
+            }
+            if (node->r_child != nullptr) {
+                node->subtree_size_ += node->r_child->subtree_size_;
+            }
+            node->bounds_ = minimum_bounding_rectangle(node);
+            return node;
+        }
+
+        /// \brief Link a range of nodes into a tree split at the medians
+        /// Elements equal to the median might go to either side. Queries
+        /// only depend on the bounds, and insertions only need some path
+        /// to a leaf, so this does not break the tree.
+        /// \return The root of the new subtree
+        kdtree_node *
+        build_balanced(typename std::vector<kdtree_node *>::iterator first,
+                       typename std::vector<kdtree_node *>::iterator last,
+                       kdtree_node *parent, size_t split_dimension) {
+            if (first == last) {
+                return nullptr;
+            }
+            auto median = first + (last - first) / 2;
+            std::nth_element(first, median, last,
+                             [this, split_dimension](const kdtree_node *a,
+                                                     const kdtree_node *b) {
+                                 return comp_(
+                                     a->values_[0].first[split_dimension],
+                                     b->values_[0].first[split_dimension]);
+                             });
+            kdtree_node *node = *median;
+            const size_t next_dimension = (split_dimension + 1) % dimensions();
+            node->parent_ = parent;
+            node->split_dimension_ = split_dimension;
+            node->l_child =
+                build_balanced(first, median, node, next_dimension);
+            node->r_child =
+                build_balanced(median + 1, last, node, next_dimension);
+            node->subtree_size_ = node->values_.size();
+            if (node->l_child != nullptr) {
+                node->subtree_size_ += node->l_child->subtree_size_;
+            }
+            if (node->r_child != nullptr) {
+                node->subtree_size_ += node->r_child->subtree_size_;
+            }
+            node->bounds_ = minimum_bounding_rectangle(node);
+            return node;
         }
 
         /// \brief Find the smallest rectangle that includes all rectangles in
         /// branches of a node.
         box_type minimum_bounding_rectangle(kdtree_node *a_node) {
             assert(a_node);
-            box_type rect = box_type(a_node->value_.first);
+            box_type rect = box_type(a_node->values_[0].first);
+            for (size_t i = 1; i < a_node->values_.size(); ++i) {
+                rect.stretch(a_node->values_[i].first);
+            }
             if (a_node->l_child != nullptr) {
                 rect.stretch(a_node->l_child->bounds_);
             }
@@ -1956,9 +2420,10 @@ namespace pareto {
         void copy_recursive(kdtree_node *current, kdtree_node *current_parent,
                             const kdtree_node *other) {
             assert(current != nullptr);
-            current->value_ = other->value_;
+            current->values_ = other->values_;
             current->bounds_ = other->bounds_;
             current->split_dimension_ = other->split_dimension_;
+            current->subtree_size_ = other->subtree_size_;
             current->parent_ = current_parent;
             if (other->l_child != nullptr) {
                 auto l_child = allocate_kdtree_node();
@@ -1981,15 +2446,36 @@ namespace pareto {
             copy_recursive(current, nullptr, other);
         }
 
+        /// \brief Position of the value with the largest or smallest
+        /// coordinate in the bucket of a node
+        template <bool find_max>
+        size_t bucket_extreme(const kdtree_node *node,
+                              size_t dimension) const {
+            size_t best = 0;
+            for (size_t i = 1; i < node->values_.size(); ++i) {
+                const auto &candidate = node->values_[i].first[dimension];
+                const auto &current = node->values_[best].first[dimension];
+                if (find_max ? comp_(current, candidate)
+                             : comp_(candidate, current)) {
+                    best = i;
+                }
+            }
+            return best;
+        }
+
         /// \brief Recursively find max element
-        kdtree_node *recursive_max_element(kdtree_node *parent_node,
-                                           size_t dimension) const {
+        /// \return Node and position of the element in the node bucket
+        std::pair<kdtree_node *, size_t>
+        recursive_max_element(kdtree_node *parent_node,
+                              size_t dimension) const {
+            const size_t best = bucket_extreme<true>(parent_node, dimension);
+            const auto &best_value = parent_node->values_[best].first;
             if (parent_node->is_leaf_node()) {
-                return parent_node;
+                return {parent_node, best};
             }
-            if (!comp_(parent_node->value_.first[dimension],
+            if (!comp_(best_value[dimension],
                        parent_node->bounds_.second()[dimension])) {
-                return parent_node;
+                return {parent_node, best};
             }
             // we could iterate only though the elements that have
             // quadrant[dimension] == 1 but both algorithms would be O(n) on
@@ -2010,23 +2496,27 @@ namespace pareto {
                 max_ptr = parent_node->r_child;
             }
             assert(max_ptr != nullptr);
-            if (!comp_(parent_node->value_.first[dimension],
+            if (!comp_(best_value[dimension],
                        max_ptr->bounds_.second()[dimension])) {
-                return parent_node;
+                return {parent_node, best};
             } else {
                 return recursive_max_element(max_ptr, dimension);
             }
         }
 
         /// \brief Recursively find min element
-        kdtree_node *recursive_min_element(kdtree_node *parent_node,
-                                           size_t dimension) const {
+        /// \return Node and position of the element in the node bucket
+        std::pair<kdtree_node *, size_t>
+        recursive_min_element(kdtree_node *parent_node,
+                              size_t dimension) const {
+            const size_t best = bucket_extreme<false>(parent_node, dimension);
+            const auto &best_value = parent_node->values_[best].first;
             if (parent_node->is_leaf_node()) {
-                return parent_node;
+                return {parent_node, best};
             }
             if (!comp_(parent_node->bounds_.first()[dimension],
-                       parent_node->value_.first[dimension])) {
-                return parent_node;
+                       best_value[dimension])) {
+                return {parent_node, best};
             }
             // we could iterate only though the elements that have
             // quadrant[dimension] == 1 but both algorithms would be O(n) on
@@ -2048,8 +2538,8 @@ namespace pareto {
             }
             assert(min_ptr != nullptr);
             if (!comp_(min_ptr->bounds_.first()[dimension],
-                       parent_node->value_.first[dimension])) {
-                return parent_node;
+                       best_value[dimension])) {
+                return {parent_node, best};
             } else {
                 return recursive_min_element(min_ptr, dimension);
             }
@@ -2093,9 +2583,10 @@ namespace pareto {
         std::string to_string(const kdtree_node *current, size_t level) const {
             std::string str(level * 2, ' ');
             std::stringstream ss;
-            ss << current->value_.first;
-            // ss << current->value_.first << ": " << current->value_.second;
-            assert(current->bounds_.contains(current->value_.first));
+            for (size_t i = 0; i < current->values_.size(); ++i) {
+                ss << current->values_[i].first << " ";
+                assert(current->bounds_.contains(current->values_[i].first));
+            }
             str += ss.str() + "\n";
             if (current->l_child != nullptr) {
                 str += to_string(current->l_child, level + 1);
@@ -2110,6 +2601,8 @@ namespace pareto {
             iterator it(const_cast<kd_tree *>(position.current_tree_),
                         const_cast<kdtree_node *>(position.current_node_),
                         position.predicates_);
+            it.current_node_ = const_cast<kdtree_node *>(position.current_node_);
+            it.current_index_ = position.current_index_;
             it.nearest_queue_.reserve(position.nearest_queue_.size());
             for (const auto &[a, b, c] : position.nearest_queue_) {
                 it.nearest_queue_.emplace_back(
@@ -2166,20 +2659,26 @@ namespace pareto {
 
         /// \brief Key comparison (single dimension)
         dimension_compare comp_{dimension_compare()};
+
+        /// \brief Maximum fraction of a subtree in one of its children
+        double balance_factor_{0.7};
+
+        /// \brief Largest size since the last full rebuild
+        size_t max_size_{0};
     };
 
     // MSVC hack (we cannot define it in iterator_impl)
-    template <class N, size_t M, class E, class C, class A>
+    template <class N, size_t M, class E, class C, class A, size_t B>
     template <bool is_const>
     const std::function<
-        bool(const typename kd_tree<N, M, E, C, A>::template iterator_impl<
+        bool(const typename kd_tree<N, M, E, C, A, B>::template iterator_impl<
                  is_const>::queue_element &,
-             const typename kd_tree<N, M, E, C, A>::template iterator_impl<
+             const typename kd_tree<N, M, E, C, A, B>::template iterator_impl<
                  is_const>::queue_element &)>
-        kd_tree<N, M, E, C, A>::iterator_impl<is_const>::queue_comp =
-            [](const typename kd_tree<N, M, E, C, A>::template iterator_impl<
+        kd_tree<N, M, E, C, A, B>::iterator_impl<is_const>::queue_comp =
+            [](const typename kd_tree<N, M, E, C, A, B>::template iterator_impl<
                    is_const>::queue_element &a,
-               const typename kd_tree<N, M, E, C, A>::template iterator_impl<
+               const typename kd_tree<N, M, E, C, A, B>::template iterator_impl<
                    is_const>::queue_element &b) -> bool {
         return std::get<2>(a) > std::get<2>(b);
     };
@@ -2195,25 +2694,25 @@ namespace pareto {
     /// If you need to compare if the elements are the same, regardless
     /// of their trees, you have to iterate one container and call
     /// find on the second container. This operation takes loglinear time.
-    template <class K, size_t M, class T, class C, class A>
-    bool operator==(const kd_tree<K, M, T, C, A> &lhs,
-                    const kd_tree<K, M, T, C, A> &rhs) {
+    template <class K, size_t M, class T, class C, class A, size_t B>
+    bool operator==(const kd_tree<K, M, T, C, A, B> &lhs,
+                    const kd_tree<K, M, T, C, A, B> &rhs) {
         if (lhs.size() != rhs.size()) {
             return false;
         }
         return std::equal(
             lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
-            [](const typename kd_tree<K, M, T, C, A>::value_type &a,
-               const typename kd_tree<K, M, T, C, A>::value_type &b) {
+            [](const typename kd_tree<K, M, T, C, A, B>::value_type &a,
+               const typename kd_tree<K, M, T, C, A, B>::value_type &b) {
                 return a.first == b.first &&
                        mapped_type_custom_equality_operator(a.second, b.second);
             });
     }
 
     /// \brief Inequality operator
-    template <class K, size_t M, class T, class C, class A>
-    bool operator!=(const kd_tree<K, M, T, C, A> &lhs,
-                    const kd_tree<K, M, T, C, A> &rhs) {
+    template <class K, size_t M, class T, class C, class A, size_t B>
+    bool operator!=(const kd_tree<K, M, T, C, A, B> &lhs,
+                    const kd_tree<K, M, T, C, A, B> &rhs) {
         return !(lhs == rhs);
     }
 
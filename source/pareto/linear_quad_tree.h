@@ -0,0 +1,1501 @@
+#ifndef PARETO_LINEAR_QUAD_TREE_H
+#define PARETO_LINEAR_QUAD_TREE_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <tuple>
+#include <vector>
+
+#include <pareto/common/default_allocator.h>
+#include <pareto/common/space_filling_curve.h>
+#include <pareto/point.h>
+#include <pareto/query/predicates.h>
+#include <pareto/query/query_box.h>
+
+namespace pareto {
+
+    /// \brief Linear quadtree
+    /// A quadtree where the nodes are implicit. Each element gets the code
+    /// of its grid cell along a space-filling curve, and the elements are
+    /// kept in a single array sorted by these codes.
+    ///
+    /// Every cell of the quadtree is then a contiguous range of the array:
+    /// the cell of level l is the range of codes that share their first
+    /// l * m bits. Queries walk the cells by splitting these ranges with
+    /// binary searches and skip the cells whose boxes cannot pass the
+    /// predicates. Levels where all elements fall in the same child are
+    /// skipped, so the depth of the walk depends on the data and not on
+    /// the resolution of the grid.
+    ///
+    /// There are no nodes to allocate or follow. Insertion is a binary
+    /// search and an insertion in the array. A range insertion appends the
+    /// elements and radix sorts the whole array by code again.
+    ///
+    /// The grid covers the bounding box of the elements with some margin.
+    /// When an element falls outside of the grid, we recompute the grid and
+    /// the codes of all elements. Each coordinate uses min(32, 64 / m) bits
+    /// of the 64-bit codes. With more than 64 dimensions, all codes are
+    /// equal and queries become linear searches.
+    ///
+    /// This container type implements the following concepts
+    /// Container: https://en.cppreference.com/w/cpp/named_req/Container
+    /// ReversibleContainer:
+    /// https://en.cppreference.com/w/cpp/named_req/Container
+    /// AssociativeContainer:
+    /// https://en.cppreference.com/w/cpp/named_req/AssociativeContainer
+    ///
+    /// \tparam K Number/key type
+    /// \tparam M Number of dimensions
+    /// \tparam E Element/mapped type
+    /// \tparam C Comparison function type in one dimension
+    /// \tparam A Allocator type
+    /// \tparam Curve Space-filling curve (morton_curve or hilbert_curve)
+    template <class K, size_t M, class T, typename C = std::less<K>,
+              class A = default_allocator_type<std::pair<const point<K, M>, T>>,
+              class Curve = morton_curve>
+    class linear_quad_tree {
+      private /* Internal types */:
+        using unprotected_point_type = point<K, M>;
+        using protected_point_type = const point<K, M>;
+        using unprotected_mapped_type = T;
+        using unprotected_key_type = unprotected_point_type;
+        using protected_key_type = protected_point_type;
+        using unprotected_value_type =
+            std::pair<unprotected_key_type, unprotected_mapped_type>;
+        using protected_value_type =
+            std::pair<protected_key_type, unprotected_mapped_type>;
+        using unprotected_allocator_type = typename std::allocator_traits<
+            A>::template rebind_alloc<unprotected_value_type>;
+        using unprotected_vector_type =
+            std::vector<unprotected_value_type, unprotected_allocator_type>;
+        using code_allocator_type =
+            typename std::allocator_traits<A>::template rebind_alloc<uint64_t>;
+        using code_vector_type = std::vector<uint64_t, code_allocator_type>;
+        using point_type = unprotected_point_type;
+        using grid_point_type = point<double, M>;
+
+      public /* Forward declarations */:
+        template <bool is_const> class iterator_impl;
+
+      public /* Container Concept */:
+        using value_type = protected_value_type;
+        using reference = value_type &;
+        using const_reference = value_type const &;
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+        using pointer = value_type *;
+        using const_pointer = const value_type *;
+        using difference_type =
+            typename unprotected_vector_type::difference_type;
+        using size_type = typename unprotected_vector_type::size_type;
+
+      public /* ReversibleContainer Concept */:
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      public /* AssociativeContainer Concept */:
+        using key_type = unprotected_point_type;
+        using mapped_type = T;
+        using key_compare =
+            std::function<bool(const key_type &, const key_type &)>;
+        using value_compare =
+            std::function<bool(const value_type &, const value_type &)>;
+
+      public /* AllocatorAwareContainer Concept */:
+        using allocator_type = A;
+
+      public /* SpatialContainer Concept */:
+        static constexpr size_t number_of_compile_dimensions = M;
+        using dimension_type = K;
+        using dimension_compare = C;
+        using box_type =
+            query_box<dimension_type, number_of_compile_dimensions>;
+        using predicate_list_type =
+            predicate_list<dimension_type, number_of_compile_dimensions, T>;
+
+      public /* Linear Quadtree Types */:
+        using curve_type = Curve;
+
+      private /* Internal types */:
+        using nearest_type =
+            nearest<dimension_type, number_of_compile_dimensions>;
+
+        /// \brief Index that represents no element
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        /// \brief Cells with up to this many elements are searched linearly
+        static constexpr size_t scan_size = 16;
+
+      public /* Iterators */:
+        /// \brief Linear quadtree iterator
+        /// The iterator is an index in the array. Iterators with predicates
+        /// find the next index that passes the predicates by walking the
+        /// cells from the root and skipping the cells whose boxes cannot
+        /// pass the predicates.
+        ///
+        /// Nearest queries find the k nearest elements when the iterator is
+        /// created and iterate them from the closest to the farthest.
+        template <bool is_const> class iterator_impl {
+          private /* Internal Types */:
+            template <class TYPE, class CONST_TYPE>
+            using const_toggle =
+                std::conditional_t<!is_const, TYPE, CONST_TYPE>;
+
+            using tree_pointer =
+                const_toggle<linear_quad_tree *, const linear_quad_tree *>;
+
+          public /* LegacyIterator Types */:
+            using value_type = const_toggle<linear_quad_tree::value_type,
+                                            const linear_quad_tree::value_type>;
+            using reference = const_toggle<linear_quad_tree::reference,
+                                           linear_quad_tree::const_reference>;
+            using difference_type = linear_quad_tree::difference_type;
+            using pointer = const_toggle<linear_quad_tree::pointer,
+                                         linear_quad_tree::const_pointer>;
+            using iterator_category = std::bidirectional_iterator_tag;
+
+          public /* LegacyForwardIterator Constructors */:
+            /// \brief Default constructor
+            iterator_impl() = default;
+
+          public /* ContainerConcept Constructors */:
+            /// \brief Copy constructor
+            /// const_iterator can be constructed from const_iterator and
+            /// iterator, but iterator cannot be constructed from
+            /// const_iterator.
+            template <bool rhs_is_const,
+                      class = std::enable_if_t<is_const && !rhs_is_const>>
+            // NOLINTNEXTLINE(google-explicit-constructor)
+            iterator_impl(const iterator_impl<rhs_is_const> &rhs)
+                : tree_(rhs.tree_), index_(rhs.index_),
+                  predicates_(rhs.predicates_), is_nearest_(rhs.is_nearest_),
+                  nearest_set_(rhs.nearest_set_),
+                  nearest_position_(rhs.nearest_position_) {}
+
+          public /* Internal Constructors / Used by Container */:
+            /// \brief Iterator to an element of the array
+            iterator_impl(tree_pointer tree, size_t index)
+                : tree_(tree), index_(index) {}
+
+            /// \brief Iterator to the first element that passes the
+            /// predicates
+            iterator_impl(tree_pointer tree,
+                          const predicate_list_type &predicates)
+                : tree_(tree), index_(tree->size()), predicates_(predicates) {
+                if (predicates_.contains_nearest()) {
+                    is_nearest_ = true;
+                    nearest_set_ =
+                        tree_->nearest_indices(*predicates_.get_nearest());
+                    nearest_position_ = 0;
+                    advance_nearest();
+                } else {
+                    index_ = tree_->next_match(0, predicates_);
+                }
+            }
+
+          public /* LegacyIterator */:
+            /// \brief Dereference iterator
+            reference operator*() const { return tree_->value_at(index_); }
+
+            /// \brief Advance iterator
+            iterator_impl &operator++() {
+                if (is_nearest_) {
+                    ++nearest_position_;
+                    advance_nearest();
+                } else if (predicates_.size() == 0) {
+                    ++index_;
+                } else {
+                    index_ = tree_->next_match(index_ + 1, predicates_);
+                }
+                return *this;
+            }
+
+          public /* LegacyInputIterator */:
+            pointer operator->() const { return &tree_->value_at(index_); }
+
+          public /* LegacyForwardIterator */:
+            /// \brief Equality operator
+            template <bool rhs_is_const>
+            bool operator==(const iterator_impl<rhs_is_const> &rhs) const {
+                return index_ == rhs.index_;
+            }
+
+            /// \brief Inequality operator
+            template <bool rhs_is_const>
+            bool operator!=(const iterator_impl<rhs_is_const> &rhs) const {
+                return !(this->operator==(rhs));
+            }
+
+            /// \brief Advance iterator
+            iterator_impl operator++(int) { // NOLINT(cert-dcl21-cpp):
+                auto tmp = *this;
+                operator++();
+                return tmp;
+            }
+
+          public /* LegacyBidirectionalIterator */:
+            /// \brief Decrement iterator
+            iterator_impl &operator--() {
+                if (is_nearest_) {
+                    rewind_nearest();
+                } else if (predicates_.size() == 0) {
+                    --index_;
+                } else {
+                    const size_t previous =
+                        tree_->previous_match(index_, predicates_);
+                    assert(previous != npos);
+                    index_ = previous;
+                }
+                return *this;
+            }
+
+            /// \brief Decrement iterator
+            iterator_impl operator--(int) { // NOLINT(cert-dcl21-cpp)
+                auto tmp = *this;
+                operator--();
+                return tmp;
+            }
+
+          private /* Internal Functions */:
+            /// \brief Move to the next nearest element that passes the
+            /// other predicates
+            void advance_nearest() {
+                while (nearest_position_ < nearest_set_.size() &&
+                       !tree_->passes(nearest_set_[nearest_position_],
+                                      predicates_)) {
+                    ++nearest_position_;
+                }
+                index_ = nearest_position_ < nearest_set_.size()
+                             ? nearest_set_[nearest_position_]
+                             : tree_->size();
+            }
+
+            /// \brief Move to the previous nearest element that passes the
+            /// other predicates
+            void rewind_nearest() {
+                do {
+                    assert(nearest_position_ > 0);
+                    --nearest_position_;
+                } while (nearest_position_ > 0 &&
+                         !tree_->passes(nearest_set_[nearest_position_],
+                                        predicates_));
+                index_ = nearest_set_[nearest_position_];
+            }
+
+          private:
+            /// \brief Tree we are iterating
+            tree_pointer tree_{nullptr};
+
+            /// \brief Index of the current element in the array
+            size_t index_{0};
+
+            /// \brief Predicates the elements need to pass
+            predicate_list_type predicates_;
+
+            /// \brief Whether we are iterating the k nearest elements
+            bool is_nearest_{false};
+
+            /// \brief Indexes of the nearest elements by distance
+            std::vector<size_t> nearest_set_;
+
+            /// \brief Position of the current element in nearest_set_
+            size_t nearest_position_{0};
+
+          public:
+            /// Let the tree access the spatial private constructors
+            friend linear_quad_tree;
+
+            /// Let iterators and const iterators access each other
+            template <bool> friend class iterator_impl;
+        };
+
+      public /* Constructors: Container + AllocatorAwareContainer */:
+        /// \brief Create an empty container
+        explicit linear_quad_tree(const allocator_type &alloc = allocator_type())
+            : data_(unprotected_allocator_type(alloc)),
+              codes_(code_allocator_type(alloc)), comp_(dimension_compare()) {}
+
+        /// \brief Copy constructor
+        linear_quad_tree(const linear_quad_tree &rhs)
+            : data_(rhs.data_), codes_(rhs.codes_), comp_(rhs.comp_),
+              grid_min_(rhs.grid_min_), grid_max_(rhs.grid_max_) {}
+
+        /// \brief Copy constructor data but use another allocator
+        linear_quad_tree(const linear_quad_tree &rhs,
+                         const allocator_type &alloc)
+            : data_(rhs.data_, unprotected_allocator_type(alloc)),
+              codes_(rhs.codes_, code_allocator_type(alloc)), comp_(rhs.comp_),
+              grid_min_(rhs.grid_min_), grid_max_(rhs.grid_max_) {}
+
+        /// \brief Move constructor
+        linear_quad_tree(linear_quad_tree &&rhs) noexcept
+            : data_(std::move(rhs.data_)), codes_(std::move(rhs.codes_)),
+              comp_(std::move(rhs.comp_)), grid_min_(std::move(rhs.grid_min_)),
+              grid_max_(std::move(rhs.grid_max_)) {}
+
+        /// \brief Move constructor data but use new allocator
+        linear_quad_tree(linear_quad_tree &&rhs,
+                         const allocator_type &alloc) noexcept
+            : data_(std::move(rhs.data_), unprotected_allocator_type(alloc)),
+              codes_(std::move(rhs.codes_), code_allocator_type(alloc)),
+              comp_(std::move(rhs.comp_)), grid_min_(std::move(rhs.grid_min_)),
+              grid_max_(std::move(rhs.grid_max_)) {}
+
+        /// \brief Destructor
+        ~linear_quad_tree() = default;
+
+      public /* Constructors: AssociativeContainer + AllocatorAwareContainer */:
+        /// \brief Create container with custom comparison function
+        explicit linear_quad_tree(const C &comp,
+                                  const allocator_type &alloc = allocator_type())
+            : data_(unprotected_allocator_type(alloc)),
+              codes_(code_allocator_type(alloc)), comp_(comp) {}
+
+        /// \brief Construct with iterators + comparison
+        /// The elements are bulk loaded with a radix sort by code
+        template <class InputIt>
+        linear_quad_tree(InputIt first, InputIt last, const C &comp = C(),
+                         const allocator_type &alloc = allocator_type())
+            : linear_quad_tree(comp, alloc) {
+            insert(first, last);
+        }
+
+        /// \brief Construct with list + comparison
+        linear_quad_tree(std::initializer_list<value_type> il,
+                         const C &comp = C(),
+                         const allocator_type &alloc = allocator_type())
+            : linear_quad_tree(il.begin(), il.end(), comp, alloc) {}
+
+        /// \brief Construct with iterators
+        template <class InputIt>
+        linear_quad_tree(InputIt first, InputIt last,
+                         const allocator_type &alloc)
+            : linear_quad_tree(first, last, C(), alloc) {}
+
+        /// \brief Construct with list
+        linear_quad_tree(std::initializer_list<value_type> il,
+                         const allocator_type &alloc)
+            : linear_quad_tree(il.begin(), il.end(), C(), alloc) {}
+
+      public /* Assignment: Container + AllocatorAwareContainer */:
+        /// \brief Copy assignment
+        linear_quad_tree &operator=(const linear_quad_tree &rhs) {
+            if (&rhs == this) {
+                return *this;
+            }
+            data_.clear();
+            data_.insert(data_.end(), rhs.data_.begin(), rhs.data_.end());
+            codes_.clear();
+            codes_.insert(codes_.end(), rhs.codes_.begin(), rhs.codes_.end());
+            comp_ = rhs.comp_;
+            grid_min_ = rhs.grid_min_;
+            grid_max_ = rhs.grid_max_;
+            return *this;
+        }
+
+        /// \brief Move assignment
+        linear_quad_tree &operator=(linear_quad_tree &&rhs) noexcept {
+            if (&rhs == this) {
+                return *this;
+            }
+            data_ = std::move(rhs.data_);
+            codes_ = std::move(rhs.codes_);
+            comp_ = std::move(rhs.comp_);
+            grid_min_ = std::move(rhs.grid_min_);
+            grid_max_ = std::move(rhs.grid_max_);
+            return *this;
+        }
+
+      public /* Assignment: AssociativeContainer */:
+        /// \brief Initializer list assignment
+        linear_quad_tree &operator=(std::initializer_list<value_type> il) {
+            clear();
+            insert(il.begin(), il.end());
+            return *this;
+        }
+
+      public /* Non-Modifying Functions: AllocatorAwareContainer */:
+        /// \brief Obtains a copy of the allocator
+        allocator_type get_allocator() const noexcept {
+            return allocator_type(data_.get_allocator());
+        }
+
+      public /* Element Access / Map Concept */:
+        /// \brief Get reference to element at a given position, and throw error
+        /// if it does not exist
+        mapped_type &at(const key_type &k) {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                throw std::out_of_range("linear_quad_tree::at: key not found");
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and throw error
+        /// if it does not exist
+        const mapped_type &at(const key_type &k) const {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                throw std::out_of_range("linear_quad_tree::at: key not found");
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and create one
+        /// if it does not exits
+        mapped_type &operator[](const key_type &k) {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                auto it_new = insert(std::make_pair(k, mapped_type()));
+                return it_new->second;
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and create one
+        /// if it does not exits
+        mapped_type &operator[](key_type &&k) {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                auto it_new = insert(std::make_pair(std::move(k), mapped_type()));
+                return it_new->second;
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and create one
+        /// if it does not exits
+        template <typename... Targs>
+        mapped_type &operator()(const dimension_type &x1, const Targs &...xs) {
+            constexpr size_t m = sizeof...(Targs) + 1;
+            assert(number_of_compile_dimensions == 0 ||
+                   number_of_compile_dimensions == m);
+            point_type p(m);
+            copy_pack(p.begin(), x1, xs...);
+            return operator[](p);
+        }
+
+      public /* Non-Modifying Functions: Container Concept */:
+        /// \brief Get iterator to first element
+        const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+        /// \brief Get iterator to past-the-end element
+        const_iterator end() const noexcept {
+            return const_iterator(this, data_.size());
+        }
+
+        /// \brief Get iterator to first element
+        iterator begin() noexcept { return iterator(this, 0); }
+
+        /// \brief Get iterator to past-the-end element
+        iterator end() noexcept { return iterator(this, data_.size()); }
+
+        /// \brief Get iterator to first element
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        /// \brief Get iterator to past-the-end element
+        const_iterator cend() const noexcept { return end(); }
+
+      public /* Non-Modifying Functions: ReversibleContainer Concept */:
+        /// \brief Get iterator to first element in reverse
+        const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        }
+
+        /// \brief Get iterator to last element in reverse
+        const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        /// \brief Get iterator to first element in reverse
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        /// \brief Get iterator to last element in reverse
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        /// \brief Get iterator to first element in reverse
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        /// \brief Get iterator to past-the-end element in reverse
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+      public /* Non-Modifying Functions / Capacity / Container Concept */:
+        /// \brief True if container is empty
+        [[nodiscard]] bool empty() const noexcept { return data_.empty(); }
+
+        /// \brief Get container size
+        [[nodiscard]] size_t size() const noexcept { return data_.size(); }
+
+        /// \brief Get container max size
+        [[nodiscard]] size_t max_size() const noexcept {
+            return data_.max_size();
+        }
+
+      public /* Non-Modifying Functions / Capacity / Spatial Concept */:
+        /// \brief Get container dimensions
+        [[nodiscard]] size_t dimensions() const noexcept {
+            if constexpr (M != 0) {
+                return M;
+            } else {
+                return data_.empty() ? 0 : data_.front().first.dimensions();
+            }
+        }
+
+        /// \brief Get maximum value in a given dimension
+        dimension_type max_value(size_t dimension) const {
+            auto it = max_element(dimension);
+            return it != end() ? it->first[dimension]
+                               : std::numeric_limits<dimension_type>::max();
+        }
+
+        /// \brief Get minimum value in a given dimension
+        dimension_type min_value(size_t dimension) const {
+            auto it = min_element(dimension);
+            return it != end() ? it->first[dimension]
+                               : std::numeric_limits<dimension_type>::min();
+        }
+
+      public /* Modifying Functions: Container + AllocatorAwareContainer */:
+        /// \brief Swap the content of two objects
+        void swap(linear_quad_tree &other) noexcept {
+            data_.swap(other.data_);
+            codes_.swap(other.codes_);
+            std::swap(comp_, other.comp_);
+            std::swap(grid_min_, other.grid_min_);
+            std::swap(grid_max_, other.grid_max_);
+        }
+
+      public /* Modifiers: Multimap Concept */:
+        /// \brief Clear the container
+        void clear() noexcept {
+            data_.clear();
+            codes_.clear();
+        }
+
+        /// \brief Insert element pair
+        /// Elements with the same code keep their insertion order
+        iterator insert(const value_type &v) { return insert(value_type(v)); }
+
+        /// \brief Insert element pair
+        iterator insert(value_type &&v) {
+            if (data_.empty() || !is_inside_grid(v.first)) {
+                // recompute the grid with the new element, which is the
+                // last element with its code after the stable sort
+                const key_type k = v.first;
+                data_.emplace_back(std::move(v));
+                codes_.emplace_back(0);
+                rebuild();
+                const auto last =
+                    std::upper_bound(codes_.begin(), codes_.end(), encode(k));
+                return iterator(this,
+                                static_cast<size_t>(last - codes_.begin()) - 1);
+            }
+            const uint64_t code = encode(v.first);
+            const auto pos =
+                std::upper_bound(codes_.begin(), codes_.end(), code);
+            const auto index = static_cast<size_t>(pos - codes_.begin());
+            codes_.insert(pos, code);
+            data_.emplace(data_.begin() + index, std::move(v));
+            return iterator(this, index);
+        }
+
+        /// \brief Insert element pair
+        template <class P> iterator insert(P &&v) {
+            static_assert(std::is_constructible_v<value_type, P &&>);
+            return emplace(std::forward<P>(v));
+        }
+
+        /// \brief Insert element with a hint
+        iterator insert(const_iterator, const value_type &v) {
+            return insert(v);
+        }
+
+        /// \brief Insert element with a hint
+        iterator insert(const_iterator, value_type &&v) {
+            return insert(std::move(v));
+        }
+
+        /// \brief Insert element with a hint
+        template <class P> iterator insert(const_iterator hint, P &&v) {
+            static_assert(std::is_constructible_v<value_type, P &&>);
+            return emplace_hint(hint, std::forward<P>(v));
+        }
+
+        /// \brief Insert list of elements
+        /// The elements are appended to the array, and the array is sorted
+        /// by code again with a radix sort.
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            const size_t previous_size = data_.size();
+            for (; first != last; ++first) {
+                data_.emplace_back(first->first, first->second);
+            }
+            if (data_.size() != previous_size) {
+                codes_.resize(data_.size());
+                rebuild();
+            }
+        }
+
+        /// \brief Insert list of elements
+        void insert(std::initializer_list<value_type> init) {
+            insert(init.begin(), init.end());
+        }
+
+        /// \brief Emplace element
+        template <class... Args> iterator emplace(Args &&...args) {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+
+        /// \brief Emplace element with a hint
+        template <class... Args>
+        iterator emplace_hint(const_iterator, Args &&...args) {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+
+        /// \brief Erase element
+        /// \return Iterator to the element that was after the erased element
+        iterator erase(const_iterator position) {
+            const size_t index = position.index_;
+            if (index >= data_.size()) {
+                return end();
+            }
+            data_.erase(data_.begin() + index);
+            codes_.erase(codes_.begin() + index);
+            return iterator(this, index);
+        }
+
+        /// \brief Erase element
+        iterator erase(iterator position) {
+            return erase(const_iterator(position));
+        }
+
+        /// \brief Remove range of iterators from the container
+        /// Iterators are positions in the array, so we can mark the
+        /// positions in the range and remove them all in one pass.
+        iterator erase(const_iterator first, const_iterator last) {
+            std::vector<bool> erased(data_.size(), false);
+            size_t last_erased = npos;
+            for (; first != last; ++first) {
+                erased[first.index_] = true;
+                last_erased = last_erased == npos
+                                  ? first.index_
+                                  : std::max(last_erased, first.index_);
+            }
+            if (last_erased == npos) {
+                return iterator(this, last.index_);
+            }
+            size_t next = 0;
+            size_t j = 0;
+            for (size_t i = 0; i < data_.size(); ++i) {
+                if (i == last_erased + 1) {
+                    next = j;
+                }
+                if (!erased[i]) {
+                    if (i != j) {
+                        data_[j] = std::move(data_[i]);
+                        codes_[j] = codes_[i];
+                    }
+                    ++j;
+                }
+            }
+            if (last_erased + 1 == data_.size()) {
+                next = j;
+            }
+            data_.erase(data_.begin() + j, data_.end());
+            codes_.erase(codes_.begin() + j, codes_.end());
+            return iterator(this, next);
+        }
+
+        /// \brief Erase elements with given key
+        /// Equal keys have equal codes, so we only look at the elements with
+        /// the code of the key.
+        size_type erase(const key_type &k) {
+            if (data_.empty() || !is_inside_grid(k)) {
+                return 0;
+            }
+            // k might be a reference to the element we are about to delete
+            const key_type k_copy(k);
+            const auto [first, last] = code_range(k_copy);
+            size_t j = first;
+            for (size_t i = first; i < last; ++i) {
+                if (data_[i].first != k_copy) {
+                    if (i != j) {
+                        data_[j] = std::move(data_[i]);
+                    }
+                    ++j;
+                }
+            }
+            const size_type s = last - j;
+            data_.erase(data_.begin() + j, data_.begin() + last);
+            codes_.erase(codes_.begin() + j, codes_.begin() + last);
+            return s;
+        }
+
+        /// \brief Splices nodes from another container
+        void merge(linear_quad_tree &source) noexcept {
+            insert(source.begin(), source.end());
+        }
+
+        /// \brief Splices nodes from another container
+        void merge(linear_quad_tree &&source) noexcept {
+            insert(source.begin(), source.end());
+        }
+
+      public /* Lookup / Multimap Concept */:
+        /// \brief Returns the number of elements with key that compares
+        /// equivalent to the specified argument.
+        size_type count(const key_type &k) const {
+            if (data_.empty() || !is_inside_grid(k)) {
+                return 0;
+            }
+            const auto [first, last] = code_range(k);
+            size_type s = 0;
+            for (size_t i = first; i < last; ++i) {
+                s += data_[i].first == k;
+            }
+            return s;
+        }
+
+        /// \brief Returns the number of elements with key that compares
+        /// equivalent to the specified argument.
+        template <class L> size_type count(const L &k) const {
+            return count(key_type(k));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        iterator find(const key_type &k) { return iterator(this, find_index(k)); }
+
+        /// \brief Finds an element with key equivalent to key
+        const_iterator find(const key_type &k) const {
+            return const_iterator(this, find_index(k));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> iterator find(const L &x) {
+            return find(key_type(x));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> const_iterator find(const L &x) const {
+            return find(key_type(x));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        bool contains(const key_type &k) const { return find(k) != end(); }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> bool contains(const L &x) const {
+            return find(x) != end();
+        }
+
+      public /* Modifiers: Lookup / Spatial Concept */:
+        /// \brief Get iterator to first element that passes the list of
+        /// predicates
+        const_iterator find(const predicate_list_type &ps) const noexcept {
+            return const_iterator(this, ps);
+        }
+
+        /// \brief Get iterator to first element that passes the list of
+        /// predicates
+        iterator find(const predicate_list_type &ps) noexcept {
+            return iterator(this, ps);
+        }
+
+        /// \brief Find intersection between points and query box
+        iterator find_intersection(const point_type &k) {
+            return find_intersection(k, k);
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator find_intersection(const point_type &k) const {
+            return find_intersection(k, k);
+        }
+
+        /// \brief Find intersection between points and query box
+        iterator find_intersection(const point_type &lb, const point_type &ub) {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return iterator(this, {intersects(lb_, ub_)});
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator find_intersection(const point_type &lb,
+                                         const point_type &ub) const {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return const_iterator(this, {intersects(lb_, ub_)});
+        }
+
+        /// \brief Find intersection between points and query box
+        iterator find_intersection(const point_type &lb, const point_type &ub,
+                                   std::function<bool(const value_type &)> fn) {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return iterator(
+                this, {intersects(lb_, ub_),
+                       satisfies<dimension_type, number_of_compile_dimensions,
+                                 mapped_type>(fn)});
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator
+        find_intersection(const point_type &lb, const point_type &ub,
+                          std::function<bool(const value_type &)> fn) const {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return const_iterator(
+                this, {intersects(lb_, ub_),
+                       satisfies<dimension_type, number_of_compile_dimensions,
+                                 mapped_type>(fn)});
+        }
+
+        /// \brief Find points within a query box
+        iterator find_within(const point_type &lb, const point_type &ub) {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return iterator(this, {within(lb_, ub_)});
+        }
+
+        /// \brief Find points within a query box
+        const_iterator find_within(const point_type &lb,
+                                   const point_type &ub) const {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return const_iterator(this, {within(lb_, ub_)});
+        }
+
+        /// \brief Find points outside a query box
+        iterator find_disjoint(const point_type &lb, const point_type &ub) {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return iterator(this, {disjoint(lb_, ub_)});
+        }
+
+        /// \brief Find points outside a query box
+        const_iterator find_disjoint(const point_type &lb,
+                                     const point_type &ub) const {
+            point_type lb_ = lb;
+            point_type ub_ = ub;
+            normalize_corners(lb_, ub_);
+            return const_iterator(this, {disjoint(lb_, ub_)});
+        }
+
+        /// \brief Find points closest to a reference point
+        iterator find_nearest(const point_type &p) {
+            return iterator(this, {nearest(p)});
+        }
+
+        /// \brief Find points closest to a reference point
+        const_iterator find_nearest(const point_type &p) const {
+            return const_iterator(this, {nearest(p)});
+        }
+
+        /// \brief Find points closest to a reference point
+        iterator find_nearest(const point_type &p, size_t k) {
+            return iterator(this, {nearest(p, k)});
+        }
+
+        /// \brief Find points closest to a reference point
+        const_iterator find_nearest(const point_type &p, size_t k) const {
+            return const_iterator(this, {nearest(p, k)});
+        }
+
+        /// \brief Find points closest to a reference box
+        iterator find_nearest(const box_type &b, size_t k) {
+            return iterator(this, {nearest(b, k)});
+        }
+
+        /// \brief Find points closest to a reference box
+        const_iterator find_nearest(const box_type &b, size_t k) const {
+            return const_iterator(this, {nearest(b, k)});
+        }
+
+        /// \brief Find points closest to a reference point
+        iterator find_nearest(const point_type &p, size_t k,
+                              std::function<bool(const value_type &)> fn) {
+            return iterator(
+                this, {nearest(p, k),
+                       satisfies<dimension_type, number_of_compile_dimensions,
+                                 mapped_type>(fn)});
+        }
+
+        /// \brief Find points closest to a reference point
+        const_iterator
+        find_nearest(const point_type &p, size_t k,
+                     std::function<bool(const value_type &)> fn) const {
+            return const_iterator(
+                this, {nearest(p, k),
+                       satisfies<dimension_type, number_of_compile_dimensions,
+                                 mapped_type>(fn)});
+        }
+
+        /// \brief Get iterator to element with maximum value in a given
+        /// dimension
+        iterator max_element(size_t dimension) {
+            return iterator(this, extreme_index(dimension, true));
+        }
+
+        /// \brief Get iterator to element with maximum value in a given
+        /// dimension
+        const_iterator max_element(size_t dimension) const {
+            return const_iterator(this, extreme_index(dimension, true));
+        }
+
+        /// \brief Get iterator to element with minimum value in a given
+        /// dimension
+        iterator min_element(size_t dimension) {
+            return iterator(this, extreme_index(dimension, false));
+        }
+
+        /// \brief Get iterator to element with minimum value in a given
+        /// dimension
+        const_iterator min_element(size_t dimension) const {
+            return const_iterator(this, extreme_index(dimension, false));
+        }
+
+      public /* Observers: AssociativeContainer */:
+        /// \brief Returns the function object that compares keys
+        key_compare key_comp() const noexcept {
+            return [this](const key_type &a, const key_type &b) {
+                return std::lexicographical_compare(a.begin(), a.end(),
+                                                    b.begin(), b.end(), comp_);
+            };
+        }
+
+        /// \brief Returns the function object that compares values
+        value_compare value_comp() const noexcept {
+            return [this](const value_type &a, const value_type &b) {
+                return std::lexicographical_compare(
+                    a.first.begin(), a.first.end(), b.first.begin(),
+                    b.first.end(), comp_);
+            };
+        }
+
+        /// \brief Returns the function object that compares numbers
+        /// This is the comparison operator for a single dimension
+        dimension_compare dimension_comp() const noexcept { return comp_; }
+
+      private /* Internal functions: Elements */:
+        /// \brief Element at a position as a protected reference
+        value_type &value_at(size_t i) const {
+            const std::pair<key_type, mapped_type> &p = data_[i];
+            return *(value_type *)&p;
+        }
+
+        /// \brief Check if the element at a position passes the predicates
+        bool passes(size_t i, const predicate_list_type &ps) const {
+            return ps.pass_predicate(data_[i]);
+        }
+
+        /// \brief Position of an element with key k or size() if there is
+        /// none
+        size_t find_index(const key_type &k) const {
+            if (data_.empty() || !is_inside_grid(k)) {
+                return data_.size();
+            }
+            const auto [first, last] = code_range(k);
+            for (size_t i = first; i < last; ++i) {
+                if (data_[i].first == k) {
+                    return i;
+                }
+            }
+            return data_.size();
+        }
+
+        /// \brief Range of positions with the same code as the key
+        std::pair<size_t, size_t> code_range(const key_type &k) const {
+            const auto [first, last] =
+                std::equal_range(codes_.begin(), codes_.end(), encode(k));
+            return {static_cast<size_t>(first - codes_.begin()),
+                    static_cast<size_t>(last - codes_.begin())};
+        }
+
+      private /* Internal functions: Grid */:
+        /// \brief Bits per coordinate in the codes
+        size_t bits() const {
+            const size_t m = dimensions();
+            if (m == 0 || m > 64) {
+                return 0;
+            }
+            return std::min<size_t>(32, 64 / m);
+        }
+
+        /// \brief Check if a key is inside the grid
+        bool is_inside_grid(const key_type &k) const {
+            for (size_t i = 0; i < k.dimensions(); ++i) {
+                const auto x = static_cast<double>(k[i]);
+                if (!(grid_min_[i] <= x && x <= grid_max_[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// \brief Code of the grid cell of a key
+        uint64_t encode(const key_type &k) const {
+            const size_t b = bits();
+            if (b == 0) {
+                return 0;
+            }
+            const size_t m = dimensions();
+            const double cells = std::ldexp(1.0, static_cast<int>(b));
+            const uint64_t max_cell = (uint64_t(1) << b) - 1;
+            uint64_t q[64];
+            for (size_t i = 0; i < m; ++i) {
+                const double x = (static_cast<double>(k[i]) - grid_min_[i]) /
+                                 (grid_max_[i] - grid_min_[i]) * cells;
+                q[i] = !(x > 0.)                                ? 0
+                       : x >= static_cast<double>(max_cell) ? max_cell
+                                                            : uint64_t(x);
+            }
+            return Curve::encode(q, m, b);
+        }
+
+        /// \brief Recompute the grid and the codes and sort the elements
+        /// The grid is the bounding box of the elements plus a quarter of
+        /// its width on each side, so that elements that arrive close to
+        /// the border do not require a new grid.
+        void rebuild() {
+            const size_t m = dimensions();
+            grid_min_ = grid_point_type(m);
+            grid_max_ = grid_point_type(m);
+            for (size_t i = 0; i < m; ++i) {
+                double lo = static_cast<double>(data_.front().first[i]);
+                double hi = lo;
+                for (const auto &v : data_) {
+                    lo = std::min(lo, static_cast<double>(v.first[i]));
+                    hi = std::max(hi, static_cast<double>(v.first[i]));
+                }
+                const double w = hi - lo;
+                const double margin =
+                    w > 0. ? w / 4. : std::max(1., std::abs(lo)) / 4.;
+                grid_min_[i] = lo - margin;
+                grid_max_[i] = hi + margin;
+            }
+            for (size_t i = 0; i < data_.size(); ++i) {
+                codes_[i] = encode(data_[i].first);
+            }
+            sort_by_code();
+        }
+
+        /// \brief Stable LSD radix sort of the elements by code
+        /// We sort the positions 8 bits at a time and skip the passes where
+        /// all codes have the same digit.
+        void sort_by_code() {
+            const size_t n = data_.size();
+            if (n < 2) {
+                return;
+            }
+            std::vector<size_t> order(n);
+            std::vector<size_t> buffer(n);
+            for (size_t i = 0; i < n; ++i) {
+                order[i] = i;
+            }
+            const size_t code_bits = dimensions() * bits();
+            for (size_t shift = 0; shift < code_bits; shift += 8) {
+                std::array<size_t, 257> offsets{};
+                for (size_t i = 0; i < n; ++i) {
+                    ++offsets[((codes_[i] >> shift) & 0xFF) + 1];
+                }
+                if (std::any_of(offsets.begin() + 1, offsets.end(),
+                                [n](size_t c) { return c == n; })) {
+                    continue;
+                }
+                for (size_t d = 1; d < offsets.size(); ++d) {
+                    offsets[d] += offsets[d - 1];
+                }
+                for (size_t i : order) {
+                    buffer[offsets[(codes_[i] >> shift) & 0xFF]++] = i;
+                }
+                order.swap(buffer);
+            }
+            unprotected_vector_type sorted_data(data_.get_allocator());
+            sorted_data.reserve(n);
+            code_vector_type sorted_codes(codes_.get_allocator());
+            sorted_codes.reserve(n);
+            for (size_t i : order) {
+                sorted_data.emplace_back(std::move(data_[i]));
+                sorted_codes.emplace_back(codes_[i]);
+            }
+            data_.swap(sorted_data);
+            codes_.swap(sorted_codes);
+        }
+
+      private /* Internal functions: Cells */:
+        /// \brief Level of the smallest cell that contains the range
+        /// This is the number of leading m-bit digits the codes of the range
+        /// have in common.
+        size_t cell_level(size_t lo, size_t hi) const {
+            const size_t b = bits();
+            const uint64_t x = codes_[lo] ^ codes_[hi - 1];
+            if (x == 0) {
+                return b;
+            }
+            const size_t code_bits = dimensions() * b;
+            size_t leading_zeros = 0;
+            for (uint64_t bit = uint64_t(1) << 63; (x & bit) == 0; bit >>= 1) {
+                ++leading_zeros;
+            }
+            return (leading_zeros - (64 - code_bits)) / dimensions();
+        }
+
+        /// \brief End of the child cell that starts at position first
+        size_t child_end(size_t first, size_t hi, size_t level) const {
+            const size_t shift = (bits() - level - 1) * dimensions();
+            const uint64_t prefix = codes_[first] >> shift;
+            return static_cast<size_t>(
+                std::partition_point(codes_.begin() + first,
+                                     codes_.begin() + hi,
+                                     [&](uint64_t c) {
+                                         return (c >> shift) == prefix;
+                                     }) -
+                codes_.begin());
+        }
+
+        /// \brief Beginning of the child cell that ends at position last
+        size_t child_begin(size_t lo, size_t last, size_t level) const {
+            const size_t shift = (bits() - level - 1) * dimensions();
+            const uint64_t prefix = codes_[last - 1] >> shift;
+            return static_cast<size_t>(
+                std::partition_point(codes_.begin() + lo,
+                                     codes_.begin() + last,
+                                     [&](uint64_t c) {
+                                         return (c >> shift) < prefix;
+                                     }) -
+                codes_.begin());
+        }
+
+        /// \brief Box of the cell of a given level that contains a code
+        /// The first level * m bits of the code are the code of the cell in
+        /// a grid with 2^level cells per dimension.
+        /// The box has a small margin so that rounding errors in the codes
+        /// never leave an element out of the box of its cell.
+        box_type cell_box(uint64_t code, size_t level) const {
+            const size_t m = dimensions();
+            uint64_t q[64];
+            if (level != 0) {
+                Curve::decode(code >> ((bits() - level) * m), q, m, level);
+            }
+            const double cells = static_cast<double>(uint64_t(1) << level);
+            point_type lb(m);
+            point_type ub(m);
+            for (size_t i = 0; i < m; ++i) {
+                double lo = grid_min_[i];
+                double hi = grid_max_[i];
+                if (level != 0) {
+                    const double side = (hi - lo) / cells;
+                    lo += static_cast<double>(q[i]) * side;
+                    hi = lo + side;
+                }
+                const double margin =
+                    (std::abs(grid_min_[i]) + std::abs(grid_max_[i])) * 0x1p-40;
+                lb[i] = round_down(lo - margin);
+                ub[i] = round_up(hi + margin);
+            }
+            return box_type(lb, ub);
+        }
+
+        /// \brief Box of the smallest cell that contains a range
+        box_type range_box(size_t lo, size_t hi) const {
+            return cell_box(codes_[lo], cell_level(lo, hi));
+        }
+
+        /// \brief Largest dimension value not greater than x
+        static dimension_type round_down(double x) {
+            constexpr auto lowest = std::numeric_limits<dimension_type>::lowest();
+            if (!(x > static_cast<double>(lowest))) {
+                return lowest;
+            }
+            auto r = static_cast<dimension_type>(x);
+            if (static_cast<double>(r) > x) {
+                if constexpr (std::is_floating_point_v<dimension_type>) {
+                    r = std::nextafter(r, lowest);
+                } else {
+                    --r;
+                }
+            }
+            return r;
+        }
+
+        /// \brief Smallest dimension value not less than x
+        static dimension_type round_up(double x) {
+            constexpr auto highest = std::numeric_limits<dimension_type>::max();
+            if (!(x < static_cast<double>(highest))) {
+                return highest;
+            }
+            auto r = static_cast<dimension_type>(x);
+            if (static_cast<double>(r) < x) {
+                if constexpr (std::is_floating_point_v<dimension_type>) {
+                    r = std::nextafter(r, highest);
+                } else {
+                    ++r;
+                }
+            }
+            return r;
+        }
+
+      private /* Internal functions: Queries */:
+        /// \brief First element at or after the position that passes the
+        /// predicates
+        /// \return The position of the element or size() if there is none
+        /// Elements that pass the predicates are usually next to each other
+        /// in the array, so we check the element at the position before
+        /// walking the cells from the root.
+        size_t next_match(size_t from, const predicate_list_type &ps) const {
+            if (from < data_.size() && passes(from, ps)) {
+                return from;
+            }
+            const size_t i = first_match(0, data_.size(), from, ps);
+            return i == npos ? data_.size() : i;
+        }
+
+        /// \brief Last element before the position that passes the predicates
+        size_t previous_match(size_t to, const predicate_list_type &ps) const {
+            if (to != 0 && passes(to - 1, ps)) {
+                return to - 1;
+            }
+            return last_match(0, data_.size(), to, ps);
+        }
+
+        /// \brief First element in [max(lo, from), hi) that passes the
+        /// predicates
+        size_t first_match(size_t lo, size_t hi, size_t from,
+                           const predicate_list_type &ps) const {
+            if (lo >= hi || hi <= from) {
+                return npos;
+            }
+            if (hi - lo > 1) {
+                const size_t level = cell_level(lo, hi);
+                const box_type box = cell_box(codes_[lo], level);
+                if (!ps.might_pass_predicate(box)) {
+                    return npos;
+                }
+                // every element in a box inside the query passes
+                if (ps.is_all_intersects() && ps.pass_predicate(box)) {
+                    return std::max(lo, from);
+                }
+                if (hi - lo > scan_size && level != bits()) {
+                    for (size_t first = lo; first < hi;) {
+                        const size_t last = child_end(first, hi, level);
+                        if (from < last) {
+                            const size_t i =
+                                first_match(first, last, from, ps);
+                            if (i != npos) {
+                                return i;
+                            }
+                        }
+                        first = last;
+                    }
+                    return npos;
+                }
+            }
+            for (size_t i = std::max(lo, from); i < hi; ++i) {
+                if (passes(i, ps)) {
+                    return i;
+                }
+            }
+            return npos;
+        }
+
+        /// \brief Last element in [lo, min(hi, to)) that passes the
+        /// predicates
+        size_t last_match(size_t lo, size_t hi, size_t to,
+                          const predicate_list_type &ps) const {
+            if (lo >= hi || to <= lo) {
+                return npos;
+            }
+            if (hi - lo > 1) {
+                const size_t level = cell_level(lo, hi);
+                const box_type box = cell_box(codes_[lo], level);
+                if (!ps.might_pass_predicate(box)) {
+                    return npos;
+                }
+                if (ps.is_all_intersects() && ps.pass_predicate(box)) {
+                    return std::min(hi, to) - 1;
+                }
+                if (hi - lo > scan_size && level != bits()) {
+                    for (size_t last = hi; last > lo;) {
+                        const size_t first = child_begin(lo, last, level);
+                        if (first < to) {
+                            const size_t i = last_match(first, last, to, ps);
+                            if (i != npos) {
+                                return i;
+                            }
+                        }
+                        last = first;
+                    }
+                    return npos;
+                }
+            }
+            for (size_t i = std::min(hi, to); i > lo; --i) {
+                if (passes(i - 1, ps)) {
+                    return i - 1;
+                }
+            }
+            return npos;
+        }
+
+        /// \brief Positions of the k nearest elements by distance
+        /// This is a depth-first branch and bound search. We visit the
+        /// closest child cells first and skip the cells that are farther
+        /// than the k-th nearest element so far.
+        std::vector<size_t> nearest_indices(nearest_type reference) const {
+            const size_t k = std::min(reference.k(), data_.size());
+            std::priority_queue<std::pair<double, size_t>> nearest_so_far;
+            if (k != 0) {
+                nearest_search(0, data_.size(), reference, k, nearest_so_far);
+            }
+            std::vector<size_t> r(nearest_so_far.size());
+            for (auto it = r.rbegin(); it != r.rend(); ++it) {
+                *it = nearest_so_far.top().second;
+                nearest_so_far.pop();
+            }
+            return r;
+        }
+
+        void nearest_search(
+            size_t lo, size_t hi, nearest_type &reference, size_t k,
+            std::priority_queue<std::pair<double, size_t>> &nearest_so_far)
+            const {
+            const size_t level = cell_level(lo, hi);
+            if (hi - lo <= scan_size || level == bits()) {
+                for (size_t i = lo; i < hi; ++i) {
+                    const double distance = reference.distance(data_[i].first);
+                    if (nearest_so_far.size() < k) {
+                        nearest_so_far.emplace(distance, i);
+                    } else if (distance < nearest_so_far.top().first) {
+                        nearest_so_far.pop();
+                        nearest_so_far.emplace(distance, i);
+                    }
+                }
+                return;
+            }
+            // children by distance to the reference
+            std::vector<std::tuple<double, size_t, size_t>> children;
+            for (size_t first = lo; first < hi;) {
+                const size_t last = child_end(first, hi, level);
+                children.emplace_back(
+                    reference.distance(range_box(first, last)), first, last);
+                first = last;
+            }
+            std::sort(children.begin(), children.end());
+            for (const auto &[distance, first, last] : children) {
+                if (nearest_so_far.size() == k &&
+                    distance > nearest_so_far.top().first) {
+                    return;
+                }
+                nearest_search(first, last, reference, k, nearest_so_far);
+            }
+        }
+
+        /// \brief Position of the max or min element in a dimension
+        size_t extreme_index(size_t dimension, bool is_max) const {
+            size_t best = npos;
+            if (!data_.empty()) {
+                extreme_search(0, data_.size(), dimension, is_max, best);
+            }
+            return best == npos ? data_.size() : best;
+        }
+
+        /// \brief Find the max or min element in a dimension
+        /// We skip the cells whose boxes cannot beat the best element so far.
+        void extreme_search(size_t lo, size_t hi, size_t dimension,
+                            bool is_max, size_t &best) const {
+            auto better = [is_max](const dimension_type &a,
+                                   const dimension_type &b) {
+                return is_max ? b < a : a < b;
+            };
+            const size_t level = cell_level(lo, hi);
+            if (hi - lo <= scan_size || level == bits()) {
+                for (size_t i = lo; i < hi; ++i) {
+                    if (best == npos || better(data_[i].first[dimension],
+                                               data_[best].first[dimension])) {
+                        best = i;
+                    }
+                }
+                return;
+            }
+            if (best != npos) {
+                const box_type box = cell_box(codes_[lo], level);
+                const dimension_type &bound = is_max ? box.second()[dimension]
+                                                     : box.first()[dimension];
+                if (!better(bound, data_[best].first[dimension])) {
+                    return;
+                }
+            }
+            for (size_t first = lo; first < hi;) {
+                const size_t last = child_end(first, hi, level);
+                extreme_search(first, last, dimension, is_max, best);
+                first = last;
+            }
+        }
+
+      private:
+        /// \brief Elements sorted by code
+        /// Note that the key_type is not constant, unlike the value_type
+        /// exposed to the user. The iterators are responsible for
+        /// converting these references to protected types where the
+        /// key is const.
+        unprotected_vector_type data_{};
+
+        /// \brief Code of each element along the curve
+        code_vector_type codes_{};
+
+        /// \brief Key comparison (single dimension)
+        dimension_compare comp_{dimension_compare()};
+
+        /// \brief Lower corner of the grid
+        grid_point_type grid_min_{};
+
+        /// \brief Upper corner of the grid
+        grid_point_type grid_max_{};
+    };
+
+    /* Non-Modifying Functions / Comparison / Container Concept */
+    /// \brief Equality operator
+    /// Elements with the same code are in insertion order, so this tells
+    /// us if the trees are equal and not if they contain the same elements.
+    template <class K, size_t M, class T, class C, class A, class Curve>
+    bool operator==(const linear_quad_tree<K, M, T, C, A, Curve> &lhs,
+                    const linear_quad_tree<K, M, T, C, A, Curve> &rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        using value_type =
+            typename linear_quad_tree<K, M, T, C, A, Curve>::value_type;
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                          [](const value_type &a, const value_type &b) {
+                              return a.first == b.first &&
+                                     mapped_type_custom_equality_operator(
+                                         a.second, b.second);
+                          });
+    }
+
+    /// \brief Inequality operator
+    template <class K, size_t M, class T, class C, class A, class Curve>
+    bool operator!=(const linear_quad_tree<K, M, T, C, A, Curve> &lhs,
+                    const linear_quad_tree<K, M, T, C, A, Curve> &rhs) {
+        return !(lhs == rhs);
+    }
+
+} // namespace pareto
+
+#endif // PARETO_LINEAR_QUAD_TREE_H
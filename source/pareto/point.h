@@ -19,7 +19,9 @@
 #endif
 
 #include <pareto/common/common.h>
+#include <pareto/common/dominance.h>
 #include <pareto/common/promote_to_floating_point.h>
+#include <pareto/common/small_vector.h>
 
 namespace pareto {
 
@@ -56,13 +58,18 @@ namespace pareto {
         /// but you can also set the number of dimension in runtime.
         /// We need both options to support all kinds of pareto sets.
         /// In the first case, we use an array as data structure.
-        /// In the second case, we use a vector as data structure.
+        /// In the second case, we use a small vector as data structure,
+        /// which only allocates memory for more than
+        /// runtime_inline_dimensions dimensions.
         static constexpr size_t compile_dimensions = M;
 
-        using array_type =
-            std::conditional_t<compile_dimensions == 0,
-                               std::vector<dimension_type>,
-                               std::array<dimension_type, compile_dimensions>>;
+        /// \brief Dimensions a runtime-dimension point stores inline
+        static constexpr size_t runtime_inline_dimensions = 8;
+
+        using array_type = std::conditional_t<
+            compile_dimensions == 0,
+            small_vector<dimension_type, runtime_inline_dimensions>,
+            std::array<dimension_type, compile_dimensions>>;
 
       public:
         /// \brief Default constructor
@@ -197,7 +204,41 @@ namespace pareto {
 
         /// \brief Check for weak dominance
         bool dominates(const point &p, bool is_minimization) const {
-            return dominates(p, std::vector<uint8_t>(dimensions(), is_minimization));
+            if constexpr (detail::has_dominance_masks_v<T, M>) {
+                return detail::dominates(
+                    values_, p.values_,
+                    is_minimization);
+            }
+            auto pi = p.values_.begin();
+            bool better_at_any = false;
+            for (auto it = values_.begin(); it != values_.end(); it++) {
+                if (is_minimization ? *it > *pi : *it < *pi) {
+                    return false;
+                }
+                better_at_any |= is_minimization ? *it < *pi : *it > *pi;
+                ++pi;
+            }
+            return better_at_any;
+        }
+
+        /// \brief Check for weak dominance with precomputed directions
+        /// Containers with compile-time dimensions keep their directions
+        /// as a mask, so mixed directions also use the chunked comparisons
+        bool dominates(const point &p,
+                       const detail::direction_mask<M> &is_minimization) const {
+            if constexpr (detail::has_dominance_masks_v<T, M>) {
+                return detail::dominates(values_, p.values_, is_minimization);
+            }
+            bool better_at_any = false;
+            for (size_t i = 0; i < dimensions(); ++i) {
+                const bool min = is_minimization.bits(i, 1) != 0;
+                if (min ? values_[i] > p.values_[i] : values_[i] < p.values_[i]) {
+                    return false;
+                }
+                better_at_any |=
+                    min ? values_[i] < p.values_[i] : values_[i] > p.values_[i];
+            }
+            return better_at_any;
         }
 
         /// \brief Check for weak dominance
@@ -224,7 +265,19 @@ namespace pareto {
 
         /// \brief Check for strong dominance
         bool strongly_dominates(const point &p, bool is_minimization) const {
-            return strongly_dominates(p, std::vector<uint8_t>(dimensions(), is_minimization));
+            if constexpr (detail::has_dominance_masks_v<T, M>) {
+                return detail::strongly_dominates(
+                    values_, p.values_,
+                    is_minimization);
+            }
+            auto pi = p.values_.begin();
+            for (auto it = values_.begin(); it != values_.end(); it++) {
+                if (is_minimization ? *it >= *pi : *it <= *pi) {
+                    return false;
+                }
+                ++pi;
+            }
+            return true;
         }
 
         /// \brief Check for strong dominance
@@ -296,6 +349,11 @@ namespace pareto {
             return sqrt(sum);
         }
 
+        /// \brief Coordinates of the point
+        /// With runtime dimensions, this is a small_vector rather than
+        /// the std::vector it used to be. It has the same interface for
+        /// reading and resizing and converts to a std::vector, but
+        /// code binding a std::vector<T>& to it needs to copy instead.
         array_type &values() { return values_; }
 
         const array_type &values() const { return values_; }
@@ -539,8 +597,8 @@ namespace pareto {
     private:
 
         /// \brief Underlying data structure holding the point components
-        /// This might be an array or a vector, depending on whether the point
-        /// dimension was set at compile time
+        /// This might be an array or a small vector, depending on whether
+        /// the point dimension was set at compile time
         array_type values_;
 
     };
@@ -6,17 +6,21 @@
 #define PARETO_FRONT_QUAD_TREE_H
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <forward_list>
 #include <functional>
+#include <limits>
 #include <map>
 #include <queue>
 #include <sstream>
 #include <vector>
 
+#include <pareto/common/default_allocator.h>
+#include <pareto/common/static_vector.h>
 #include <pareto/point.h>
 #include <pareto/query/predicates.h>
 #include <pareto/query/query_box.h>
@@ -40,8 +44,13 @@ namespace pareto {
     /// https://github.com/danshapero/quadtree
     /// as reference for correctness, but the design is completely different.
     /// \see https://en.wikipedia.org/wiki/Quadtree#Point_quadtree
+    ///
+    /// BucketSize is the number of points each node holds in a contiguous
+    /// array. The first point in a node splits its children, and a node only
+    /// gets children when its bucket is full.
     template <class K, size_t M, class T, typename C = std::less<K>,
-              class A = default_allocator_type<std::pair<const point<K, M>, T>>>
+              class A = default_allocator_type<std::pair<const point<K, M>, T>>,
+              size_t BucketSize = 1>
     class quad_tree : container_with_pool {
       private /* Internal types */:
         using unprotected_point_type = point<K, M>;
@@ -111,6 +120,11 @@ namespace pareto {
         static_assert(maxnodes_ > minnodes_);
         static_assert(minnodes_ > 0);
 
+      public /* Quadtree options */:
+        /// \brief Maximum number of points in a node
+        static constexpr size_t bucket_size = BucketSize;
+        static_assert(bucket_size > 0);
+
       private /* internal node types */:
         /// Node
         /// Each branch might have a quadtree_node for each branch level
@@ -126,8 +140,9 @@ namespace pareto {
 
             /// \brief Construct child node with value
             quadtree_node(quadtree_node *parent, const value_type &value)
-                : value_(value), parent_(parent),
-                  bounds_(box_type(value.first)) {}
+                : parent_(parent), bounds_(box_type(value.first)) {
+                values_.emplace_back(value);
+            }
 
             /// \brief An internal node, contains other nodes
             [[nodiscard]] bool is_internal_node() const {
@@ -139,8 +154,10 @@ namespace pareto {
                 return children_.empty();
             }
 
-            /// \brief Value: a quad-containers node holds a value itself.
-            unprotected_value_type value_;
+            /// \brief Values: a quad-containers node holds a bucket of values
+            /// The first value is the one that splits the children.
+            /// Only the values in the bucket are constructed.
+            static_vector<unprotected_value_type, bucket_size> values_;
 
             /// \brief Node children
             /// Unlike other data structures, we use a map instead of
@@ -221,6 +238,7 @@ namespace pareto {
             iterator_impl(const iterator_impl<rhs_is_const> &rhs)
                 : current_tree_(rhs.current_tree_),
                   current_node_(rhs.current_node_),
+                  current_index_(rhs.current_index_),
                   predicates_(rhs.predicates_),
                   nearest_points_iterated_(rhs.nearest_points_iterated_) {
                 nearest_queue_.reserve(rhs.nearest_queue_.size());
@@ -235,6 +253,7 @@ namespace pareto {
             iterator_impl &operator=(const iterator_impl<rhs_is_const> &rhs) {
                 current_tree_ = rhs.current_tree_;
                 current_node_ = rhs.current_node_;
+                current_index_ = rhs.current_index_;
                 predicates_ = rhs.predicates_;
                 nearest_points_iterated_ = rhs.nearest_points_iterated_;
                 nearest_queue_.reserve(rhs.nearest_queue_.size());
@@ -273,6 +292,7 @@ namespace pareto {
             iterator_impl(iterator_impl<rhs_is_const> &&rhs)
                 : current_tree_(rhs.current_tree_),
                   current_node_(rhs.current_node_),
+                  current_index_(rhs.current_index_),
                   predicates_(std::move(rhs.predicates_)),
                   nearest_points_iterated_(rhs.nearest_points_iterated_) {
                 nearest_queue_.reserve(rhs.nearest_queue_.size());
@@ -288,6 +308,7 @@ namespace pareto {
             iterator_impl &operator=(iterator_impl<rhs_is_const> &&rhs) {
                 current_tree_ = rhs.current_tree_;
                 current_node_ = rhs.current_node_;
+                current_index_ = rhs.current_index_;
                 predicates_ = std::move(rhs.predicates_);
                 nearest_points_iterated_ = rhs.nearest_points_iterated_;
                 nearest_queue_ = rhs.nearest_queue_;
@@ -299,7 +320,13 @@ namespace pareto {
             /// When the current pointer == nullptr, we are at end().
             /// We need the tree_ so that a.end() != b.end().
             iterator_impl(tree_pointer tree_, node_pointer root_)
-                : current_tree_(tree_), current_node_(root_), nearest_queue_{},
+                : iterator_impl(tree_, root_, 0) {}
+
+            /// \brief Iterator to a value in the bucket of a node
+            iterator_impl(tree_pointer tree_, node_pointer node_,
+                          size_t index)
+                : current_tree_(tree_), current_node_(node_),
+                  current_index_(index), nearest_queue_{},
                   nearest_points_iterated_(0) {
                 advance_if_invalid();
             }
@@ -346,11 +373,12 @@ namespace pareto {
             reference operator*() const {
                 assert(is_not_null());
                 constexpr bool is_protected = std::is_const_v<
-                    typename decltype(current_node_->value_)::first_type>;
+                    typename unprotected_value_type::first_type>;
                 if constexpr (is_protected) {
-                    return current_node_->value_;
+                    return current_node_->values_[current_index_];
                 } else {
-                    return protect_pair_key(current_node_->value_);
+                    return protect_pair_key(
+                        current_node_->values_[current_index_]);
                 }
             }
 
@@ -375,7 +403,9 @@ namespace pareto {
                     return false;
                 } else {
                     return (current_node_ == rhs.current_node_) &&
-                           (current_tree_ == rhs.current_tree_);
+                           (current_tree_ == rhs.current_tree_) &&
+                           (current_node_ == nullptr ||
+                            current_index_ == rhs.current_index_);
                 }
             }
 
@@ -418,7 +448,7 @@ namespace pareto {
                     predicates_.get_nearest() != nullptr &&
                     nearest_points_iterated_ == 0;
                 if (need_to_iterate_to_nearest ||
-                    !predicates_.pass_predicate(current_node_->value_)) {
+                    !predicates_.pass_predicate(current_value())) {
                     // advance if current is not valid
                     advance_to_next_valid(false);
                 }
@@ -437,12 +467,38 @@ namespace pareto {
                     return true;
                 }
                 // in the general case, begin is the root node (depth-first)
-                return current_node_ == current_tree_->root_;
+                return current_node_ == current_tree_->root_ &&
+                       current_index_ == 0;
             }
 
             /// \brief Is iterator_impl pointing to valid data
             [[nodiscard]] bool is_not_null() const { return !is_end(); }
 
+            /// \brief Value the iterator points to
+            const unprotected_value_type &current_value() const {
+                return current_node_->values_[current_index_];
+            }
+
+            /// \brief Enqueue the values and children of a node by their
+            /// distance to the reference point
+            void enqueue_nearest(node_pointer node) {
+                auto nearest_predicate = predicates_.get_nearest();
+                for (size_t i = 0; i < node->values_.size(); ++i) {
+                    nearest_queue_.emplace_back(
+                        node, i,
+                        nearest_predicate->distance(node->values_[i].first));
+                    std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
+                                   queue_comp);
+                }
+                for (auto &child : node->children_) {
+                    nearest_queue_.emplace_back(
+                        child.second, node_index,
+                        nearest_predicate->distance(child.second->bounds_));
+                    std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
+                                   queue_comp);
+                }
+            }
+
             /// \brief Initialize queue for the nearest element algorithm
             void initialize_nearest_algorithm() {
                 auto nearest_predicate = predicates_.get_nearest();
@@ -450,6 +506,11 @@ namespace pareto {
                     return;
                 }
 
+                // An empty tree has no root and no nearest points
+                if (current_node_ == nullptr) {
+                    return;
+                }
+
                 // If this is the end iterator
                 if (is_end()) {
                     // We already pre-process all the results
@@ -488,19 +549,8 @@ namespace pareto {
                 // the distance doesn't matter. It's just easier to Enqueue all
                 // branches of quad-containers.RootNode already, as would always
                 // happen at the first iteration anyway. Because this is a
-                // quad-containers, we also enqueue the node value.
-                nearest_queue_.emplace_back(
-                    current_node_, true,
-                    nearest_predicate->distance(current_node_->value_.first));
-                std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
-                               queue_comp);
-                for (auto &child : current_node_->children_) {
-                    nearest_queue_.emplace_back(
-                        child.second, false,
-                        nearest_predicate->distance(current_node_->bounds_));
-                    std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
-                                   queue_comp);
-                }
+                // quad-containers, we also enqueue the node values.
+                enqueue_nearest(current_node_);
 
                 // 3. while not IsEmpty(Queue) do
                 // From this point the algorithm is implemented inside the
@@ -522,11 +572,10 @@ namespace pareto {
                 // If we already iterated this nearest point in the past
                 // we should have the pre-processed results
                 while (nearest_points_iterated_ < nearest_set_.size()) {
-                    bool is_value;
                     bool passed_predicate;
-                    std::tie(current_node_, is_value, passed_predicate) =
+                    std::tie(current_node_, current_index_, passed_predicate) =
                         nearest_set_[nearest_points_iterated_];
-                    assert(is_value);
+                    assert(current_index_ != node_index);
                     ++nearest_points_iterated_;
                     if (passed_predicate) {
                         return;
@@ -540,9 +589,8 @@ namespace pareto {
                 // 3. while not IsEmpty(Queue) do
                 while (!nearest_queue_.empty()) {
                     // 4. Element <- Dequeue(Queue)
-                    auto [element_node, is_value, distance] =
+                    auto [element_node, element_index, distance] =
                         nearest_queue_.front();
-                    auto &element = element_node->value_;
                     std::pop_heap(nearest_queue_.begin(), nearest_queue_.end(),
                                   queue_comp);
                     nearest_queue_.pop_back();
@@ -551,27 +599,29 @@ namespace pareto {
                     // bounding rectangle because we only represent points in
                     // our containers. So we only test if it's an object (a
                     // value).
-                    if (is_value) {
+                    if (element_index != node_index) {
                         // 6. if Element is the bounding rectangle
                         //     7. That never happens in our containers
                         // 8. else
                         // 9.     Report Element
                         // in our version, we only report it if it also passes
                         // the other predicates
-                        if (predicates_.pass_predicate(element)) {
+                        if (predicates_.pass_predicate(
+                                element_node->values_[element_index])) {
                             ++nearest_points_iterated_;
                             current_node_ = element_node;
+                            current_index_ = element_index;
                             // put it in the pre-processed set of results
-                            nearest_set_.emplace_back(current_node_, true,
-                                                      true);
+                            nearest_set_.emplace_back(current_node_,
+                                                      current_index_, true);
                             return;
                         } else {
                             // if it doesn't pass the predicates, we just count
                             // it as one more nearest point we would have
                             // reported
                             ++nearest_points_iterated_;
-                            nearest_set_.emplace_back(current_node_, true,
-                                                      false);
+                            nearest_set_.emplace_back(element_node,
+                                                      element_index, false);
                             if (nearest_points_iterated_ >=
                                 nearest_predicate->k()) {
                                 advance_to_end();
@@ -588,24 +638,11 @@ namespace pareto {
                         // Element do
                         // 16. for each entry (Node,   Rect) in      node
                         // Element do
-                        nearest_queue_.emplace_back(
-                            element_node, true,
-                            nearest_predicate->distance(
-                                element_node->value_.first));
-                        std::push_heap(nearest_queue_.begin(),
-                                       nearest_queue_.end(), queue_comp);
-                        for (auto &child : element_node->children_) {
-                            // 13. Enqueue(Queue, [Object], Dist(QueryObject,
-                            // Rect))
-                            // 17. Enqueue(Queue, Node,     Dist(QueryObject,
-                            // Rect))
-                            nearest_queue_.emplace_back(
-                                child.second, false,
-                                nearest_predicate->distance(
-                                    child.second->bounds_));
-                            std::push_heap(nearest_queue_.begin(),
-                                           nearest_queue_.end(), queue_comp);
-                        }
+                        // 13. Enqueue(Queue, [Object], Dist(QueryObject,
+                        // Rect))
+                        // 17. Enqueue(Queue, Node,     Dist(QueryObject,
+                        // Rect))
+                        enqueue_nearest(element_node);
                     }
                 }
                 // Nothing else to report
@@ -628,11 +665,11 @@ namespace pareto {
                     } else {
                         // if nearest_points_iterated_ - 1 is already
                         // pre-processed
-                        bool is_value;
                         bool passed_predicate;
-                        std::tie(current_node_, is_value, passed_predicate) =
+                        std::tie(current_node_, current_index_,
+                                 passed_predicate) =
                             nearest_set_[nearest_points_iterated_ - 1];
-                        assert(is_value);
+                        assert(current_index_ != node_index);
                         --nearest_points_iterated_;
                         if (passed_predicate) {
                             return;
@@ -652,6 +689,7 @@ namespace pareto {
             void return_to_begin() {
                 if (current_tree_ != nullptr) {
                     current_node_ = current_tree_->root_;
+                    current_index_ = 0;
                 }
             }
 
@@ -664,12 +702,19 @@ namespace pareto {
                     // return if first time
                     // if we haven't checked the current node yet
                     if (first_time_in_this_branch) {
-                        if (predicates_.pass_predicate(current_node_->value_)) {
+                        if (predicates_.pass_predicate(current_value())) {
                             // found a valid value in current node
                             // point to it (already does) and return
                             return;
                         }
                         first_time_in_this_branch = false;
+                    } else if (current_index_ + 1 <
+                               current_node_->values_.size()) {
+                        // try the next value in the bucket
+                        ++current_index_;
+                        if (predicates_.pass_predicate(current_value())) {
+                            return;
+                        }
                     } else {
                         // if we already checked this node,
                         // go to first valid child if there are children, stop
@@ -706,6 +751,7 @@ namespace pareto {
                             go_to_sibling(true);
                             first_time_in_this_branch = true;
                         }
+                        current_index_ = 0;
                     }
                 }
             }
@@ -718,12 +764,19 @@ namespace pareto {
                 while (!is_begin()) {
                     // return if first time
                     if (first_time_in_this_branch) {
-                        if (predicates_.pass_predicate(current_node_->value_)) {
+                        if (predicates_.pass_predicate(current_value())) {
                             // found a valid value in current node
                             // point to it (already does) and return
                             return;
                         }
                         first_time_in_this_branch = false;
+                    } else if (current_node_ != nullptr &&
+                               current_index_ > 0) {
+                        // try the previous value in the bucket
+                        --current_index_;
+                        if (predicates_.pass_predicate(current_value())) {
+                            return;
+                        }
                     } else {
                         // go to left sibling and then to rightmost valid
                         // element, stop iterating if this is end(), left
@@ -759,6 +812,8 @@ namespace pareto {
                                 }
                             }
                         }
+                        // start from the last value in the bucket
+                        current_index_ = current_node_->values_.size() - 1;
                         first_time_in_this_branch = true;
                     }
                 }
@@ -809,9 +864,10 @@ namespace pareto {
                     // Move to parent and find index of current branch there
                     auto branch_address = current_node_;
                     current_node_ = current_node_->parent_;
-                    size_t branch_index = current_node_->value_.first.quadrant(
-                        branch_address->value_.first,
-                        current_tree_->dimension_comp());
+                    size_t branch_index =
+                        current_node_->values_[0].first.quadrant(
+                            branch_address->values_[0].first,
+                            current_tree_->dimension_comp());
                     auto branch_it =
                         current_node_->children_.find(branch_index);
                     assert(branch_it != current_node_->children_.end());
@@ -884,15 +940,23 @@ namespace pareto {
             /// \brief Stack as we are doing iteration instead of recursion
             node_pointer current_node_;
 
+            /// \brief Position of the current value in the node bucket
+            size_t current_index_{0};
+
             /// \brief Predicate constraining the search area
             predicate_list_type predicates_;
 
+            // Index of queue elements that represent a whole node
+            static constexpr size_t node_index =
+                std::numeric_limits<size_t>::max();
+
             // Pair with branch (node or object) and distance to the reference
-            // point The branch is represented by the node and a boolean marking
-            // if the pointer represents itself or its value
-            // tuple<node, represents value, distance>
+            // point The branch is represented by the node and the index of a
+            // value in its bucket, or node_index if the pointer represents
+            // the node itself
+            // tuple<node, value index, distance>
             using queue_element =
-                std::tuple<node_pointer, bool,
+                std::tuple<node_pointer, size_t,
                            typename point_type::distance_type>;
 
             // Function to compare queue_elements by their distance to the
@@ -910,8 +974,8 @@ namespace pareto {
             // Set of nearest values we have already found
             // Some pointers represent the value of a node
             // Some pointers represent the node itself with its bounding box
-            // tuple<node, represents value, passed predicate>
-            std::vector<std::tuple<node_pointer, bool, bool>> nearest_set_;
+            // tuple<node, value index, passed predicate>
+            std::vector<std::tuple<node_pointer, size_t, bool>> nearest_set_;
 
           public:
             // Allow hiding of non-public functions while allowing manipulation
@@ -1295,6 +1359,57 @@ namespace pareto {
                          : std::numeric_limits<dimension_type>::min();
         }
 
+        /// \brief Check the structure of the tree (for tests)
+        /// Each node has a non-empty bucket, a link to its parent, and
+        /// bounds with its values and children. The first value of a node
+        /// splits its children: all values under a child are in the
+        /// quadrant of the first value the child is linked to.
+        [[nodiscard]] bool check_invariants() const {
+            if (root_ == nullptr) {
+                return size_ == 0;
+            }
+            if (root_->parent_ != nullptr) {
+                return false;
+            }
+            size_t n = 0;
+            std::vector<const quadtree_node *> stack = {root_};
+            while (!stack.empty()) {
+                const quadtree_node *node = stack.back();
+                stack.pop_back();
+                if (node->values_.empty()) {
+                    return false;
+                }
+                for (const auto &[k, v] : node->values_) {
+                    if (!node->bounds_.contains(k)) {
+                        return false;
+                    }
+                }
+                const auto &splitter = node->values_[0].first;
+                for (const auto &[quadrant, child] : node->children_) {
+                    if (child->parent_ != node ||
+                        !node->bounds_.contains(child->bounds_)) {
+                        return false;
+                    }
+                    std::vector<const quadtree_node *> subtree = {child};
+                    while (!subtree.empty()) {
+                        const quadtree_node *s = subtree.back();
+                        subtree.pop_back();
+                        for (const auto &[k, v] : s->values_) {
+                            if (splitter.quadrant(k, comp_) != quadrant) {
+                                return false;
+                            }
+                        }
+                        for (const auto &[q, c] : s->children_) {
+                            subtree.emplace_back(c);
+                        }
+                    }
+                    stack.emplace_back(child);
+                }
+                n += node->values_.size();
+            }
+            return n == size_;
+        }
+
       public /* Modifying Functions: Container + AllocatorAwareContainer */:
         /// \brief Swap the content of two objects
         /// Swap will replace the allocator only if
@@ -1335,13 +1450,13 @@ namespace pareto {
         /// \return Iterator to the new element
         /// \return True if insertion happened successfully
         iterator insert(const value_type &v) {
-            quadtree_node *destination_node = insert_branch(v, root_);
-            return iterator(this, destination_node);
+            auto [destination_node, index] = insert_branch(v, root_);
+            return iterator(this, destination_node, index);
         }
 
         iterator insert(value_type &&v) {
-            quadtree_node *destination_node = insert_branch(v, root_);
-            return iterator(this, destination_node);
+            auto [destination_node, index] = insert_branch(v, root_);
+            return iterator(this, destination_node, index);
         }
 
         template <class P> iterator insert(P &&v) {
@@ -1405,10 +1520,10 @@ namespace pareto {
             }
             if (next_position != end()) {
                 key_type next_key = next_position->first;
-                erase_impl(node_to_remove);
+                erase_impl(node_to_remove, position.current_index_);
                 return find(next_key);
             } else {
-                erase_impl(node_to_remove);
+                erase_impl(node_to_remove, position.current_index_);
                 return end();
             }
         }
@@ -1665,7 +1780,8 @@ namespace pareto {
             if (empty()) {
                 return end();
             }
-            return iterator(this, recursive_max_element(root_, dimension));
+            auto [node, index] = recursive_max_element(root_, dimension);
+            return iterator(this, node, index);
         }
 
         /// \brief Get iterator to element with maximum value in a given
@@ -1674,8 +1790,8 @@ namespace pareto {
             if (empty()) {
                 return end();
             }
-            return const_iterator(this,
-                                  recursive_max_element(root_, dimension));
+            auto [node, index] = recursive_max_element(root_, dimension);
+            return const_iterator(this, node, index);
         }
 
         /// \brief Get iterator to element with minimum value in a given
@@ -1684,7 +1800,8 @@ namespace pareto {
             if (empty()) {
                 return end();
             }
-            return iterator(this, recursive_min_element(root_, dimension));
+            auto [node, index] = recursive_min_element(root_, dimension);
+            return iterator(this, node, index);
         }
 
         /// \brief Get iterator to element with minimum value in a given
@@ -1693,8 +1810,8 @@ namespace pareto {
             if (empty()) {
                 return end();
             }
-            return const_iterator(this,
-                                  recursive_min_element(root_, dimension));
+            auto [node, index] = recursive_min_element(root_, dimension);
+            return const_iterator(this, node, index);
         }
 
       public /* Non-Modifying Functions: AssociativeContainer */:
@@ -1787,8 +1904,8 @@ namespace pareto {
         /// if root was split, 0 if it was not. \return Pointer to the node
         /// containing the value we inserted \return Index of the element we
         /// inserted in the node that contains it
-        quadtree_node *insert_branch(const value_type &v,
-                                     quadtree_node *&root_node) {
+        std::pair<quadtree_node *, size_t>
+        insert_branch(const value_type &v, quadtree_node *&root_node) {
             if constexpr (number_of_compile_dimensions == 0) {
                 if (dimensions_ == 0) {
                     dimensions_ = v.first.dimensions();
@@ -1798,24 +1915,35 @@ namespace pareto {
             if (root_node == nullptr) {
                 root_node = allocate_quadtree_node(nullptr, v);
                 ++size_;
-                return root_node;
+                return {root_node, 0};
             }
 
             /// \brief Find the region that would contain the point P.
+            /// The point goes into the first bucket with free space on
+            /// its path.
             quadtree_node *current = root_node;
-            size_t quadrant = current->value_.first.quadrant(v.first, comp_);
-            auto quadrant_it = current->children_.find(quadrant);
-            while (quadrant_it != current->children_.end()) {
+            std::pair<quadtree_node *, size_t> destination;
+            while (true) {
+                if (!current->values_.full()) {
+                    destination = {current, current->values_.size()};
+                    current->values_.emplace_back(v);
+                    break;
+                }
+                size_t quadrant =
+                    current->values_[0].first.quadrant(v.first, comp_);
+                auto quadrant_it = current->children_.find(quadrant);
+                if (quadrant_it == current->children_.end()) {
+                    /// \brief Add point where you fall off the containers.
+                    /// The element would be in current->children_[quadrant]
+                    quadtree_node *new_node =
+                        allocate_quadtree_node(current, v);
+                    current->children_.emplace(quadrant, new_node);
+                    destination = {new_node, 0};
+                    break;
+                }
                 current = quadrant_it->second;
-                quadrant = current->value_.first.quadrant(v.first, comp_);
-                quadrant_it = current->children_.find(quadrant);
             }
 
-            /// \brief Add point where you fall off the containers.
-            /// The element would be in current->children_[quadrant]
-            quadtree_node *new_node = allocate_quadtree_node(current, v);
-            current->children_.emplace(quadrant, new_node);
-
             /// \brief Adjust the minimum bounds up to the root
             current->bounds_.stretch(v.first);
             while (current->parent_ != nullptr) {
@@ -1824,16 +1952,32 @@ namespace pareto {
             }
 
             ++size_;
-            return new_node;
+            return destination;
         }
 
-        void erase_impl(quadtree_node *node_to_remove) {
+        void erase_impl(quadtree_node *node_to_remove, size_t index) {
             // if this is empty
             if (node_to_remove == nullptr) {
                 // we can't remove anything
                 return;
             }
 
+            // if the value is not the one splitting the children, we only
+            // need to remove it from the bucket
+            if (node_to_remove->values_.size() > 1 &&
+                (index != 0 || node_to_remove->children_.empty())) {
+                node_to_remove->values_.swap_and_pop(index);
+                assert(size_ > 0);
+                --size_;
+                quadtree_node *current_node = node_to_remove;
+                while (current_node != nullptr) {
+                    current_node->bounds_ =
+                        minimum_bounding_rectangle(current_node);
+                    current_node = current_node->parent_;
+                }
+                return;
+            }
+
             // List of elements we need to reinsert in the containers after
             // removing the node
             std::vector<unprotected_value_type> reinsert_list;
@@ -1841,6 +1985,11 @@ namespace pareto {
             // copy and erase_impl all elements under node_to_remove to the
             // reinsert_list
             move_to_reinsert(node_to_remove, reinsert_list, false);
+            for (size_t i = 0; i < node_to_remove->values_.size(); ++i) {
+                if (i != index) {
+                    reinsert_list.emplace_back(node_to_remove->values_[i]);
+                }
+            }
 
             // remove the root
             quadtree_node *current_node = node_to_remove->parent_;
@@ -1848,8 +1997,8 @@ namespace pareto {
                 // find it in the parent node and erase_impl it from the
                 // children
                 auto it = current_node->children_.find(
-                    current_node->value_.first.quadrant(
-                        node_to_remove->value_.first, comp_));
+                    current_node->values_[0].first.quadrant(
+                        node_to_remove->values_[0].first, comp_));
                 assert(it != current_node->children_.end());
                 current_node->children_.erase(it);
             } else {
@@ -1857,9 +2006,9 @@ namespace pareto {
                 root_ = nullptr;
             }
             // deallocate node
+            assert(size_ >= node_to_remove->values_.size());
+            size_ -= node_to_remove->values_.size();
             deallocate_quadtree_node(node_to_remove);
-            assert(size_ > 0);
-            --size_;
 
             // Reinsert all elements from the vector under the node
             auto comp = [this](const auto &a, const auto &b) {
@@ -1884,7 +2033,10 @@ namespace pareto {
         /// branches of a node.
         box_type minimum_bounding_rectangle(quadtree_node *a_node) {
             assert(a_node);
-            box_type rect = box_type(a_node->value_.first);
+            box_type rect = box_type(a_node->values_[0].first);
+            for (size_t i = 1; i < a_node->values_.size(); ++i) {
+                rect.stretch(a_node->values_[i].first);
+            }
             for (auto &[quadrant, child] : a_node->children_) {
                 rect.stretch(child->bounds_);
             }
@@ -1895,7 +2047,7 @@ namespace pareto {
         void copy_recursive(quadtree_node *current,
                             quadtree_node *current_parent,
                             const quadtree_node *other) {
-            current->value_ = other->value_;
+            current->values_ = other->values_;
             current->bounds_ = other->bounds_;
             current->parent_ = current_parent;
             for (const auto &[quadrant, child] : other->children_) {
@@ -1919,30 +2071,46 @@ namespace pareto {
                          std::vector<unprotected_value_type> &reinsert_list,
                          bool move_root) {
             for (auto &[quadrant, child_node] : node_to_remove->children_) {
-                if (child_node->children_.empty()) {
-                    reinsert_list.emplace_back(child_node->value_);
-                    deallocate_quadtree_node(child_node);
-                    --size_;
-                } else {
-                    move_to_reinsert(child_node, reinsert_list, true);
-                }
+                move_to_reinsert(child_node, reinsert_list, true);
             }
             if (move_root) {
-                --size_;
-                reinsert_list.emplace_back(node_to_remove->value_);
+                size_ -= node_to_remove->values_.size();
+                reinsert_list.insert(reinsert_list.end(),
+                                     node_to_remove->values_.begin(),
+                                     node_to_remove->values_.end());
                 deallocate_quadtree_node(node_to_remove);
             }
         }
 
+        /// \brief Position of the max/min element of a bucket in a dimension
+        template <bool find_max>
+        size_t bucket_extreme(const quadtree_node *node,
+                              size_t dimension) const {
+            size_t best = 0;
+            for (size_t i = 1; i < node->values_.size(); ++i) {
+                const auto &candidate = node->values_[i].first[dimension];
+                const auto &current = node->values_[best].first[dimension];
+                if (find_max ? comp_(current, candidate)
+                             : comp_(candidate, current)) {
+                    best = i;
+                }
+            }
+            return best;
+        }
+
         /// \brief Recursively find the max element
-        quadtree_node *recursive_max_element(quadtree_node *parent_node,
-                                             size_t dimension) const {
+        /// \return Node and position of the element in the node bucket
+        std::pair<quadtree_node *, size_t>
+        recursive_max_element(quadtree_node *parent_node,
+                              size_t dimension) const {
+            const size_t best = bucket_extreme<true>(parent_node, dimension);
+            const auto &best_value = parent_node->values_[best].first;
             if (parent_node->children_.empty()) {
-                return parent_node;
+                return {parent_node, best};
             }
-            if (parent_node->value_.first[dimension] >=
+            if (best_value[dimension] >=
                 parent_node->bounds_.second()[dimension]) {
-                return parent_node;
+                return {parent_node, best};
             }
             // we could iterate only though the elements that have
             // quadrant[dimension] == 1 but both algorithms would be O(n) on
@@ -1958,23 +2126,27 @@ namespace pareto {
                            b.second->bounds_.second()[dimension];
                 });
             assert(max_it != parent_node->children_.end());
-            if (parent_node->value_.first[dimension] >=
+            if (best_value[dimension] >=
                 max_it->second->bounds_.second()[dimension]) {
-                return parent_node;
+                return {parent_node, best};
             } else {
                 return recursive_max_element(max_it->second, dimension);
             }
         }
 
         /// \brief Recursively find the min element
-        quadtree_node *recursive_min_element(quadtree_node *parent_node,
-                                             size_t dimension) const {
+        /// \return Node and position of the element in the node bucket
+        std::pair<quadtree_node *, size_t>
+        recursive_min_element(quadtree_node *parent_node,
+                              size_t dimension) const {
+            const size_t best = bucket_extreme<false>(parent_node, dimension);
+            const auto &best_value = parent_node->values_[best].first;
             if (parent_node->children_.empty()) {
-                return parent_node;
+                return {parent_node, best};
             }
-            if (parent_node->value_.first[dimension] <=
+            if (best_value[dimension] <=
                 parent_node->bounds_.first()[dimension]) {
-                return parent_node;
+                return {parent_node, best};
             }
             auto min_it = std::min_element(
                 parent_node->children_.begin(), parent_node->children_.end(),
@@ -1985,9 +2157,9 @@ namespace pareto {
                            b.second->bounds_.first()[dimension];
                 });
             assert(min_it != parent_node->children_.end());
-            if (parent_node->value_.first[dimension] <=
+            if (best_value[dimension] <=
                 min_it->second->bounds_.first()[dimension]) {
-                return parent_node;
+                return {parent_node, best};
             } else {
                 return recursive_min_element(min_it->second, dimension);
             }
@@ -2029,9 +2201,12 @@ namespace pareto {
                               size_t level) const {
             std::string str(level * 2, ' ');
             std::stringstream ss;
-            ss << current->value_.first;
-            // ss << current->value_.first << ": " << current->value_.second;
-            assert(current->bounds_.contains(current->value_.first));
+            for (size_t i = 0; i < current->values_.size(); ++i) {
+                ss << (i == 0 ? "" : " ") << current->values_[i].first;
+                // ss << current->values_[i].first << ": "
+                //    << current->values_[i].second;
+                assert(current->bounds_.contains(current->values_[i].first));
+            }
             str += ss.str() + "\n";
             for (const auto &child : current->children_) {
                 str += to_string(child.second, level + 1);
@@ -2085,17 +2260,17 @@ namespace pareto {
     };
 
     // MSVC hack (we cannot define it inside iterator_impl)
-    template <class N, size_t M, class E, class C, class A>
+    template <class N, size_t M, class E, class C, class A, size_t B>
     template <bool constness>
     const std::function<
-        bool(const typename quad_tree<N, M, E, C, A>::template iterator_impl<
+        bool(const typename quad_tree<N, M, E, C, A, B>::template iterator_impl<
                  constness>::queue_element &,
-             const typename quad_tree<N, M, E, C, A>::template iterator_impl<
+             const typename quad_tree<N, M, E, C, A, B>::template iterator_impl<
                  constness>::queue_element &)>
-        quad_tree<N, M, E, C, A>::iterator_impl<constness>::queue_comp =
-            [](const typename quad_tree<N, M, E, C, A>::template iterator_impl<
+        quad_tree<N, M, E, C, A, B>::iterator_impl<constness>::queue_comp =
+            [](const typename quad_tree<N, M, E, C, A, B>::template iterator_impl<
                    constness>::queue_element &a,
-               const typename quad_tree<N, M, E, C, A>::template iterator_impl<
+               const typename quad_tree<N, M, E, C, A, B>::template iterator_impl<
                    constness>::queue_element &b) -> bool {
         return std::get<2>(a) > std::get<2>(b);
     };
@@ -2110,25 +2285,25 @@ namespace pareto {
     /// If you need to compare if the elements are the same, regardless
     /// of their trees, you have to iterate one container and call
     /// find on the second container. This operation takes loglinear time.
-    template <class K, size_t M, class T, class C, class A>
-    bool operator==(const quad_tree<K, M, T, C, A> &lhs,
-                    const quad_tree<K, M, T, C, A> &rhs) {
+    template <class K, size_t M, class T, class C, class A, size_t B>
+    bool operator==(const quad_tree<K, M, T, C, A, B> &lhs,
+                    const quad_tree<K, M, T, C, A, B> &rhs) {
         if (lhs.size() != rhs.size()) {
             return false;
         }
         return std::equal(
             lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
-            [](const typename quad_tree<K, M, T, C, A>::value_type &a,
-               const typename quad_tree<K, M, T, C, A>::value_type &b) {
+            [](const typename quad_tree<K, M, T, C, A, B>::value_type &a,
+               const typename quad_tree<K, M, T, C, A, B>::value_type &b) {
                 return a.first == b.first &&
                        mapped_type_custom_equality_operator(a.second, b.second);
             });
     }
 
     /// \brief Inequality operator
-    template <class K, size_t M, class T, class C, class A>
-    bool operator!=(const quad_tree<K, M, T, C, A> &lhs,
-                    const quad_tree<K, M, T, C, A> &rhs) {
+    template <class K, size_t M, class T, class C, class A, size_t B>
+    bool operator!=(const quad_tree<K, M, T, C, A, B> &lhs,
+                    const quad_tree<K, M, T, C, A, B> &rhs) {
         return !(lhs == rhs);
     }
 
@@ -36,8 +36,12 @@ namespace pareto {
     /// https://github.com/virtuald/r-star-containers/blob/master/RStarBoundingBox.h
     /// https://en.wikipedia.org/wiki/R*_tree
     /// But our design is completely different.
+    ///
+    /// As in the r_tree class, MaxBranches and MinBranches define the fanout
+    /// of the nodes.
     template <class K, size_t M, class T, typename C = std::less<K>,
-              class A = default_allocator_type<std::pair<const point<K, M>, T>>>
+              class A = default_allocator_type<std::pair<const point<K, M>, T>>,
+              size_t MaxBranches = 8, size_t MinBranches = MaxBranches / 2>
     class r_star_tree : container_with_pool {
       private /* Internal types */:
         using unprotected_point_type = point<K, M>;
@@ -103,12 +107,14 @@ namespace pareto {
         static constexpr bool rtree_use_spherical_volume_ = true;
 
         // Max and min number of elements in a node
-        static constexpr size_t tmaxnodes_ = 8;
-        static constexpr size_t tminnodes_ = tmaxnodes_ / 2;
+        static constexpr size_t tmaxnodes_ = MaxBranches;
+        static constexpr size_t tminnodes_ = MinBranches;
         static constexpr size_t maxnodes_ = tmaxnodes_;
         static constexpr size_t minnodes_ = tminnodes_;
         static_assert(maxnodes_ > minnodes_);
         static_assert(minnodes_ > 0);
+        // A split needs to fill two nodes with maxnodes_ + 1 branches
+        static_assert(2 * minnodes_ <= maxnodes_ + 1);
         static constexpr double RTREE_REINSERT_P = 0.30;
 
       private /* internal node types */:
@@ -138,6 +144,9 @@ namespace pareto {
             explicit branch_variant(const unprotected_value_type &v)
                 : data_(variant_type(v)) {}
 
+            explicit branch_variant(unprotected_value_type &&v)
+                : data_(variant_type(std::move(v))) {}
+
             explicit branch_variant(const value_type &v)
                 : data_(variant_type(unprotected_value_type(v))) {}
 
@@ -672,6 +681,11 @@ namespace pareto {
                     while (root->parent_ != nullptr) {
                         root = root->parent_;
                     }
+                    // An empty tree has no nearest points, and the begin
+                    // iterator would also be the end iterator
+                    if (root->count_ == 0) {
+                        return;
+                    }
                     iterator_impl it = iterator_impl(root, predicates_);
                     iterator_impl end = iterator_impl(root, root->count_);
                     // Iterate until the end so we have the nearest points
@@ -1243,10 +1257,7 @@ namespace pareto {
             : r_star_tree(alloc) {
             comp_ = comp;
             std::vector<unprotected_value_type> v(first, last);
-            std::sort(v.begin(), v.end(), [](const auto &a, const auto &b) {
-                return a.first.values() < b.first.values();
-            });
-            bulk_insert(v, root_);
+            str_bulk_load(v);
         }
 
         /// \brief Construct with list + comparison
@@ -1265,10 +1276,7 @@ namespace pareto {
         r_star_tree(InputIt first, InputIt last, const allocator_type &alloc)
             : r_star_tree(alloc) {
             std::vector<unprotected_value_type> v(first, last);
-            std::sort(v.begin(), v.end(), [](const auto &a, const auto &b) {
-                return a.first.values() < b.first.values();
-            });
-            bulk_insert(v, root_);
+            str_bulk_load(v);
         }
 
         /// \brief Construct with iterators
@@ -1652,11 +1660,21 @@ namespace pareto {
         }
 
         /// \brief Insert list of elements
+        /// If the new elements are at least as many as the elements
+        /// already in the tree, the tree is rebuilt with a packed
+        /// bulk load, which is much cheaper than splitting nodes
+        /// for each new element.
         template <class Inputiterator>
         void insert(Inputiterator first, Inputiterator last) {
-            while (first != last) {
-                insert(*first);
-                ++first;
+            std::vector<unprotected_value_type> v(first, last);
+            if (v.size() < size_) {
+                for (auto &value : v) {
+                    insert(std::move(value));
+                }
+            } else {
+                v.reserve(v.size() + size_);
+                v.insert(v.end(), begin(), end());
+                str_bulk_load(v);
             }
         }
 
@@ -2465,8 +2483,9 @@ namespace pareto {
             for (auto it = removed_items.begin(); it != removed_items.end();
                  it++) {
                 assert(it->is_value());
-                if (*it == branch_to_insert) {
-                    assert(result_node == nullptr);
+                // Copies of an element are equal, so we only keep track of
+                // the first branch that matches
+                if (result_node == nullptr && *it == branch_to_insert) {
                     std::tie(std::ignore, result_node, result_index,
                              std::ignore) = insert_branch(*it, root_, 0, false);
                 } else {
@@ -3299,56 +3318,105 @@ namespace pareto {
             }
         }
 
-        /// Bulk insertion inserts the median before other elements
-        template <class InputIterator>
-        void bulk_insert(InputIterator l_begin, InputIterator l_end,
-                         const value_type &v, InputIterator r_begin,
-                         InputIterator r_end) {
-            bulk_insert(l_begin, l_end, v, r_begin, r_end, root_);
-        }
-
-        void bulk_insert(const std::vector<unprotected_value_type> &v,
-                         rstar_tree_node *&node) {
-            // bulk insert ranges {1, median - 1}, median, { median + 1, end()}
-            if (!v.empty()) {
-                if (v.size() == 1) {
-                    insert_branch(branch_variant(v[0]), node, 0, true);
-                } else {
-                    size_t median_pos = v.size() / 2;
-                    bulk_insert(v.begin(), v.begin() + median_pos,
-                                v[median_pos], v.begin() + median_pos + 1,
-                                v.end(), node);
-                }
+        /// \brief Replace the tree with a packed tree built from v
+        /// Sort-Tile-Recursive (STR) bulk loading, as in r_tree.
+        /// Packed leaves are not reorganized with forced reinsertions,
+        /// but STR already produces nodes with little overlap.
+        void str_bulk_load(std::vector<unprotected_value_type> &v) {
+            remove_all_records(root_);
+            root_ = nullptr;
+            size_ = v.size();
+            if (v.empty()) {
+                root_ = allocate_rstar_tree_node();
+                root_->level_ = 0;
+                return;
             }
-        }
-
-        template <class InputIterator>
-        void bulk_insert(InputIterator l_begin, InputIterator l_end,
-                         const unprotected_value_type &v, InputIterator r_begin,
-                         InputIterator r_end, rstar_tree_node *&node) {
-            insert_branch(branch_variant(v), node, 0, true);
-            size_t l_size = std::distance(l_begin, l_end);
-            if (l_size != 0) {
-                if (l_size == 1) {
-                    insert_branch(branch_variant(*l_begin), node, 0, true);
-                } else {
-                    size_t l_median_pos = l_size / 2;
-                    bulk_insert(l_begin, l_begin + l_median_pos,
-                                *(l_begin + l_median_pos),
-                                l_begin + l_median_pos + 1, l_end, node);
+            if constexpr (number_of_compile_dimensions == 0) {
+                if (dimensions_ == 0) {
+                    dimensions_ = v.front().first.dimensions();
+                    initialize_unit_sphere_volume();
                 }
             }
-            size_t r_size = std::distance(r_begin, r_end);
-            if (r_size != 0) {
-                if (r_size == 1) {
-                    insert_branch(branch_variant(*r_begin), node, 0, true);
-                } else {
-                    size_t r_median_pos = r_size / 2;
-                    bulk_insert(r_begin, r_begin + r_median_pos,
-                                *(r_begin + r_median_pos),
-                                r_begin + r_median_pos + 1, r_end, node);
+            str_tile(v.begin(), v.end(), 0,
+                     [](const unprotected_value_type &a, size_t d) {
+                         return a.first[d];
+                     });
+            std::vector<branch_variant> level_branches = str_pack(v, 0);
+            size_t level = 1;
+            while (level_branches.size() > 1) {
+                // The sum of the corners sorts boxes by their centers
+                str_tile(level_branches.begin(), level_branches.end(), 0,
+                         [](const branch_variant &a, size_t d) {
+                             const box_type &b = a.as_branch().first;
+                             return b.first()[d] + b.second()[d];
+                         });
+                level_branches = str_pack(level_branches, level);
+                ++level;
+            }
+            root_ = level_branches.front().node_pointer();
+            root_->parent_ = nullptr;
+        }
+
+        /// \brief Sort the entries in [first, last) into STR slabs
+        template <class RandomIt, class Coordinate>
+        void str_tile(RandomIt first, RandomIt last, size_t dimension,
+                      Coordinate coordinate) {
+            const auto n = static_cast<size_t>(std::distance(first, last));
+            if (n <= maxnodes_) {
+                return;
+            }
+            std::sort(first, last, [&](const auto &a, const auto &b) {
+                return coordinate(a, dimension) < coordinate(b, dimension);
+            });
+            if (dimension + 1 >= dimensions_) {
+                return;
+            }
+            const size_t n_nodes = (n + maxnodes_ - 1) / maxnodes_;
+            const size_t remaining_dimensions = dimensions_ - dimension;
+            const auto n_slabs = static_cast<size_t>(std::ceil(
+                std::pow(static_cast<double>(n_nodes),
+                         1. / static_cast<double>(remaining_dimensions))));
+            const size_t slab_size =
+                maxnodes_ * ((n_nodes + n_slabs - 1) / n_slabs);
+            while (first != last) {
+                const auto remaining =
+                    static_cast<size_t>(std::distance(first, last));
+                RandomIt slab_end =
+                    remaining > slab_size ? std::next(first, slab_size) : last;
+                str_tile(first, slab_end, dimension + 1, coordinate);
+                first = slab_end;
+            }
+        }
+
+        /// \brief Pack consecutive entries into nodes of a given level
+        /// \return Branches pointing to the new nodes
+        template <class Entry>
+        std::vector<branch_variant> str_pack(std::vector<Entry> &entries,
+                                             size_t level) {
+            std::vector<branch_variant> parent_branches;
+            parent_branches.reserve(entries.size() / maxnodes_ + 1);
+            size_t first = 0;
+            while (first < entries.size()) {
+                size_t count = std::min(maxnodes_, entries.size() - first);
+                // Split the remainder between the last two nodes
+                // so that the last node is not underfull
+                const size_t rest = entries.size() - first - count;
+                if (rest != 0 && rest < minnodes_) {
+                    count = (count + rest + 1) / 2;
+                }
+                rstar_tree_node *node = allocate_rstar_tree_node();
+                node->level_ = level;
+                node->count_ = count;
+                for (size_t i = 0; i < count; ++i) {
+                    node->branches_[i] =
+                        branch_variant(std::move(entries[first + i]));
+                    node->branches_[i].set_parent(node);
                 }
+                parent_branches.emplace_back(
+                    box_and_node(minimum_bounding_rectangle(node), node));
+                first += count;
             }
+            return parent_branches;
         }
 
       private /* Allocate nodes */:
@@ -3398,17 +3466,18 @@ namespace pareto {
     };
 
     // MSVC hack
-    template <class N, size_t M, class E, class C, class A>
+    template <class N, size_t M, class E, class C, class A, size_t X,
+              size_t Y>
     template <bool constness>
     const std::function<
-        bool(const typename r_star_tree<N, M, E, C, A>::template iterator_impl<
+        bool(const typename r_star_tree<N, M, E, C, A, X, Y>::template iterator_impl<
                  constness>::queue_element &,
-             const typename r_star_tree<N, M, E, C, A>::template iterator_impl<
+             const typename r_star_tree<N, M, E, C, A, X, Y>::template iterator_impl<
                  constness>::queue_element &)>
-        r_star_tree<N, M, E, C, A>::iterator_impl<constness>::queue_comp =
-            [](const typename r_star_tree<N, M, E, C, A>::
+        r_star_tree<N, M, E, C, A, X, Y>::iterator_impl<constness>::queue_comp =
+            [](const typename r_star_tree<N, M, E, C, A, X, Y>::
                    template iterator_impl<constness>::queue_element &a,
-               const typename r_star_tree<N, M, E, C, A>::
+               const typename r_star_tree<N, M, E, C, A, X, Y>::
                    template iterator_impl<constness>::queue_element &b)
         -> bool { return std::get<2>(a) > std::get<2>(b); };
 
@@ -3423,25 +3492,27 @@ namespace pareto {
     /// If you need to compare if the elements are the same, regardless
     /// of their trees, you have to iterate one container and call
     /// find on the second container. This operation takes loglinear time.
-    template <class K, size_t M, class T, class C, class A>
-    bool operator==(const r_star_tree<K, M, T, C, A> &lhs,
-                    const r_star_tree<K, M, T, C, A> &rhs) {
+    template <class K, size_t M, class T, class C, class A, size_t X,
+              size_t Y>
+    bool operator==(const r_star_tree<K, M, T, C, A, X, Y> &lhs,
+                    const r_star_tree<K, M, T, C, A, X, Y> &rhs) {
         if (lhs.size() != rhs.size()) {
             return false;
         }
         return std::equal(
             lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
-            [](const typename r_star_tree<K, M, T, C, A>::value_type &a,
-               const typename r_star_tree<K, M, T, C, A>::value_type &b) {
+            [](const typename r_star_tree<K, M, T, C, A, X, Y>::value_type &a,
+               const typename r_star_tree<K, M, T, C, A, X, Y>::value_type &b) {
                 return a.first == b.first &&
                        mapped_type_custom_equality_operator(a.second, b.second);
             });
     }
 
     /// \brief Inequality operator
-    template <class K, size_t M, class T, class C, class A>
-    bool operator!=(const r_star_tree<K, M, T, C, A> &lhs,
-                    const r_star_tree<K, M, T, C, A> &rhs) {
+    template <class K, size_t M, class T, class C, class A, size_t X,
+              size_t Y>
+    bool operator!=(const r_star_tree<K, M, T, C, A, X, Y> &lhs,
+                    const r_star_tree<K, M, T, C, A, X, Y> &rhs) {
         return !(lhs == rhs);
     }
 
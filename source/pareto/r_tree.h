@@ -56,8 +56,15 @@ namespace pareto {
     /// This implementation used
     /// https://github.com/nushoin/RTree/blob/master/RTree.h
     /// as reference for correctness, but the design is completely different.
+    ///
+    /// MaxBranches and MinBranches are the maximum and minimum number of
+    /// branches in each node. Larger nodes make the tree shallower and use
+    /// more of each cache line when scanning a node, but make insertions
+    /// and splits more expensive. The best fanout depends on the number of
+    /// dimensions, so containers_benchmark compares a few of them.
     template <class K, size_t M, class T, typename C = std::less<K>,
-              class A = default_allocator_type<std::pair<const point<K, M>, T>>>
+              class A = default_allocator_type<std::pair<const point<K, M>, T>>,
+              size_t MaxBranches = 8, size_t MinBranches = MaxBranches / 2>
     class r_tree : container_with_pool {
       private /* Internal types */:
         using unprotected_point_type = point<K, M>;
@@ -122,13 +129,21 @@ namespace pareto {
         // Better split classification, may be slower on some systems
         static constexpr bool rtree_use_spherical_volume_ = true;
 
+        // Keep the children bounds of each node as a structure of arrays
+        // so queries can scan a node in a tight loop. We need the number
+        // of dimensions at compile time for that.
+        static constexpr bool rtree_use_soa_bounds_ =
+            number_of_compile_dimensions != 0;
+
         // Max and min number of elements in a node
-        static constexpr size_t tmaxnodes_ = 8;
-        static constexpr size_t tminnodes_ = tmaxnodes_ / 2;
+        static constexpr size_t tmaxnodes_ = MaxBranches;
+        static constexpr size_t tminnodes_ = MinBranches;
         static constexpr size_t maxnodes_ = tmaxnodes_;
         static constexpr size_t minnodes_ = tminnodes_;
         static_assert(maxnodes_ > minnodes_);
         static_assert(minnodes_ > 0);
+        // A split needs to fill two nodes with maxnodes_ + 1 branches
+        static_assert(2 * minnodes_ <= maxnodes_ + 1);
 
       private /* internal node types */:
         struct rtree_node;
@@ -151,6 +166,9 @@ namespace pareto {
             explicit branch_variant(const unprotected_value_type &v)
                 : data_(variant_type(v)) {}
 
+            explicit branch_variant(unprotected_value_type &&v)
+                : data_(variant_type(std::move(v))) {}
+
             explicit branch_variant(const value_type &v)
                 : data_(variant_type(unprotected_value_type(v))) {}
 
@@ -278,6 +296,22 @@ namespace pareto {
             variant_type data_;
         };
 
+        /// \brief Bounds of the branches of a node as a structure of arrays
+        /// Each dimension has a contiguous array with the min and the max
+        /// coordinates of all branches in the node. Points have the same
+        /// min and max coordinates.
+        struct soa_bounds {
+            using coordinate_array = std::array<dimension_type, maxnodes_>;
+            std::array<coordinate_array, number_of_compile_dimensions> min_;
+            std::array<coordinate_array, number_of_compile_dimensions> max_;
+        };
+
+        /// \brief Placeholder for the bounds with runtime dimensions
+        struct no_soa_bounds {};
+
+        using node_bounds = std::conditional_t<rtree_use_soa_bounds_,
+                                               soa_bounds, no_soa_bounds>;
+
         /// \brief Node
         /// Each branch might have a rtree_node for each branch level
         /// The number of children is fixed because we need to make the
@@ -309,6 +343,89 @@ namespace pareto {
                 return branches_[index].rectangle();
             }
 
+            /// \brief Replace a branch and keep the bounds updated
+            /// All changes to the branches should go through set_branch
+            /// or set_rectangle so that bounds_ is never stale.
+            void set_branch(size_t index, const branch_variant &branch) {
+                branches_[index] = branch;
+                update_bounds(index);
+            }
+
+            /// \brief Replace a branch and keep the bounds updated
+            void set_branch(size_t index, branch_variant &&branch) {
+                branches_[index] = std::move(branch);
+                update_bounds(index);
+            }
+
+            /// \brief Replace the rectangle of an internal branch
+            void set_rectangle(size_t index, const box_type &rectangle) {
+                branches_[index].as_branch().first = rectangle;
+                update_bounds(index);
+            }
+
+            /// \brief Copy the bounds of a branch to the structure of arrays
+            void update_bounds(size_t index) {
+                if constexpr (rtree_use_soa_bounds_) {
+                    if (branches_[index].is_branch()) {
+                        const box_type &b = branches_[index].as_branch().first;
+                        for (size_t d = 0; d < number_of_compile_dimensions;
+                             ++d) {
+                            bounds_.min_[d][index] = b.first()[d];
+                            bounds_.max_[d][index] = b.second()[d];
+                        }
+                    } else {
+                        const point_type &p = branches_[index].point_value();
+                        for (size_t d = 0; d < number_of_compile_dimensions;
+                             ++d) {
+                            bounds_.min_[d][index] = p[d];
+                            bounds_.max_[d][index] = p[d];
+                        }
+                    }
+                } else {
+                    (void) index;
+                }
+            }
+
+            /// \brief Check if a branch overlaps a box
+            [[nodiscard]] bool overlaps(size_t index,
+                                        const box_type &b) const {
+                bool overlap = true;
+                if constexpr (rtree_use_soa_bounds_) {
+                    for (size_t d = 0; d < number_of_compile_dimensions;
+                         ++d) {
+                        overlap &= (bounds_.min_[d][index] <= b.second()[d]) &
+                                   (bounds_.max_[d][index] >= b.first()[d]);
+                    }
+                } else {
+                    overlap = branches_[index].rectangle().overlap(b);
+                }
+                return overlap;
+            }
+
+            /// \brief Distances from a point to all branches in this node
+            /// Same as branch_variant::distance, one dimension at a time.
+            template <class Point>
+            void distances(const Point &p,
+                           std::array<typename point_type::distance_type,
+                                      maxnodes_> &result) const {
+                using distance_type = typename point_type::distance_type;
+                result.fill(distance_type{0});
+                for (size_t d = 0; d < number_of_compile_dimensions; ++d) {
+                    const dimension_type x = p[d];
+                    const auto &mins = bounds_.min_[d];
+                    const auto &maxs = bounds_.max_[d];
+                    for (size_t i = 0; i < maxnodes_; ++i) {
+                        const auto di = static_cast<distance_type>(std::max(
+                            std::max(mins[i] - x, x - maxs[i]),
+                            dimension_type{0}));
+                        result[i] += di * di;
+                    }
+                }
+                for (size_t i = 0; i < count_; ++i) {
+                    result[i] = std::sqrt(result[i]);
+                }
+            }
+
             /// Parent node
             /// Keeping track of parent nodes is important for more efficient
             /// iterators. A link to the parent node allows us to eliminate
@@ -331,6 +448,11 @@ namespace pareto {
             /// If the parents level is 0, then this is data.
             using branches_array = std::array<branch_variant, maxnodes_>;
             branches_array branches_;
+
+            /// Bounds of the branches as a structure of arrays
+            /// This duplicates the rectangles in branches_ in a layout
+            /// that is cheaper to scan
+            node_bounds bounds_{};
         };
 
         using node_allocator_type = typename std::allocator_traits<
@@ -677,6 +799,11 @@ namespace pareto {
                     while (root->parent_ != nullptr) {
                         root = root->parent_;
                     }
+                    // An empty tree has no nearest points, and the begin
+                    // iterator would also be the end iterator
+                    if (root->count_ == 0) {
+                        return;
+                    }
                     iterator_impl it = iterator_impl(root, predicates_);
                     iterator_impl end = iterator_impl(root, root->count_);
                     // Iterate until the end so we have the nearest points
@@ -706,14 +833,7 @@ namespace pareto {
                 // the distance doesn't matter. It's just easier to Enqueue all
                 // branches of R-containers.RootNode already, as would always
                 // happen at the first iteration anyway.
-                for (size_t i = 0; i < current_node_->count_; ++i) {
-                    nearest_queue_.emplace_back(
-                        current_node_, i,
-                        current_node_->branches_[i].distance(
-                            *nearest_predicate));
-                    std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
-                                   queue_comp);
-                }
+                enqueue_children(current_node_, *nearest_predicate);
 
                 // 3. while not IsEmpty(Queue) do
                 // From this point the algorithm is implemented inside the
@@ -721,6 +841,47 @@ namespace pareto {
                 // return the nearest points.
             }
 
+            /// \brief Enqueue all branches of a node by their distance to
+            /// the nearest predicate
+            void enqueue_children(
+                node_pointer node,
+                const nearest<dimension_type, number_of_compile_dimensions>
+                    &nearest_predicate) {
+                if constexpr (rtree_use_soa_bounds_) {
+                    if (!nearest_predicate.has_reference_box()) {
+                        std::array<typename point_type::distance_type,
+                                   maxnodes_>
+                            distances;
+                        node->distances(nearest_predicate.reference_point(),
+                                        distances);
+                        for (size_t i = 0; i < node->count_; ++i) {
+                            nearest_queue_.emplace_back(node, i, distances[i]);
+                            std::push_heap(nearest_queue_.begin(),
+                                           nearest_queue_.end(), queue_comp);
+                        }
+                        return;
+                    }
+                }
+                for (size_t i = 0; i < node->count_; ++i) {
+                    nearest_queue_.emplace_back(
+                        node, i, node->branches_[i].distance(nearest_predicate));
+                    std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
+                                   queue_comp);
+                }
+            }
+
+            /// \brief Get the intersects predicate we can check with the
+            /// structure of arrays in the nodes
+            [[nodiscard]] const intersects<dimension_type,
+                                           number_of_compile_dimensions> *
+            soa_intersects_predicate() const {
+                if constexpr (rtree_use_soa_bounds_) {
+                    return predicates_.get_intersects();
+                } else {
+                    return nullptr;
+                }
+            }
+
             /// \brief Advance to the next valid element through the nearest
             /// element algorithm
             void advance_to_next_valid_through_nearest() {
@@ -802,18 +963,11 @@ namespace pareto {
                         // Element do
                         // 16. for each entry (Node,   Rect) in      node
                         // Element do
-                        for (size_t i = 0; i < element.as_node()->count_; ++i) {
-                            // 13. Enqueue(Queue, [Object], Dist(QueryObject,
-                            // Rect))
-                            // 17. Enqueue(Queue, Node,     Dist(QueryObject,
-                            // Rect))
-                            nearest_queue_.emplace_back(
-                                element.as_node(), i,
-                                element.as_node()->branches_[i].distance(
-                                    *nearest_predicate));
-                            std::push_heap(nearest_queue_.begin(),
-                                           nearest_queue_.end(), queue_comp);
-                        }
+                        // 13. Enqueue(Queue, [Object], Dist(QueryObject,
+                        // Rect))
+                        // 17. Enqueue(Queue, Node,     Dist(QueryObject,
+                        // Rect))
+                        enqueue_children(element.as_node(), *nearest_predicate);
                     }
                 }
                 // Nothing else to report
@@ -872,6 +1026,12 @@ namespace pareto {
             /// no nearest predicate)
             void advance_to_next_valid_depth_first(
                 bool first_time_in_this_branch = false) {
+                // If there is an intersects predicate, we check the bounds
+                // of the branches with the structure of arrays first. When
+                // it's the only predicate, this is all we need to check.
+                const auto intersects_predicate = soa_intersects_predicate();
+                const bool only_intersects =
+                    intersects_predicate != nullptr && predicates_.size() == 1;
                 while (!is_end()) {
                     // this should usually be the case at the start
                     // it might only be an internal node at the next iterations
@@ -881,9 +1041,13 @@ namespace pareto {
                                  current_branch_ + !first_time_in_this_branch;
                              index < current_node_->count_; ++index) {
                             // if value passes the predicate
-                            if (predicates_.pass_predicate(
-                                    current_node_->branches_[index]
-                                        .as_value())) {
+                            if ((intersects_predicate == nullptr ||
+                                 current_node_->overlaps(
+                                     index, intersects_predicate->data())) &&
+                                (only_intersects ||
+                                 predicates_.pass_predicate(
+                                     current_node_->branches_[index]
+                                         .as_value()))) {
                                 // found a value branch in a node
                                 // point to it and return
                                 current_branch_ = index;
@@ -904,10 +1068,14 @@ namespace pareto {
                              index < current_node_->count_; ++index) {
                             // If branch might have nodes that pass all
                             // predicates
-                            if (predicates_.might_pass_predicate(
-                                    current_node_->branches_[index]
-                                        .as_branch()
-                                        .first)) {
+                            if ((intersects_predicate == nullptr ||
+                                 current_node_->overlaps(
+                                     index, intersects_predicate->data())) &&
+                                (only_intersects ||
+                                 predicates_.might_pass_predicate(
+                                     current_node_->branches_[index]
+                                         .as_branch()
+                                         .first))) {
                                 // Found a value branch in a node
                                 // Point to it and continue looking until we
                                 // find a value branch
@@ -1248,12 +1416,7 @@ namespace pareto {
             : r_tree(alloc) {
             comp_ = comp;
             std::vector<unprotected_value_type> v(first, last);
-            std::sort(v.begin(), v.end(), [this](const auto &a, const auto &b) {
-                return std::lexicographical_compare(
-                    a.first.begin(), a.first.end(), b.first.begin(),
-                    b.first.end(), comp_);
-            });
-            bulk_insert(v, root_);
+            str_bulk_load(v);
         }
 
         /// \brief Construct with list + comparison
@@ -1272,12 +1435,7 @@ namespace pareto {
         r_tree(InputIt first, InputIt last, const allocator_type &alloc)
             : r_tree(alloc) {
             std::vector<unprotected_value_type> v(first, last);
-            std::sort(v.begin(), v.end(), [this](const auto &a, const auto &b) {
-                return std::lexicographical_compare(
-                    a.first.begin(), a.first.end(), b.first.begin(),
-                    b.first.end(), comp_);
-            });
-            bulk_insert(v, root_);
+            str_bulk_load(v);
         }
 
         /// \brief Construct with iterators
@@ -1661,11 +1819,21 @@ namespace pareto {
         }
 
         /// \brief Insert list of elements
+        /// If the new elements are at least as many as the elements
+        /// already in the tree, the tree is rebuilt with a packed
+        /// bulk load, which is much cheaper than splitting nodes
+        /// for each new element.
         template <class Inputiterator>
         void insert(Inputiterator first, Inputiterator last) {
-            while (first != last) {
-                insert(*first);
-                ++first;
+            std::vector<unprotected_value_type> v(first, last);
+            if (v.size() < size_) {
+                for (auto &value : v) {
+                    insert(std::move(value));
+                }
+            } else {
+                v.reserve(v.size() + size_);
+                v.insert(v.end(), begin(), end());
+                str_bulk_load(v);
             }
         }
 
@@ -2100,9 +2268,10 @@ namespace pareto {
                     // Child was not split.
                     // Merge the bounding box of the new record with the
                     // existing bounding box
-                    parent_node->branches_[index].as_branch().first =
+                    parent_node->set_rectangle(
+                        index,
                         branch.rectangle().combine(
-                            parent_node->branches_[index].as_branch().first);
+                            parent_node->branches_[index].as_branch().first));
                     parent_node->branches_[index].set_parent(parent_node);
                     return std::make_tuple(child_was_split, insertion_branch,
                                            insertion_index);
@@ -2110,9 +2279,10 @@ namespace pareto {
                     // Child was split. The old branches are now re-partitioned
                     // to two nodes so we have to re-calculate the bounding
                     // boxes of each node
-                    parent_node->branches_[index].as_branch().first =
+                    parent_node->set_rectangle(
+                        index,
                         minimum_bounding_rectangle(
-                            parent_node->branches_[index].as_branch().second);
+                            parent_node->branches_[index].as_branch().second));
                     box_and_node branch_with_new_tree;
                     branch_with_new_tree.first =
                         minimum_bounding_rectangle(other_rtree_node);
@@ -2169,7 +2339,7 @@ namespace pareto {
             assert(parent_node);
             // Split won't be necessary
             if (parent_node->count_ < maxnodes_) {
-                parent_node->branches_[parent_node->count_] = branch_to_insert;
+                parent_node->set_branch(parent_node->count_, branch_to_insert);
                 parent_node->branches_[parent_node->count_].set_parent(
                     parent_node);
                 ++parent_node->count_;
@@ -2193,7 +2363,7 @@ namespace pareto {
             assert(parent_node);
             // Split won't be necessary
             if (parent_node->count_ < maxnodes_) {
-                parent_node->branches_[parent_node->count_] = branch_to_insert;
+                parent_node->set_branch(parent_node->count_, branch_to_insert);
                 parent_node->branches_[parent_node->count_].set_parent(
                     parent_node);
                 ++parent_node->count_;
@@ -2691,8 +2861,8 @@ namespace pareto {
             size_t branch_index = node_to_erase.current_branch_;
 
             // Remove leaf branch
-            parent_node->branches_[branch_index] =
-                parent_node->branches_[parent_node->count_ - 1];
+            parent_node->set_branch(
+                branch_index, parent_node->branches_[parent_node->count_ - 1]);
             --parent_node->count_;
 
             // Go up the containers adjusting the rectangles or eliminating
@@ -2742,9 +2912,9 @@ namespace pareto {
             // If branch still has the minimum number of elements
             if (parent_node->branches_[index].as_node()->count_ >= minnodes_) {
                 // Just update the bounding rectangle
-                parent_node->branches_[index].as_branch().first =
-                    minimum_bounding_rectangle(
-                        parent_node->branches_[index].as_node());
+                parent_node->set_rectangle(
+                    index, minimum_bounding_rectangle(
+                               parent_node->branches_[index].as_node()));
             } else {
                 // If branch doesn't have the minimum number of elements anymore
                 // Eliminate the node from the containers.
@@ -2754,8 +2924,8 @@ namespace pareto {
                 // Erase node from the containers
                 // erase_impl element by swapping with the last element to
                 // prevent gaps in array
-                parent_node->branches_[index] =
-                    parent_node->branches_[parent_node->count_ - 1];
+                parent_node->set_branch(
+                    index, parent_node->branches_[parent_node->count_ - 1]);
                 --parent_node->count_;
             }
         }
@@ -2808,8 +2978,9 @@ namespace pareto {
                     if (region_to_erase.contains(
                             parent_node->branches_[index].as_value().first)) {
                         // Remove leaf branch
-                        parent_node->branches_[index] =
-                            parent_node->branches_[parent_node->count_ - 1];
+                        parent_node->set_branch(
+                            index,
+                            parent_node->branches_[parent_node->count_ - 1]);
                         --parent_node->count_;
                         // Must return after this call as count has changed
                         return 1;
@@ -2848,6 +3019,7 @@ namespace pareto {
             current->level_ = other->level_;
             current->count_ = other->count_;
             current->parent_ = current_parent;
+            current->bounds_ = other->bounds_;
 
             // Not a leaf node
             if (current->is_internal_node()) {
@@ -3017,56 +3189,114 @@ namespace pareto {
             }
         }
 
-        /// \brief Bulk insertion inserts the median before other elements
-        template <class InputIterator>
-        void bulk_insert(InputIterator l_begin, InputIterator l_end,
-                         const value_type &v, InputIterator r_begin,
-                         InputIterator r_end) {
-            bulk_insert(l_begin, l_end, v, r_begin, r_end, root_);
-        }
-
-        void bulk_insert(const std::vector<unprotected_value_type> &v,
-                         rtree_node *&node) {
-            // bulk insert ranges {1, median - 1}, median, { median + 1, end()}
-            if (!v.empty()) {
-                if (v.size() == 1) {
-                    insert_branch(branch_variant(v[0]), node, 0);
-                } else {
-                    size_t median_pos = v.size() / 2;
-                    bulk_insert(v.begin(), v.begin() + median_pos,
-                                v[median_pos], v.begin() + median_pos + 1,
-                                v.end(), node);
-                }
+        /// \brief Replace the tree with a packed tree built from v
+        /// Sort-Tile-Recursive (STR) bulk loading: the values are tiled
+        /// into slabs one dimension at a time, so that consecutive groups
+        /// of maxnodes_ values make full leaves covering compact regions.
+        /// The upper levels are packed the same way from the rectangles
+        /// of the level below. This takes O(n log n) and leaves almost
+        /// all nodes full, so queries visit fewer nodes than in a tree
+        /// built by successive insertions.
+        /// \see Leutenegger, S. T., Lopez, M. A., & Edgington, J. (1997).
+        /// STR: A simple and efficient algorithm for R-tree packing.
+        void str_bulk_load(std::vector<unprotected_value_type> &v) {
+            remove_all_records(root_);
+            root_ = nullptr;
+            size_ = v.size();
+            if (v.empty()) {
+                root_ = allocate_rtree_node();
+                root_->level_ = 0;
+                return;
             }
-        }
-
-        template <class InputIterator>
-        void bulk_insert(InputIterator l_begin, InputIterator l_end,
-                         const unprotected_value_type &v, InputIterator r_begin,
-                         InputIterator r_end, rtree_node *&node) {
-            insert_branch(branch_variant(v), node, 0);
-            size_t l_size = std::distance(l_begin, l_end);
-            if (l_size != 0) {
-                if (l_size == 1) {
-                    insert_branch(branch_variant(*l_begin), node, 0);
-                } else {
-                    size_t l_median_pos = l_size / 2;
-                    bulk_insert(l_begin, l_begin + l_median_pos,
-                                *(l_begin + l_median_pos),
-                                l_begin + l_median_pos + 1, l_end, node);
+            if constexpr (number_of_compile_dimensions == 0) {
+                if (dimensions_ == 0) {
+                    dimensions_ = v.front().first.dimensions();
+                    initialize_unit_sphere_volume();
                 }
             }
-            size_t r_size = std::distance(r_begin, r_end);
-            if (r_size != 0) {
-                if (r_size == 1) {
-                    insert_branch(branch_variant(*r_begin), node, 0);
-                } else {
-                    size_t r_median_pos = r_size / 2;
-                    bulk_insert(r_begin, r_begin + r_median_pos,
-                                *(r_begin + r_median_pos),
-                                r_begin + r_median_pos + 1, r_end, node);
+            str_tile(v.begin(), v.end(), 0,
+                     [](const unprotected_value_type &a, size_t d) {
+                         return a.first[d];
+                     });
+            std::vector<branch_variant> level_branches = str_pack(v, 0);
+            size_t level = 1;
+            while (level_branches.size() > 1) {
+                // The sum of the corners sorts boxes by their centers
+                str_tile(level_branches.begin(), level_branches.end(), 0,
+                         [](const branch_variant &a, size_t d) {
+                             const box_type &b = a.as_branch().first;
+                             return b.first()[d] + b.second()[d];
+                         });
+                level_branches = str_pack(level_branches, level);
+                ++level;
+            }
+            root_ = level_branches.front().node_pointer();
+            root_->parent_ = nullptr;
+        }
+
+        /// \brief Sort the entries in [first, last) into STR slabs
+        /// The entries are sorted by the coordinate in dimension and
+        /// split into slabs with a multiple of maxnodes_ entries. Each
+        /// slab is then tiled by the next dimension.
+        template <class RandomIt, class Coordinate>
+        void str_tile(RandomIt first, RandomIt last, size_t dimension,
+                      Coordinate coordinate) {
+            const auto n = static_cast<size_t>(std::distance(first, last));
+            if (n <= maxnodes_) {
+                return;
+            }
+            std::sort(first, last, [&](const auto &a, const auto &b) {
+                return coordinate(a, dimension) < coordinate(b, dimension);
+            });
+            if (dimension + 1 >= dimensions_) {
+                return;
+            }
+            const size_t n_nodes = (n + maxnodes_ - 1) / maxnodes_;
+            const size_t remaining_dimensions = dimensions_ - dimension;
+            const auto n_slabs = static_cast<size_t>(std::ceil(
+                std::pow(static_cast<double>(n_nodes),
+                         1. / static_cast<double>(remaining_dimensions))));
+            const size_t slab_size =
+                maxnodes_ * ((n_nodes + n_slabs - 1) / n_slabs);
+            while (first != last) {
+                const auto remaining =
+                    static_cast<size_t>(std::distance(first, last));
+                RandomIt slab_end =
+                    remaining > slab_size ? std::next(first, slab_size) : last;
+                str_tile(first, slab_end, dimension + 1, coordinate);
+                first = slab_end;
+            }
+        }
+
+        /// \brief Pack consecutive entries into nodes of a given level
+        /// \return Branches pointing to the new nodes
+        template <class Entry>
+        std::vector<branch_variant> str_pack(std::vector<Entry> &entries,
+                                             size_t level) {
+            std::vector<branch_variant> parent_branches;
+            parent_branches.reserve(entries.size() / maxnodes_ + 1);
+            size_t first = 0;
+            while (first < entries.size()) {
+                size_t count = std::min(maxnodes_, entries.size() - first);
+                // Split the remainder between the last two nodes
+                // so that the last node is not underfull
+                const size_t rest = entries.size() - first - count;
+                if (rest != 0 && rest < minnodes_) {
+                    count = (count + rest + 1) / 2;
+                }
+                rtree_node *node = allocate_rtree_node();
+                node->level_ = level;
+                node->count_ = count;
+                for (size_t i = 0; i < count; ++i) {
+                    node->set_branch(
+                        i, branch_variant(std::move(entries[first + i])));
+                    node->branches_[i].set_parent(node);
                 }
+                parent_branches.emplace_back(
+                    box_and_node(minimum_bounding_rectangle(node), node));
+                first += count;
             }
+            return parent_branches;
         }
 
       private /* Allocate nodes */:
@@ -3116,17 +3346,18 @@ namespace pareto {
     };
 
     // MSVC hack
-    template <class N, size_t M, class E, class C, class A>
+    template <class N, size_t M, class E, class C, class A, size_t X,
+              size_t Y>
     template <bool constness>
     const std::function<
-        bool(const typename r_tree<N, M, E, C, A>::template iterator_impl<
+        bool(const typename r_tree<N, M, E, C, A, X, Y>::template iterator_impl<
                  constness>::queue_element &,
-             const typename r_tree<N, M, E, C, A>::template iterator_impl<
+             const typename r_tree<N, M, E, C, A, X, Y>::template iterator_impl<
                  constness>::queue_element &)>
-        r_tree<N, M, E, C, A>::iterator_impl<constness>::queue_comp =
-            [](const typename r_tree<N, M, E, C, A>::template iterator_impl<
+        r_tree<N, M, E, C, A, X, Y>::iterator_impl<constness>::queue_comp =
+            [](const typename r_tree<N, M, E, C, A, X, Y>::template iterator_impl<
                    constness>::queue_element &a,
-               const typename r_tree<N, M, E, C, A>::template iterator_impl<
+               const typename r_tree<N, M, E, C, A, X, Y>::template iterator_impl<
                    constness>::queue_element &b) -> bool {
         return std::get<2>(a) > std::get<2>(b);
     };
@@ -3142,25 +3373,27 @@ namespace pareto {
     /// If you need to compare if the elements are the same, regardless
     /// of their trees, you have to iterate one container and call
     /// find on the second container. This operation takes loglinear time.
-    template <class K, size_t M, class T, class C, class A>
-    bool operator==(const r_tree<K, M, T, C, A> &lhs,
-                    const r_tree<K, M, T, C, A> &rhs) {
+    template <class K, size_t M, class T, class C, class A, size_t X,
+              size_t Y>
+    bool operator==(const r_tree<K, M, T, C, A, X, Y> &lhs,
+                    const r_tree<K, M, T, C, A, X, Y> &rhs) {
         if (lhs.size() != rhs.size()) {
             return false;
         }
         return std::equal(
             lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
-            [](const typename r_tree<K, M, T, C, A>::value_type &a,
-               const typename r_tree<K, M, T, C, A>::value_type &b) {
+            [](const typename r_tree<K, M, T, C, A, X, Y>::value_type &a,
+               const typename r_tree<K, M, T, C, A, X, Y>::value_type &b) {
                 return a.first == b.first &&
                        mapped_type_custom_equality_operator(a.second, b.second);
             });
     }
 
     /// \brief Inequality operator
-    template <class K, size_t M, class T, class C, class A>
-    bool operator!=(const r_tree<K, M, T, C, A> &lhs,
-                    const r_tree<K, M, T, C, A> &rhs) {
+    template <class K, size_t M, class T, class C, class A, size_t X,
+              size_t Y>
+    bool operator!=(const r_tree<K, M, T, C, A, X, Y> &lhs,
+                    const r_tree<K, M, T, C, A, X, Y> &rhs) {
         return !(lhs == rhs);
     }
 
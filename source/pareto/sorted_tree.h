@@ -0,0 +1,1384 @@
+#ifndef PARETO_SORTED_TREE_H
+#define PARETO_SORTED_TREE_H
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include <pareto/common/default_allocator.h>
+#include <pareto/point.h>
+#include <pareto/query/predicate_list.h>
+#include <pareto/query/query_box.h>
+
+namespace pareto {
+
+    /// \brief This is a sorted vector emulating an associative spatial
+    /// container
+    /// Like implicit_tree, this container keeps all elements in a vector.
+    /// Unlike implicit_tree, the elements are kept in lexicographic order,
+    /// so queries only visit the elements in the range of the query box
+    /// in the first dimension.
+    ///
+    /// This is most useful for two-dimensional fronts. No element in a
+    /// two-dimensional front dominates another, so sorting the elements by
+    /// the first dimension also sorts them by the second dimension in
+    /// reverse order. We keep track of whether the elements form such a
+    /// staircase. When they do, box queries become two binary searches,
+    /// and nearest neighbour queries only visit the elements around the
+    /// position of the reference point.
+    ///
+    /// This container type implements the following concepts
+    /// Container: https://en.cppreference.com/w/cpp/named_req/Container
+    /// ReversibleContainer:
+    /// https://en.cppreference.com/w/cpp/named_req/Container
+    /// AssociativeContainer:
+    /// https://en.cppreference.com/w/cpp/named_req/AssociativeContainer
+    ///
+    /// \tparam K Number/key type
+    /// \tparam M Number of dimensions
+    /// \tparam E Element/mapped type
+    /// \tparam C Comparison function type in one dimension
+    /// \tparam A Allocator type
+    template <class K, size_t M, class T, typename C = std::less<K>,
+              class A = default_allocator_type<std::pair<const point<K, M>, T>>>
+    class sorted_tree {
+      private /* Internal types */:
+        using unprotected_point_type = point<K, M>;
+        using protected_point_type = const point<K, M>;
+        using unprotected_mapped_type = T;
+        using unprotected_key_type = unprotected_point_type;
+        using protected_key_type = protected_point_type;
+        using unprotected_value_type =
+            std::pair<unprotected_key_type, unprotected_mapped_type>;
+        using protected_value_type =
+            std::pair<protected_key_type, unprotected_mapped_type>;
+        using unprotected_allocator_type = typename std::allocator_traits<
+            A>::template rebind_alloc<unprotected_value_type>;
+        using unprotected_vector_type =
+            std::vector<unprotected_value_type, unprotected_allocator_type>;
+        using unprotected_vector_iterator =
+            typename unprotected_vector_type::iterator;
+        using unprotected_vector_const_iterator =
+            typename unprotected_vector_type::const_iterator;
+        using point_type = unprotected_point_type;
+
+      public /* Forward declarations */:
+        template <bool is_const> class iterator_impl;
+
+      public /* Container Concept */:
+        using value_type = protected_value_type;
+        using reference = value_type &;
+        using const_reference = value_type const &;
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+        using pointer = value_type *;
+        using const_pointer = const value_type *;
+        using difference_type =
+            typename unprotected_vector_type::difference_type;
+        using size_type = typename unprotected_vector_type::size_type;
+
+      public /* ReversibleContainer Concept */:
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      public /* AssociativeContainer Concept */:
+        using key_type = unprotected_point_type;
+        using mapped_type = T;
+        using key_compare =
+            std::function<bool(const key_type &, const key_type &)>;
+        using value_compare =
+            std::function<bool(const value_type &, const value_type &)>;
+
+      public /* AllocatorAwareContainer Concept */:
+        using allocator_type = A;
+
+      public /* SpatialContainer Concept */:
+        static constexpr size_t number_of_compile_dimensions = M;
+        using dimension_type = K;
+        using dimension_compare = C;
+        using box_type =
+            query_box<dimension_type, number_of_compile_dimensions>;
+        using predicate_list_type =
+            predicate_list<dimension_type, number_of_compile_dimensions, T>;
+
+      public /* Iterators */:
+        /// \brief Sorted vector iterator
+        /// This iterator keeps a range of vector iterators and a predicate.
+        /// The range is where the elements that might match the query are.
+        /// The iterator skips the elements in this range that don't match
+        /// the predicate and becomes the end of the container once it
+        /// leaves the range.
+        template <bool is_const> class iterator_impl {
+          private /* Internal Types */:
+            template <class TYPE, class CONST_TYPE>
+            using const_toggle =
+                std::conditional_t<!is_const, TYPE, CONST_TYPE>;
+
+            template <class U>
+            using maybe_add_const = const_toggle<U, std::add_const_t<U>>;
+
+            using vector_iterator =
+                const_toggle<unprotected_vector_iterator,
+                             unprotected_vector_const_iterator>;
+
+            using query_function = std::function<bool(const value_type &)>;
+
+          public /* LegacyIterator Types */:
+            using value_type = maybe_add_const<sorted_tree::value_type>;
+            using reference = const_toggle<sorted_tree::reference,
+                                           sorted_tree::const_reference>;
+            using difference_type = sorted_tree::difference_type;
+            using pointer = const_toggle<sorted_tree::pointer,
+                                         sorted_tree::const_pointer>;
+            using iterator_category = std::bidirectional_iterator_tag;
+
+          public /* LegacyIterator Constructors */:
+            /// \brief Copy constructor
+            /// const_iterator can be constructed from const_iterator and
+            /// iterator. But iterator cannot be constructed from
+            /// const_iterator.
+            template <bool rhs_is_const,
+                      class = std::enable_if_t<is_const || !rhs_is_const>>
+            // NOLINTNEXTLINE(google-explicit-constructor)
+            iterator_impl(const iterator_impl<rhs_is_const> &rhs)
+                : query_it_(rhs.query_it_),
+                  query_it_begin_(rhs.query_it_begin_),
+                  query_it_end_(rhs.query_it_end_),
+                  container_end_(rhs.container_end_),
+                  query_function_(rhs.query_function_) {}
+
+            /// \brief Copy assignment
+            template <bool rhs_is_const,
+                      class = std::enable_if_t<is_const || !rhs_is_const>>
+            iterator_impl &operator=(const iterator_impl<rhs_is_const> &rhs) {
+                query_it_ = rhs.query_it_;
+                query_it_begin_ = rhs.query_it_begin_;
+                query_it_end_ = rhs.query_it_end_;
+                container_end_ = rhs.container_end_;
+                query_function_ = rhs.query_function_;
+                return *this;
+            }
+
+            /// \brief Destructor
+            ~iterator_impl() = default;
+
+          public /* LegacyForwardIterator Constructors */:
+            /// \brief Default constructor
+            iterator_impl() : query_it_(vector_iterator()) {}
+
+          public /* ContainerConcept Constructors */:
+            /// \brief Convert to const iterator
+            // NOLINTNEXTLINE(google-explicit-constructor)
+            operator iterator_impl<true>() {
+                iterator_impl<true> r(query_it_begin_, query_it_end_,
+                                      container_end_, query_function_);
+                r.query_it_ = query_it_;
+                return r;
+            }
+
+          public /* SpatialContainer Concept Constructors */:
+            /// \brief Move constructor
+            template <bool rhs_is_const,
+                      class = std::enable_if_t<is_const || !rhs_is_const>>
+            // NOLINTNEXTLINE(google-explicit-constructor)
+            iterator_impl(iterator_impl<rhs_is_const> &&rhs)
+                : query_it_(rhs.query_it_),
+                  query_it_begin_(rhs.query_it_begin_),
+                  query_it_end_(rhs.query_it_end_),
+                  container_end_(rhs.container_end_),
+                  query_function_(std::move(rhs.query_function_)) {}
+
+            /// \brief Move assignment
+            template <bool rhs_is_const,
+                      class = std::enable_if_t<is_const || !rhs_is_const>>
+            iterator_impl &operator=(iterator_impl<rhs_is_const> &&rhs) {
+                query_it_ = rhs.query_it_;
+                query_it_begin_ = rhs.query_it_begin_;
+                query_it_end_ = rhs.query_it_end_;
+                container_end_ = rhs.container_end_;
+                query_function_ = std::move(rhs.query_function_);
+                return *this;
+            }
+
+          public /* Internal Constructors / Used by Container */:
+            /// \brief Use the whole vector as source of values
+            iterator_impl(vector_iterator it, vector_iterator end)
+                : query_it_(it), query_it_begin_(it), query_it_end_(end),
+                  container_end_(end) {}
+
+            /// \brief Use a vector range and a function predicate as
+            /// source of values
+            iterator_impl(vector_iterator begin, vector_iterator end,
+                          vector_iterator container_end, query_function fn)
+                : query_it_(begin), query_it_begin_(begin),
+                  query_it_end_(end), container_end_(container_end),
+                  query_function_(std::move(fn)) {
+                maybe_advance_predicate();
+            }
+
+          public /* LegacyIterator */:
+            /// \brief Dereference iterator
+            /// The user cannot change the key because it would mess
+            /// the order of the vector. But the user CAN change the
+            /// mapped value.
+            reference operator*() const {
+                const std::pair<key_type, mapped_type> &p = *query_it_;
+                auto *p2 = (std::pair<const key_type, mapped_type> *)&p;
+                return *p2;
+            }
+
+            iterator_impl &operator++() {
+                ++query_it_;
+                maybe_advance_predicate();
+                return *this;
+            }
+
+          public /* LegacyInputIterator */:
+            pointer operator->() const {
+                const std::pair<key_type, mapped_type> &p = *query_it_;
+                return (std::pair<const key_type, mapped_type> *)&p;
+            }
+
+          public /* LegacyForwardIterator */:
+            /// \brief Equality operator
+            template <bool rhs_is_const>
+            bool operator==(const iterator_impl<rhs_is_const> &rhs) const {
+                return query_it_ == rhs.query_it_;
+            }
+
+            /// \brief Inequality operator
+            template <bool rhs_is_const>
+            bool operator!=(const iterator_impl<rhs_is_const> &rhs) const {
+                return !(this->operator==(rhs));
+            }
+
+            /// \brief Advance iterator
+            iterator_impl operator++(int) { // NOLINT(cert-dcl21-cpp):
+                auto tmp = *this;
+                operator++();
+                return tmp;
+            }
+
+          public /* LegacyBidirectionalIterator */:
+            /// \brief Decrement iterator
+            iterator_impl &operator--() {
+                if (query_it_ == container_end_) {
+                    query_it_ = query_it_end_;
+                }
+                --query_it_;
+                maybe_rewind_predicate();
+                return *this;
+            }
+
+            /// \brief Decrement iterator
+            iterator_impl operator--(int) { // NOLINT(cert-dcl21-cpp)
+                auto tmp = *this;
+                operator--();
+                return tmp;
+            }
+
+          private /* Internal Functions */:
+            void maybe_advance_predicate() {
+                if (query_function_) {
+                    while (query_it_ != query_it_end_ && !matches()) {
+                        ++query_it_;
+                    }
+                }
+                // leaving the query range means we reached the end
+                if (query_it_ == query_it_end_) {
+                    query_it_ = container_end_;
+                }
+            }
+
+            /// \brief Check the current element against the predicate
+            /// The element is passed as a protected reference to the
+            /// element in the vector rather than as a converted copy, so
+            /// predicates can identify elements by their addresses.
+            bool matches() const { return query_function_(operator*()); }
+
+            void maybe_rewind_predicate() {
+                if (query_function_) {
+                    while (query_it_ != query_it_begin_ && !matches()) {
+                        --query_it_;
+                    }
+                }
+            }
+
+          private:
+            /// \brief Current vector element
+            vector_iterator query_it_;
+
+            /// \brief First vector element in the query range
+            vector_iterator query_it_begin_;
+
+            /// \brief Past-the-end vector element in the query range
+            vector_iterator query_it_end_;
+
+            /// \brief Past-the-end vector element
+            vector_iterator container_end_;
+
+            /// \brief Query function, in case the iterator has a predicate
+            query_function query_function_;
+
+          public:
+            /// Let sorted tree access the spatial private constructors
+            friend sorted_tree;
+
+            /// Let iterators and const iterators access each other
+            template <bool> friend class iterator_impl;
+        };
+
+      public /* Constructors: Container + AllocatorAwareContainer */:
+        /// \brief Create an empty container
+        explicit sorted_tree(const allocator_type &alloc = allocator_type())
+            : data_(unprotected_allocator_type(alloc)),
+              comp_(dimension_compare()) {}
+
+        /// \brief Copy constructor
+        sorted_tree(const sorted_tree &rhs)
+            : data_(rhs.data_), comp_(rhs.comp_),
+              ascending_steps_(rhs.ascending_steps_),
+              descending_steps_(rhs.descending_steps_) {}
+
+        /// \brief Copy constructor data but use another allocator
+        sorted_tree(const sorted_tree &rhs, const allocator_type &alloc)
+            : data_(rhs.data_, unprotected_allocator_type(alloc)),
+              comp_(rhs.comp_), ascending_steps_(rhs.ascending_steps_),
+              descending_steps_(rhs.descending_steps_) {}
+
+        /// \brief Move constructor
+        sorted_tree(sorted_tree &&rhs) noexcept
+            : data_(std::move(rhs.data_)), comp_(std::move(rhs.comp_)),
+              ascending_steps_(rhs.ascending_steps_),
+              descending_steps_(rhs.descending_steps_) {
+            rhs.ascending_steps_ = 0;
+            rhs.descending_steps_ = 0;
+        }
+
+        /// \brief Move constructor data but use new allocator
+        sorted_tree(sorted_tree &&rhs, const allocator_type &alloc) noexcept
+            : data_(std::move(rhs.data_), unprotected_allocator_type(alloc)),
+              comp_(std::move(rhs.comp_)),
+              ascending_steps_(rhs.ascending_steps_),
+              descending_steps_(rhs.descending_steps_) {
+            rhs.ascending_steps_ = 0;
+            rhs.descending_steps_ = 0;
+        }
+
+        /// \brief Destructor
+        ~sorted_tree() = default;
+
+      public /* Constructors: AssociativeContainer + AllocatorAwareContainer */:
+        /// \brief Create container with custom comparison function
+        explicit sorted_tree(const C &comp,
+                             const allocator_type &alloc = allocator_type())
+            : data_(unprotected_allocator_type(alloc)), comp_(comp) {}
+
+        /// \brief Construct with iterators + comparison
+        template <class InputIt>
+        sorted_tree(InputIt first, InputIt last, const C &comp = C(),
+                    const allocator_type &alloc = allocator_type())
+            : data_(unprotected_allocator_type(alloc)), comp_(comp) {
+            insert(first, last);
+        }
+
+        /// \brief Construct with list + comparison
+        sorted_tree(std::initializer_list<value_type> il, const C &comp = C(),
+                    const allocator_type &alloc = allocator_type())
+            : sorted_tree(il.begin(), il.end(), comp, alloc) {}
+
+        /// \brief Construct with iterators
+        template <class InputIt>
+        sorted_tree(InputIt first, InputIt last, const allocator_type &alloc)
+            : sorted_tree(first, last, C(), alloc) {}
+
+        /// \brief Construct with iterators
+        sorted_tree(std::initializer_list<value_type> il,
+                    const allocator_type &alloc)
+            : sorted_tree(il.begin(), il.end(), C(), alloc) {}
+
+      public /* Assignment: Container + AllocatorAwareContainer */:
+        /// \brief Copy assignment
+        sorted_tree &operator=(const sorted_tree &rhs) {
+            if (&rhs == this) {
+                return *this;
+            }
+            data_.clear();
+            data_.insert(data_.end(), rhs.data_.begin(), rhs.data_.end());
+            comp_ = rhs.comp_;
+            ascending_steps_ = rhs.ascending_steps_;
+            descending_steps_ = rhs.descending_steps_;
+            return *this;
+        };
+
+        /// \brief Move assignment
+        sorted_tree &operator=(sorted_tree &&rhs) noexcept {
+            if (&rhs == this) {
+                return *this;
+            }
+            data_ = std::move(rhs.data_);
+            comp_ = std::move(rhs.comp_);
+            ascending_steps_ = rhs.ascending_steps_;
+            descending_steps_ = rhs.descending_steps_;
+            rhs.ascending_steps_ = 0;
+            rhs.descending_steps_ = 0;
+            return *this;
+        }
+
+      public /* Assignment: AssociativeContainer */:
+        /// \brief Initializer list assignment
+        sorted_tree &operator=(std::initializer_list<value_type> il) noexcept {
+            clear();
+            insert(il.begin(), il.end());
+            return *this;
+        }
+
+      public /* Non-Modifying Functions: AllocatorAwareContainer */:
+        /// \brief Obtains a copy of the allocator
+        allocator_type get_allocator() const noexcept {
+            return allocator_type(data_.get_allocator());
+        }
+
+      public /* Element Access / Map Concept */:
+        /// \brief Get reference to element at a given position, and throw error
+        /// if it does not exist
+        mapped_type &at(const key_type &k) {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                throw std::out_of_range("sorted_tree::at: key not found");
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and throw error
+        /// if it does not exist
+        const mapped_type &at(const key_type &k) const {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                throw std::out_of_range("sorted_tree::at: key not found");
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and create one
+        /// if it does not exits
+        mapped_type &operator[](const key_type &k) {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                auto it_new = insert(std::make_pair(k, mapped_type()));
+                return it_new->second;
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and create one
+        /// if it does not exits
+        mapped_type &operator[](key_type &&k) {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                auto it_new = insert(std::make_pair(k, mapped_type()));
+                return it_new->second;
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and create one
+        /// if it does not exits
+        template <typename... Targs>
+        mapped_type &operator()(const dimension_type &x1, const Targs &...xs) {
+            constexpr size_t m = sizeof...(Targs) + 1;
+            assert(number_of_compile_dimensions == 0 ||
+                   number_of_compile_dimensions == m);
+            point_type p(m);
+            copy_pack(p.begin(), x1, xs...);
+            return operator[](p);
+        }
+
+      public /* Non-Modifying Functions: Container Concept */:
+        /// \brief Get iterator to first element
+        const_iterator begin() const noexcept {
+            return const_iterator(data_.cbegin(), data_.cend());
+        }
+
+        /// \brief Get iterator to past-the-end element
+        const_iterator end() const noexcept {
+            return const_iterator(data_.cend(), data_.cend());
+        }
+
+        /// \brief Get iterator to first element
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        /// \brief Get iterator to past-the-end element
+        const_iterator cend() const noexcept { return end(); }
+
+        /// \brief Get iterator to first element
+        iterator begin() noexcept {
+            return iterator(data_.begin(), data_.end());
+        }
+
+        /// \brief Get iterator to past-the-end element
+        iterator end() noexcept { return iterator(data_.end(), data_.end()); }
+
+      public /* Non-Modifying Functions: ReversibleContainer Concept */:
+        /// \brief Get iterator to first element in reverse
+        std::reverse_iterator<const_iterator> rbegin() const noexcept {
+            return std::reverse_iterator<const_iterator>(end());
+        }
+
+        /// \brief Get iterator to last element in reverse
+        std::reverse_iterator<const_iterator> rend() const noexcept {
+            return std::reverse_iterator<const_iterator>(begin());
+        }
+
+        /// \brief Get iterator to first element in reverse
+        std::reverse_iterator<iterator> rbegin() noexcept {
+            return std::reverse_iterator<iterator>(end());
+        }
+
+        /// \brief Get iterator to last element in reverse
+        std::reverse_iterator<iterator> rend() noexcept {
+            return std::reverse_iterator<iterator>(begin());
+        }
+
+        /// \brief Get iterator to first element in reverse
+        std::reverse_iterator<const_iterator> crbegin() const noexcept {
+            return std::reverse_iterator(cend());
+        }
+
+        /// \brief Get iterator to past-the-end element in reverse
+        std::reverse_iterator<const_iterator> crend() const noexcept {
+            return std::reverse_iterator(cbegin());
+        }
+
+      public /* Non-Modifying Functions / Capacity / Container Concept */:
+        /// \brief True if container is empty
+        [[nodiscard]] bool empty() const noexcept { return data_.empty(); }
+
+        /// \brief Get container size
+        [[nodiscard]] size_t size() const noexcept { return data_.size(); }
+
+        /// \brief Get container max size
+        [[nodiscard]] size_t max_size() const noexcept {
+            return data_.max_size();
+        }
+
+      public /* Non-Modifying Functions / Capacity / Spatial Concept */:
+        /// \brief Get container dimensions
+        [[nodiscard]] size_t dimensions() const noexcept {
+            if constexpr (M != 0) {
+                return M;
+            } else {
+                return data_.empty() ? 0 : data_.front().first.dimensions();
+            }
+        }
+
+        /// \brief Get maximum value in a given dimension
+        dimension_type max_value(size_t dimension) const {
+            auto it = max_element(dimension);
+            if (it != end()) {
+                return it->first[dimension];
+            }
+            return std::numeric_limits<dimension_type>::min();
+        }
+
+        /// \brief Get minimum value in a given dimension
+        dimension_type min_value(size_t dimension) const {
+            auto it = min_element(dimension);
+            if (it != end()) {
+                return it->first[dimension];
+            }
+            return std::numeric_limits<dimension_type>::min();
+        }
+
+      public /* Modifying Functions: Container + AllocatorAwareContainer */:
+        /// \brief Swap the content of two objects
+        void swap(sorted_tree &other) noexcept {
+            other.data_.swap(data_);
+            std::swap(comp_, other.comp_);
+            std::swap(ascending_steps_, other.ascending_steps_);
+            std::swap(descending_steps_, other.descending_steps_);
+        }
+
+      public /* Modifiers: Multimap Concept */:
+        /// Clear the container
+        void clear() noexcept {
+            data_.clear();
+            ascending_steps_ = 0;
+            descending_steps_ = 0;
+        }
+
+        /// \brief Insert element pair
+        /// Copies of a key are inserted after the existing ones
+        iterator insert(const value_type &v) {
+            return insert_sorted(unprotected_value_type(v.first, v.second));
+        }
+
+        iterator insert(value_type &&v) {
+            return insert_sorted(
+                unprotected_value_type(v.first, std::move(v.second)));
+        }
+
+        template <class P> iterator insert(P &&v) {
+            static_assert(std::is_constructible_v<value_type, P &&>);
+            return emplace(std::forward<P>(v));
+        }
+
+        /// \brief Insert element with a hint
+        /// The position of the element is defined by its key, so the
+        /// hint is ignored.
+        iterator insert(iterator, const value_type &v) { return insert(v); }
+
+        iterator insert(const_iterator, const value_type &v) {
+            return insert(v);
+        }
+
+        iterator insert(const_iterator, value_type &&v) {
+            return insert(std::move(v));
+        }
+
+        template <class P> iterator insert(const_iterator hint, P &&v) {
+            static_assert(std::is_constructible_v<value_type, P &&>);
+            return emplace_hint(hint, std::forward<P>(v));
+        }
+
+        /// \brief Insert list of elements
+        /// We sort the new elements and merge them with the existing ones
+        /// instead of inserting them one by one.
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            const auto n = static_cast<difference_type>(data_.size());
+            for (auto it = first; it != last; ++it) {
+                data_.emplace_back(it->first, it->second);
+            }
+            auto middle = data_.begin() + n;
+            std::stable_sort(middle, data_.end(), element_less());
+            std::inplace_merge(data_.begin(), middle, data_.end(),
+                               element_less());
+            count_steps();
+        }
+
+        /// \brief Insert list of elements
+        void insert(std::initializer_list<value_type> init) {
+            insert(init.begin(), init.end());
+        }
+
+        template <class... Args> iterator emplace(Args &&...args) {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+
+        template <class... Args>
+        iterator emplace_hint(const_iterator, Args &&...args) {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+
+        /// Erase element
+        iterator erase(const_iterator position) {
+            if (position != end()) {
+                const size_t i = index_of(position);
+                remove_steps_around(i);
+                auto next = data_.erase(data_.begin() + i);
+                add_step(i);
+                return iterator(next, data_.end());
+            } else {
+                return end();
+            }
+        }
+
+        iterator erase(iterator position) {
+            return erase(const_iterator(position));
+        }
+
+        /// Remove range of iterators from the container
+        /// The elements are removed in a single pass over the vector
+        iterator erase(const_iterator first, const_iterator last) {
+            std::vector<bool> is_erased(data_.size(), false);
+            size_t last_erased = 0;
+            size_t n = 0;
+            for (auto it = first; it != last; ++it) {
+                last_erased = index_of(it);
+                is_erased[last_erased] = true;
+                ++n;
+            }
+            if (n == 0) {
+                return iterator(data_.begin() + index_of(last), data_.end());
+            }
+            size_t i = 0;
+            auto new_end = std::remove_if(
+                data_.begin(), data_.end(),
+                [&](const unprotected_value_type &) { return is_erased[i++]; });
+            data_.erase(new_end, data_.end());
+            count_steps();
+            return iterator(data_.begin() + (last_erased + 1 - n),
+                            data_.end());
+        }
+
+        /// \brief Erase element by value
+        size_t erase(const key_type &k) {
+            auto [first, last] = std::equal_range(
+                data_.begin(), data_.end(), k, element_less());
+            const auto s = static_cast<size_type>(last - first);
+            if (s != 0) {
+                data_.erase(first, last);
+                count_steps();
+            }
+            return s;
+        }
+
+        /// \brief Splices nodes from another container
+        void merge(sorted_tree &source) noexcept {
+            insert(source.begin(), source.end());
+        }
+
+      public /* Lookup / Multimap Concept */:
+        /// \brief Returns the number of elements with key that compares
+        /// equivalent to the specified argument.
+        size_type count(const key_type &k) const {
+            auto [first, last] = std::equal_range(
+                data_.begin(), data_.end(), k, element_less());
+            return static_cast<size_type>(last - first);
+        }
+
+        /// \brief Returns the number of elements with key that compares
+        /// equivalent to the specified argument.
+        template <class L> size_type count(const L &k) const {
+            return count(key_type(k));
+        }
+
+        /// \brief Find point
+        iterator find(const key_type &p) {
+            auto it = std::lower_bound(data_.begin(), data_.end(), p,
+                                       element_less());
+            if (it != data_.end() && it->first == p) {
+                return iterator(it, data_.end());
+            }
+            return end();
+        }
+
+        /// \brief Find point
+        const_iterator find(const key_type &p) const {
+            auto it = std::lower_bound(data_.begin(), data_.end(), p,
+                                       element_less());
+            if (it != data_.end() && it->first == p) {
+                return const_iterator(it, data_.end());
+            }
+            return end();
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> iterator find(const L &x) {
+            return find(key_type(x));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> const_iterator find(const L &x) const {
+            return find(key_type(x));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        bool contains(const key_type &k) const { return find(k) != end(); }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> bool contains(const L &x) const {
+            return find(x) != end();
+        }
+
+      public /* Modifiers: Lookup / Spatial Concept */:
+        /// \brief Get iterator to first element that passes the list of
+        /// predicates
+        const_iterator find(const predicate_list_type &ps) const noexcept {
+            return const_iterator(
+                data_.begin(), data_.end(), data_.end(),
+                [ps](const value_type &v) { return ps.pass_predicate(v); });
+        }
+
+        /// \brief Get iterator to first element that passes the list of
+        /// predicates
+        iterator find(const predicate_list_type &ps) noexcept {
+            return iterator(
+                data_.begin(), data_.end(), data_.end(),
+                [ps](const value_type &v) { return ps.pass_predicate(v); });
+        }
+
+        /// \brief Find intersection between points and query box
+        iterator find_intersection(const point_type &k) {
+            return find_intersection(k, k);
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator find_intersection(const point_type &k) const {
+            return find_intersection(k, k);
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator find_intersection(const point_type &lb,
+                                         const point_type &ub) const {
+            intersects<dimension_type, number_of_compile_dimensions> p(lb, ub);
+            return find_in_box<const_iterator>(
+                lb, ub, [p](const value_type &v) {
+                    return p.pass_predicate(v.first);
+                });
+        }
+
+        /// \brief Find intersection between points and query box
+        iterator find_intersection(const point_type &lb, const point_type &ub) {
+            intersects<dimension_type, number_of_compile_dimensions> p(lb, ub);
+            return find_in_box<iterator>(lb, ub, [p](const value_type &v) {
+                return p.pass_predicate(v.first);
+            });
+        }
+
+        template <class PREDICATE_TYPE>
+        const_iterator find_intersection(const point_type &lb,
+                                         const point_type &ub,
+                                         PREDICATE_TYPE fn) const {
+            intersects<dimension_type, number_of_compile_dimensions> p(lb, ub);
+            return find_in_box<const_iterator>(
+                lb, ub, [p, fn](const value_type &v) {
+                    return p.pass_predicate(v.first) && fn(v);
+                });
+        }
+
+        template <class PREDICATE_TYPE>
+        iterator find_intersection(const point_type &lb, const point_type &ub,
+                                   PREDICATE_TYPE fn) {
+            intersects<dimension_type, number_of_compile_dimensions> p(lb, ub);
+            return find_in_box<iterator>(
+                lb, ub, [p, fn](const value_type &v) {
+                    return p.pass_predicate(v.first) && fn(v);
+                });
+        }
+
+        /// \brief Find points within a query box
+        const_iterator find_within(const point_type &lb,
+                                   const point_type &ub) const {
+            within<dimension_type, number_of_compile_dimensions> p(lb, ub);
+            return find_in_box<const_iterator>(
+                lb, ub, [p](const value_type &v) {
+                    return p.pass_predicate(v.first);
+                });
+        }
+
+        /// \brief Find points within a query box
+        iterator find_within(const point_type &lb, const point_type &ub) {
+            within<dimension_type, number_of_compile_dimensions> p(lb, ub);
+            return find_in_box<iterator>(lb, ub, [p](const value_type &v) {
+                return p.pass_predicate(v.first);
+            });
+        }
+
+        /// \brief Find points outside a query box
+        const_iterator find_disjoint(const point_type &lb,
+                                     const point_type &ub) const {
+            disjoint<dimension_type, number_of_compile_dimensions> p(lb, ub);
+            return const_iterator(
+                data_.begin(), data_.end(), data_.end(),
+                [p](const value_type &v) { return p.pass_predicate(v.first); });
+        }
+
+        /// \brief Find points outside a query box
+        iterator find_disjoint(const point_type &lb, const point_type &ub) {
+            disjoint<dimension_type, number_of_compile_dimensions> p(lb, ub);
+            return iterator(
+                data_.begin(), data_.end(), data_.end(),
+                [p](const value_type &v) { return p.pass_predicate(v.first); });
+        }
+
+        /// \brief Find points outside a query box
+        template <class PREDICATE_TYPE>
+        const_iterator find_disjoint(const point_type &lb, const point_type &ub,
+                                     PREDICATE_TYPE fn) const {
+            disjoint<dimension_type, number_of_compile_dimensions> p(lb, ub);
+            return const_iterator(data_.begin(), data_.end(), data_.end(),
+                                  [p, fn](const value_type &v) {
+                                      return p.pass_predicate(v.first) &&
+                                             fn(v);
+                                  });
+        }
+
+        /// \brief Find points outside a query box
+        template <class PREDICATE_TYPE>
+        iterator find_disjoint(const point_type &lb, const point_type &ub,
+                               PREDICATE_TYPE fn) {
+            disjoint<dimension_type, number_of_compile_dimensions> p(lb, ub);
+            return iterator(data_.begin(), data_.end(), data_.end(),
+                            [p, fn](const value_type &v) {
+                                return p.pass_predicate(v.first) && fn(v);
+                            });
+        }
+
+        /// \brief Find points closest to a reference point
+        const_iterator find_nearest(const point_type &p) const {
+            return find_nearest(p, 1);
+        }
+
+        /// \brief Find points closest to a reference point
+        iterator find_nearest(const point_type &p) {
+            return find_nearest(p, 1);
+        }
+
+        /// \brief Find k nearest points
+        /// We visit the elements around the position of p in the first
+        /// dimension and stop when the distance in the first dimension
+        /// alone is larger than the k-th nearest distance so far.
+        const_iterator find_nearest(const point_type &p, size_t k) const {
+            return find_nearest(p, k, [](const value_type &) { return true; });
+        }
+
+        /// \brief Find k nearest points
+        iterator find_nearest(const point_type &p, size_t k) {
+            return find_nearest(p, k, [](const value_type &) { return true; });
+        }
+
+        /// \brief Find k nearest points that pass a predicate
+        template <class PREDICATE_TYPE>
+        const_iterator find_nearest(const point_type &p, size_t k,
+                                    PREDICATE_TYPE fn) const {
+            return nearest_iterator<const_iterator>(p, k, fn);
+        }
+
+        /// \brief Find k nearest points that pass a predicate
+        template <class PREDICATE_TYPE>
+        iterator find_nearest(const point_type &p, size_t k,
+                              PREDICATE_TYPE fn) {
+            return nearest_iterator<iterator>(p, k, fn);
+        }
+
+        /// \brief Find points closest to a reference box
+        const_iterator find_nearest(const box_type &p, size_t k = 1) const {
+            return find_nearest(p, k, [](const value_type &) { return true; });
+        }
+
+        /// \brief Find points closest to a reference box
+        iterator find_nearest(const box_type &p, size_t k = 1) {
+            return find_nearest(p, k, [](const value_type &) { return true; });
+        }
+
+        /// \brief Find points closest to a reference box
+        template <class PREDICATE_TYPE>
+        const_iterator find_nearest(const box_type &p, size_t k,
+                                    PREDICATE_TYPE fn) const {
+            return nearest_iterator<const_iterator>(p, k, fn);
+        }
+
+        /// \brief Find points closest to a reference box
+        template <class PREDICATE_TYPE>
+        iterator find_nearest(const box_type &p, size_t k, PREDICATE_TYPE fn) {
+            return nearest_iterator<iterator>(p, k, fn);
+        }
+
+        /// \brief Get iterator to element with maximum value in a given
+        /// dimension
+        iterator max_element(size_t dimension) {
+            return iterator(data_.begin() + extreme_index(dimension, true),
+                            data_.end());
+        }
+
+        /// \brief Get iterator to element with maximum value in a given
+        /// dimension
+        const_iterator max_element(size_t dimension) const {
+            return const_iterator(
+                data_.begin() + extreme_index(dimension, true), data_.end());
+        }
+
+        /// \brief Get iterator to element with minimum value in a given
+        /// dimension
+        iterator min_element(size_t dimension) {
+            return iterator(data_.begin() + extreme_index(dimension, false),
+                            data_.end());
+        }
+
+        /// \brief Get iterator to element with minimum value in a given
+        /// dimension
+        const_iterator min_element(size_t dimension) const {
+            return const_iterator(
+                data_.begin() + extreme_index(dimension, false), data_.end());
+        }
+
+      public /* Observers: AssociativeContainer */:
+        /// \brief Returns the function object that compares keys
+        key_compare key_comp() const noexcept {
+            return [this](const key_type &a, const key_type &b) {
+                return std::lexicographical_compare(a.begin(), a.end(),
+                                                    b.begin(), b.end(), comp_);
+            };
+        }
+
+        /// \brief Returns the function object that compares values
+        value_compare value_comp() const noexcept {
+            return [this](const value_type &a, const value_type &b) {
+                return std::lexicographical_compare(
+                    a.first.begin(), a.first.end(), b.first.begin(),
+                    b.first.end(), comp_);
+            };
+        }
+
+        /// \brief Returns the function object that compares numbers
+        /// This is the comparison operator for a single dimension
+        dimension_compare dimension_comp() const noexcept { return comp_; }
+
+        /// \brief Check if the elements form a two-dimensional staircase
+        /// This is the case when the elements are sorted by the second
+        /// dimension in the same or in the reverse order of the first
+        /// dimension, which always happens in a two-dimensional front.
+        [[nodiscard]] bool is_staircase() const noexcept {
+            return dimensions() == 2 &&
+                   (ascending_steps_ == 0 || descending_steps_ == 0);
+        }
+
+      private /* Internal functions */:
+        /// \brief Insert element at its sorted position
+        iterator insert_sorted(unprotected_value_type &&v) {
+            auto it = std::upper_bound(data_.begin(), data_.end(), v.first,
+                                       element_less());
+            const auto i = static_cast<size_t>(it - data_.begin());
+            remove_step(i);
+            data_.insert(it, std::move(v));
+            add_steps_around(i);
+            return iterator(data_.begin() + i, data_.end());
+        }
+
+        /// \brief Lexicographic order of the keys
+        bool key_less(const key_type &a, const key_type &b) const {
+            return std::lexicographical_compare(a.begin(), a.end(), b.begin(),
+                                                b.end(), comp_);
+        }
+
+        static const key_type &key_of(const key_type &k) { return k; }
+
+        static const key_type &key_of(const unprotected_value_type &v) {
+            return v.first;
+        }
+
+        /// \brief Lexicographic order of keys and elements
+        auto element_less() const {
+            return [this](const auto &a, const auto &b) {
+                return key_less(key_of(a), key_of(b));
+            };
+        }
+
+        /// \brief Mutable iterator to the end of the container
+        /// Used by const functions that construct any iterator type
+        iterator data_end() const {
+            auto &data = const_cast<unprotected_vector_type &>(data_);
+            return iterator(data.end(), data.end());
+        }
+
+        template <class ITERATOR_TYPE>
+        size_t index_of(const ITERATOR_TYPE &it) const {
+            return static_cast<size_t>(it.query_it_ - data_.begin());
+        }
+
+        /// \brief Direction of the step between element i and i + 1 in the
+        /// second dimension
+        /// \return 1 if ascending, -1 if descending, and 0 if flat
+        int step(size_t i) const {
+            if (i + 1 >= data_.size() || data_[i].first.dimensions() < 2) {
+                return 0;
+            }
+            const dimension_type &a = data_[i].first[1];
+            const dimension_type &b = data_[i + 1].first[1];
+            return comp_(a, b) ? 1 : comp_(b, a) ? -1 : 0;
+        }
+
+        void add_step(size_t i) {
+            if (i == 0) {
+                return;
+            }
+            const int s = step(i - 1);
+            ascending_steps_ += s > 0;
+            descending_steps_ += s < 0;
+        }
+
+        void remove_step(size_t i) {
+            if (i == 0) {
+                return;
+            }
+            const int s = step(i - 1);
+            ascending_steps_ -= s > 0;
+            descending_steps_ -= s < 0;
+        }
+
+        /// \brief Count the steps to and from the element i
+        void add_steps_around(size_t i) {
+            add_step(i);
+            add_step(i + 1);
+        }
+
+        /// \brief Remove the steps to and from the element i
+        void remove_steps_around(size_t i) {
+            remove_step(i);
+            remove_step(i + 1);
+        }
+
+        void count_steps() {
+            ascending_steps_ = 0;
+            descending_steps_ = 0;
+            for (size_t i = 1; i < data_.size(); ++i) {
+                add_step(i);
+            }
+        }
+
+        /// \brief Range of elements in [lb, ub] in one dimension
+        /// The elements have to be sorted in this dimension, in the order of
+        /// comp_ if ascending and in the reverse order otherwise.
+        std::pair<size_t, size_t> sorted_range(size_t first, size_t last,
+                                               size_t dimension,
+                                               const dimension_type &lb,
+                                               const dimension_type &ub,
+                                               bool ascending) const {
+            const dimension_type &lo = comp_(ub, lb) ? ub : lb;
+            const dimension_type &hi = comp_(ub, lb) ? lb : ub;
+            auto b = data_.begin() + static_cast<difference_type>(first);
+            auto e = data_.begin() + static_cast<difference_type>(last);
+            auto range_begin =
+                std::partition_point(b, e, [&](const auto &v) {
+                    return ascending ? comp_(v.first[dimension], lo)
+                                     : comp_(hi, v.first[dimension]);
+                });
+            auto range_end =
+                std::partition_point(range_begin, e, [&](const auto &v) {
+                    return ascending ? !comp_(hi, v.first[dimension])
+                                     : !comp_(v.first[dimension], lo);
+                });
+            return {static_cast<size_t>(range_begin - data_.begin()),
+                    static_cast<size_t>(range_end - data_.begin())};
+        }
+
+        /// \brief Range of elements that might be in a query box
+        /// All elements are sorted in the first dimension. When the
+        /// elements form a staircase, they are also sorted in the second
+        /// dimension.
+        std::pair<size_t, size_t> box_range(const point_type &lb,
+                                            const point_type &ub) const {
+            auto r = sorted_range(0, data_.size(), 0, lb[0], ub[0], true);
+            if (r.first != r.second && is_staircase()) {
+                r = sorted_range(r.first, r.second, 1, lb[1], ub[1],
+                                 descending_steps_ == 0);
+            }
+            return r;
+        }
+
+        template <class ITERATOR_TYPE, class QUERY_FUNCTION>
+        ITERATOR_TYPE find_in_box(const point_type &lb, const point_type &ub,
+                                  QUERY_FUNCTION fn) const {
+            if (data_.empty()) {
+                return ITERATOR_TYPE(data_end());
+            }
+            auto [first, last] = box_range(lb, ub);
+            auto &data = const_cast<unprotected_vector_type &>(data_);
+            return ITERATOR_TYPE(
+                data.begin() + static_cast<difference_type>(first),
+                data.begin() + static_cast<difference_type>(last), data.end(),
+                fn);
+        }
+
+        /// \brief Distance between a point and a reference point or box
+        static double distance_to(const point_type &a, const point_type &p) {
+            return static_cast<double>(a.distance(p));
+        }
+
+        static double distance_to(const point_type &a, const box_type &b) {
+            return static_cast<double>(b.distance(a));
+        }
+
+        /// \brief Distance in the first dimension between a point and a
+        /// reference point or box
+        static double gap_to(const point_type &a, const point_type &p) {
+            return std::abs(static_cast<double>(a[0]) -
+                            static_cast<double>(p[0]));
+        }
+
+        static double gap_to(const point_type &a, const box_type &b) {
+            const auto x = static_cast<double>(a[0]);
+            const auto lo = static_cast<double>(b.first()[0]);
+            const auto hi = static_cast<double>(b.second()[0]);
+            return x < lo ? lo - x : x > hi ? x - hi : 0.;
+        }
+
+        static const dimension_type &position_of(const point_type &p) {
+            return p[0];
+        }
+
+        static const dimension_type &position_of(const box_type &b) {
+            return b.first()[0];
+        }
+
+        /// \brief Iterator to the k nearest elements
+        /// We walk left and right of the reference position at the same
+        /// time, always visiting the closest candidate in the first
+        /// dimension, and keep the k nearest elements in a heap.
+        template <class ITERATOR_TYPE, class REFERENCE_TYPE,
+                  class PREDICATE_TYPE>
+        ITERATOR_TYPE nearest_iterator(const REFERENCE_TYPE &p, size_t k,
+                                       PREDICATE_TYPE fn) const {
+            k = std::min(k, size());
+            if (k == 0) {
+                return ITERATOR_TYPE(data_end());
+            }
+            const dimension_type &x = position_of(p);
+            auto pos = std::partition_point(
+                data_.begin(), data_.end(),
+                [&](const auto &v) { return comp_(v.first[0], x); });
+            size_t right = static_cast<size_t>(pos - data_.begin());
+            size_t left = right;
+
+            using candidate = std::pair<double, size_t>;
+            std::priority_queue<candidate> nearest;
+            auto visit = [&](size_t i) {
+                const value_type &v = reinterpret_cast<const value_type &>(
+                    data_[i]);
+                if (!fn(v)) {
+                    return;
+                }
+                const double d = distance_to(data_[i].first, p);
+                if (nearest.size() < k) {
+                    nearest.emplace(d, i);
+                } else if (d < nearest.top().first) {
+                    nearest.pop();
+                    nearest.emplace(d, i);
+                }
+            };
+            while (left > 0 || right < data_.size()) {
+                const double left_gap =
+                    left > 0 ? gap_to(data_[left - 1].first, p)
+                             : std::numeric_limits<double>::max();
+                const double right_gap =
+                    right < data_.size() ? gap_to(data_[right].first, p)
+                                         : std::numeric_limits<double>::max();
+                const bool go_left = left_gap < right_gap;
+                const double gap = go_left ? left_gap : right_gap;
+                if (nearest.size() == k && gap > nearest.top().first) {
+                    break;
+                }
+                if (go_left) {
+                    visit(--left);
+                } else {
+                    visit(right++);
+                }
+            }
+
+            if (nearest.empty()) {
+                return ITERATOR_TYPE(data_end());
+            }
+            // copies of a key might not be among the nearest, so we
+            // identify the nearest elements by their addresses
+            std::vector<const void *> nearest_set;
+            size_t first = data_.size();
+            size_t last = 0;
+            while (!nearest.empty()) {
+                const size_t i = nearest.top().second;
+                nearest.pop();
+                nearest_set.emplace_back(&data_[i]);
+                first = std::min(first, i);
+                last = std::max(last, i + 1);
+            }
+            std::sort(nearest_set.begin(), nearest_set.end());
+            auto &data = const_cast<unprotected_vector_type &>(data_);
+            return ITERATOR_TYPE(
+                data.begin() + static_cast<difference_type>(first),
+                data.begin() + static_cast<difference_type>(last), data.end(),
+                [nearest_set](const value_type &v) {
+                    return std::binary_search(nearest_set.begin(),
+                                              nearest_set.end(),
+                                              static_cast<const void *>(&v));
+                });
+        }
+
+        /// \brief Index of the first element with the maximum or minimum
+        /// value in a dimension
+        /// The extremes of the first dimension are at the ends of the
+        /// vector. The same happens to the second dimension when the
+        /// elements form a staircase.
+        size_t extreme_index(size_t dimension, bool is_max) const {
+            if (data_.empty()) {
+                return 0;
+            }
+            auto less = [&](const auto &a, const auto &b) {
+                return a.first[dimension] < b.first[dimension];
+            };
+            constexpr bool sorted_by_less =
+                std::is_same_v<dimension_compare, std::less<dimension_type>>;
+            if constexpr (sorted_by_less) {
+                const bool is_sorted_ascending =
+                    dimension == 0 ||
+                    (dimension == 1 && is_staircase() &&
+                     descending_steps_ == 0);
+                const bool is_sorted_descending =
+                    dimension == 1 && is_staircase() && ascending_steps_ == 0;
+                if (is_sorted_ascending || is_sorted_descending) {
+                    // first element with the same value as the extreme
+                    const bool extreme_is_last = is_max == is_sorted_ascending;
+                    if (!extreme_is_last) {
+                        return 0;
+                    }
+                    const dimension_type &x = data_.back().first[dimension];
+                    auto it = std::partition_point(
+                        data_.begin(), data_.end(), [&](const auto &v) {
+                            return is_sorted_ascending
+                                       ? v.first[dimension] < x
+                                       : x < v.first[dimension];
+                        });
+                    return static_cast<size_t>(it - data_.begin());
+                }
+            }
+            auto it = is_max
+                          ? std::max_element(data_.begin(), data_.end(), less)
+                          : std::min_element(data_.begin(), data_.end(), less);
+            return static_cast<size_t>(it - data_.begin());
+        }
+
+      private:
+        /// \brief Sorted vector storing the data
+        /// Note that the key_type is not constant, unlike the value_type
+        /// exposed to the user. The iterators are responsible for
+        /// converting these references to protected types where the
+        /// key is const.
+        unprotected_vector_type data_{};
+
+        dimension_compare comp_{dimension_compare()};
+
+        /// \brief Number of consecutive elements that go up in the
+        /// second dimension
+        size_t ascending_steps_{0};
+
+        /// \brief Number of consecutive elements that go down in the
+        /// second dimension
+        size_t descending_steps_{0};
+    };
+
+    /* Non-Modifying Functions / Comparison / Container Concept */
+    /// \brief Equality operator
+    /// Elements are always sorted, so two containers with the same
+    /// elements are equal regardless of the insertion order.
+    template <class K, size_t M, class T, class C, class A>
+    bool operator==(const sorted_tree<K, M, T, C, A> &lhs,
+                    const sorted_tree<K, M, T, C, A> &rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        return std::equal(
+            lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+            [](const typename sorted_tree<K, M, T, C, A>::value_type &a,
+               const typename sorted_tree<K, M, T, C, A>::value_type &b) {
+                return a.first == b.first &&
+                       mapped_type_custom_equality_operator(a.second, b.second);
+            });
+    }
+
+    /// \brief Inequality operator
+    template <class K, size_t M, class T, class C, class A>
+    bool operator!=(const sorted_tree<K, M, T, C, A> &lhs,
+                    const sorted_tree<K, M, T, C, A> &rhs) {
+        return !(lhs == rhs);
+    }
+
+} // namespace pareto
+
+#endif // PARETO_SORTED_TREE_H
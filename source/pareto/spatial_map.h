@@ -5,12 +5,24 @@
 #ifndef PARETO_SPATIAL_MAP_H
 #define PARETO_SPATIAL_MAP_H
 
+#include <type_traits>
+
 #include <pareto/r_tree.h>
+#include <pareto/sorted_tree.h>
 
 namespace pareto {
     template <class K, size_t M, class T, typename C = std::less<K>,
               class A = default_allocator_type<std::pair<const point<K, M>, T>>>
     using spatial_map = r_tree<K, M, T, C, A>;
+
+    /// \brief Default container for fronts and archives
+    /// No point in a two-dimensional front dominates another, so the
+    /// points form a staircase and a sorted vector answers the front
+    /// queries with binary searches. Other fronts use a spatial_map.
+    template <class K, size_t M, class T, typename C = std::less<K>,
+              class A = default_allocator_type<std::pair<const point<K, M>, T>>>
+    using front_map = std::conditional_t<M == 2, sorted_tree<K, M, T, C, A>,
+                                         spatial_map<K, M, T, C, A>>;
 }
 
 #endif // PARETO_SPATIAL_MAP_H
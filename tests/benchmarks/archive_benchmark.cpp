@@ -0,0 +1,170 @@
+#include <benchmark/benchmark.h>
+#include <pareto/archive.h>
+#include "../test_helpers.h"
+
+/// Number of random values we insert in each archive
+constexpr size_t number_of_values = 16384;
+
+/// \brief Random values on the surface of a sphere
+/// No value on this surface dominates another, so all values stay in
+/// the first front and every insertion in a full archive prunes it.
+template <size_t dimensions>
+std::vector<typename pareto::archive<double, dimensions, unsigned>::value_type>
+random_archive_values() {
+    std::vector<typename pareto::archive<double, dimensions, unsigned>::value_type> v;
+    v.reserve(number_of_values);
+    for (size_t i = 0; i < number_of_values; ++i) {
+        typename pareto::archive<double, dimensions, unsigned>::key_type p(dimensions);
+        double norm = 0.;
+        for (auto &x : p) {
+            x = std::abs(randn());
+            norm += x * x;
+        }
+        for (auto &x : p) {
+            x /= std::sqrt(norm);
+        }
+        v.emplace_back(p, randi());
+    }
+    return v;
+}
+
+/// \brief Insert values in a full archive with a pruning policy
+/// Each insertion makes the archive exceed its capacity, so this
+/// measures the cost of removing one element from the front.
+template <size_t dimensions, pareto::archive_pruning policy>
+void archive_overflow(benchmark::State &state) {
+    const auto v = random_archive_values<dimensions>();
+    pareto::archive<double, dimensions, unsigned> ar(static_cast<size_t>(state.range(0)));
+    ar.set_pruning(policy);
+    auto it = v.begin();
+    while (ar.size() < ar.capacity() && it != v.end()) {
+        ar.insert(*it);
+        ++it;
+    }
+    for (auto _ : state) {
+        if (it == v.end()) {
+            it = v.begin();
+        }
+        ar.insert(*it);
+        ++it;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["fronts"] = static_cast<double>(ar.size_fronts());
+}
+
+BENCHMARK_TEMPLATE(archive_overflow, 2, pareto::archive_pruning::crowding)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(archive_overflow, 2, pareto::archive_pruning::hypervolume)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(archive_overflow, 2, pareto::archive_pruning::grid)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(archive_overflow, 3, pareto::archive_pruning::crowding)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(archive_overflow, 3, pareto::archive_pruning::hypervolume)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(archive_overflow, 3, pareto::archive_pruning::grid)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(archive_overflow, 5, pareto::archive_pruning::crowding)->Arg(100);
+BENCHMARK_TEMPLATE(archive_overflow, 5, pareto::archive_pruning::hypervolume)->Arg(100);
+BENCHMARK_TEMPLATE(archive_overflow, 5, pareto::archive_pruning::grid)->Arg(100);
+
+/// \brief Random population with many fronts
+template <size_t dimensions>
+std::vector<typename pareto::archive<double, dimensions, unsigned>::value_type>
+random_population(size_t n) {
+    std::vector<typename pareto::archive<double, dimensions, unsigned>::value_type> v;
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        typename pareto::archive<double, dimensions, unsigned>::key_type p(dimensions);
+        std::generate(p.begin(), p.end(), randn);
+        v.emplace_back(p, randi());
+    }
+    return v;
+}
+
+/// \brief Construct an archive from a range
+/// The range constructor sorts the whole population into fronts at once.
+template <size_t dimensions>
+void construct_archive(benchmark::State &state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    const auto v = random_population<dimensions>(n);
+    size_t fronts = 0;
+    for (auto _ : state) {
+        pareto::archive<double, dimensions, unsigned> ar(n, v.begin(), v.end());
+        fronts = ar.size_fronts();
+        benchmark::DoNotOptimize(ar);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["fronts"] = static_cast<double>(fronts);
+}
+
+/// \brief Construct an archive inserting one element at a time
+template <size_t dimensions>
+void construct_archive_incrementally(benchmark::State &state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    const auto v = random_population<dimensions>(n);
+    size_t fronts = 0;
+    for (auto _ : state) {
+        pareto::archive<double, dimensions, unsigned> ar(n);
+        for (const auto &x : v) {
+            ar.insert(x);
+        }
+        fronts = ar.size_fronts();
+        benchmark::DoNotOptimize(ar);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["fronts"] = static_cast<double>(fronts);
+}
+
+/// \brief Insert a population in an archive that already has elements
+/// The population is inserted with parallel_insert and the given
+/// number of threads
+template <size_t dimensions>
+void parallel_insert_archive(benchmark::State &state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    const auto threads = static_cast<size_t>(state.range(1));
+    const auto v = random_population<dimensions>(n);
+    const auto middle = v.begin() + static_cast<std::ptrdiff_t>(n / 10);
+    size_t fronts = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        pareto::archive<double, dimensions, unsigned> ar(n, v.begin(), middle);
+        state.ResumeTiming();
+        ar.parallel_insert(middle, v.end(), threads);
+        fronts = ar.size_fronts();
+        benchmark::DoNotOptimize(ar);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["fronts"] = static_cast<double>(fronts);
+}
+
+/// \brief Insert a population in an archive with the default capacity
+/// The batch does not fit in the archive, so the sorted fronts are
+/// pruned once
+template <size_t dimensions>
+void parallel_insert_default_capacity(benchmark::State &state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    const auto threads = static_cast<size_t>(state.range(1));
+    const auto v = random_population<dimensions>(n);
+    const auto middle = v.begin() + static_cast<std::ptrdiff_t>(n / 10);
+    size_t fronts = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        pareto::archive<double, dimensions, unsigned> ar(v.begin(), middle);
+        state.ResumeTiming();
+        ar.parallel_insert(middle, v.end(), threads);
+        fronts = ar.size_fronts();
+        benchmark::DoNotOptimize(ar);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["fronts"] = static_cast<double>(fronts);
+}
+
+BENCHMARK_TEMPLATE(construct_archive, 2)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(construct_archive, 3)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(construct_archive, 5)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(construct_archive_incrementally, 2)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(construct_archive_incrementally, 3)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(construct_archive_incrementally, 5)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(parallel_insert_archive, 2)->ArgsProduct({{10000, 100000}, {1, 2, 4, 8}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(parallel_insert_archive, 3)->ArgsProduct({{10000, 100000}, {1, 2, 4, 8}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(parallel_insert_archive, 5)->ArgsProduct({{10000, 100000}, {1, 2, 4, 8}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(parallel_insert_default_capacity, 2)->ArgsProduct({{10000, 100000}, {1, 2, 4, 8}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(parallel_insert_default_capacity, 3)->ArgsProduct({{10000, 100000}, {1, 2, 4, 8}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(parallel_insert_default_capacity, 5)->ArgsProduct({{10000, 100000}, {1, 2, 4, 8}})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,191 @@
+#include <benchmark/benchmark.h>
+#include <pareto/concurrent_front.h>
+#include <pareto/concurrent_spatial_map.h>
+#include "../test_helpers.h"
+#include <mutex>
+
+/// Number of elements the writer publishes at once
+constexpr size_t batch_size = 16;
+
+/// \brief Index of the current benchmark thread
+/// google benchmark turned thread_index into a function in v1.6
+template <class S>
+auto thread_index(const S &state, int) -> decltype(state.thread_index()) {
+    return state.thread_index();
+}
+
+template <class S>
+auto thread_index(const S &state, long) -> decltype(state.thread_index) {
+    return state.thread_index;
+}
+
+/// \brief Random front values
+template <size_t dimensions>
+std::vector<typename pareto::front<double, dimensions, unsigned>::value_type>
+random_front_values(size_t n) {
+    std::vector<typename pareto::front<double, dimensions, unsigned>::value_type> v;
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        typename pareto::front<double, dimensions, unsigned>::key_type p(dimensions);
+        std::generate(p.begin(), p.end(), randn);
+        v.emplace_back(p, randi());
+    }
+    return v;
+}
+
+/// \brief Front shared by all benchmark threads
+/// Thread 0 is the writer and the other threads are readers
+template <size_t dimensions> struct shared_front {
+    shared_front()
+        : values(random_front_values<dimensions>(1 << 16)),
+          queries(random_front_values<dimensions>(1024)) {
+        cf.insert(values.begin(), values.begin() + 1000);
+        pf.insert(values.begin(), values.begin() + 1000);
+    }
+
+    std::vector<typename pareto::front<double, dimensions, unsigned>::value_type> values;
+    std::vector<typename pareto::front<double, dimensions, unsigned>::value_type> queries;
+    pareto::concurrent_front<double, dimensions, unsigned> cf;
+    pareto::front<double, dimensions, unsigned> pf;
+    std::mutex pf_mutex;
+};
+
+template <size_t dimensions> shared_front<dimensions> &get_shared_front() {
+    static shared_front<dimensions> s;
+    return s;
+}
+
+/// \brief Readers query snapshots while the writer publishes batches
+template <size_t dimensions> void snapshot_readers(benchmark::State &state) {
+    auto &s = get_shared_front<dimensions>();
+    const auto &queries = s.queries;
+    size_t i = 0;
+    for (auto _ : state) {
+        if (thread_index(state, 0) == 0) {
+            auto first = s.values.begin() + static_cast<std::ptrdiff_t>((i * batch_size) % (s.values.size() - batch_size));
+            s.cf.insert(first, first + batch_size);
+        } else {
+            auto pf = s.cf.snapshot();
+            benchmark::DoNotOptimize(pf->dominates(queries[i % queries.size()].first));
+            benchmark::DoNotOptimize(pf->find_nearest(queries[i % queries.size()].first));
+        }
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// \brief Readers and the writer share a front behind a mutex
+template <size_t dimensions> void mutex_readers(benchmark::State &state) {
+    auto &s = get_shared_front<dimensions>();
+    const auto &queries = s.queries;
+    size_t i = 0;
+    for (auto _ : state) {
+        std::lock_guard lock(s.pf_mutex);
+        if (thread_index(state, 0) == 0) {
+            auto first = s.values.begin() + static_cast<std::ptrdiff_t>((i * batch_size) % (s.values.size() - batch_size));
+            s.pf.insert(first, first + batch_size);
+        } else {
+            benchmark::DoNotOptimize(s.pf.dominates(queries[i % queries.size()].first));
+            benchmark::DoNotOptimize(s.pf.find_nearest(queries[i % queries.size()].first));
+        }
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// \brief The writer publishes each element or defers them in batches
+/// A copy-on-write front copies the whole front on each publication,
+/// so publishing one element at a time costs O(n) per element
+template <size_t dimensions, bool deferred>
+void snapshot_writer(benchmark::State &state) {
+    const auto values = random_front_values<dimensions>(1 << 16);
+    pareto::concurrent_front<double, dimensions, unsigned> cf;
+    cf.insert(values.begin(), values.begin() + 1000);
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto &v = values[i % values.size()];
+        if constexpr (deferred) {
+            if (cf.defer_insert(v) == batch_size) {
+                cf.flush();
+            }
+        } else {
+            cf.insert(v);
+        }
+        ++i;
+    }
+    cf.flush();
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// \brief Spatial maps shared by all benchmark threads
+template <size_t dimensions> struct shared_map {
+    shared_map()
+        : values(random_front_values<dimensions>(1 << 16)),
+          queries(random_front_values<dimensions>(1024)) {}
+
+    std::vector<typename pareto::front<double, dimensions, unsigned>::value_type> values;
+    std::vector<typename pareto::front<double, dimensions, unsigned>::value_type> queries;
+    pareto::concurrent_spatial_map<double, dimensions, unsigned> cm;
+    pareto::spatial_map<double, dimensions, unsigned> m;
+    std::mutex m_mutex;
+};
+
+template <size_t dimensions> shared_map<dimensions> &get_shared_map() {
+    static shared_map<dimensions> s;
+    return s;
+}
+
+/// \brief All threads insert in a sharded map and query it every 16 inserts
+template <size_t dimensions> void sharded_map_ingestion(benchmark::State &state) {
+    auto &s = get_shared_map<dimensions>();
+    if (thread_index(state, 0) == 0) {
+        s.cm.clear();
+    }
+    size_t i = static_cast<size_t>(thread_index(state, 0)) * 4099;
+    for (auto _ : state) {
+        if (i % batch_size == 0) {
+            benchmark::DoNotOptimize(s.cm.find_nearest(s.queries[i % s.queries.size()].first));
+        } else {
+            s.cm.insert(s.values[i % s.values.size()]);
+        }
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// \brief All threads insert in a map behind a mutex and query it every 16 inserts
+template <size_t dimensions> void mutex_map_ingestion(benchmark::State &state) {
+    auto &s = get_shared_map<dimensions>();
+    if (thread_index(state, 0) == 0) {
+        std::lock_guard lock(s.m_mutex);
+        s.m.clear();
+    }
+    size_t i = static_cast<size_t>(thread_index(state, 0)) * 4099;
+    for (auto _ : state) {
+        std::lock_guard lock(s.m_mutex);
+        if (i % batch_size == 0 && !s.m.empty()) {
+            benchmark::DoNotOptimize(s.m.find_nearest(s.queries[i % s.queries.size()].first));
+        } else {
+            s.m.insert(s.values[i % s.values.size()]);
+        }
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+
+BENCHMARK_TEMPLATE(snapshot_readers, 2)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(mutex_readers, 2)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(snapshot_readers, 3)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(mutex_readers, 3)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(snapshot_writer, 2, false);
+BENCHMARK_TEMPLATE(snapshot_writer, 2, true);
+BENCHMARK_TEMPLATE(snapshot_writer, 3, false);
+BENCHMARK_TEMPLATE(snapshot_writer, 3, true);
+
+BENCHMARK_TEMPLATE(sharded_map_ingestion, 2)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(mutex_map_ingestion, 2)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(sharded_map_ingestion, 3)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(mutex_map_ingestion, 3)->ThreadRange(1, 16)->UseRealTime();
+
+BENCHMARK_MAIN();
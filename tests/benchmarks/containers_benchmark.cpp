@@ -1,10 +1,13 @@
 #include <benchmark/benchmark.h>
+#include <pareto/columnar_tree.h>
 #include <pareto/front.h>
 #include <pareto/implicit_tree.h>
 #include <pareto/kd_tree.h>
+#include <pareto/linear_quad_tree.h>
 #include <pareto/quad_tree.h>
 #include <pareto/r_star_tree.h>
 #include <pareto/r_tree.h>
+#include <pareto/sorted_tree.h>
 #ifdef BUILD_BOOST_TREE
 #include <pareto/boost_tree.h>
 #endif
@@ -25,6 +28,42 @@ struct construct {
     }
 };
 
+/// \brief Construct a container from a range
+/// Containers that support bulk loading (r-trees) are packed bottom-up
+/// instead of receiving one element at a time
+/// Functors allow us to pass functions as template template parameters
+template<size_t COMPILE_DIMENSION, class Container>
+struct bulk_construct {
+    void operator()(benchmark::State &state) const {
+        size_t n = state.range(0);
+        for (auto _ : state) {
+            state.PauseTiming();
+            auto v = create_vector_with_values<COMPILE_DIMENSION, Container>(n);
+            state.ResumeTiming();
+            benchmark::DoNotOptimize(Container(v.begin(), v.end()));
+        }
+    }
+};
+
+/// \brief query_intersection in a container constructed from a range
+/// Functors allow us to pass functions as template template parameters
+template<size_t COMPILE_DIMENSION, class Container>
+struct bulk_query_intersection {
+    void operator()(benchmark::State &state) const {
+        size_t n = state.range(0);
+        for (auto _ : state) {
+            state.PauseTiming();
+            auto v = create_vector_with_values<COMPILE_DIMENSION, Container>(n);
+            Container c(v.begin(), v.end());
+            auto p = random_point<COMPILE_DIMENSION, Container>();
+            auto p1 = p - 0.5;
+            auto p2 = p + 0.5;
+            state.ResumeTiming();
+            benchmark::DoNotOptimize(std::distance(c.find_intersection(p1, p2), c.end()));
+        }
+    }
+};
+
 /// \brief Insert in a front
 /// Functors allow us to pass functions as template template parameters
 template<size_t COMPILE_DIMENSION, class Container>
@@ -40,6 +79,23 @@ struct insert {
     }
 };
 
+/// \brief Insert a batch of n elements in a front with n elements
+/// The batch is filtered and inserted at once
+/// Functors allow us to pass functions as template template parameters
+template<size_t COMPILE_DIMENSION, class Container>
+struct batch_insert {
+    void operator()(benchmark::State &state) const {
+        size_t n = state.range(0);
+        for (auto _ : state) {
+            state.PauseTiming();
+            auto pf = create_test_pareto<COMPILE_DIMENSION, Container>(n);
+            auto v = create_vector_with_values<COMPILE_DIMENSION, Container>(n);
+            state.ResumeTiming();
+            benchmark::DoNotOptimize(pf.insert(v.begin(), v.end()));
+        }
+    }
+};
+
 /// \brief erase in a front
 /// Functors allow us to pass functions as template template parameters
 template<size_t COMPILE_DIMENSION, class Container>
@@ -104,6 +160,38 @@ struct query_nearest {
     }
 };
 
+/// \brief query_intersection in a frozen front
+/// Functors allow us to pass functions as template template parameters
+template<size_t COMPILE_DIMENSION, class Container>
+struct frozen_query_intersection {
+    void operator()(benchmark::State &state) const {
+        for (auto _ : state) {
+            state.PauseTiming();
+            const auto pf = create_test_pareto<COMPILE_DIMENSION, Container>(state.range(0)).freeze();
+            auto p1 = random_point<COMPILE_DIMENSION, Container>();
+            state.ResumeTiming();
+            auto it = pf.find_intersection(p1,p1);
+            benchmark::DoNotOptimize(it != pf.end());
+        }
+    }
+};
+
+/// \brief Query nearest in a frozen front
+/// Functors allow us to pass functions as template template parameters
+template<size_t COMPILE_DIMENSION, class Container>
+struct frozen_query_nearest {
+    void operator()(benchmark::State &state) const {
+        for (auto _ : state) {
+            state.PauseTiming();
+            const auto pf = create_test_pareto<COMPILE_DIMENSION, Container>(state.range(0)).freeze();
+            auto p = random_point<COMPILE_DIMENSION, Container>();
+            state.ResumeTiming();
+            auto it = pf.find_nearest(p);
+            benchmark::DoNotOptimize(it != pf.end());
+        }
+    }
+};
+
 /// \brief Calculate front hypervolume
 /// Functors allow us to pass functions as template template parameters
 template<size_t COMPILE_DIMENSION, class Container>
@@ -188,6 +276,9 @@ auto register_all_containers(const std::string& name, S state_values) {
         register_bench(name + ",kd_tree>", F<M,pareto::kd_tree<double,M,unsigned>>(), state_values);
         register_bench(name + ",r_tree>", F<M,pareto::r_tree<double,M,unsigned>>(), state_values);
         register_bench(name + ",r_star_tree>", F<M,pareto::r_star_tree<double,M,unsigned>>(), state_values);
+        register_bench(name + ",sorted_tree>", F<M,pareto::sorted_tree<double,M,unsigned>>(), state_values);
+        register_bench(name + ",linear_quad_tree>", F<M,pareto::linear_quad_tree<double,M,unsigned>>(), state_values);
+        register_bench(name + ",columnar_tree>", F<M,pareto::columnar_tree<double,M,unsigned>>(), state_values);
     }
 #ifdef BUILD_BOOST_TREE
     else {
@@ -196,16 +287,79 @@ auto register_all_containers(const std::string& name, S state_values) {
 #endif
 }
 
+/// \brief Register a benchmark for r-trees with a given node fanout
+template <size_t M, template <size_t,class> class F, size_t MaxBranches, class S>
+auto register_fanout(const std::string& name, S state_values) {
+    using allocator_type = pareto::default_allocator_type<std::pair<const pareto::point<double, M>, unsigned>>;
+    const std::string fanout = "<fanout=" + std::to_string(MaxBranches) + ">";
+    register_bench(name + ",r_tree" + fanout + ">", F<M,pareto::r_tree<double,M,unsigned,std::less<double>,allocator_type,MaxBranches>>(), state_values);
+    register_bench(name + ",r_star_tree" + fanout + ">", F<M,pareto::r_star_tree<double,M,unsigned,std::less<double>,allocator_type,MaxBranches>>(), state_values);
+}
+
+/// \brief Register a benchmark for r-trees with the fanouts we want to compare
+/// The best fanout depends on the number of dimensions
+template <size_t M, template <size_t,class> class F, class S>
+auto register_all_fanouts(const std::string& name, S state_values) {
+    register_fanout<M, F, 8>(name, state_values);
+    register_fanout<M, F, 16>(name, state_values);
+    register_fanout<M, F, 32>(name, state_values);
+    register_fanout<M, F, 64>(name, state_values);
+}
+
+/// \brief Register a benchmark for kd-trees and quadtrees with a given bucket size
+template <size_t M, template <size_t,class> class F, size_t BucketSize, class S>
+auto register_bucket(const std::string& name, S state_values) {
+    using allocator_type = pareto::default_allocator_type<std::pair<const pareto::point<double, M>, unsigned>>;
+    const std::string bucket = "<bucket=" + std::to_string(BucketSize) + ">";
+    register_bench(name + ",kd_tree" + bucket + ">", F<M,pareto::kd_tree<double,M,unsigned,std::less<double>,allocator_type,BucketSize>>(), state_values);
+    register_bench(name + ",quad_tree" + bucket + ">", F<M,pareto::quad_tree<double,M,unsigned,std::less<double>,allocator_type,BucketSize>>(), state_values);
+}
+
+/// \brief Register a benchmark for kd-trees and quadtrees with the bucket sizes we want to compare
+/// The unbucketed layout (bucket=1) is registered with the other containers
+template <size_t M, template <size_t,class> class F, class S>
+auto register_all_buckets(const std::string& name, S state_values) {
+    register_bucket<M, F, 4>(name, state_values);
+    register_bucket<M, F, 16>(name, state_values);
+    register_bucket<M, F, 32>(name, state_values);
+}
+
+/// \brief Register a benchmark for linear quadtrees ordered by the Hilbert curve
+/// The Z-order curve (the default) is registered with the other containers
+template <size_t M, template <size_t,class> class F, class S>
+auto register_hilbert(const std::string& name, S state_values) {
+    using allocator_type = pareto::default_allocator_type<std::pair<const pareto::point<double, M>, unsigned>>;
+    register_bench(name + ",linear_quad_tree<curve=hilbert>>", F<M,pareto::linear_quad_tree<double,M,unsigned,std::less<double>,allocator_type,pareto::hilbert_curve>>(), state_values);
+}
+
 template <size_t M, bool is_hypervolume_benchmark, bool is_boost_benchmark>
 void register_all_functions() {
     if constexpr (!is_hypervolume_benchmark) {
         register_all_containers<M, construct, is_boost_benchmark>("construct<m=" + std::to_string(M), pareto_sizes);
+        register_all_containers<M, bulk_construct, is_boost_benchmark>("bulk_construct<m=" + std::to_string(M), pareto_sizes);
+        register_all_containers<M, bulk_query_intersection, is_boost_benchmark>("bulk_query_intersection<m=" + std::to_string(M), pareto_sizes);
         register_all_containers<M, insert, is_boost_benchmark>("insert<m=" + std::to_string(M), pareto_sizes);
+        register_all_containers<M, batch_insert, is_boost_benchmark>("batch_insert<m=" + std::to_string(M), pareto_sizes);
         register_all_containers<M, erase, is_boost_benchmark>("erase<m=" + std::to_string(M), pareto_sizes);
         register_all_containers<M, check_dominance, is_boost_benchmark>("check_dominance<m=" + std::to_string(M), pareto_sizes);
         register_all_containers<M, query_intersection, is_boost_benchmark>("query_intersection<m=" + std::to_string(M), pareto_sizes);
         register_all_containers<M, query_nearest, is_boost_benchmark>("query_nearest<m=" + std::to_string(M), pareto_sizes);
         register_all_containers<M, igd, is_boost_benchmark>("igd<m=" + std::to_string(M), pareto_sizes);
+        if constexpr (!is_boost_benchmark) {
+            register_all_fanouts<M, insert>("insert<m=" + std::to_string(M), pareto_sizes);
+            register_all_fanouts<M, erase>("erase<m=" + std::to_string(M), pareto_sizes);
+            register_all_fanouts<M, query_intersection>("query_intersection<m=" + std::to_string(M), pareto_sizes);
+            register_all_fanouts<M, query_nearest>("query_nearest<m=" + std::to_string(M), pareto_sizes);
+            register_all_buckets<M, insert>("insert<m=" + std::to_string(M), pareto_sizes);
+            register_all_buckets<M, erase>("erase<m=" + std::to_string(M), pareto_sizes);
+            register_all_buckets<M, query_intersection>("query_intersection<m=" + std::to_string(M), pareto_sizes);
+            register_all_buckets<M, query_nearest>("query_nearest<m=" + std::to_string(M), pareto_sizes);
+            register_bench("frozen_query_intersection<m=" + std::to_string(M) + ",kd_tree>", frozen_query_intersection<M,pareto::kd_tree<double,M,unsigned>>(), pareto_sizes);
+            register_bench("frozen_query_nearest<m=" + std::to_string(M) + ",kd_tree>", frozen_query_nearest<M,pareto::kd_tree<double,M,unsigned>>(), pareto_sizes);
+            register_hilbert<M, bulk_construct>("bulk_construct<m=" + std::to_string(M), pareto_sizes);
+            register_hilbert<M, query_intersection>("query_intersection<m=" + std::to_string(M), pareto_sizes);
+            register_hilbert<M, query_nearest>("query_nearest<m=" + std::to_string(M), pareto_sizes);
+        }
     } else {
         register_all_containers<M, hypervolume, is_boost_benchmark>("hypervolume<m=" + std::to_string(M), pareto_sizes_and_samples);
     }
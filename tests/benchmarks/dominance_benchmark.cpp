@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+#include <pareto/front.h>
+#include <pareto/point.h>
+#include "../test_helpers.h"
+
+/// Number of point pairs we compare in each benchmark iteration
+constexpr size_t number_of_pairs = 1024;
+
+/// \brief Create pairs of random points
+/// Points with compile time dimensions compare a few coordinates at a
+/// time when all directions are the same. Points with runtime dimensions
+/// (M = 0) compare one coordinate at a time, so they work as a baseline.
+template <class T, size_t M, size_t runtime_dimensions>
+std::vector<std::pair<pareto::point<T, M>, pareto::point<T, M>>> random_pairs() {
+    std::vector<std::pair<pareto::point<T, M>, pareto::point<T, M>>> v;
+    v.reserve(number_of_pairs);
+    for (size_t i = 0; i < number_of_pairs; ++i) {
+        pareto::point<T, M> a(runtime_dimensions);
+        pareto::point<T, M> b(runtime_dimensions);
+        for (size_t j = 0; j < runtime_dimensions; ++j) {
+            a[j] = static_cast<T>(randn() * 10);
+            b[j] = static_cast<T>(randn() * 10);
+        }
+        v.emplace_back(a, b);
+    }
+    return v;
+}
+
+/// \brief Point dominance throughput
+template <class T, size_t M, size_t runtime_dimensions>
+void point_dominance(benchmark::State &state) {
+    auto v = random_pairs<T, M, runtime_dimensions>();
+    std::array<uint8_t, runtime_dimensions> is_minimization{};
+    for (size_t j = 0; j < runtime_dimensions; j += 2) {
+        is_minimization[j] = 1;
+    }
+    for (auto _ : state) {
+        size_t c = 0;
+        for (const auto &[a, b] : v) {
+            c += a.dominates(b, is_minimization);
+        }
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * number_of_pairs);
+}
+
+/// \brief Point dominance throughput with a direction mask
+/// Fronts keep their mixed directions as a mask when the dimensions are
+/// known at compile time
+template <class T, size_t M>
+void point_dominance_mask(benchmark::State &state) {
+    auto v = random_pairs<T, M, M>();
+    std::array<uint8_t, M> is_minimization{};
+    for (size_t j = 0; j < M; j += 2) {
+        is_minimization[j] = 1;
+    }
+    const pareto::detail::direction_mask<M> directions(is_minimization);
+    for (auto _ : state) {
+        size_t c = 0;
+        for (const auto &[a, b] : v) {
+            c += a.dominates(b, directions);
+        }
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * number_of_pairs);
+}
+
+/// \brief Front insertion throughput with mixed directions
+/// Insertion checks dominance against the front through
+/// front::dominates, so this measures the dominance checks the
+/// containers actually run
+template <class T, size_t M, size_t runtime_dimensions>
+void front_insert_dominance(benchmark::State &state) {
+    auto v = random_pairs<T, M, runtime_dimensions>();
+    std::vector<uint8_t> is_minimization(runtime_dimensions);
+    for (size_t j = 0; j < runtime_dimensions; j += 2) {
+        is_minimization[j] = 1;
+    }
+    for (auto _ : state) {
+        pareto::front<T, M, unsigned> pf({}, is_minimization.begin(),
+                                         is_minimization.end());
+        for (const auto &[a, b] : v) {
+            pf.insert(std::make_pair(a, 0U));
+            pf.insert(std::make_pair(b, 0U));
+        }
+        benchmark::DoNotOptimize(pf);
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * number_of_pairs);
+}
+
+/// \brief Point dominance throughput when all directions are minimization
+template <class T, size_t M, size_t runtime_dimensions>
+void point_dominance_minimization(benchmark::State &state) {
+    auto v = random_pairs<T, M, runtime_dimensions>();
+    for (auto _ : state) {
+        size_t c = 0;
+        for (const auto &[a, b] : v) {
+            c += a.dominates(b);
+        }
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * number_of_pairs);
+}
+
+#define DOMINANCE_BENCHMARKS(TYPE, M)                                          \
+    BENCHMARK_TEMPLATE(point_dominance, TYPE, M, M);                           \
+    BENCHMARK_TEMPLATE(point_dominance, TYPE, 0, M);                           \
+    BENCHMARK_TEMPLATE(point_dominance_mask, TYPE, M);                         \
+    BENCHMARK_TEMPLATE(point_dominance_minimization, TYPE, M, M);              \
+    BENCHMARK_TEMPLATE(point_dominance_minimization, TYPE, 0, M);              \
+    BENCHMARK_TEMPLATE(front_insert_dominance, TYPE, M, M);                    \
+    BENCHMARK_TEMPLATE(front_insert_dominance, TYPE, 0, M)
+
+DOMINANCE_BENCHMARKS(double, 2);
+DOMINANCE_BENCHMARKS(double, 3);
+DOMINANCE_BENCHMARKS(double, 5);
+DOMINANCE_BENCHMARKS(double, 8);
+DOMINANCE_BENCHMARKS(double, 13);
+DOMINANCE_BENCHMARKS(float, 3);
+DOMINANCE_BENCHMARKS(float, 8);
+DOMINANCE_BENCHMARKS(int, 3);
+DOMINANCE_BENCHMARKS(int, 8);
+
+BENCHMARK_MAIN();
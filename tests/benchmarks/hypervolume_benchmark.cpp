@@ -1,4 +1,7 @@
 #include <benchmark/benchmark.h>
+#include <map>
+#include <mutex>
+#include <numeric>
 #include <pareto/front.h>
 #include "../test_helpers.h"
 
@@ -78,6 +81,158 @@ void calculate_hypervolume(benchmark::State &state) {
     state.counters["hv"] = hv;
 }
 
+/// \brief Exact hypervolume of independent fronts in many threads
+/// Each thread evaluates its own copy of the front with its own
+/// workspace, so the throughput should scale with the number of threads.
+template<size_t dimensions>
+void parallel_hypervolume(benchmark::State &state) {
+    static std::mutex cache_mutex;
+    std::unique_lock<std::mutex> lock(cache_mutex);
+    auto pf = create_test_pareto<dimensions, dimensions>(state.range(0));
+    lock.unlock();
+    auto nadir = pf.nadir();
+    pareto::hypervolume_workspace workspace;
+    double hv = 0.0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hv = pf.hypervolume(nadir, workspace));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["hv"] = hv;
+}
+
+/// \brief Front with n points on the surface of a sphere
+/// Random fronts with a few dimensions stay small, while no point on this
+/// surface dominates another, so the front has exactly n points.
+/// Fronts are cached so that all algorithms get the same front.
+template<size_t dimensions>
+pareto::front<double, dimensions, unsigned> create_spherical_front(size_t n) {
+    static std::map<size_t, pareto::front<double, dimensions, unsigned>> cache;
+    auto it = cache.find(n);
+    if (it != cache.end()) {
+        return it->second;
+    }
+    pareto::front<double, dimensions, unsigned> pf;
+    std::vector<typename pareto::front<double, dimensions, unsigned>::value_type> v;
+    while (v.size() < n) {
+        auto p = random_point<dimensions, dimensions>();
+        double norm = 0.;
+        for (auto &x : p) {
+            x = std::abs(x);
+            norm += x * x;
+        }
+        if (norm != 0.) {
+            for (auto &x : p) {
+                x /= std::sqrt(norm);
+            }
+            v.emplace_back(p, randi());
+        }
+    }
+    pf.insert(v.begin(), v.end());
+    cache[n] = pf;
+    return pf;
+}
+
+/// \brief Exact hypervolume with the general recursion
+/// This is the path front::hypervolume used to take for all dimensions.
+/// Compare it with calculate_hypervolume, which uses the sweeps for
+/// two and three dimensions.
+template<size_t dimensions>
+void general_hypervolume(benchmark::State &state) {
+    auto pf = create_spherical_front<dimensions>(state.range(0));
+    auto nadir = pf.nadir();
+    pareto::hypervolume_workspace workspace;
+    double hv = 0.0;
+    for (auto _ : state) {
+        std::vector<double> data;
+        data.reserve(pf.size() * dimensions);
+        for (const auto &[k, v] : pf) {
+            data.insert(data.end(), k.begin(), k.end());
+        }
+        benchmark::DoNotOptimize(hv = pareto::fpli_hv(data.data(), dimensions, static_cast<int>(pf.size()), nadir.values().data(), workspace));
+    }
+    state.counters["hv"] = hv;
+}
+
+/// \brief Exact hypervolume with the sweeps for two and three dimensions
+template<size_t dimensions>
+void sweep_hypervolume(benchmark::State &state) {
+    auto pf = create_spherical_front<dimensions>(state.range(0));
+    auto nadir = pf.nadir();
+    pareto::hypervolume_workspace workspace;
+    double hv = 0.0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hv = pf.hypervolume(nadir, workspace));
+    }
+    state.counters["hv"] = hv;
+}
+
+/// \brief Exact hypervolume with a given algorithm
+/// WFG is much faster than the default algorithm with many objectives
+template<size_t dimensions, pareto::hypervolume_algorithm algorithm>
+void exact_hypervolume(benchmark::State &state) {
+    auto pf = create_spherical_front<dimensions>(state.range(0));
+    auto nadir = pf.nadir();
+    pareto::hypervolume_workspace workspace;
+    double hv = 0.0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hv = pf.hypervolume(nadir, workspace, algorithm));
+    }
+    state.counters["hv"] = hv;
+}
+
+/// \brief Contributions as the hypervolume without each element
+/// This is what we had to do before hypervolume_contributions
+template<size_t dimensions>
+void leave_one_out_contributions(benchmark::State &state) {
+    auto pf = create_spherical_front<dimensions>(state.range(0));
+    auto nadir = pf.nadir();
+    pareto::hypervolume_workspace workspace;
+    double sum = 0.0;
+    for (auto _ : state) {
+        sum = 0.0;
+        const double hv = pf.hypervolume(nadir, workspace);
+        for (const auto &[k, v] : pf) {
+            auto without_k = pf;
+            without_k.erase(k);
+            sum += hv - without_k.hypervolume(nadir, workspace);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.counters["sum"] = sum;
+}
+
+/// \brief All contributions in one pass
+template<size_t dimensions>
+void hypervolume_contributions(benchmark::State &state) {
+    auto pf = create_spherical_front<dimensions>(state.range(0));
+    auto nadir = pf.nadir();
+    double sum = 0.0;
+    for (auto _ : state) {
+        auto c = pf.hypervolume_contributions(nadir);
+        benchmark::DoNotOptimize(sum = std::accumulate(c.begin(), c.end(), 0.0));
+    }
+    state.counters["sum"] = sum;
+}
+
+/// \brief Insert and erase a point while tracking the contributions
+/// Only the neighbours of the point are updated
+template<size_t dimensions>
+void tracked_contributions(benchmark::State &state) {
+    auto pf = create_spherical_front<dimensions>(state.range(0));
+    pf.track_hypervolume_contributions(pf.nadir());
+    auto extra = create_spherical_front<dimensions>(state.range(0) + 1);
+    auto it = extra.begin();
+    for (auto _ : state) {
+        if (it == extra.end()) {
+            it = extra.begin();
+        }
+        pf.insert(*it);
+        pf.erase(it->first);
+        ++it;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
 constexpr size_t max_pareto_size = 5000;
 constexpr size_t max_number_of_samples = 10000;
 
@@ -108,11 +263,32 @@ void pareto_sizes_and_samples2(benchmark::internal::Benchmark *b) {
 size_t number_of_threads = std::thread::hardware_concurrency();
 
 BENCHMARK_TEMPLATE(calculate_hypervolume, 2)->Apply(pareto_sizes_and_samples)->Iterations(1);
+BENCHMARK_TEMPLATE(general_hypervolume, 2)->RangeMultiplier(10)->Range(50, max_pareto_size);
+BENCHMARK_TEMPLATE(sweep_hypervolume, 2)->RangeMultiplier(10)->Range(50, max_pareto_size);
+BENCHMARK_TEMPLATE(general_hypervolume, 3)->RangeMultiplier(10)->Range(50, max_pareto_size);
+BENCHMARK_TEMPLATE(sweep_hypervolume, 3)->RangeMultiplier(10)->Range(50, max_pareto_size);
+BENCHMARK_TEMPLATE(exact_hypervolume, 5, pareto::hypervolume_algorithm::fpli)->Arg(50)->Arg(100)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(exact_hypervolume, 5, pareto::hypervolume_algorithm::wfg)->Arg(50)->Arg(100)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(exact_hypervolume, 7, pareto::hypervolume_algorithm::fpli)->Arg(50)->Arg(100)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(exact_hypervolume, 7, pareto::hypervolume_algorithm::wfg)->Arg(50)->Arg(100)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(leave_one_out_contributions, 2)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(hypervolume_contributions, 2)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(tracked_contributions, 2)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(leave_one_out_contributions, 3)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(hypervolume_contributions, 3)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(tracked_contributions, 3)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(leave_one_out_contributions, 5)->Arg(100)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(hypervolume_contributions, 5)->Arg(100)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(tracked_contributions, 5)->Arg(100);
+BENCHMARK_TEMPLATE(parallel_hypervolume, 3)->Arg(500)->ThreadRange(1, static_cast<int>(number_of_threads))->UseRealTime();
 #ifdef BUILD_LONG_TESTS
 BENCHMARK_TEMPLATE(calculate_hypervolume, 3)->Apply(pareto_sizes_and_samples)->Iterations(1);
 BENCHMARK_TEMPLATE(calculate_hypervolume, 5)->Apply(pareto_sizes_and_samples)->Iterations(1);
 BENCHMARK_TEMPLATE(calculate_hypervolume, 9)->Apply(pareto_sizes_and_samples2)->Iterations(1);
 BENCHMARK_TEMPLATE(calculate_hypervolume, 9)->Apply(pareto_sizes_and_samples)->Iterations(1);
+BENCHMARK_TEMPLATE(exact_hypervolume, 9, pareto::hypervolume_algorithm::fpli)->Arg(50)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(exact_hypervolume, 9, pareto::hypervolume_algorithm::wfg)->Arg(50)->Arg(100)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(exact_hypervolume, 11, pareto::hypervolume_algorithm::wfg)->Arg(50)->Iterations(1)->Unit(benchmark::kMillisecond);
 #endif
 
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -33,7 +33,7 @@ int main(int argc, char **argv) {
     std::cout << "Set up factors " << filename << std::endl;
     std::vector<std::string> container_factors = {
         "implicit_tree", "quad_tree",  "boost_tree",
-        "kd_tree",       "r_tree",     "r_star_tree", };
+        "kd_tree",       "r_tree",     "r_star_tree", "sorted_tree", };
 
     std::vector<size_t> container_dimensions = {1, 2, 3, 5, 7, 9, 13};
 
@@ -102,6 +102,8 @@ int main(int argc, char **argv) {
             return matplot::default_color(3);
         } else if (str == "boost_tree") {
             return matplot::default_color(6);
+        } else if (str == "sorted_tree") {
+            return matplot::to_array(matplot::color::black);
         } else {
             return matplot::default_color(5);
         }
@@ -120,6 +122,8 @@ int main(int argc, char **argv) {
             return matplot::line_spec::marker_style::plus_sign;
         } else if (str == "boost_tree") {
             return matplot::line_spec::marker_style::cross;
+        } else if (str == "sorted_tree") {
+            return matplot::line_spec::marker_style::upward_pointing_triangle;
         } else {
             return matplot::line_spec::marker_style::none;
         }
@@ -138,6 +142,8 @@ int main(int argc, char **argv) {
             return "R*-tree";
         } else if (str == "boost_tree") {
             return "R-tree (Boost)";
+        } else if (str == "sorted_tree") {
+            return "Sorted List";
         } else {
             return str;
         }
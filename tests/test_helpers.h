@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <mutex>
 #include <pareto/front.h>
 #include <random>
 #include <thread>
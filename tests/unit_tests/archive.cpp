@@ -14,6 +14,12 @@
 #include <pareto/r_tree.h>
 #elif r_star_TREETAG
 #include <pareto/r_star_tree.h>
+#elif sorted_TREETAG
+#include <pareto/sorted_tree.h>
+#elif linear_TREETAG
+#include <pareto/linear_quad_tree.h>
+#elif columnar_TREETAG
+#include <pareto/columnar_tree.h>
 #endif
 
 #include <pareto/archive.h>
@@ -390,6 +396,216 @@ void test_archive(size_t RUNTIME_DIMENSION = COMPILE_DIMENSION,
         point_type nadir_ = ar.nadir();
         REQUIRE_FALSE(worst_.dominates(nadir_, is_mini));
     }
+
+    SECTION("Pruning") {
+        for (archive_pruning policy :
+             {archive_pruning::crowding, archive_pruning::hypervolume,
+              archive_pruning::grid}) {
+            archive_type ar(size_t{20}, {}, is_mini.begin(), is_mini.end());
+            ar.set_pruning(policy);
+            REQUIRE(ar.pruning() == policy);
+            for (size_t i = 0; i < 100; ++i) {
+                ar.insert(random_value());
+                REQUIRE(ar.size() <= ar.capacity());
+            }
+            REQUIRE(ar.check_invariants());
+            REQUIRE(ar.size() == ar.total_front_sizes());
+            ar.resize(10);
+            REQUIRE(ar.size() <= 10);
+            REQUIRE(ar.size() == ar.total_front_sizes());
+            REQUIRE(ar.check_invariants());
+        }
+
+        if (test_dimension == 2 && is_mini[0] && is_mini[1]) {
+            // (2, 3) has the least hypervolume contribution
+            archive_type ar(size_t{3}, {}, is_mini.begin(), is_mini.end());
+            ar.set_pruning(archive_pruning::hypervolume);
+            point_type p(test_dimension);
+            for (auto [x, y] : std::vector<std::pair<double, double>>{
+                     {1., 4.}, {2., 3.}, {2.1, 2.9}, {4., 1.}}) {
+                p[0] = x;
+                p[1] = y;
+                ar.insert(std::make_pair(p, 0));
+            }
+            REQUIRE(ar.size() == 3);
+            p[0] = 2.;
+            p[1] = 3.;
+            REQUIRE(ar.find(p) == ar.end());
+        }
+
+        if (test_dimension == 2) {
+            // the reference point does not wrap around for unsigned
+            // maximized dimensions, and (20, 30) still has the least
+            // hypervolume contribution
+            using unsigned_archive =
+                archive<unsigned, COMPILE_DIMENSION, unsigned>;
+            unsigned_archive ar(size_t{3}, {false});
+            ar.set_pruning(archive_pruning::hypervolume);
+            typename unsigned_archive::key_type p(test_dimension);
+            for (auto [x, y] : std::vector<std::pair<unsigned, unsigned>>{
+                     {5, 40}, {20, 30}, {21, 29}, {40, 2}}) {
+                p[0] = x;
+                p[1] = y;
+                ar.insert(std::make_pair(p, 0));
+            }
+            REQUIRE(ar.size() == 3);
+            p[0] = 20;
+            p[1] = 30;
+            REQUIRE(ar.find(p) == ar.end());
+        }
+    }
+
+    SECTION("Batch construction") {
+        // ties and copies of elements
+        std::vector<value_type> v;
+        for (size_t i = 0; i < 300; ++i) {
+            point_type p(test_dimension);
+            for (auto &x : p) {
+                x = std::round(randn() * 4.) / 4.;
+            }
+            v.emplace_back(p, static_cast<unsigned>(i));
+        }
+        v.emplace_back(v.front());
+        archive_type batch(size_t{1000}, v.begin(), v.end(), is_mini.begin(),
+                           is_mini.end());
+        archive_type incremental(size_t{1000}, {}, is_mini.begin(),
+                                 is_mini.end());
+        for (const auto &x : v) {
+            incremental.insert(x);
+        }
+        REQUIRE(batch.size() == v.size());
+        REQUIRE(batch.size() == batch.total_front_sizes());
+        REQUIRE(batch.size_fronts() == incremental.size_fronts());
+        auto sorted_points = [](const auto &pf) {
+            std::vector<std::vector<double>> r;
+            for (const auto &[k, x] : pf) {
+                r.emplace_back(k.begin(), k.end());
+            }
+            std::sort(r.begin(), r.end());
+            return r;
+        };
+        auto it = incremental.begin_front();
+        for (auto pf = batch.begin_front(); pf != batch.end_front(); ++pf) {
+            REQUIRE(pf->check_invariants());
+            REQUIRE(sorted_points(*pf) == sorted_points(*it));
+            ++it;
+        }
+
+        v.clear();
+        for (size_t i = 0; i < 300; ++i) {
+            v.emplace_back(random_value());
+        }
+        archive_type small(size_t{50}, v.begin(), v.end(), is_mini.begin(),
+                           is_mini.end());
+        REQUIRE(small.size() <= 50);
+        REQUIRE(small.size() == small.total_front_sizes());
+        REQUIRE(small.check_invariants());
+
+        // batches over capacity are pruned as if inserted one at a time
+        archive_type small_incremental(size_t{50}, {}, is_mini.begin(),
+                                       is_mini.end());
+        for (const auto &x : v) {
+            small_incremental.insert(x);
+        }
+        REQUIRE(small.size() == small_incremental.size());
+        REQUIRE(small.size_fronts() == small_incremental.size_fronts());
+        it = small_incremental.begin_front();
+        for (auto pf = small.begin_front(); pf != small.end_front(); ++pf) {
+            REQUIRE(sorted_points(*pf) == sorted_points(*it));
+            ++it;
+        }
+
+        // the number of elements inserted
+        archive_type counted(size_t{1000}, {}, is_mini.begin(),
+                             is_mini.end());
+        REQUIRE(counted.insert(v.begin(), v.begin() + 100) == 100);
+        REQUIRE(counted.insert(v.begin() + 100, v.end()) == 200);
+        REQUIRE(counted.size() == v.size());
+    }
+
+    SECTION("Parallel insertion") {
+        // enough elements for the threads to sort and merge three shards
+        std::vector<value_type> v;
+        for (size_t i = 0; i < 3500; ++i) {
+            point_type p(test_dimension);
+            for (auto &x : p) {
+                x = std::round(randn() * 4.) / 4.;
+            }
+            v.emplace_back(p, static_cast<unsigned>(i));
+        }
+        archive_type incremental(size_t{10000}, {}, is_mini.begin(),
+                                 is_mini.end());
+        for (const auto &x : v) {
+            incremental.insert(x);
+        }
+        archive_type parallel(size_t{10000}, {}, is_mini.begin(),
+                              is_mini.end());
+        const auto middle = v.begin() + 500;
+        parallel.insert(v.begin(), middle);
+        parallel.parallel_insert(middle, v.end(), 3);
+        REQUIRE(parallel.size() == v.size());
+        REQUIRE(parallel.size() == parallel.total_front_sizes());
+        auto sorted_points = [](const auto &pf) {
+            std::vector<std::vector<double>> r;
+            for (const auto &[k, x] : pf) {
+                r.emplace_back(k.begin(), k.end());
+            }
+            std::sort(r.begin(), r.end());
+            return r;
+        };
+        auto same_fronts = [&](const archive_type &a, const archive_type &b) {
+            REQUIRE(a.size_fronts() == b.size_fronts());
+            auto it = b.begin_front();
+            for (auto pf = a.begin_front(); pf != a.end_front(); ++pf) {
+                REQUIRE(pf->check_invariants());
+                REQUIRE(sorted_points(*pf) == sorted_points(*it));
+                ++it;
+            }
+        };
+        same_fronts(parallel, incremental);
+
+        // over capacity, the sorted fronts are pruned once
+        archive_type unlimited(size_t{10000}, {}, is_mini.begin(),
+                               is_mini.end());
+        for (auto x = v.begin(); x != v.begin() + 1000; ++x) {
+            unlimited.insert(*x);
+        }
+        for (archive_pruning policy :
+             {archive_pruning::crowding, archive_pruning::hypervolume,
+              archive_pruning::grid}) {
+            auto over_capacity = [&](size_t threads) {
+                archive_type over(size_t{300}, {}, is_mini.begin(),
+                                  is_mini.end());
+                over.set_pruning(policy);
+                for (auto x = v.begin(); x != v.begin() + 200; ++x) {
+                    over.insert(*x);
+                }
+                over.parallel_insert(v.begin() + 200, v.begin() + 1000,
+                                     threads);
+                return over;
+            };
+            const archive_type over = over_capacity(3);
+            REQUIRE(over.size() == over.capacity());
+            REQUIRE(over.size() == over.total_front_sizes());
+            // crowding pruning removes random elements
+            if (policy != archive_pruning::crowding) {
+                same_fronts(over, over_capacity(1));
+            }
+            // only the last front is pruned
+            auto it = unlimited.begin_front();
+            for (auto pf = over.begin_front(); pf != over.end_front(); ++pf) {
+                if (std::next(pf) != over.end_front()) {
+                    REQUIRE(sorted_points(*pf) == sorted_points(*it));
+                } else {
+                    REQUIRE(pf->size() <= it->size());
+                    for (const auto &[k, x] : *pf) {
+                        REQUIRE(it->find(k) != it->end());
+                    }
+                }
+                ++it;
+            }
+        }
+    }
 }
 
 template <bool runtime,
@@ -598,4 +814,31 @@ TEST_CASE("R*-Archive") {
         test_all_dimensions<false, pareto::r_star_tree>();
     }
 }
-#endif
\ No newline at end of file
+#elif sorted_TREETAG
+TEST_CASE("Sorted-Archive") {
+    SECTION("Runtime Dimension") {
+        test_all_dimensions<true, pareto::sorted_tree>();
+    }
+    SECTION("Compile Time Dimension") {
+        test_all_dimensions<false, pareto::sorted_tree>();
+    }
+}
+#elif linear_TREETAG
+TEST_CASE("Linear-Archive") {
+    SECTION("Runtime Dimension") {
+        test_all_dimensions<true, pareto::linear_quad_tree>();
+    }
+    SECTION("Compile Time Dimension") {
+        test_all_dimensions<false, pareto::linear_quad_tree>();
+    }
+}
+#elif columnar_TREETAG
+TEST_CASE("Columnar-Archive") {
+    SECTION("Runtime Dimension") {
+        test_all_dimensions<true, pareto::columnar_tree>();
+    }
+    SECTION("Compile Time Dimension") {
+        test_all_dimensions<false, pareto::columnar_tree>();
+    }
+}
+#endif
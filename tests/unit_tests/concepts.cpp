@@ -11,6 +11,7 @@
 #include <pareto/quad_tree.h>
 #include <pareto/r_star_tree.h>
 #include <pareto/r_tree.h>
+#include <pareto/sorted_tree.h>
 
 template <class T> void check_move_insertable_concept() {
     ;
@@ -951,6 +952,11 @@ TEST_CASE("Concepts") {
         check_spatial_concepts<C, T>();
     }
 
+    SECTION("Sorted Tree") {
+        using C = pareto::sorted_tree<double, 2, unsigned, L>;
+        check_spatial_concepts<C, T>();
+    }
+
     SECTION("Front") {
         using C = pareto::front<double, 2, unsigned>;
         check_front_concepts<C, T>();
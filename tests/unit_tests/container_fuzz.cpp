@@ -6,12 +6,16 @@
 #ifdef BUILD_BOOST_TREE
 #include <pareto/boost_tree.h>
 #endif
+#include <pareto/columnar_tree.h>
+#include <pareto/concurrent_spatial_map.h>
 #include <pareto/front.h>
 #include <pareto/implicit_tree.h>
 #include <pareto/kd_tree.h>
+#include <pareto/linear_quad_tree.h>
 #include <pareto/quad_tree.h>
 #include <pareto/r_star_tree.h>
 #include <pareto/r_tree.h>
+#include <pareto/sorted_tree.h>
 
 template <class TREE_TYPE>
 void test_tree() {
@@ -173,6 +177,9 @@ void test_tree() {
     }
 
     SECTION("Finding the nearest") {
+        // nearest queries in empty trees find nothing
+        REQUIRE(t.find_nearest({0, 0, 0}) == t.end());
+        REQUIRE(t.find_nearest({0, 0, 0}, 3) == t.end());
         insert_some();
         clear_some();
         for (auto it2 = t.find_nearest({0, 0, 0}); it2 != t.end(); ++it2) {
@@ -305,6 +312,20 @@ void test_tree() {
             ++i;
         }
         REQUIRE(i == previous_size / 2);
+
+        // Queries should still find all elements after the erasures
+        key_type p1({-1, -1, -1});
+        key_type p2({+1, +1, +1});
+        auto in_box = [&](const value_type &v) {
+            for (size_t d = 0; d < v.first.dimensions(); ++d) {
+                if (v.first[d] < p1[d] || v.first[d] > p2[d]) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        REQUIRE(std::distance(t.find_intersection(p1, p2), t.end()) ==
+                std::count_if(t.begin(), t.end(), in_box));
     }
 
     SECTION("Erasing with iterator") {
@@ -348,6 +369,57 @@ void test_tree() {
         }
     }
 
+    SECTION("Range constructor and range insertion") {
+        std::vector<value_type> v;
+        for (size_t i = 0; i < 1000; ++i) {
+            v.emplace_back(key_type({randn(), randn(), randn()}), randi());
+        }
+        tree_type t2(v.begin(), v.end());
+        REQUIRE(t2.size() == v.size());
+        REQUIRE(std::distance(t2.begin(), t2.end()) ==
+                static_cast<std::ptrdiff_t>(v.size()));
+        for (const auto &value : v) {
+            REQUIRE(t2.find(value.first) != t2.end());
+        }
+        key_type p1({-0.5, -0.5, -0.5});
+        key_type p2({0.5, 0.5, 0.5});
+        auto in_box = [&](const value_type &a) {
+            for (size_t i = 0; i < a.first.dimensions(); ++i) {
+                if (a.first[i] < p1[i] || a.first[i] > p2[i]) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        REQUIRE(std::distance(t2.find_intersection(p1, p2), t2.end()) ==
+                std::count_if(v.begin(), v.end(), in_box));
+        insert_some();
+        t.insert(v.begin(), v.end());
+        REQUIRE(t.size() == 104 + v.size());
+        for (const auto &value : v) {
+            REQUIRE(t.find(value.first) != t.end());
+        }
+    }
+
+    SECTION("Copies of elements") {
+        // equal values should not confuse the reinsertion of branches
+        std::vector<value_type> v;
+        for (size_t i = 0; i < 300; ++i) {
+            if (i % 3 == 0 && !v.empty()) {
+                v.emplace_back(v[randi() % v.size()]);
+            } else {
+                v.emplace_back(key_type({std::round(randn()), std::round(randn()),
+                                         std::round(randn())}),
+                               randi() % 2);
+            }
+            t.insert(v.back());
+        }
+        REQUIRE(t.size() == v.size());
+        for (const auto &value : v) {
+            REQUIRE(t.find(value.first) != t.end());
+        }
+    }
+
     SECTION("Copy constructor") {
         insert_some();
         clear_some();
@@ -361,6 +433,51 @@ void test_tree() {
     }
 }
 
+/// \brief Erase the value splitting the children of full buckets
+/// The first value of a bucket splits the children of the node, so
+/// erasing it cannot just move another value from the bucket there.
+template <template <class, size_t, class, class, class, size_t> class Tree,
+          size_t BucketSize>
+void test_bucket_splitter() {
+    using namespace pareto;
+    // mapped type without a default constructor
+    struct mapped_type {
+        explicit mapped_type(unsigned x) : x(x) {}
+        bool operator==(const mapped_type &rhs) const { return x == rhs.x; }
+        unsigned x;
+    };
+    using allocator_type = default_allocator_type<
+        std::pair<const point<double, 2>, mapped_type>>;
+    using tree_type =
+        Tree<double, 2, mapped_type, std::less<double>, allocator_type,
+             BucketSize>;
+    using key_type = typename tree_type::key_type;
+    tree_type t;
+    std::vector<key_type> keys;
+    for (size_t i = 0; i < 40 * BucketSize; ++i) {
+        // the last value in the root bucket is the most extreme one
+        const double x = i == BucketSize - 1
+                             ? 100.
+                             : std::round(randn() * 4.);
+        keys.emplace_back(key_type({x, std::round(randn() * 4.)}));
+        t.insert(std::make_pair(keys.back(), mapped_type(unsigned(i))));
+    }
+    REQUIRE(t.check_invariants());
+    // the first value is the splitter of the root
+    for (size_t i = 0; i < keys.size(); i += BucketSize) {
+        auto it = t.find(keys[i]);
+        REQUIRE(it != t.end());
+        t.erase(it);
+        REQUIRE(t.check_invariants());
+    }
+    REQUIRE(t.size() == keys.size() - keys.size() / BucketSize);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (i % BucketSize != 0) {
+            REQUIRE(t.find(keys[i]) != t.end());
+        }
+    }
+}
+
 #ifdef implicit_TREETAG
 TEST_CASE("Implicit-Tree") {
     SECTION("Runtime Dimension") {
@@ -378,6 +495,20 @@ TEST_CASE("Quad-Tree") {
     SECTION("Compile Time Dimension") {
         test_tree<pareto::quad_tree<double, 3, unsigned>>();
     }
+    SECTION("Bucket Size") {
+        using allocator_type = pareto::default_allocator_type<
+            std::pair<const pareto::point<double, 3>, unsigned>>;
+        test_tree<pareto::quad_tree<double, 3, unsigned, std::less<double>,
+                                    allocator_type, 4>>();
+        test_tree<pareto::quad_tree<double, 3, unsigned, std::less<double>,
+                                    allocator_type, 32>>();
+        using runtime_allocator_type = pareto::default_allocator_type<
+            std::pair<const pareto::point<double, 0>, unsigned>>;
+        test_tree<pareto::quad_tree<double, 0, unsigned, std::less<double>,
+                                    runtime_allocator_type, 8>>();
+        test_bucket_splitter<pareto::quad_tree, 4>();
+        test_bucket_splitter<pareto::quad_tree, 32>();
+    }
 }
 #elif kd_TREETAG
 TEST_CASE("kd-Tree") {
@@ -387,6 +518,200 @@ TEST_CASE("kd-Tree") {
     SECTION("Compile Time Dimension") {
         test_tree<pareto::kd_tree<double, 3, unsigned>>();
     }
+    SECTION("Bucket Size") {
+        using allocator_type = pareto::default_allocator_type<
+            std::pair<const pareto::point<double, 3>, unsigned>>;
+        test_tree<pareto::kd_tree<double, 3, unsigned, std::less<double>,
+                                  allocator_type, 4>>();
+        test_tree<pareto::kd_tree<double, 3, unsigned, std::less<double>,
+                                  allocator_type, 32>>();
+        using runtime_allocator_type = pareto::default_allocator_type<
+            std::pair<const pareto::point<double, 0>, unsigned>>;
+        test_tree<pareto::kd_tree<double, 0, unsigned, std::less<double>,
+                                  runtime_allocator_type, 8>>();
+        test_bucket_splitter<pareto::kd_tree, 4>();
+        test_bucket_splitter<pareto::kd_tree, 32>();
+    }
+    SECTION("Freeze") {
+        using tree_type = pareto::kd_tree<double, 3, unsigned>;
+        using key_type = tree_type::key_type;
+        tree_type t;
+        REQUIRE(t.freeze().empty());
+        for (size_t i = 0; i < 500; ++i) {
+            t.insert(std::make_pair(key_type({randn(), randn(), randn()}),
+                                    static_cast<unsigned>(i)));
+        }
+        // copies of an element
+        t.insert(*t.begin());
+        const auto f = t.freeze();
+        REQUIRE(f.size() == t.size());
+        REQUIRE(f.dimensions() == 3);
+        REQUIRE(std::distance(f.begin(), f.end()) ==
+                static_cast<std::ptrdiff_t>(t.size()));
+        REQUIRE(std::distance(f.rbegin(), f.rend()) ==
+                static_cast<std::ptrdiff_t>(t.size()));
+        auto sorted_values = [](auto first, auto last) {
+            std::vector<std::pair<key_type, unsigned>> v;
+            for (; first != last; ++first) {
+                v.emplace_back(first->first, first->second);
+            }
+            std::sort(v.begin(), v.end(), [](const auto &a, const auto &b) {
+                return std::tie(a.first[0], a.first[1], a.first[2],
+                                a.second) < std::tie(b.first[0], b.first[1],
+                                                     b.first[2], b.second);
+            });
+            return v;
+        };
+        REQUIRE(sorted_values(f.begin(), f.end()) ==
+                sorted_values(t.begin(), t.end()));
+        for (size_t i = 0; i < 50; ++i) {
+            key_type a({randn(), randn(), randn()});
+            key_type b({randn(), randn(), randn()});
+            REQUIRE(sorted_values(f.find_intersection(a, b), f.end()) ==
+                    sorted_values(t.find_intersection(a, b), t.end()));
+            REQUIRE(sorted_values(f.find_within(a, b), f.end()) ==
+                    sorted_values(t.find_within(a, b), t.end()));
+            REQUIRE(sorted_values(f.find_disjoint(a, b), f.end()) ==
+                    sorted_values(t.find_disjoint(a, b), t.end()));
+            // iterate a query backwards
+            auto first = f.find_intersection(a, b);
+            auto last = first;
+            std::ptrdiff_t n = 0;
+            while (last != f.end()) {
+                ++last;
+                ++n;
+            }
+            for (; n > 0; --n) {
+                --last;
+            }
+            REQUIRE(last == first);
+            // nearest elements come from the closest to the farthest
+            const size_t k = 1 + i % 7;
+            std::vector<double> frozen_distances;
+            for (auto it2 = f.find_nearest(a, k); it2 != f.end(); ++it2) {
+                frozen_distances.emplace_back(it2->first.distance(a));
+            }
+            std::vector<double> distances;
+            for (auto it2 = t.find_nearest(a, k); it2 != t.end(); ++it2) {
+                distances.emplace_back(it2->first.distance(a));
+            }
+            std::sort(distances.begin(), distances.end());
+            REQUIRE(frozen_distances == distances);
+            // the k nearest among the elements that pass the predicates
+            auto nearest_passing = [&](auto passes) {
+                std::vector<double> r;
+                for (const auto &[key, value] : t) {
+                    if (passes(key, value)) {
+                        r.emplace_back(key.distance(a));
+                    }
+                }
+                std::sort(r.begin(), r.end());
+                r.resize(std::min(r.size(), k));
+                return r;
+            };
+            auto odd = [](const auto &v) { return v.second % 2 == 1; };
+            frozen_distances.clear();
+            for (auto it2 = f.find_nearest(a, k, odd); it2 != f.end(); ++it2) {
+                REQUIRE(odd(*it2));
+                frozen_distances.emplace_back(it2->first.distance(a));
+            }
+            REQUIRE(frozen_distances ==
+                    nearest_passing([](const key_type &, unsigned value) {
+                        return value % 2 == 1;
+                    }));
+            key_type lb({-1., -1., -1.});
+            key_type ub({1., 1., 1.});
+            frozen_distances.clear();
+            for (auto it2 = f.find({pareto::nearest<double, 3>(a, k),
+                                    pareto::intersects<double, 3>(lb, ub)});
+                 it2 != f.end(); ++it2) {
+                frozen_distances.emplace_back(it2->first.distance(a));
+            }
+            REQUIRE(frozen_distances ==
+                    nearest_passing([&](const key_type &key, unsigned) {
+                        return pareto::query_box<double, 3>(lb, ub).contains(
+                            key);
+                    }));
+        }
+        for (const auto &[k, v] : t) {
+            REQUIRE(f.contains(k));
+            REQUIRE(f.count(k) == t.count(k));
+        }
+        for (size_t i = 0; i < 3; ++i) {
+            REQUIRE(f.max_element(i)->first[i] == t.max_value(i));
+            REQUIRE(f.min_element(i)->first[i] == t.min_value(i));
+            REQUIRE(f.max_value(i) == t.max_value(i));
+            REQUIRE(f.min_value(i) == t.min_value(i));
+        }
+        auto copy = f;
+        REQUIRE(copy == f);
+    }
+    SECTION("Balancing") {
+        using tree_type = pareto::kd_tree<double, 3, unsigned>;
+        using key_type = tree_type::key_type;
+        // Sorted insertions turn an unbalanced kd-tree into a list
+        const size_t n = 2000;
+        auto max_height = [](const tree_type &tree) {
+            return std::log(static_cast<double>(tree.size())) /
+                       -std::log(tree.balance_factor()) +
+                   1.;
+        };
+        tree_type unbalanced;
+        unbalanced.balance_factor(1.0);
+        tree_type t;
+        for (size_t i = 0; i < n; ++i) {
+            const double x = static_cast<double>(i);
+            unbalanced.insert(std::make_pair(key_type({x, x, x}), unsigned(i)));
+            auto it = t.insert(std::make_pair(key_type({x, x, x}), unsigned(i)));
+            REQUIRE(it->first == key_type({x, x, x}));
+            REQUIRE(it->second == i);
+        }
+        REQUIRE(unbalanced.height() == n);
+        REQUIRE(t.size() == n);
+        REQUIRE(t.height() <= max_height(t));
+        REQUIRE(t.imbalance() < unbalanced.imbalance());
+        REQUIRE(std::distance(t.begin(), t.end()) == n);
+        for (size_t i = 0; i < n; i += 97) {
+            const double x = static_cast<double>(i);
+            auto it = t.find(key_type({x, x, x}));
+            REQUIRE(it != t.end());
+            REQUIRE(it->second == i);
+        }
+        auto nearest = t.find_nearest(key_type({500.2, 500.2, 500.2}));
+        REQUIRE(nearest->second == 500);
+
+        // Erasures rebuild the tree when it shrinks
+        for (size_t i = 0; i < n; i += 2) {
+            const double x = static_cast<double>(i);
+            REQUIRE(t.erase(key_type({x, x, x})) == 1);
+        }
+        REQUIRE(t.size() == n / 2);
+        REQUIRE(t.height() <= max_height(t));
+        REQUIRE(t.min_value(0) == 1.);
+        REQUIRE(t.max_value(0) == static_cast<double>(n - 1));
+        size_t count = 0;
+        for (const auto &[k, v] : t) {
+            REQUIRE(v % 2 == 1);
+            ++count;
+        }
+        REQUIRE(count == n / 2);
+
+        // Duplicates and random points
+        for (size_t i = 0; i < n; ++i) {
+            t.insert(std::make_pair(key_type({1., 1., 1.}), unsigned(1)));
+            t.insert(std::make_pair(key_type({randn(), randn(), randn()}),
+                                    unsigned(0)));
+        }
+        REQUIRE(t.size() == n / 2 + 2 * n);
+        REQUIRE(t.count(key_type({1., 1., 1.})) == n + 1);
+        tree_type copy = t;
+        REQUIRE(copy == t);
+        copy.balance_factor(0.5);
+        copy.rebalance();
+        REQUIRE(copy.size() == t.size());
+        REQUIRE(copy.height() ==
+                static_cast<size_t>(std::ceil(std::log2(copy.size() + 1))));
+    }
 }
 #elif boost_TREETAG
 #ifdef BUILD_BOOST_TREE
@@ -404,6 +729,70 @@ TEST_CASE("R-Tree") {
     SECTION("Compile Time Dimension") {
         test_tree<pareto::r_tree<double, 3, unsigned>>();
     }
+    SECTION("Custom Fanout") {
+        using allocator_type = pareto::default_allocator_type<
+            std::pair<const pareto::point<double, 3>, unsigned>>;
+        test_tree<pareto::r_tree<double, 3, unsigned, std::less<double>,
+                                 allocator_type, 32>>();
+        test_tree<pareto::r_tree<double, 3, unsigned, std::less<double>,
+                                 allocator_type, 5, 2>>();
+    }
+    SECTION("Concurrent") {
+        // threads insert and query while other threads insert
+        using map_type = pareto::concurrent_spatial_map<double, 3, unsigned>;
+        using tree_type = pareto::r_tree<double, 3, unsigned>;
+        using value_type = tree_type::value_type;
+        using key_type = tree_type::key_type;
+        map_type m(4);
+        REQUIRE(m.number_of_shards() == 4);
+        std::vector<value_type> v;
+        for (size_t i = 0; i < 2000; ++i) {
+            v.emplace_back(key_type({randn(), randn(), randn()}),
+                           static_cast<unsigned>(i));
+        }
+        const key_type lb({-0.5, -0.5, -0.5});
+        const key_type ub({0.5, 0.5, 0.5});
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t]() {
+                for (size_t i = t; i < v.size(); i += 4) {
+                    m.insert(v[i]);
+                    if (i % 50 == 0) {
+                        m.find_intersection(lb, ub);
+                        m.find_nearest(v[i].first, 3);
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        tree_type t(v.begin(), v.end());
+        REQUIRE(m.size() == t.size());
+        auto in_box = m.find_intersection(lb, ub);
+        REQUIRE(in_box.size() ==
+                static_cast<size_t>(
+                    std::distance(t.find_intersection(lb, ub), t.end())));
+        for (const auto &[k, x] : in_box) {
+            REQUIRE(t.find(k) != t.end());
+        }
+        const key_type p({0.1, 0.2, 0.3});
+        auto nearest = m.find_nearest(p, 5);
+        REQUIRE(nearest.size() == 5);
+        std::vector<double> expected;
+        for (auto it = t.find_nearest(p, 5); it != t.end(); ++it) {
+            expected.emplace_back(it->first.distance(p));
+        }
+        std::sort(expected.begin(), expected.end());
+        for (size_t i = 0; i < nearest.size(); ++i) {
+            REQUIRE(nearest[i].first.distance(p) == expected[i]);
+        }
+        REQUIRE(m.contains(v.front().first));
+        REQUIRE(m.erase(v.front().first) == 1);
+        REQUIRE_FALSE(m.contains(v.front().first));
+        m.clear();
+        REQUIRE(m.empty());
+    }
 }
 #elif r_star_TREETAG
 TEST_CASE("R*-Tree") {
@@ -413,5 +802,107 @@ TEST_CASE("R*-Tree") {
     SECTION("Compile Time Dimension") {
         test_tree<pareto::r_star_tree<double, 3, unsigned>>();
     }
+    SECTION("Custom Fanout") {
+        using allocator_type = pareto::default_allocator_type<
+            std::pair<const pareto::point<double, 3>, unsigned>>;
+        test_tree<pareto::r_star_tree<double, 3, unsigned, std::less<double>,
+                                      allocator_type, 32>>();
+        test_tree<pareto::r_star_tree<double, 3, unsigned, std::less<double>,
+                                      allocator_type, 5, 2>>();
+    }
+}
+#elif sorted_TREETAG
+TEST_CASE("Sorted-Tree") {
+    SECTION("Runtime Dimension") {
+        test_tree<pareto::sorted_tree<double, 0, unsigned>>();
+    }
+    SECTION("Compile Time Dimension") {
+        test_tree<pareto::sorted_tree<double, 3, unsigned>>();
+    }
+    SECTION("Staircase") {
+        // Two-dimensional fronts are sorted in both dimensions, so the
+        // queries use binary searches instead of scanning
+        using tree_type = pareto::sorted_tree<double, 2, unsigned>;
+        using key_type = tree_type::key_type;
+        tree_type t;
+        for (size_t i = 0; i < 200; ++i) {
+            const double x = std::round(randn() * 50.) / 50.;
+            t.insert(std::make_pair(key_type({x, -x}), unsigned(i)));
+        }
+        REQUIRE(t.is_staircase());
+        t.insert(std::make_pair(key_type({0., 1.}), 0u));
+        REQUIRE_FALSE(t.is_staircase());
+        t.erase(key_type({0., 1.}));
+        REQUIRE(t.is_staircase());
+        for (size_t i = 0; i < 50; ++i) {
+            key_type lb({randn(), randn()});
+            key_type ub({randn(), randn()});
+            auto in_box = [&](const tree_type::value_type &v) {
+                return v.first[0] >= std::min(lb[0], ub[0]) &&
+                       v.first[0] <= std::max(lb[0], ub[0]) &&
+                       v.first[1] >= std::min(lb[1], ub[1]) &&
+                       v.first[1] <= std::max(lb[1], ub[1]);
+            };
+            const auto expected = std::count_if(t.begin(), t.end(), in_box);
+            REQUIRE(std::distance(t.find_intersection(lb, ub), t.end()) ==
+                    expected);
+            REQUIRE(std::distance(t.find_within(lb, ub), t.end()) ==
+                    expected);
+            auto nearest = t.find_nearest(lb, 3);
+            REQUIRE(std::distance(nearest, t.end()) == 3);
+            double farthest = 0.;
+            for (auto it = nearest; it != t.end(); ++it) {
+                farthest = std::max(farthest, it->first.distance(lb));
+            }
+            REQUIRE(std::count_if(t.begin(), t.end(), [&](const auto &v) {
+                        return v.first.distance(lb) < farthest;
+                    }) <= 2);
+        }
+        for (size_t d = 0; d < 2; ++d) {
+            REQUIRE(t.min_value(d) ==
+                    std::min_element(t.begin(), t.end(),
+                                     [d](const auto &a, const auto &b) {
+                                         return a.first[d] < b.first[d];
+                                     })
+                        ->first[d]);
+            REQUIRE(t.max_value(d) ==
+                    std::max_element(t.begin(), t.end(),
+                                     [d](const auto &a, const auto &b) {
+                                         return a.first[d] < b.first[d];
+                                     })
+                        ->first[d]);
+        }
+    }
+}
+#elif linear_TREETAG
+TEST_CASE("Linear-Quad-Tree") {
+    SECTION("Runtime Dimension") {
+        test_tree<pareto::linear_quad_tree<double, 0, unsigned>>();
+    }
+    SECTION("Compile Time Dimension") {
+        test_tree<pareto::linear_quad_tree<double, 3, unsigned>>();
+    }
+    SECTION("Hilbert Curve") {
+        using allocator_type = pareto::default_allocator_type<
+            std::pair<const pareto::point<double, 3>, unsigned>>;
+        test_tree<pareto::linear_quad_tree<double, 3, unsigned,
+                                           std::less<double>, allocator_type,
+                                           pareto::hilbert_curve>>();
+        using runtime_allocator_type = pareto::default_allocator_type<
+            std::pair<const pareto::point<double, 0>, unsigned>>;
+        test_tree<pareto::linear_quad_tree<double, 0, unsigned,
+                                           std::less<double>,
+                                           runtime_allocator_type,
+                                           pareto::hilbert_curve>>();
+    }
+}
+#elif columnar_TREETAG
+TEST_CASE("Columnar-Tree") {
+    SECTION("Runtime Dimension") {
+        test_tree<pareto::columnar_tree<double, 0, unsigned>>();
+    }
+    SECTION("Compile Time Dimension") {
+        test_tree<pareto::columnar_tree<double, 3, unsigned>>();
+    }
 }
 #endif
\ No newline at end of file
@@ -14,6 +14,12 @@
 #include <pareto/r_tree.h>
 #elif r_star_TREETAG
 #include <pareto/r_star_tree.h>
+#elif sorted_TREETAG
+#include <pareto/sorted_tree.h>
+#elif linear_TREETAG
+#include <pareto/linear_quad_tree.h>
+#elif columnar_TREETAG
+#include <pareto/columnar_tree.h>
 #endif
 
 #include <pareto/front.h>
@@ -192,6 +198,48 @@ void test_front(size_t RUNTIME_DIMENSION = COMPILE_DIMENSION,
         REQUIRE(pfs2 == pf.size());
     }
 
+    SECTION("Batch insertion") {
+        // inserting a batch is the same as inserting its elements one by one
+        auto pf = random_pareto_front();
+        std::vector<value_type> v;
+        for (size_t i = 0; i < 300; ++i) {
+            v.emplace_back(random_value());
+        }
+        // values with ties
+        for (size_t i = 0; i < 100; ++i) {
+            auto x = random_value();
+            for (auto &c : x.first) {
+                c = std::round(c);
+            }
+            v.emplace_back(x);
+        }
+        v.emplace_back(v.front());
+        v.emplace_back(*pf.begin());
+        front_type pf2 = pf;
+        for (const auto &x : v) {
+            pf2.insert(x);
+        }
+        pf.insert(v.begin(), v.end());
+        REQUIRE(pf.check_invariants());
+        REQUIRE(pf.size() == pf2.size());
+        auto sorted_keys = [](const front_type &f) {
+            std::vector<point_type> r;
+            for (const auto &[k, x] : f) {
+                r.emplace_back(k);
+            }
+            std::sort(r.begin(), r.end(), [](const auto &a, const auto &b) {
+                return std::lexicographical_compare(a.begin(), a.end(),
+                                                    b.begin(), b.end());
+            });
+            return r;
+        };
+        REQUIRE(sorted_keys(pf) == sorted_keys(pf2));
+        front_type pf3({}, is_mini.begin(), is_mini.end());
+        size_t inserted = pf3.insert(v.begin(), v.end());
+        REQUIRE(inserted == pf3.size());
+        REQUIRE(pf3.check_invariants());
+    }
+
     SECTION("Queries") {
         auto pf = random_pareto_front();
         auto p = random_point();
@@ -369,6 +417,41 @@ void test_front(size_t RUNTIME_DIMENSION = COMPILE_DIMENSION,
 
         REQUIRE(pf <= worst_);
         REQUIRE(ideal_ <= pf);
+
+        // ideal and nadir are cached, so compare them with the elements
+        // while the front changes
+        auto check_extremes = [&]() {
+            if (pf.empty()) {
+                return;
+            }
+            for (size_t i = 0; i < pf.dimensions(); ++i) {
+                auto [min_it, max_it] = std::minmax_element(
+                    pf.begin(), pf.end(), [i](const auto &a, const auto &b) {
+                        return a.first[i] < b.first[i];
+                    });
+                REQUIRE(pf.min_value(i) == min_it->first[i]);
+                REQUIRE(pf.max_value(i) == max_it->first[i]);
+                REQUIRE(pf.ideal(i) == (pf.is_minimization(i)
+                                            ? min_it->first[i]
+                                            : max_it->first[i]));
+                REQUIRE(pf.nadir(i) == (pf.is_minimization(i)
+                                            ? max_it->first[i]
+                                            : min_it->first[i]));
+            }
+        };
+        check_extremes();
+        for (size_t i = 0; i < 20; ++i) {
+            pf.insert(std::make_pair(random_point(), randi()));
+            check_extremes();
+        }
+        while (!pf.empty()) {
+            pf.erase(pf.max_element(0));
+            check_extremes();
+            if (!pf.empty()) {
+                pf.erase(pf.min_element(pf.dimensions() - 1)->first);
+                check_extremes();
+            }
+        }
     }
 }
 
@@ -574,4 +657,31 @@ TEST_CASE("R*-Front") {
         test_all_dimensions<false, pareto::r_star_tree>();
     }
 }
-#endif
\ No newline at end of file
+#elif sorted_TREETAG
+TEST_CASE("Sorted-Front") {
+    SECTION("Runtime Dimension") {
+        test_all_dimensions<true, pareto::sorted_tree>();
+    }
+    SECTION("Compile Time Dimension") {
+        test_all_dimensions<false, pareto::sorted_tree>();
+    }
+}
+#elif linear_TREETAG
+TEST_CASE("Linear-Front") {
+    SECTION("Runtime Dimension") {
+        test_all_dimensions<true, pareto::linear_quad_tree>();
+    }
+    SECTION("Compile Time Dimension") {
+        test_all_dimensions<false, pareto::linear_quad_tree>();
+    }
+}
+#elif columnar_TREETAG
+TEST_CASE("Columnar-Front") {
+    SECTION("Runtime Dimension") {
+        test_all_dimensions<true, pareto::columnar_tree>();
+    }
+    SECTION("Compile Time Dimension") {
+        test_all_dimensions<false, pareto::columnar_tree>();
+    }
+}
+#endif
@@ -2,6 +2,9 @@
 
 #include "../test_helpers.h"
 #include <catch2/catch.hpp>
+#include <pareto/concurrent_front.h>
+
+#include <atomic>
 
 TEST_CASE("Front Interface") {
     SECTION("Front 2d") {
@@ -100,4 +103,412 @@ TEST_CASE("Front Interface") {
         }
         REQUIRE(pf.hypervolume() != 0);
     }
-}
\ No newline at end of file
+
+    SECTION("Concurrent hypervolume") {
+        /*
+         * The exact hypervolume keeps its state in a workspace,
+         * so fronts can be evaluated concurrently. Each thread
+         * can also reuse its own workspace for many fronts.
+         */
+        using namespace pareto;
+        using front_type = front<double, 3, unsigned>;
+        std::vector<front_type> fronts(8);
+        for (auto &pf : fronts) {
+            for (size_t i = 0; i < 100; ++i) {
+                pf(randn(), randn(), randn()) = 0;
+            }
+        }
+        std::vector<double> expected;
+        for (const auto &pf : fronts) {
+            expected.emplace_back(pf.hypervolume(pf.nadir()));
+        }
+        std::vector<double> results(fronts.size(), 0.);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < 2; ++t) {
+            threads.emplace_back([&, t]() {
+                hypervolume_workspace workspace;
+                for (size_t i = t; i < fronts.size(); i += 2) {
+                    results[i] =
+                        fronts[i].hypervolume(fronts[i].nadir(), workspace);
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        REQUIRE(results == expected);
+
+        front<double, 2, unsigned> pf2;
+        pf2(1., 3.) = 0;
+        pf2(2., 2.) = 0;
+        pf2(3., 1.) = 0;
+        REQUIRE(pf2.hypervolume({4., 4.}) == Approx(6.));
+    }
+
+    SECTION("Concurrent front") {
+        /*
+         * Readers query snapshots of the front while a writer
+         * publishes new versions. A snapshot never changes.
+         */
+        using namespace pareto;
+        using concurrent_type = concurrent_front<double, 2, unsigned>;
+        using value_type = concurrent_type::value_type;
+        concurrent_type cf;
+        auto empty_snapshot = cf.snapshot();
+        std::vector<value_type> values;
+        for (size_t i = 0; i < 200; ++i) {
+            values.emplace_back(value_type({randn(), randn()}, 0));
+        }
+        std::atomic<bool> done{false};
+        std::atomic<size_t> inconsistent{0};
+        std::vector<std::thread> readers;
+        for (size_t t = 0; t < 2; ++t) {
+            readers.emplace_back([&]() {
+                while (!done) {
+                    auto pf = cf.snapshot();
+                    const size_t n = pf->size();
+                    if (static_cast<size_t>(std::distance(
+                            pf->begin(), pf->end())) != n) {
+                        ++inconsistent;
+                    }
+                    if (pf->size() > 1 && !pf->dominates(pf->nadir())) {
+                        ++inconsistent;
+                    }
+                }
+            });
+        }
+        for (size_t i = 0; i < values.size(); i += 10) {
+            cf.insert(values.begin() + i, values.begin() + i + 10);
+        }
+        done = true;
+        for (auto &reader : readers) {
+            reader.join();
+        }
+        REQUIRE(inconsistent == 0);
+        REQUIRE(empty_snapshot->empty());
+        REQUIRE(cf.version() == values.size() / 10);
+
+        front<double, 2, unsigned> expected(values.begin(), values.end());
+        REQUIRE(*cf.snapshot() == expected);
+        auto before_erase = cf.snapshot();
+        REQUIRE(cf.erase(expected.begin()->first) == 1);
+        REQUIRE(before_erase->size() == expected.size());
+        REQUIRE(cf.snapshot()->size() == expected.size() - 1);
+        cf.clear();
+        REQUIRE(cf.snapshot()->empty());
+
+        // deferred changes are published together
+        const size_t version = cf.version();
+        for (size_t i = 0; i < 10; ++i) {
+            REQUIRE(cf.defer_insert(values[i]) == i + 1);
+        }
+        REQUIRE(cf.snapshot()->empty());
+        REQUIRE(cf.flush() == 10);
+        REQUIRE(cf.flush() == 0);
+        REQUIRE(cf.version() == version + 1);
+        front<double, 2, unsigned> expected_batch(values.begin(),
+                                                  values.begin() + 10);
+        REQUIRE(*cf.snapshot() == expected_batch);
+    }
+
+    SECTION("Hypervolume sweeps") {
+        /*
+         * Two and three dimensions have their own sweeps.
+         * They should match the general algorithm.
+         */
+        using namespace pareto;
+        for (size_t n : {1, 2, 10, 200}) {
+            std::vector<double> data2;
+            std::vector<double> data3;
+            std::vector<std::array<double, 2>> points2;
+            std::vector<std::array<double, 3>> points3;
+            for (size_t i = 0; i < n; ++i) {
+                // ties, duplicates and points beyond the reference
+                auto x = [] { return std::round(randn() * 4.) / 4.; };
+                points2.push_back({x(), x()});
+                points3.push_back({x(), x(), x()});
+                data2.insert(data2.end(), points2.back().begin(),
+                             points2.back().end());
+                data3.insert(data3.end(), points3.back().begin(),
+                             points3.back().end());
+            }
+            const double ref[] = {1., 1., 1.};
+            const int m = static_cast<int>(n);
+            REQUIRE(hv_2d(points2, ref) ==
+                    Approx(fpli_hv(data2.data(), 2, m, ref)));
+            REQUIRE(hv_3d(points3, ref) ==
+                    Approx(fpli_hv(data3.data(), 3, m, ref)));
+        }
+
+        front<double, 3, unsigned> pf3({min, max, min});
+        pf3(1., 3., 1.) = 0;
+        pf3(2., 4., 0.) = 0;
+        REQUIRE(pf3.hypervolume({3., 0., 2.}) == Approx(11.));
+    }
+
+    SECTION("Hypervolume algorithms") {
+        /*
+         * WFG is much faster than the default algorithm
+         * with many objectives. We can choose the algorithm
+         * or let the front choose it from the number of
+         * dimensions.
+         */
+        using namespace pareto;
+        for (size_t m : {2, 4, 6, 7}) {
+            front<double, 0, unsigned> pf;
+            for (size_t i = 0; i < 30; ++i) {
+                front<double, 0, unsigned>::key_type p(m);
+                std::generate(p.begin(), p.end(), randn);
+                pf.insert(std::make_pair(p, 0));
+            }
+            const auto ref = pf.nadir();
+            const double fpli = pf.hypervolume(ref, hypervolume_algorithm::fpli);
+            const double wfg = pf.hypervolume(ref, hypervolume_algorithm::wfg);
+            REQUIRE(wfg == Approx(fpli));
+            REQUIRE(pf.hypervolume(ref) == Approx(fpli));
+        }
+
+        // small fronts never reach the WFG recursion
+        front<double, 0, unsigned> pf1;
+        pf1.insert(std::make_pair(front<double, 0, unsigned>::key_type({1.}), 0));
+        REQUIRE(pf1.hypervolume({3.}, hypervolume_algorithm::wfg) ==
+                Approx(2.));
+        pf1.insert(std::make_pair(front<double, 0, unsigned>::key_type({2.}), 0));
+        pf1.insert(std::make_pair(front<double, 0, unsigned>::key_type({0.}), 0));
+        REQUIRE(pf1.hypervolume({3.}, hypervolume_algorithm::wfg) ==
+                Approx(3.));
+        front<double, 0, unsigned> pf4;
+        pf4.insert(std::make_pair(
+            front<double, 0, unsigned>::key_type({1., 2., 3., 4.}), 0));
+        REQUIRE(pf4.hypervolume({2., 3., 4., 5.}, hypervolume_algorithm::wfg) ==
+                Approx(1.));
+        REQUIRE(pf4.hypervolume({0., 3., 4., 5.}, hypervolume_algorithm::wfg) ==
+                Approx(0.));
+        std::vector<double> empty;
+        std::vector<double> ref1 = {1.};
+        detail::fpli_workspace w;
+        REQUIRE(wfg_hv(empty.data(), 1, 0, ref1.data(), w) == 0.);
+    }
+
+    SECTION("Frozen front") {
+        using namespace pareto;
+        front<double, 3, unsigned> pf({min, max, min});
+        for (size_t i = 0; i < 300; ++i) {
+            pf(randn(), randn(), randn()) = static_cast<unsigned>(i);
+        }
+        const auto frozen = pf.freeze();
+        REQUIRE(frozen.size() == pf.size());
+        REQUIRE(frozen.is_minimization(0));
+        REQUIRE(frozen.is_maximization(1));
+        REQUIRE(frozen.ideal() == pf.ideal());
+        REQUIRE(frozen.nadir() == pf.nadir());
+        REQUIRE(frozen.hypervolume(pf.nadir()) ==
+                Approx(pf.hypervolume(pf.nadir())));
+        for (size_t i = 0; i < 100; ++i) {
+            front<double, 3, unsigned>::key_type p({randn(), randn(), randn()});
+            REQUIRE(frozen.dominates(p) == pf.dominates(p));
+            REQUIRE(frozen.is_partially_dominated_by(p) ==
+                    pf.is_partially_dominated_by(p));
+            REQUIRE(std::distance(frozen.find_dominated(p), frozen.end()) ==
+                    std::distance(pf.find_dominated(p), pf.end()));
+            REQUIRE(frozen.find_nearest(p)->first.distance(p) ==
+                    Approx(pf.find_nearest(p)->first.distance(p)));
+        }
+        for (const auto &[k, v] : pf) {
+            REQUIRE(frozen.find(k) != frozen.end());
+            REQUIRE(frozen.find(k)->second == v);
+        }
+    }
+
+    SECTION("Hypervolume contributions") {
+        /*
+         * The contribution of an element is the hypervolume
+         * the front loses without it. We can calculate all
+         * contributions at once or keep them updated while
+         * the front changes.
+         */
+        using namespace pareto;
+        using front_type = front<double, 0, unsigned>;
+        for (size_t m : {1, 2, 3, 4, 6}) {
+            front_type pf;
+            for (size_t i = 0; i < 40; ++i) {
+                front_type::key_type p(m);
+                std::generate(p.begin(), p.end(), randn);
+                pf.insert(std::make_pair(p, 0));
+            }
+            // copies of an element contribute nothing
+            const auto copy = *pf.begin();
+            pf.insert(copy);
+            const front_type::key_type ref(m, 2.);
+            const double hv = pf.hypervolume(ref);
+            const auto contributions = pf.hypervolume_contributions(ref);
+            REQUIRE(contributions.size() == pf.size());
+            size_t i = 0;
+            for (auto it = pf.begin(); it != pf.end(); ++it) {
+                front_type without_it = pf;
+                without_it.erase(without_it.find(it->first));
+                const double expected = hv - without_it.hypervolume(ref);
+                REQUIRE(contributions[i] == Approx(expected).margin(1e-9));
+                REQUIRE(pf.hypervolume_contribution(it, ref) ==
+                        Approx(expected).margin(1e-9));
+                if (it->first == copy.first) {
+                    REQUIRE(contributions[i] == 0.);
+                }
+                ++i;
+            }
+        }
+
+        // the three-dimensional sweep needs fronts without copies
+        for (size_t n : {1, 2, 50, 300}) {
+            front<double, 3, unsigned> pf3({min, max, min});
+            for (size_t i = 0; i < n; ++i) {
+                pf3(randn(), randn(), randn()) = static_cast<unsigned>(i);
+            }
+            const front<double, 3, unsigned>::key_type ref3({1., -1., 1.});
+            const double hv = pf3.hypervolume(ref3);
+            const auto contributions = pf3.hypervolume_contributions(ref3);
+            size_t i = 0;
+            for (auto it = pf3.begin(); it != pf3.end(); ++it) {
+                auto without_it = pf3;
+                without_it.erase(without_it.find(it->first));
+                const double expected = hv - without_it.hypervolume(ref3);
+                REQUIRE(contributions[i] == Approx(expected).margin(1e-9));
+                ++i;
+            }
+        }
+
+        front<double, 3, unsigned> pf({min, max, min});
+        const front<double, 3, unsigned>::key_type ref({2., -2., 2.});
+        pf.track_hypervolume_contributions(ref);
+        REQUIRE(pf.is_tracking_hypervolume_contributions());
+        for (size_t i = 0; i < 100; ++i) {
+            pf(randn(), randn(), randn()) = static_cast<unsigned>(i);
+            if (i % 7 == 0) {
+                pf.insert(*pf.begin());
+            }
+            if (i % 3 == 0) {
+                pf.erase(pf.begin());
+            }
+            auto fresh = pf;
+            fresh.untrack_hypervolume_contributions();
+            const auto expected = fresh.hypervolume_contributions(ref);
+            const auto cached = pf.hypervolume_contributions(ref);
+            REQUIRE(cached.size() == expected.size());
+            for (size_t j = 0; j < cached.size(); ++j) {
+                REQUIRE(cached[j] == Approx(expected[j]).margin(1e-9));
+            }
+        }
+    }
+
+    SECTION("Batch insertion") {
+        /*
+         * Inserting a range gives the same front as inserting
+         * its elements one at a time, even when the range is
+         * unsorted and has elements dominated by other elements
+         * in the range or in the front.
+         */
+        using namespace pareto;
+        using front_type = front<double, 3, unsigned>;
+        for (size_t initial : {0, 1, 20}) {
+            front_type batch_front({min, max, min});
+            for (size_t i = 0; i < initial; ++i) {
+                batch_front(randn(), randn(), randn()) = static_cast<unsigned>(i);
+            }
+            front_type sequential_front = batch_front;
+            std::vector<std::pair<front_type::key_type, unsigned>> v;
+            for (size_t i = 0; i < 200; ++i) {
+                front_type::key_type p({randn(), randn(), randn()});
+                v.emplace_back(p, static_cast<unsigned>(1000 + i));
+                // an element dominated by the previous one
+                if (i % 5 == 0) {
+                    p[0] += 1.;
+                    p[1] -= 1.;
+                    v.emplace_back(p, static_cast<unsigned>(2000 + i));
+                }
+            }
+            std::shuffle(v.begin(), v.end(), std::mt19937(initial));
+            const size_t inserted = batch_front.insert(v.begin(), v.end());
+            for (const auto &e : v) {
+                sequential_front.insert(e);
+            }
+            REQUIRE(batch_front.size() == sequential_front.size());
+            // the trees might have different shapes, so we compare
+            // the elements in the same order
+            auto sorted_elements = [](const front_type &pf) {
+                std::vector<std::pair<front_type::key_type, unsigned>> r(
+                    pf.begin(), pf.end());
+                std::sort(r.begin(), r.end(), [](const auto &a, const auto &b) {
+                    return a.first.values() < b.first.values();
+                });
+                return r;
+            };
+            REQUIRE(sorted_elements(batch_front) ==
+                    sorted_elements(sequential_front));
+            REQUIRE(batch_front.ideal() == sequential_front.ideal());
+            REQUIRE(batch_front.nadir() == sequential_front.nadir());
+            size_t from_batch = 0;
+            for (const auto &[k, value] : batch_front) {
+                from_batch += value >= 1000;
+            }
+            REQUIRE(inserted == from_batch);
+            REQUIRE(batch_front.check_invariants());
+        }
+    }
+
+    SECTION("Grid crowding") {
+        /*
+         * The front keeps its elements in the cells of a grid
+         * over its extreme values, so the element in the most
+         * crowded cell is always at hand.
+         */
+        using namespace pareto;
+        front<double, 3, unsigned> pf({min, max, min});
+        const size_t divisions = 3;
+        pf.track_grid_crowding(divisions);
+        REQUIRE(pf.is_tracking_grid_crowding());
+        REQUIRE(pf.grid_divisions() == divisions);
+        REQUIRE(pf.most_crowded_element() == pf.end());
+        auto cell = [&](const front<double, 3, unsigned>::key_type &p) {
+            std::vector<size_t> c(p.dimensions());
+            for (size_t j = 0; j < p.dimensions(); ++j) {
+                double lower = pf.begin()->first[j];
+                double upper = lower;
+                for (const auto &[k, v] : pf) {
+                    lower = std::min(lower, k[j]);
+                    upper = std::max(upper, k[j]);
+                }
+                const double x =
+                    upper > lower ? (p[j] - lower) / (upper - lower) : 0.;
+                c[j] = std::min(static_cast<size_t>(x * divisions),
+                                divisions - 1);
+            }
+            return c;
+        };
+        for (size_t i = 0; i < 150; ++i) {
+            pf(randn(), randn(), randn()) = static_cast<unsigned>(i);
+            if (i % 7 == 0) {
+                pf.insert(*pf.begin());
+            }
+            if (i % 3 == 0) {
+                pf.erase(pf.begin());
+            }
+            if (i % 11 == 0 && pf.size() > 1) {
+                pf.erase(pf.most_crowded_element());
+            }
+            std::map<std::vector<size_t>, size_t> counts;
+            for (const auto &[k, v] : pf) {
+                ++counts[cell(k)];
+            }
+            size_t most = 0;
+            for (const auto &[c, n] : counts) {
+                most = std::max(most, n);
+            }
+            auto it = pf.most_crowded_element();
+            REQUIRE(it != pf.end());
+            REQUIRE(counts[cell(it->first)] == most);
+        }
+        pf.untrack_grid_crowding();
+        REQUIRE_FALSE(pf.is_tracking_grid_crowding());
+        REQUIRE(pf.most_crowded_element() == pf.end());
+    }
+}
@@ -3,6 +3,7 @@
 #include <catch2/catch.hpp>
 #include <pareto/front.h>
 #include <pareto/point.h>
+#include <random>
 
 /// The point object has a better distance function
 /// This one is for comparisons only
@@ -54,3 +55,123 @@ TEST_CASE("Point dominance") {
     REQUIRE(p3.non_dominates(p1));
     REQUIRE_FALSE(p3.non_dominates(p2));
 }
+
+/// Compare the dominance of compile time dimension points, which use
+/// bit masks, with runtime dimension points, which compare one
+/// coordinate at a time
+template <class T, size_t M>
+void test_compile_time_dominance() {
+    using namespace pareto;
+    std::mt19937 g(M);
+    // Few values so that we get lots of ties
+    std::uniform_int_distribution<int> d(-2, 2);
+    std::uniform_int_distribution<int> flip(0, 1);
+    for (size_t i = 0; i < 1000; ++i) {
+        point<T, M> a;
+        point<T, M> b;
+        point<T> ra(M);
+        point<T> rb(M);
+        std::array<uint8_t, M> is_minimization{};
+        for (size_t j = 0; j < M; ++j) {
+            a[j] = ra[j] = static_cast<T>(d(g));
+            b[j] = rb[j] = static_cast<T>(d(g));
+            is_minimization[j] = static_cast<uint8_t>(flip(g));
+        }
+        REQUIRE(a.dominates(b, is_minimization) ==
+                ra.dominates(rb, is_minimization));
+        const detail::direction_mask<M> directions(is_minimization);
+        REQUIRE(a.dominates(b, directions) ==
+                ra.dominates(rb, is_minimization));
+        REQUIRE(a.strongly_dominates(b, is_minimization) ==
+                ra.strongly_dominates(rb, is_minimization));
+        REQUIRE(a.dominates(b) == ra.dominates(rb));
+        REQUIRE(a.dominates(b, false) == ra.dominates(rb, false));
+        REQUIRE(a.strongly_dominates(b) == ra.strongly_dominates(rb));
+        REQUIRE(a.strongly_dominates(b, false) ==
+                ra.strongly_dominates(rb, false));
+    }
+}
+
+template <class T>
+void test_compile_time_dominance_all_dimensions() {
+    test_compile_time_dominance<T, 1>();
+    test_compile_time_dominance<T, 2>();
+    test_compile_time_dominance<T, 3>();
+    test_compile_time_dominance<T, 4>();
+    test_compile_time_dominance<T, 5>();
+    test_compile_time_dominance<T, 8>();
+    test_compile_time_dominance<T, 9>();
+    test_compile_time_dominance<T, 13>();
+    // direction masks with more than one word
+    test_compile_time_dominance<T, 70>();
+}
+
+TEST_CASE("Point dominance with compile time dimensions") {
+    SECTION("double") { test_compile_time_dominance_all_dimensions<double>(); }
+    SECTION("float") { test_compile_time_dominance_all_dimensions<float>(); }
+    SECTION("int") { test_compile_time_dominance_all_dimensions<int>(); }
+    SECTION("unsigned") {
+        test_compile_time_dominance_all_dimensions<unsigned>();
+    }
+}
+
+TEST_CASE("Point storage with runtime dimensions") {
+    using namespace pareto;
+    using point_type = point<double, 0>;
+    constexpr size_t n = point_type::runtime_inline_dimensions;
+
+    SECTION("Inline") {
+        point_type p({1., 2., 3.});
+        REQUIRE(p.values().is_inline());
+        point_type q(n, 1.);
+        REQUIRE(q.values().is_inline());
+        q.push_back(2.);
+        REQUIRE_FALSE(q.values().is_inline());
+        REQUIRE(q.dimensions() == n + 1);
+        REQUIRE(q[n] == 2.);
+        REQUIRE(q[n - 1] == 1.);
+    }
+
+    SECTION("Copy and move") {
+        for (size_t d : {size_t(3), n, n + 5}) {
+            point_type p(d);
+            std::iota(p.begin(), p.end(), 0.);
+            point_type copy = p;
+            REQUIRE(copy == p);
+            point_type moved = std::move(copy);
+            REQUIRE(moved == p);
+            REQUIRE(moved.values().is_inline() == (d <= n));
+            point_type assigned({9.});
+            assigned = p;
+            REQUIRE(assigned == p);
+            assigned = std::move(moved);
+            REQUIRE(assigned == p);
+            point_type other(d + 1, 7.);
+            std::swap(assigned, other);
+            REQUIRE(other == p);
+            REQUIRE(assigned == point_type(d + 1, 7.));
+            assigned.clear();
+            REQUIRE(assigned.dimensions() == 0);
+        }
+    }
+
+    SECTION("Size") {
+        // the inline coordinates, a pointer, the size and the capacity
+        static_assert(sizeof(point_type) ==
+                      n * sizeof(double) + sizeof(double *) +
+                          2 * sizeof(size_t));
+        static_assert(sizeof(point<double, 3>) == 3 * sizeof(double));
+        point_type p({1., 2., 3.});
+        std::vector<double> v = p.values();
+        REQUIRE(v == std::vector<double>({1., 2., 3.}));
+    }
+
+    SECTION("Comparison") {
+        point_type a({1., 2.});
+        point_type b({1., 3.});
+        REQUIRE(a.values() < b.values());
+        REQUIRE(a != b);
+        REQUIRE(a.dominates(b));
+        REQUIRE_FALSE(b.values() < a.values());
+    }
+}